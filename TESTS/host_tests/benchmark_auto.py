@@ -0,0 +1,110 @@
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+
+import json
+import os
+
+from mbed_host_tests import BaseHostTest
+
+
+class BenchmarkTest(BaseHostTest):
+    """ Collects {{__benchmark;"name",iterations,min,median,p99,max}} results
+        sent by utest benchmarks and compares them against a baseline.
+
+        Environment variables:
+            MBED_BENCHMARK_RESULTS   - JSON file the results are merged into
+            MBED_BENCHMARK_BASELINE  - JSON file of earlier results to compare with
+            MBED_BENCHMARK_TOLERANCE - allowed median slowdown as a fraction (0.10)
+    """
+    FIELDS = ('iterations', 'min_us', 'median_us', 'p99_us', 'max_us')
+
+    def __init__(self):
+        BaseHostTest.__init__(self)
+        self.benchmarks = {}
+        self.regressions = []
+        self.results_path = os.environ.get('MBED_BENCHMARK_RESULTS')
+        self.baseline_path = os.environ.get('MBED_BENCHMARK_BASELINE')
+        self.tolerance = float(os.environ.get('MBED_BENCHMARK_TOLERANCE', '0.10'))
+
+    @staticmethod
+    def parse(value):
+        name, _, numbers = value.rpartition('",')
+        name = name.lstrip('"')
+        values = [int(x) for x in numbers.split(',')]
+        return name, dict(zip(BenchmarkTest.FIELDS, values))
+
+    @staticmethod
+    def load(path):
+        if not path or not os.path.exists(path):
+            return {}
+        with open(path) as f:
+            return json.load(f)
+
+    def _callback_benchmark(self, key, value, timestamp):
+        """ {{__benchmark;"name",iterations,min,median,p99,max}} """
+        try:
+            name, stats = self.parse(value)
+        except ValueError:
+            self.log("Malformed benchmark result: %s" % value)
+            self.regressions.append(value)
+            return
+
+        self.benchmarks[name] = stats
+        self.log("%s: %d iterations, min %d us, median %d us, p99 %d us, max %d us" %
+                 (name, stats['iterations'], stats['min_us'], stats['median_us'],
+                  stats['p99_us'], stats['max_us']))
+
+    def _callback_end(self, key, value, timestamp):
+        """ {{end;%s}}} """
+        self.compare()
+        self.store()
+        self.notify_complete(result=(value == 'success' and not self.regressions))
+
+    def compare(self):
+        baseline = self.load(self.baseline_path)
+        for name, stats in sorted(self.benchmarks.items()):
+            if name not in baseline:
+                continue
+
+            previous = baseline[name]['median_us']
+            limit = previous * (1.0 + self.tolerance)
+            if stats['median_us'] > limit:
+                self.log("FAIL: %s median %d us exceeds baseline %d us by more than %d%%" %
+                         (name, stats['median_us'], previous, self.tolerance * 100))
+                self.regressions.append(name)
+            else:
+                self.log("%s median %d us, baseline %d us" %
+                         (name, stats['median_us'], previous))
+
+    def store(self):
+        if not self.results_path:
+            return
+
+        results = self.load(self.results_path)
+        results.update(self.benchmarks)
+        with open(self.results_path, 'w') as f:
+            json.dump(results, f, indent=4, sort_keys=True)
+
+    def setup(self):
+        self.register_callback('__benchmark', self._callback_benchmark)
+        self.register_callback('end', self._callback_end)
+
+    def result(self):
+        return not self.regressions
+
+    def teardown(self):
+        pass
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_PORTOUT || !defined(TARGET_FF_ARDUINO)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define RACE_WRITES 20000
+#define TOGGLE_PERIOD_US 20
+
+// Two bus pins and another pin, all on the same port
+static PinName bus_pins[2];
+static PinName other_pin;
+
+static volatile int other_level;
+static DigitalOut *toggled;
+
+// Find three header pins on one port, so the bus pins are grouped
+static bool find_pins() {
+    static const PinName candidates[] = {D2, D3, D4, D5, D6, D7, D8, D9, D10, D11, D12, D13};
+    const int count = sizeof(candidates) / sizeof(candidates[0]);
+
+    for (int i = 0; i < count; i++) {
+        PortName port;
+        if (port_pin_number(candidates[i], &port) < 0) {
+            continue;
+        }
+
+        int found = 0;
+        for (int j = i + 1; j < count && found < 2; j++) {
+            PortName other;
+            if (port_pin_number(candidates[j], &other) >= 0 && other == port) {
+                bus_pins[found++] = candidates[j];
+            }
+        }
+        if (found == 2) {
+            other_pin = candidates[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void test_other_pins_kept() {
+    if (!find_pins()) {
+        TEST_IGNORE_MESSAGE("No port with three header pins");
+    }
+
+    BusOut bus(bus_pins[0], bus_pins[1]);
+    DigitalOut other(other_pin);
+
+    for (int level = 0; level < 2; level++) {
+        other = level;
+        for (int value = 0; value < 4; value++) {
+            bus = value;
+            TEST_ASSERT_EQUAL(value, bus.read());
+            TEST_ASSERT_EQUAL(level, other.read());
+        }
+    }
+}
+
+static void toggle() {
+    other_level = !other_level;
+    *toggled = other_level;
+}
+
+void test_other_pins_kept_during_interrupts() {
+    if (!find_pins()) {
+        TEST_IGNORE_MESSAGE("No port with three header pins");
+    }
+
+    BusOut bus(bus_pins[0], bus_pins[1]);
+    DigitalOut other(other_pin, 0);
+    Ticker ticker;
+    int errors = 0;
+
+    other_level = 0;
+    toggled = &other;
+    ticker.attach_us(toggle, TOGGLE_PERIOD_US);
+
+    for (int i = 0; i < RACE_WRITES; i++) {
+        bus = i & 3;
+
+        // A bus write that raced the ticker would have restored the old level
+        core_util_critical_section_enter();
+        if (other.read() != other_level) {
+            errors++;
+        }
+        core_util_critical_section_exit();
+    }
+
+    ticker.detach();
+    TEST_ASSERT_EQUAL(0, errors);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Bus writes keep the other pins of the port", test_other_pins_kept),
+    Case("Bus writes keep pins changed by an interrupt", test_other_pins_kept_during_interrupts),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    Harness::run(specification);
+}
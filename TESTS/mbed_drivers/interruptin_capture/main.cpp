@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_INTERRUPTIN || !defined(TARGET_FF_ARDUINO)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+// The input is driven by a DigitalOut on the same pin, which still raises
+// edge interrupts on targets whose input stage stays connected while the pin
+// is an output (all STM targets). Other targets need PIN_OUT wired to PIN_IN.
+#ifndef PIN_IN
+#define PIN_IN D9
+#endif
+#ifndef PIN_OUT
+#define PIN_OUT PIN_IN
+#endif
+
+#define PULSE_US 1000
+#define TOLERANCE_US 200
+#define DEBOUNCE_US 5000
+#define GLITCH_US 50
+
+static InterruptIn::edge_t edges[8];
+static InterruptIn::edge_t batch[8];
+
+void test_capture_timestamps() {
+    InterruptIn in(PIN_IN);
+    DigitalOut out(PIN_OUT, 0);
+    wait_ms(1);
+
+    in.capture(edges, 8);
+    uint32_t count = in.edge_count();
+
+    // Two pulses: PULSE_US high, PULSE_US low, 2 * PULSE_US high
+    out = 1;
+    wait_us(PULSE_US);
+    out = 0;
+    wait_us(PULSE_US);
+    out = 1;
+    wait_us(2 * PULSE_US);
+    out = 0;
+    wait_ms(1);
+
+    TEST_ASSERT_EQUAL(4, in.read_edges(batch, 8));
+    TEST_ASSERT_EQUAL(0, in.read_edges(batch + 4, 4));
+    TEST_ASSERT_EQUAL(count + 4, in.edge_count());
+    TEST_ASSERT_EQUAL(0, in.overruns());
+
+    static const uint32_t gaps[] = {PULSE_US, PULSE_US, 2 * PULSE_US};
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(i % 2 == 0, batch[i].rise);
+        if (i > 0) {
+            TEST_ASSERT_UINT32_WITHIN(TOLERANCE_US, gaps[i - 1], batch[i].time - batch[i - 1].time);
+        }
+    }
+
+    in.capture(NULL, 0);
+}
+
+void test_capture_overruns() {
+    InterruptIn in(PIN_IN);
+    DigitalOut out(PIN_OUT, 0);
+    wait_ms(1);
+
+    // Room for two edges, the next two are dropped
+    in.capture(edges, 3);
+    for (int i = 0; i < 2; i++) {
+        out = 1;
+        wait_us(100);
+        out = 0;
+        wait_us(100);
+    }
+
+    TEST_ASSERT_EQUAL(2, in.read_edges(batch, 8));
+    TEST_ASSERT_TRUE(batch[0].rise);
+    TEST_ASSERT_FALSE(batch[1].rise);
+    TEST_ASSERT_EQUAL(2, in.overruns());
+
+    in.capture(NULL, 0);
+}
+
+void test_debounce_filters_glitches() {
+    InterruptIn in(PIN_IN);
+    DigitalOut out(PIN_OUT, 0);
+    wait_ms(1);
+
+    in.capture(edges, 8);
+    in.debounce(DEBOUNCE_US);
+    uint32_t count = in.edge_count();
+
+    // Glitches back to the stable level are not reported at all
+    for (int i = 0; i < 5; i++) {
+        out = 1;
+        wait_us(GLITCH_US);
+        out = 0;
+        wait_us(GLITCH_US);
+    }
+    wait_us(2 * DEBOUNCE_US);
+    TEST_ASSERT_EQUAL(count, in.edge_count());
+    TEST_ASSERT_EQUAL(0, in.read_edges(batch, 8));
+
+    // A bouncing rise is reported once, stamped with its last transition
+    for (int i = 0; i < 5; i++) {
+        out = 1;
+        wait_us(GLITCH_US);
+        out = 0;
+        wait_us(GLITCH_US);
+    }
+    timestamp_t settled = us_ticker_read();
+    out = 1;
+    wait_us(DEBOUNCE_US / 2);
+    TEST_ASSERT_EQUAL(count, in.edge_count());
+    wait_us(DEBOUNCE_US);
+
+    TEST_ASSERT_EQUAL(count + 1, in.edge_count());
+    TEST_ASSERT_EQUAL(1, in.read_edges(batch, 8));
+    TEST_ASSERT_TRUE(batch[0].rise);
+    TEST_ASSERT_UINT32_WITHIN(TOLERANCE_US, 0, batch[0].time - settled);
+
+    in.debounce(0);
+    in.capture(NULL, 0);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Capture records edges with their timestamps", test_capture_timestamps),
+    Case("Capture counts edges dropped on a full buffer", test_capture_overruns),
+    Case("Debounce filters glitches and bouncing", test_debounce_filters_glitches),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    Harness::run(specification);
+}
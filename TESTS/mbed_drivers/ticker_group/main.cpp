@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2013-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+using namespace utest::v1;
+
+static const timestamp_t BASE_PERIOD_US = 1000;
+static const int LOG_SIZE = 256;
+
+volatile int log_count = 0;
+volatile char log_ids[LOG_SIZE];
+
+void log_id(char id) {
+    if (log_count < LOG_SIZE) {
+        log_ids[log_count++] = id;
+    }
+}
+
+void call_1() { log_id(1); }
+void call_2() { log_id(2); }
+void call_5() { log_id(5); }
+
+void test_harmonic_phase() {
+    TickerGroup group(BASE_PERIOD_US);
+    TickerGroup::Entry e1, e2, e5;
+
+    log_count = 0;
+    group.attach_us(e1, call_1, 1*BASE_PERIOD_US, 0);
+    group.attach_us(e2, call_2, 2*BASE_PERIOD_US, 1);
+    group.attach_us(e5, call_5, 5*BASE_PERIOD_US, 2);
+    wait_ms(100);
+    group.detach(e5);
+    group.detach(e2);
+    group.detach(e1);
+
+    // every tick ends with the lowest priority function, which runs every tick
+    int tick = 1;
+    int last = 10;
+    bool has_2 = false;
+    bool has_5 = false;
+    for (int i = 0; i < log_count; i++) {
+        int id = log_ids[i];
+        TEST_ASSERT_MESSAGE(id < last, "functions not called in priority order");
+        last = id;
+        has_2 |= (id == 2);
+        has_5 |= (id == 5);
+
+        if (id == 1) {
+            TEST_ASSERT_EQUAL(tick % 2 == 0, has_2);
+            TEST_ASSERT_EQUAL(tick % 5 == 0, has_5);
+            tick++;
+            last = 10;
+            has_2 = false;
+            has_5 = false;
+        }
+    }
+
+    TEST_ASSERT_INT_WITHIN(2, 100, tick - 1);
+}
+
+volatile int stats_calls = 0;
+
+void count_call() {
+    stats_calls++;
+}
+
+void busy_call() {
+    stats_calls++;
+    wait_us(2*BASE_PERIOD_US + BASE_PERIOD_US/2);
+}
+
+void test_stats() {
+    TickerGroup group(BASE_PERIOD_US);
+    TickerGroup::Entry entry;
+    TickerGroup::stats_t stats;
+
+    stats_calls = 0;
+    group.attach_us(entry, count_call, 2*BASE_PERIOD_US);
+    wait_ms(50);
+    group.detach(entry);
+    entry.get_stats(&stats);
+
+    TEST_ASSERT_EQUAL(stats_calls, stats.calls);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+    TEST_ASSERT(stats.min_latency <= stats.max_latency);
+    TEST_ASSERT(stats.max_latency < BASE_PERIOD_US);
+}
+
+void test_overruns() {
+    TickerGroup group(BASE_PERIOD_US);
+    TickerGroup::Entry entry;
+    TickerGroup::stats_t stats;
+
+    // each call takes longer than two periods, so the group skips ticks
+    stats_calls = 0;
+    group.attach_us(entry, busy_call, BASE_PERIOD_US);
+    wait_ms(50);
+    group.detach(entry);
+    entry.get_stats(&stats);
+
+    TEST_ASSERT_EQUAL(stats_calls, stats.calls);
+    TEST_ASSERT(stats.overruns > 0);
+    TEST_ASSERT(stats.calls + stats.overruns >= 45);
+}
+
+volatile int first_calls = 0;
+volatile int victim_calls = 0;
+volatile int last_calls = 0;
+TickerGroup::Entry *victim = NULL;
+
+void destroy_victim() {
+    first_calls++;
+    if (victim) {
+        delete victim;
+        victim = NULL;
+    }
+}
+
+void call_victim() { victim_calls++; }
+void call_last() { last_calls++; }
+
+void test_destroy_next_entry() {
+    TickerGroup group(BASE_PERIOD_US);
+    TickerGroup::Entry first, last;
+
+    // the first function destroys the entry after it, the one after that
+    // must still be called in the same tick
+    first_calls = 0;
+    victim_calls = 0;
+    last_calls = 0;
+    victim = new TickerGroup::Entry;
+    group.attach_us(first, destroy_victim, BASE_PERIOD_US, 2);
+    group.attach_us(*victim, call_victim, BASE_PERIOD_US, 1);
+    group.attach_us(last, call_last, BASE_PERIOD_US, 0);
+    wait_ms(20);
+
+    core_util_critical_section_enter();
+    group.detach(first);
+    group.detach(last);
+    core_util_critical_section_exit();
+
+    TEST_ASSERT_NULL(victim);
+    TEST_ASSERT_EQUAL(0, victim_calls);
+    TEST_ASSERT(first_calls > 0);
+    TEST_ASSERT_EQUAL(first_calls, last_calls);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("TickerGroup harmonic phase and priority", test_harmonic_phase),
+    Case("TickerGroup statistics", test_stats),
+    Case("TickerGroup overruns", test_overruns),
+    Case("TickerGroup function destroying the next entry", test_destroy_next_entry),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    Harness::run(specification);
+}
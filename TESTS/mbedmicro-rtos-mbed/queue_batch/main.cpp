@@ -0,0 +1,193 @@
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+typedef struct {
+    uint32_t counter;   /* A counter value */
+} message_t;
+
+#define QUEUE_SIZE       16
+#define BENCH_ROUNDS     200
+#define MAIL_BATCH       5
+#define MAIL_TOTAL       (10 * QUEUE_SIZE)
+#define ISR_QUEUE_SIZE   32
+#define ISR_BATCH        24     /* more than the RTX post service FIFO (OS_FIFOSZ) holds */
+#define ISR_TOTAL        (8 * ISR_QUEUE_SIZE)
+#define ISR_PERIOD_US    1000
+
+/*
+ * The stack size is defined in cmsis_os.h mainly dependent on the underlying toolchain and
+ * the C standard library. For GCC, ARM_STD and IAR it is defined with a size of 2048 bytes
+ * and for ARM_MICRO 512. Because of reduce RAM size some targets need a reduced stacksize.
+ */
+#if (defined(TARGET_EFM32HG_STK3400)) && !defined(TOOLCHAIN_ARM_MICRO)
+    #define STACK_SIZE 512
+#elif (defined(TARGET_EFM32LG_STK3600) || defined(TARGET_EFM32WG_STK3800) || defined(TARGET_EFM32PG_STK3401)) && !defined(TOOLCHAIN_ARM_MICRO)
+    #define STACK_SIZE 768
+#elif (defined(TARGET_EFM32GG_STK3700)) && !defined(TOOLCHAIN_ARM_MICRO)
+    #define STACK_SIZE 1536
+#elif defined(TARGET_MCU_NRF51822) || defined(TARGET_MCU_NRF52832)
+    #define STACK_SIZE 768
+#elif defined(TARGET_XDOT_L151CC)
+    #define STACK_SIZE 1024
+#else
+    #define STACK_SIZE DEFAULT_STACK_SIZE
+#endif
+
+MemoryPool<message_t, QUEUE_SIZE> mpool;
+Queue<message_t, QUEUE_SIZE> queue;
+Mail<message_t, QUEUE_SIZE> mail_box;
+Queue<uint32_t, ISR_QUEUE_SIZE> isr_queue;
+
+volatile uint32_t isr_counter = 0;
+
+/* Time a full queue going round one message at a time, then in batches */
+bool test_queue_bench() {
+    message_t *sent[QUEUE_SIZE];
+    message_t *received[QUEUE_SIZE];
+    bool result = true;
+    Timer timer;
+
+    if (mpool.alloc_n(sent, QUEUE_SIZE) != QUEUE_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < QUEUE_SIZE; i++) {
+        sent[i]->counter = i;
+    }
+
+    timer.start();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (uint32_t i = 0; i < QUEUE_SIZE; i++) {
+            result = result && (queue.put(sent[i]) == osOK);
+        }
+        for (uint32_t i = 0; i < QUEUE_SIZE; i++) {
+            osEvent evt = queue.get(0);
+            result = result && (evt.status == osEventMessage) && (evt.value.p == sent[i]);
+        }
+    }
+    int single_us = timer.read_us();
+
+    timer.reset();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        result = result && (queue.put_n(sent, QUEUE_SIZE) == QUEUE_SIZE);
+        result = result && (queue.put_n(sent, 1) == 0);
+        result = result && (queue.get_n(received, QUEUE_SIZE, 0) == QUEUE_SIZE);
+        result = result && (memcmp(sent, received, sizeof(sent)) == 0);
+        result = result && (queue.get_n(received, 1, 0) == 0);
+    }
+    int batch_us = timer.read_us();
+
+    printf("Queue: %d messages single %dus, batched %dus ... [%s]\r\n",
+           BENCH_ROUNDS * QUEUE_SIZE, single_us, batch_us, result ? "OK" : "FAIL");
+
+    result = result && (mpool.free_n(sent, QUEUE_SIZE) == osOK);
+    return result;
+}
+
+/* Exhaust the pool in one call and give everything back */
+bool test_pool_batch() {
+    message_t *blocks[QUEUE_SIZE + 1];
+    bool result = true;
+
+    result = result && (mpool.alloc_n(blocks, QUEUE_SIZE + 1) == QUEUE_SIZE);
+    result = result && (mpool.alloc() == NULL);
+    result = result && (mpool.free_n(blocks, QUEUE_SIZE) == osOK);
+    result = result && (mpool.alloc_n(blocks, 1) == 1);
+    result = result && (mpool.free_n(blocks, 1) == osOK);
+
+    printf("MemoryPool: alloc_n/free_n ... [%s]\r\n", result ? "OK" : "FAIL");
+    return result;
+}
+
+/* Send Thread */
+void send_thread() {
+    message_t *batch[MAIL_BATCH];
+    uint32_t counter = 0;
+
+    while (counter < MAIL_TOTAL) {
+        uint32_t n = mail_box.alloc_n(batch, MAIL_BATCH, osWaitForever);
+        for (uint32_t i = 0; i < n; i++) {
+            batch[i]->counter = counter++;
+        }
+        mail_box.put_n(batch, n);
+    }
+}
+
+/* Receive mails from another thread in batches, in the order they were sent */
+bool test_mail_batch() {
+    message_t *batch[QUEUE_SIZE];
+    uint32_t expected = 0;
+    bool result = true;
+
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    thread.start(send_thread);
+
+    while (result && expected < MAIL_TOTAL) {
+        uint32_t n = mail_box.get_n(batch, QUEUE_SIZE, 1000);
+        result = (n != 0);
+        for (uint32_t i = 0; i < n; i++) {
+            result = result && (batch[i]->counter == expected++);
+        }
+        result = result && (mail_box.free_n(batch, n) == osOK);
+    }
+    if (result) {
+        thread.join();
+    } else {
+        thread.terminate();
+    }
+
+    printf("Mail: %d mails ... [%s]\r\n", MAIL_TOTAL, result ? "OK" : "FAIL");
+    return result;
+}
+
+/* Put a batch from the ticker interrupt, as much of it as fits */
+void isr_put() {
+    uint32_t *batch[ISR_BATCH];
+    uint32_t count = ISR_TOTAL - isr_counter;
+
+    if (count > ISR_BATCH) {
+        count = ISR_BATCH;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        batch[i] = (uint32_t*)(isr_counter + i);
+    }
+    isr_counter += isr_queue.put_n(batch, count);
+}
+
+/* Receive batches put from an ISR, in the order they were put */
+bool test_queue_isr_batch() {
+    uint32_t *batch[ISR_QUEUE_SIZE];
+    uint32_t expected = 0;
+    bool result = true;
+
+    Ticker ticker;
+    ticker.attach_us(isr_put, ISR_PERIOD_US);
+
+    while (result && expected < ISR_TOTAL) {
+        uint32_t n = isr_queue.get_n(batch, ISR_QUEUE_SIZE, 1000);
+        result = (n != 0);
+        for (uint32_t i = 0; i < n; i++) {
+            result = result && ((uint32_t)batch[i] == expected++);
+        }
+    }
+    ticker.detach();
+
+    printf("Queue: %d messages from ISR ... [%s]\r\n", ISR_TOTAL, result ? "OK" : "FAIL");
+    return result;
+}
+
+int main (void) {
+    GREENTEA_SETUP(20, "default_auto");
+
+    bool result = test_queue_bench();
+    result = test_pool_batch() && result;
+    result = test_mail_batch() && result;
+    result = test_queue_isr_batch() && result;
+
+    GREENTEA_TESTSUITE_RESULT(result);
+    return 0;
+}
@@ -0,0 +1,341 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+using namespace utest::v1;
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if !defined(MBEDTLS_ACCEL_C) || !defined(MBEDTLS_AES_C) || \
+    !defined(MBEDTLS_SHA256_C) || !defined(MBEDTLS_BIGNUM_C)
+#error [NOT_SUPPORTED] Accelerator dispatch not enabled
+#endif
+
+#include "mbedtls/accel.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/bignum.h"
+
+#include <string.h>
+
+/*
+ * Simulated accelerator: runs the software implementations, but only
+ * accepts 128-bit AES keys and can be told to fail or to hold a request
+ * until released.
+ */
+static volatile bool sim_fail;
+static volatile bool sim_hold;
+static Semaphore sim_entered(0);
+static Semaphore sim_release(0);
+
+static int sim_aes_crypt_ecb(void *p_ctx, const unsigned char *key, unsigned int keybits, int mode,
+                             const unsigned char input[16], unsigned char output[16])
+{
+    mbedtls_aes_context aes;
+
+    (void) p_ctx;
+
+    if (keybits != 128) {
+        return MBEDTLS_ERR_ACCEL_UNSUPPORTED;
+    }
+    if (sim_hold) {
+        sim_entered.release();
+        sim_release.wait();
+    }
+    if (sim_fail) {
+        return MBEDTLS_ERR_ACCEL_HW_FAILED;
+    }
+
+    mbedtls_aes_init(&aes);
+    if (mode == MBEDTLS_AES_ENCRYPT) {
+        mbedtls_aes_setkey_enc(&aes, key, keybits);
+        mbedtls_aes_encrypt(&aes, input, output);
+    } else {
+        mbedtls_aes_setkey_dec(&aes, key, keybits);
+        mbedtls_aes_decrypt(&aes, input, output);
+    }
+    mbedtls_aes_free(&aes);
+
+    return 0;
+}
+
+static int sim_sha256_process(void *p_ctx, uint32_t state[8], const unsigned char data[64])
+{
+    mbedtls_sha256_context sha;
+
+    (void) p_ctx;
+
+    if (sim_fail) {
+        return MBEDTLS_ERR_ACCEL_HW_FAILED;
+    }
+
+    mbedtls_sha256_init(&sha);
+    memcpy(sha.state, state, sizeof(sha.state));
+    mbedtls_sha256_process(&sha, data);
+    memcpy(state, sha.state, sizeof(sha.state));
+    mbedtls_sha256_free(&sha);
+
+    return 0;
+}
+
+static int sim_mpi_exp_mod(void *p_ctx, mbedtls_mpi *X, const mbedtls_mpi *A,
+                           const mbedtls_mpi *E, const mbedtls_mpi *N)
+{
+    (void) p_ctx;
+
+    if (sim_fail) {
+        return MBEDTLS_ERR_ACCEL_HW_FAILED;
+    }
+
+    return mbedtls_mpi_exp_mod_ext(X, A, E, N, NULL, MBEDTLS_MPI_WINDOW_SIZE);
+}
+
+static const mbedtls_accel_ops sim_ops = {
+    sim_aes_crypt_ecb,
+    sim_sha256_process,
+    sim_mpi_exp_mod
+};
+
+static mbedtls_accel_engine sim_engine;
+
+/* FIPS-197 C.1 */
+static const unsigned char aes128_key[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const unsigned char aes_pt[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const unsigned char aes128_ct[16] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+/* FIPS-197 C.3 */
+static const unsigned char aes256_key[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+static const unsigned char aes256_ct[16] = {
+    0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf,
+    0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89
+};
+
+/* SHA-256("abc") */
+static const unsigned char sha256_abc[32] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+    0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+    0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+static mbedtls_accel_stats stats(mbedtls_accel_primitive_t primitive)
+{
+    mbedtls_accel_stats s;
+    mbedtls_accel_get_stats(primitive, &s);
+    return s;
+}
+
+static void aes_ecb(const unsigned char *key, unsigned int keybits, int mode,
+                    const unsigned char input[16], unsigned char output[16])
+{
+    mbedtls_aes_context aes;
+
+    mbedtls_aes_init(&aes);
+    if (mode == MBEDTLS_AES_ENCRYPT) {
+        TEST_ASSERT_EQUAL(0, mbedtls_aes_setkey_enc(&aes, key, keybits));
+    } else {
+        TEST_ASSERT_EQUAL(0, mbedtls_aes_setkey_dec(&aes, key, keybits));
+    }
+    TEST_ASSERT_EQUAL(0, mbedtls_aes_crypt_ecb(&aes, mode, input, output));
+    mbedtls_aes_free(&aes);
+}
+
+void test_software_only()
+{
+    unsigned char out[16];
+
+    mbedtls_accel_reset_stats();
+    aes_ecb(aes128_key, 128, MBEDTLS_AES_ENCRYPT, aes_pt, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes128_ct, out, 16);
+
+    /* Nothing registered, nothing counted */
+    TEST_ASSERT_EQUAL(0, stats(MBEDTLS_ACCEL_AES).offloaded);
+    TEST_ASSERT_EQUAL(0, stats(MBEDTLS_ACCEL_AES).unsupported);
+}
+
+void test_register()
+{
+    mbedtls_accel_engine_init(&sim_engine, "sim", &sim_ops, NULL, 0);
+    TEST_ASSERT_EQUAL(0, mbedtls_accel_register(&sim_engine));
+    mbedtls_accel_reset_stats();
+}
+
+void test_aes_offload()
+{
+    unsigned char out[16];
+
+    aes_ecb(aes128_key, 128, MBEDTLS_AES_ENCRYPT, aes_pt, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes128_ct, out, 16);
+    aes_ecb(aes128_key, 128, MBEDTLS_AES_DECRYPT, aes128_ct, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes_pt, out, 16);
+
+    TEST_ASSERT_EQUAL(2, stats(MBEDTLS_ACCEL_AES).offloaded);
+}
+
+void test_aes_unsupported()
+{
+    unsigned char out[16];
+
+    mbedtls_accel_reset_stats();
+    aes_ecb(aes256_key, 256, MBEDTLS_AES_ENCRYPT, aes_pt, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes256_ct, out, 16);
+
+    TEST_ASSERT_EQUAL(0, stats(MBEDTLS_ACCEL_AES).offloaded);
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_AES).unsupported);
+}
+
+void test_sha256_offload()
+{
+    unsigned char out[32];
+
+    mbedtls_accel_reset_stats();
+    mbedtls_sha256((const unsigned char *) "abc", 3, out, 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(sha256_abc, out, 32);
+
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_SHA256).offloaded);
+}
+
+void test_mpi_offload()
+{
+    mbedtls_mpi A, E, N, X, Y;
+
+    mbedtls_mpi_init(&A); mbedtls_mpi_init(&E); mbedtls_mpi_init(&N);
+    mbedtls_mpi_init(&X); mbedtls_mpi_init(&Y);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&A, 16, "B2E7EFD37075B9F03FF989C7C5051C20"));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&E, 16, "10001"));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&N, 16, "C0FC1C7C2B0D8E9A8F4C1B2D3E4F5A6B"));
+
+    mbedtls_accel_reset_stats();
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_exp_mod(&X, &A, &E, &N, NULL));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_exp_mod_ext(&Y, &A, &E, &N, NULL, MBEDTLS_MPI_WINDOW_SIZE));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_cmp_mpi(&X, &Y));
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_MPI_EXP_MOD).offloaded);
+
+    /* Invalid input is reported by the software path, not offloaded */
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_sub_int(&N, &N, 1));
+    TEST_ASSERT_EQUAL(MBEDTLS_ERR_MPI_BAD_INPUT_DATA, mbedtls_mpi_exp_mod(&X, &A, &E, &N, NULL));
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_MPI_EXP_MOD).offloaded);
+
+    mbedtls_mpi_free(&A); mbedtls_mpi_free(&E); mbedtls_mpi_free(&N);
+    mbedtls_mpi_free(&X); mbedtls_mpi_free(&Y);
+}
+
+void test_hw_failure()
+{
+    unsigned char out[32];
+
+    mbedtls_accel_reset_stats();
+    sim_fail = true;
+    aes_ecb(aes128_key, 128, MBEDTLS_AES_ENCRYPT, aes_pt, out);
+    mbedtls_sha256((const unsigned char *) "abc", 3, out + 16, 0);
+    sim_fail = false;
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes128_ct, out, 16);
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_AES).failed);
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_SHA256).failed);
+
+    mbedtls_sha256((const unsigned char *) "abc", 3, out, 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(sha256_abc, out, 32);
+}
+
+static unsigned char held_out[16];
+
+static void held_request()
+{
+    aes_ecb(aes128_key, 128, MBEDTLS_AES_ENCRYPT, aes_pt, held_out);
+}
+
+void test_busy_fallback()
+{
+    unsigned char out[16];
+    Thread thread;
+
+    mbedtls_accel_reset_stats();
+    sim_hold = true;
+    TEST_ASSERT_EQUAL(osOK, thread.start(held_request));
+    TEST_ASSERT_TRUE(sim_entered.wait(1000) > 0);
+    sim_hold = false;
+
+    /* Engine is running the held request and nothing may wait for it */
+    aes_ecb(aes128_key, 128, MBEDTLS_AES_ENCRYPT, aes_pt, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes128_ct, out, 16);
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_AES).busy);
+
+    sim_release.release();
+    thread.join();
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes128_ct, held_out, 16);
+    TEST_ASSERT_EQUAL(1, stats(MBEDTLS_ACCEL_AES).offloaded);
+}
+
+void test_unregister()
+{
+    unsigned char out[16];
+
+    mbedtls_accel_unregister(&sim_engine);
+    mbedtls_accel_engine_free(&sim_engine);
+    mbedtls_accel_reset_stats();
+
+    aes_ecb(aes128_key, 128, MBEDTLS_AES_ENCRYPT, aes_pt, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(aes128_ct, out, 16);
+    TEST_ASSERT_EQUAL(0, stats(MBEDTLS_ACCEL_AES).offloaded);
+}
+
+Case cases[] = {
+    Case("Software only", test_software_only),
+    Case("Register simulated engine", test_register),
+    Case("AES offload", test_aes_offload),
+    Case("AES unsupported key size falls back", test_aes_unsupported),
+    Case("SHA-256 offload", test_sha256_offload),
+    Case("MPI exp_mod offload", test_mpi_offload),
+    Case("Hardware failure falls back", test_hw_failure),
+    Case("Busy engine falls back", test_busy_fallback),
+    Case("Unregister engine", test_unregister),
+};
+
+utest::v1::status_t test_setup(const size_t num_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(num_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
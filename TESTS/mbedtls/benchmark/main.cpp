@@ -0,0 +1,156 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#include "mbedtls/gcm.h"
+
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_PK_PARSE_C) && \
+    defined(MBEDTLS_PEM_PARSE_C) && defined(MBEDTLS_CERTS_C)
+#define BENCHMARK_RSA
+#include "mbedtls/certs.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/rsa.h"
+#endif
+
+#include <string.h>
+
+#if !defined(MBEDTLS_GCM_C) || !defined(MBEDTLS_AES_C)
+#error [NOT_SUPPORTED] GCM not enabled
+#endif
+
+/* Size of a full TLS record fragment with the default MBEDTLS_SSL_MAX_CONTENT_LEN */
+#define RECORD_SIZE 1024
+
+static mbedtls_gcm_context gcm;
+static unsigned char record[RECORD_SIZE];
+static unsigned char tag[16];
+static const unsigned char key[16] = { 0 };
+static const unsigned char iv[12] = { 0 };
+static const unsigned char add[13] = { 0 };
+
+void test_gcm_setup() {
+    mbedtls_gcm_init(&gcm);
+    TEST_ASSERT_EQUAL(0, mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 128));
+}
+
+void bench_gcm_encrypt_record() {
+    mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, sizeof(record), iv, sizeof(iv),
+                              add, sizeof(add), record, record, sizeof(tag), tag);
+}
+
+void bench_gcm_encrypt_block() {
+    mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, 16, iv, sizeof(iv),
+                              add, sizeof(add), record, record, sizeof(tag), tag);
+}
+
+void bench_gcm_setkey() {
+    mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 128);
+}
+
+void test_gcm_teardown() {
+    mbedtls_gcm_free(&gcm);
+}
+
+#if defined(BENCHMARK_RSA)
+/* Size of an RSA-2048 modulus */
+#define RSA_SIZE 256
+
+static mbedtls_pk_context pk;
+static unsigned char rsa_input[RSA_SIZE];
+static unsigned char rsa_output[RSA_SIZE];
+static unsigned char rsa_check[RSA_SIZE];
+static uint32_t rng_state;
+
+/* Deterministic generator for the blinding values, not for real use */
+static int test_rng(void *p_rng, unsigned char *output, size_t len)
+{
+    (void) p_rng;
+
+    while (len--) {
+        rng_state = rng_state * 1103515245u + 12345u;
+        *output++ = (unsigned char)(rng_state >> 16);
+    }
+
+    return 0;
+}
+
+void test_rsa_setup() {
+    mbedtls_pk_init(&pk);
+    TEST_ASSERT_EQUAL(0, mbedtls_pk_parse_key(&pk, (const unsigned char *) mbedtls_test_srv_key_rsa,
+                                              mbedtls_test_srv_key_rsa_len, NULL, 0));
+    TEST_ASSERT_EQUAL(MBEDTLS_PK_RSA, mbedtls_pk_get_type(&pk));
+    TEST_ASSERT_EQUAL(RSA_SIZE, mbedtls_pk_rsa(pk)->len);
+
+    /* Below the modulus, which starts with 0xc1 */
+    for (size_t i = 1; i < sizeof(rsa_input); i++) {
+        rsa_input[i] = (unsigned char) i;
+    }
+
+    /* The operations must round-trip for the timings to mean anything */
+    TEST_ASSERT_EQUAL(0, mbedtls_rsa_private(mbedtls_pk_rsa(pk), test_rng, NULL, rsa_input, rsa_output));
+    TEST_ASSERT_EQUAL(0, mbedtls_rsa_public(mbedtls_pk_rsa(pk), rsa_output, rsa_check));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(rsa_input, rsa_check, sizeof(rsa_input));
+}
+
+void bench_rsa_private() {
+    mbedtls_rsa_private(mbedtls_pk_rsa(pk), test_rng, NULL, rsa_input, rsa_output);
+}
+
+void bench_rsa_public() {
+    mbedtls_rsa_public(mbedtls_pk_rsa(pk), rsa_output, rsa_check);
+}
+
+void test_rsa_teardown() {
+    mbedtls_pk_free(&pk);
+}
+#endif /* BENCHMARK_RSA */
+
+Case cases[] = {
+    Case("AES-GCM setup", test_gcm_setup),
+    BENCHMARK_CASE("AES-128-GCM setkey", bench_gcm_setkey, 2, 50),
+    BENCHMARK_CASE("AES-128-GCM encrypt 16 bytes", bench_gcm_encrypt_block, 10, 200),
+    BENCHMARK_CASE("AES-128-GCM encrypt 1K record", bench_gcm_encrypt_record, 2, 50),
+    Case("AES-GCM teardown", test_gcm_teardown),
+#if defined(BENCHMARK_RSA)
+    Case("RSA setup", test_rsa_setup),
+    BENCHMARK_CASE("RSA-2048 private", bench_rsa_private, 1, 5),
+    BENCHMARK_CASE("RSA-2048 public", bench_rsa_public, 2, 50),
+    Case("RSA teardown", test_rsa_teardown),
+#endif
+};
+
+utest::v1::status_t test_setup(const size_t num_cases) {
+    GREENTEA_SETUP(300, "benchmark_auto");
+    return verbose_test_setup_handler(num_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,263 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+using namespace utest::v1;
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if !defined(MBEDTLS_ECP_RESTARTABLE) || !defined(MBEDTLS_ECDH_C) || \
+    !defined(MBEDTLS_ECDSA_C) || !defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+#error [NOT_SUPPORTED] Restartable ECC not enabled
+#endif
+
+#include "mbedtls/ecdh.h"
+#include "mbedtls/ecdsa.h"
+
+#include <string.h>
+
+/* Small enough to split every operation into many slices */
+#define TEST_MAX_OPS    100
+
+/* Deterministic RNG, so both runs of an operation draw the same values */
+static uint32_t rng_state;
+
+static int test_rng(void *p_rng, unsigned char *output, size_t len)
+{
+    (void) p_rng;
+
+    while (len--) {
+        rng_state = rng_state * 1103515245u + 12345u;
+        *output++ = (unsigned char)(rng_state >> 16);
+    }
+
+    return 0;
+}
+
+static const unsigned char test_hash[32] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+void test_disabled_by_default()
+{
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_restart_is_enabled());
+
+    mbedtls_ecp_set_max_ops(TEST_MAX_OPS);
+    TEST_ASSERT_EQUAL(1, mbedtls_ecp_restart_is_enabled());
+
+    mbedtls_ecp_set_max_ops(0);
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_restart_is_enabled());
+}
+
+void test_ecdh_sliced()
+{
+    mbedtls_ecdh_context sliced, ref, peer;
+    unsigned char buf[100], peer_buf[100], z_sliced[32], z_ref[32];
+    size_t len, peer_len, z_len;
+    int ret, slices = 0;
+
+    mbedtls_ecdh_init(&sliced);
+    mbedtls_ecdh_init(&ref);
+    mbedtls_ecdh_init(&peer);
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(&sliced.grp, MBEDTLS_ECP_DP_SECP256R1));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(&ref.grp, MBEDTLS_ECP_DP_SECP256R1));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(&peer.grp, MBEDTLS_ECP_DP_SECP256R1));
+
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdh_make_public(&peer, &peer_len, peer_buf, sizeof(peer_buf),
+                                                  test_rng, NULL));
+
+    /* Reference run in one go */
+    rng_state = 1;
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdh_make_public(&ref, &len, buf, sizeof(buf), test_rng, NULL));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdh_read_public(&ref, peer_buf, peer_len));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdh_calc_secret(&ref, &z_len, z_ref, sizeof(z_ref), test_rng, NULL));
+
+    /* Same computation in slices */
+    rng_state = 1;
+    mbedtls_ecdh_enable_restart(&sliced);
+    mbedtls_ecp_set_max_ops(TEST_MAX_OPS);
+
+    while ((ret = mbedtls_ecdh_make_public(&sliced, &len, buf, sizeof(buf),
+                                           test_rng, NULL)) == MBEDTLS_ERR_ECP_IN_PROGRESS) {
+        slices++;
+    }
+    TEST_ASSERT_EQUAL(0, ret);
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_point_cmp(&ref.Q, &sliced.Q));
+
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdh_read_public(&sliced, peer_buf, peer_len));
+    while ((ret = mbedtls_ecdh_calc_secret(&sliced, &z_len, z_sliced, sizeof(z_sliced),
+                                           test_rng, NULL)) == MBEDTLS_ERR_ECP_IN_PROGRESS) {
+        slices++;
+    }
+    mbedtls_ecp_set_max_ops(0);
+
+    TEST_ASSERT_EQUAL(0, ret);
+    TEST_ASSERT_TRUE(slices > 2);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(z_ref, z_sliced, sizeof(z_ref));
+
+    mbedtls_ecdh_free(&sliced);
+    mbedtls_ecdh_free(&ref);
+    mbedtls_ecdh_free(&peer);
+}
+
+void test_ecdsa_sliced()
+{
+    mbedtls_ecdsa_context key;
+    mbedtls_ecdsa_restart_ctx rs;
+    mbedtls_mpi r, s;
+    int ret, slices = 0;
+
+    mbedtls_ecdsa_init(&key);
+    mbedtls_ecdsa_restart_init(&rs);
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+
+    rng_state = 2;
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdsa_genkey(&key, MBEDTLS_ECP_DP_SECP256R1, test_rng, NULL));
+
+    mbedtls_ecp_set_max_ops(TEST_MAX_OPS);
+    while ((ret = mbedtls_ecdsa_sign_restartable(&key.grp, &r, &s, &key.d,
+                                                 test_hash, sizeof(test_hash),
+                                                 test_rng, NULL, &rs)) == MBEDTLS_ERR_ECP_IN_PROGRESS) {
+        slices++;
+    }
+    TEST_ASSERT_EQUAL(0, ret);
+    TEST_ASSERT_TRUE(slices > 0);
+
+    slices = 0;
+    while ((ret = mbedtls_ecdsa_verify_restartable(&key.grp, test_hash, sizeof(test_hash),
+                                                   &key.Q, &r, &s, &rs)) == MBEDTLS_ERR_ECP_IN_PROGRESS) {
+        slices++;
+    }
+    mbedtls_ecp_set_max_ops(0);
+
+    TEST_ASSERT_EQUAL(0, ret);
+    TEST_ASSERT_TRUE(slices > 0);
+
+    /* The signature made in slices verifies in one go as well */
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdsa_verify(&key.grp, test_hash, sizeof(test_hash),
+                                              &key.Q, &r, &s));
+
+    mbedtls_ecdsa_restart_free(&rs);
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&s);
+    mbedtls_ecdsa_free(&key);
+}
+
+void test_abandon()
+{
+    mbedtls_ecdsa_context key;
+    mbedtls_ecdsa_restart_ctx rs;
+    mbedtls_mpi r, s;
+
+    mbedtls_ecdsa_init(&key);
+    mbedtls_ecdsa_restart_init(&rs);
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+
+    rng_state = 3;
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdsa_genkey(&key, MBEDTLS_ECP_DP_SECP256R1, test_rng, NULL));
+
+    mbedtls_ecp_set_max_ops(TEST_MAX_OPS);
+    TEST_ASSERT_EQUAL(MBEDTLS_ERR_ECP_IN_PROGRESS,
+                      mbedtls_ecdsa_sign_restartable(&key.grp, &r, &s, &key.d,
+                                                     test_hash, sizeof(test_hash),
+                                                     test_rng, NULL, &rs));
+    mbedtls_ecp_set_max_ops(0);
+
+    /* Freeing releases the interrupted operation, the context can be reused */
+    mbedtls_ecdsa_restart_free(&rs);
+    mbedtls_ecdsa_restart_init(&rs);
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdsa_sign_restartable(&key.grp, &r, &s, &key.d,
+                                                        test_hash, sizeof(test_hash),
+                                                        test_rng, NULL, &rs));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecdsa_verify(&key.grp, test_hash, sizeof(test_hash),
+                                              &key.Q, &r, &s));
+
+    mbedtls_ecdsa_restart_free(&rs);
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&s);
+    mbedtls_ecdsa_free(&key);
+}
+
+/* Key generation driven one slice per event, as an application would */
+static EventQueue slice_queue;
+static mbedtls_ecdh_context slice_ecdh;
+static int slice_count;
+static int slice_result;
+
+static void slice_step()
+{
+    unsigned char buf[100];
+    size_t len;
+
+    slice_count++;
+    slice_result = mbedtls_ecdh_make_public(&slice_ecdh, &len, buf, sizeof(buf), test_rng, NULL);
+    if (slice_result == MBEDTLS_ERR_ECP_IN_PROGRESS) {
+        slice_queue.call(slice_step);
+    } else {
+        slice_queue.break_dispatch();
+    }
+}
+
+void test_event_queue_slices()
+{
+    mbedtls_ecdh_init(&slice_ecdh);
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(&slice_ecdh.grp, MBEDTLS_ECP_DP_SECP256R1));
+    mbedtls_ecdh_enable_restart(&slice_ecdh);
+
+    rng_state = 4;
+    slice_count = 0;
+    mbedtls_ecp_set_max_ops(TEST_MAX_OPS);
+    slice_queue.call(slice_step);
+    slice_queue.dispatch(10000);
+    mbedtls_ecp_set_max_ops(0);
+
+    TEST_ASSERT_EQUAL(0, slice_result);
+    TEST_ASSERT_TRUE(slice_count > 2);
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_check_pubkey(&slice_ecdh.grp, &slice_ecdh.Q));
+
+    mbedtls_ecdh_free(&slice_ecdh);
+}
+
+Case cases[] = {
+    Case("Restart disabled by default", test_disabled_by_default),
+    Case("ECDH in slices", test_ecdh_sliced),
+    Case("ECDSA in slices", test_ecdsa_sliced),
+    Case("Abandon interrupted operation", test_abandon),
+    Case("Slices from EventQueue", test_event_queue_slices),
+};
+
+utest::v1::status_t test_setup(const size_t num_cases) {
+    GREENTEA_SETUP(60, "default_auto");
+    return verbose_test_setup_handler(num_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
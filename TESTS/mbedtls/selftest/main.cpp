@@ -32,6 +32,11 @@ using namespace utest::v1;
 #include "mbedtls/sha512.h"
 #include "mbedtls/entropy.h"
 #include "mbedtls/entropy_poll.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/bignum.h"
+#include "mbedtls/rsa.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/x509.h"
 
 #include <string.h>
 
@@ -67,6 +72,26 @@ MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_sha512_self_test)
 MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_entropy_self_test)
 #endif
 
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_AES_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_gcm_self_test)
+#endif
+
+#if defined(MBEDTLS_BIGNUM_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_mpi_self_test)
+#endif
+
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_PKCS1_V15)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_rsa_self_test)
+#endif
+
+#if defined(MBEDTLS_CTR_DRBG_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_ctr_drbg_self_test)
+#endif
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_x509_self_test)
+#endif
+
 #else
 #warning "MBEDTLS_SELF_TEST not enabled"
 #endif /* MBEDTLS_SELF_TEST */
@@ -86,6 +111,26 @@ Case cases[] = {
     Case("mbedtls_entropy_self_test", mbedtls_entropy_self_test_test_case),
 #endif
 
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_AES_C)
+    Case("mbedtls_gcm_self_test", mbedtls_gcm_self_test_test_case),
+#endif
+
+#if defined(MBEDTLS_BIGNUM_C)
+    Case("mbedtls_mpi_self_test", mbedtls_mpi_self_test_test_case),
+#endif
+
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_PKCS1_V15)
+    Case("mbedtls_rsa_self_test", mbedtls_rsa_self_test_test_case),
+#endif
+
+#if defined(MBEDTLS_CTR_DRBG_C)
+    Case("mbedtls_ctr_drbg_self_test", mbedtls_ctr_drbg_self_test_test_case),
+#endif
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+    Case("mbedtls_x509_self_test", mbedtls_x509_self_test_test_case),
+#endif
+
 #endif /* MBEDTLS_SELF_TEST */
 };
 
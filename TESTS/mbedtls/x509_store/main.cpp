@@ -0,0 +1,286 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if !defined(MBEDTLS_X509_CRT_PARSE_C) || !defined(MBEDTLS_PEM_PARSE_C) || \
+    !defined(MBEDTLS_CERTS_C) || !defined(MBEDTLS_SSL_TLS_C)
+#error [NOT_SUPPORTED] X.509 test certificates not enabled
+#endif
+
+#include "mbedtls/certs.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/x509_crt.h"
+
+#include <string.h>
+
+/* Test certificates signed with a hash the configuration supports */
+#if defined(MBEDTLS_ECDSA_C)
+#define TEST_CA_CRT         mbedtls_test_ca_crt_ec
+#define TEST_CA_CRT_LEN     mbedtls_test_ca_crt_ec_len
+#define TEST_SRV_CRT        mbedtls_test_srv_crt_ec
+#define TEST_SRV_CRT_LEN    mbedtls_test_srv_crt_ec_len
+#define TEST_CLI_CRT        mbedtls_test_cli_crt_ec
+#define TEST_CLI_CRT_LEN    mbedtls_test_cli_crt_ec_len
+#elif defined(MBEDTLS_RSA_C) && defined(MBEDTLS_SHA1_C)
+#define TEST_CA_CRT         mbedtls_test_ca_crt_rsa
+#define TEST_CA_CRT_LEN     mbedtls_test_ca_crt_rsa_len
+#define TEST_SRV_CRT        mbedtls_test_srv_crt_rsa
+#define TEST_SRV_CRT_LEN    mbedtls_test_srv_crt_rsa_len
+#define TEST_CLI_CRT        mbedtls_test_cli_crt_rsa
+#define TEST_CLI_CRT_LEN    mbedtls_test_cli_crt_rsa_len
+#else
+#error [NOT_SUPPORTED] No test certificates with a supported signature
+#endif
+
+/* Bytes following the certificate in the buffer, like the next one of a bundle */
+static const unsigned char trailer[] = { 0x30, 0x03, 0x02, 0x01, 0x00, 0xff };
+
+static unsigned char der[2048];
+
+/* CA store of the running test case */
+static mbedtls_x509_crt_store store;
+
+/* Copy the DER data of a PEM certificate into der, returns its length */
+static size_t load_der(const char *pem, size_t pem_len)
+{
+    mbedtls_x509_crt crt;
+    size_t len;
+
+    mbedtls_x509_crt_init(&crt);
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse(&crt, (const unsigned char *) pem, pem_len));
+    TEST_ASSERT_TRUE(crt.raw.len + sizeof(trailer) <= sizeof(der));
+
+    len = crt.raw.len;
+    memcpy(der, crt.raw.p, len);
+    mbedtls_x509_crt_free(&crt);
+
+    return len;
+}
+
+static void verify(mbedtls_x509_crt *crt, mbedtls_x509_crt *trust_ca, mbedtls_x509_crl *ca_crl,
+                   int *ret, uint32_t *flags)
+{
+    *ret = mbedtls_x509_crt_verify(crt, trust_ca, ca_crl, NULL, flags, NULL, NULL);
+}
+
+void test_nocopy_trailing_data() {
+    mbedtls_x509_crt copy, nocopy;
+    size_t len = load_der(TEST_CA_CRT, TEST_CA_CRT_LEN);
+
+    memcpy(der + len, trailer, sizeof(trailer));
+
+    mbedtls_x509_crt_init(&copy);
+    mbedtls_x509_crt_init(&nocopy);
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse_der(&copy, der, len + sizeof(trailer)));
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse_der_nocopy(&nocopy, der, len + sizeof(trailer)));
+
+    /* The certificate references the buffer and stops before the trailer */
+    TEST_ASSERT_EQUAL(1, copy.own_buffer);
+    TEST_ASSERT_EQUAL(0, nocopy.own_buffer);
+    TEST_ASSERT_TRUE(nocopy.raw.p == der);
+    TEST_ASSERT_EQUAL(len, nocopy.raw.len);
+    TEST_ASSERT_EQUAL(copy.raw.len, nocopy.raw.len);
+    TEST_ASSERT_EQUAL(copy.tbs.len, nocopy.tbs.len);
+    TEST_ASSERT_EQUAL(copy.sig.len, nocopy.sig.len);
+    TEST_ASSERT_EQUAL(0, memcmp(copy.sig.p, nocopy.sig.p, copy.sig.len));
+    TEST_ASSERT_EQUAL(copy.version, nocopy.version);
+    TEST_ASSERT_EQUAL(copy.ca_istrue, nocopy.ca_istrue);
+
+    /* Self-signed, so it verifies against itself */
+    int ret_copy, ret_nocopy;
+    uint32_t flags_copy, flags_nocopy;
+    verify(&copy, &copy, NULL, &ret_copy, &flags_copy);
+    verify(&nocopy, &nocopy, NULL, &ret_nocopy, &flags_nocopy);
+    TEST_ASSERT_EQUAL(ret_copy, ret_nocopy);
+    TEST_ASSERT_EQUAL_HEX32(flags_copy, flags_nocopy);
+    TEST_ASSERT_EQUAL(0, flags_nocopy & MBEDTLS_X509_BADCERT_NOT_TRUSTED);
+
+    mbedtls_x509_crt_free(&copy);
+    mbedtls_x509_crt_free(&nocopy);
+
+    /* The buffer was not touched, and a truncated certificate is rejected */
+    mbedtls_x509_crt_init(&nocopy);
+    TEST_ASSERT_EQUAL(0, memcmp(der + len, trailer, sizeof(trailer)));
+    TEST_ASSERT_NOT_EQUAL(0, mbedtls_x509_crt_parse_der_nocopy(&nocopy, der, len - 1));
+    mbedtls_x509_crt_free(&nocopy);
+
+    /* A TBSCertificate running past the end of the certificate, into the
+     * following data, is rejected the same way as when it is copied */
+    TEST_ASSERT_TRUE(der[0] == 0x30 && der[1] == 0x82 && der[4] == 0x30 && der[5] == 0x82);
+    size_t short_len = 4 + ((der[6] << 8) | der[7]) - 8;
+    der[2] = (unsigned char)(short_len >> 8);
+    der[3] = (unsigned char) short_len;
+
+    int ret_short_copy, ret_short_nocopy;
+    mbedtls_x509_crt_init(&copy);
+    mbedtls_x509_crt_init(&nocopy);
+    ret_short_copy = mbedtls_x509_crt_parse_der(&copy, der, len + sizeof(trailer));
+    ret_short_nocopy = mbedtls_x509_crt_parse_der_nocopy(&nocopy, der, len + sizeof(trailer));
+    TEST_ASSERT_NOT_EQUAL(0, ret_short_copy);
+    TEST_ASSERT_EQUAL(ret_short_copy, ret_short_nocopy);
+    mbedtls_x509_crt_free(&copy);
+    mbedtls_x509_crt_free(&nocopy);
+}
+
+void test_store_refcount() {
+    mbedtls_x509_crt_store_init(&store);
+    TEST_ASSERT_EQUAL(1, store.refcount);
+    TEST_ASSERT_NULL(store.index);
+
+    /* Test CAs whose signature is not supported are skipped */
+    TEST_ASSERT_TRUE(mbedtls_x509_crt_parse(&store.chain, (const unsigned char *) mbedtls_test_cas_pem,
+                                            mbedtls_test_cas_pem_len) >= 0);
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse(&store.chain, (const unsigned char *) TEST_CA_CRT,
+                                                TEST_CA_CRT_LEN));
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_store_seal(&store));
+
+    /* Every CA is indexed, sorted by hash, and belongs to the store */
+    size_t count = 0;
+    for (mbedtls_x509_crt *crt = &store.chain; crt != NULL; crt = crt->next) {
+        TEST_ASSERT_TRUE(crt->store == &store);
+        count++;
+    }
+    TEST_ASSERT_EQUAL(count, store.count);
+    for (size_t i = 1; i < store.count; i++) {
+        TEST_ASSERT_TRUE(store.index[i - 1].hash <= store.index[i].hash);
+    }
+
+    /* Each CA is found through the index */
+    for (mbedtls_x509_crt *crt = &store.chain; crt != NULL; crt = crt->next) {
+        int ret;
+        uint32_t flags;
+        verify(crt, &store.chain, NULL, &ret, &flags);
+        TEST_ASSERT_EQUAL(0, flags & MBEDTLS_X509_BADCERT_NOT_TRUSTED);
+    }
+
+    mbedtls_x509_crt_store_acquire(&store);
+    TEST_ASSERT_EQUAL(2, store.refcount);
+
+    /* A configuration holds one reference while it uses the store */
+    mbedtls_ssl_config conf;
+    mbedtls_x509_crt other;
+    mbedtls_ssl_config_init(&conf);
+    mbedtls_x509_crt_init(&other);
+
+    mbedtls_ssl_conf_ca_store(&conf, &store, NULL);
+    TEST_ASSERT_EQUAL(3, store.refcount);
+    TEST_ASSERT_TRUE(conf.ca_chain == &store.chain);
+
+    mbedtls_ssl_conf_ca_store(&conf, &store, NULL);
+    TEST_ASSERT_EQUAL(3, store.refcount);
+
+    mbedtls_ssl_conf_ca_chain(&conf, &other, NULL);
+    TEST_ASSERT_EQUAL(2, store.refcount);
+    TEST_ASSERT_NULL(conf.ca_store);
+
+    mbedtls_ssl_conf_ca_store(&conf, &store, NULL);
+    TEST_ASSERT_EQUAL(3, store.refcount);
+    mbedtls_ssl_config_free(&conf);
+    TEST_ASSERT_EQUAL(2, store.refcount);
+    mbedtls_x509_crt_free(&other);
+
+    /* The contents are freed with the last reference */
+    mbedtls_x509_crt_store_release(&store);
+    TEST_ASSERT_EQUAL(1, store.refcount);
+    TEST_ASSERT_NOT_NULL(store.index);
+    TEST_ASSERT_NOT_NULL(store.chain.raw.p);
+
+    mbedtls_x509_crt_store_release(&store);
+    TEST_ASSERT_EQUAL(0, store.refcount);
+    TEST_ASSERT_NULL(store.index);
+    TEST_ASSERT_NULL(store.chain.raw.p);
+    TEST_ASSERT_NULL(store.chain.next);
+}
+
+/* Verify a certificate against the CAs as a plain chain and as a store set
+ * on an SSL configuration, the results must be the same */
+static void check_verify_matches(const char *cas, size_t cas_len, const char *pem, size_t len,
+                                 bool trusted)
+{
+    mbedtls_x509_crt chain, crt;
+    mbedtls_ssl_config conf;
+    int ret_chain, ret_store;
+    uint32_t flags_chain, flags_store;
+
+    mbedtls_x509_crt_init(&chain);
+    int ret = mbedtls_x509_crt_parse(&chain, (const unsigned char *) cas, cas_len);
+    TEST_ASSERT_TRUE(ret >= 0);
+
+    mbedtls_x509_crt_store_init(&store);
+    TEST_ASSERT_EQUAL(ret, mbedtls_x509_crt_parse(&store.chain, (const unsigned char *) cas, cas_len));
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_store_seal(&store));
+
+    /* The configuration keeps the only reference */
+    mbedtls_ssl_config_init(&conf);
+    mbedtls_ssl_conf_ca_store(&conf, &store, NULL);
+    mbedtls_x509_crt_store_release(&store);
+    TEST_ASSERT_EQUAL(1, store.refcount);
+
+    mbedtls_x509_crt_init(&crt);
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse(&crt, (const unsigned char *) pem, len));
+
+    verify(&crt, &chain, NULL, &ret_chain, &flags_chain);
+    verify(&crt, conf.ca_chain, conf.ca_crl, &ret_store, &flags_store);
+    TEST_ASSERT_EQUAL(ret_chain, ret_store);
+    TEST_ASSERT_EQUAL_HEX32(flags_chain, flags_store);
+    TEST_ASSERT_EQUAL(trusted, (flags_store & MBEDTLS_X509_BADCERT_NOT_TRUSTED) == 0);
+
+    mbedtls_x509_crt_free(&crt);
+    mbedtls_ssl_config_free(&conf);
+    TEST_ASSERT_EQUAL(0, store.refcount);
+    mbedtls_x509_crt_free(&chain);
+}
+
+void test_store_verify_matches_chain() {
+    const char *cas = mbedtls_test_cas_pem;
+    size_t cas_len = mbedtls_test_cas_pem_len;
+
+    check_verify_matches(cas, cas_len, TEST_SRV_CRT, TEST_SRV_CRT_LEN, true);
+    check_verify_matches(cas, cas_len, TEST_CLI_CRT, TEST_CLI_CRT_LEN, true);
+    check_verify_matches(cas, cas_len, TEST_CA_CRT, TEST_CA_CRT_LEN, true);
+
+    /* Issuer not in the store */
+    check_verify_matches(TEST_SRV_CRT, TEST_SRV_CRT_LEN, TEST_CLI_CRT, TEST_CLI_CRT_LEN, false);
+}
+
+utest::v1::status_t test_setup(const size_t num_cases) {
+    GREENTEA_SETUP(60, "default_auto");
+    return verbose_test_setup_handler(num_cases);
+}
+
+Case cases[] = {
+    Case("X.509 parse in place with trailing data", test_nocopy_trailing_data),
+    Case("X.509 CA store reference counting", test_store_refcount),
+    Case("X.509 CA store verifies like a CA chain", test_store_verify_matches_chain),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
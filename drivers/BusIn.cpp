@@ -15,27 +15,30 @@
  */
 #include "drivers/BusIn.h"
 #include "platform/mbed_assert.h"
+#include <new>
 
 namespace mbed {
 
 BusIn::BusIn(PinName p0, PinName p1, PinName p2, PinName p3, PinName p4, PinName p5, PinName p6, PinName p7, PinName p8, PinName p9, PinName p10, PinName p11, PinName p12, PinName p13, PinName p14, PinName p15) {
     PinName pins[16] = {p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15};
-
-    // No lock needed in the constructor
-    _nc_mask = 0;
-    for (int i=0; i<16; i++) {
-        _pin[i] = (pins[i] != NC) ? new DigitalIn(pins[i]) : 0;
-        if (pins[i] != NC) {
-            _nc_mask |= (1 << i);
-        }
-    }
+    init(pins);
 }
 
 BusIn::BusIn(PinName pins[16]) {
+    init(pins);
+}
+
+void BusIn::init(PinName pins[16]) {
     // No lock needed in the constructor
+#if DEVICE_PORTIN
+    _port_mask = _ports.init(pins, PIN_INPUT);
+#else
+    _port_mask = 0;
+#endif
+
     _nc_mask = 0;
     for (int i=0; i<16; i++) {
-        _pin[i] = (pins[i] != NC) ? new DigitalIn(pins[i]) : 0;
+        _pin[i] = (pins[i] != NC) ? new (&_pin_storage[i]) DigitalIn(pins[i]) : 0;
         if (pins[i] != NC) {
             _nc_mask |= (1 << i);
         }
@@ -46,7 +49,7 @@ BusIn::~BusIn() {
     // No lock needed in the destructor
     for (int i=0; i<16; i++) {
         if (_pin[i] != 0) {
-            delete _pin[i];
+            _pin[i]->~DigitalIn();
         }
     }
 }
@@ -54,8 +57,11 @@ BusIn::~BusIn() {
 int BusIn::read() {
     int v = 0;
     lock();
+#if DEVICE_PORTIN
+    v = _ports.read();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (_pin[i] != 0 && !(_port_mask & (1 << i))) {
             v |= _pin[i]->read() << i;
         }
     }
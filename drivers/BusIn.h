@@ -18,6 +18,7 @@
 
 #include "platform/platform.h"
 #include "drivers/DigitalIn.h"
+#include "drivers/BusPorts.h"
 #include "platform/PlatformMutex.h"
 
 namespace mbed {
@@ -91,6 +92,16 @@ protected:
      */
     int _nc_mask;
 
+    /** Mask of bus's pins written and read through their port
+     * If bit[n] is set to 1 - pin is accessed through _ports
+     * if bit[n] is cleared - pin is accessed through _pin[n]
+     */
+    int _port_mask;
+
+#if DEVICE_PORTIN
+    BusPorts _ports;
+#endif
+
     PlatformMutex _mutex;
 
     /* disallow copy constructor and assignment operators */
@@ -99,6 +110,14 @@ private:
     virtual void unlock();
     BusIn(const BusIn&);
     BusIn & operator = (const BusIn&);
+
+    void init(PinName pins[16]);
+
+    /* Storage for the connected pins, avoids a heap allocation per pin */
+    union {
+        char _data[sizeof(DigitalIn)];
+        uint32_t _align;
+    } _pin_storage[16];
 };
 
 } // namespace mbed
@@ -15,27 +15,30 @@
  */
 #include "drivers/BusInOut.h"
 #include "platform/mbed_assert.h"
+#include <new>
 
 namespace mbed {
 
 BusInOut::BusInOut(PinName p0, PinName p1, PinName p2, PinName p3, PinName p4, PinName p5, PinName p6, PinName p7, PinName p8, PinName p9, PinName p10, PinName p11, PinName p12, PinName p13, PinName p14, PinName p15) {
     PinName pins[16] = {p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15};
-
-    // No lock needed in the constructor
-    _nc_mask = 0;
-    for (int i=0; i<16; i++) {
-        _pin[i] = (pins[i] != NC) ? new DigitalInOut(pins[i]) : 0;
-        if (pins[i] != NC) {
-            _nc_mask |= (1 << i);
-        }
-    }
+    init(pins);
 }
 
 BusInOut::BusInOut(PinName pins[16]) {
+    init(pins);
+}
+
+void BusInOut::init(PinName pins[16]) {
     // No lock needed in the constructor
+#if DEVICE_PORTINOUT
+    _port_mask = _ports.init(pins, PIN_INPUT);
+#else
+    _port_mask = 0;
+#endif
+
     _nc_mask = 0;
     for (int i=0; i<16; i++) {
-        _pin[i] = (pins[i] != NC) ? new DigitalInOut(pins[i]) : 0;
+        _pin[i] = (pins[i] != NC) ? new (&_pin_storage[i]) DigitalInOut(pins[i]) : 0;
         if (pins[i] != NC) {
             _nc_mask |= (1 << i);
         }
@@ -46,15 +49,18 @@ BusInOut::~BusInOut() {
     // No lock needed in the destructor
     for (int i=0; i<16; i++) {
         if (_pin[i] != 0) {
-            delete _pin[i];
+            _pin[i]->~DigitalInOut();
         }
     }
 }
 
 void BusInOut::write(int value) {
     lock();
+#if DEVICE_PORTINOUT
+    _ports.write(value);
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (_pin[i] != 0 && !(_port_mask & (1 << i))) {
             _pin[i]->write((value >> i) & 1);
         }
     }
@@ -64,8 +70,11 @@ void BusInOut::write(int value) {
 int BusInOut::read() {
     lock();
     int v = 0;
+#if DEVICE_PORTINOUT
+    v = _ports.read();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (_pin[i] != 0 && !(_port_mask & (1 << i))) {
             v |= _pin[i]->read() << i;
         }
     }
@@ -75,6 +84,9 @@ int BusInOut::read() {
 
 void BusInOut::output() {
     lock();
+#if DEVICE_PORTINOUT
+    _ports.dir(PIN_OUTPUT);
+#endif
     for (int i=0; i<16; i++) {
         if (_pin[i] != 0) {
             _pin[i]->output();
@@ -85,6 +97,9 @@ void BusInOut::output() {
 
 void BusInOut::input() {
     lock();
+#if DEVICE_PORTINOUT
+    _ports.dir(PIN_INPUT);
+#endif
     for (int i=0; i<16; i++) {
         if (_pin[i] != 0) {
             _pin[i]->input();
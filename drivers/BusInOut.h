@@ -17,6 +17,7 @@
 #define MBED_BUSINOUT_H
 
 #include "drivers/DigitalInOut.h"
+#include "drivers/BusPorts.h"
 #include "platform/PlatformMutex.h"
 
 namespace mbed {
@@ -112,12 +113,30 @@ protected:
      */
     int _nc_mask;
 
+    /** Mask of bus's pins written and read through their port
+     * If bit[n] is set to 1 - pin is accessed through _ports
+     * if bit[n] is cleared - pin is accessed through _pin[n]
+     */
+    int _port_mask;
+
+#if DEVICE_PORTINOUT
+    BusPorts _ports;
+#endif
+
     PlatformMutex _mutex;
 
     /* disallow copy constructor and assignment operators */
 private:
     BusInOut(const BusInOut&);
     BusInOut & operator = (const BusInOut&);
+
+    void init(PinName pins[16]);
+
+    /* Storage for the connected pins, avoids a heap allocation per pin */
+    union {
+        char _data[sizeof(DigitalInOut)];
+        uint32_t _align;
+    } _pin_storage[16];
 };
 
 } // namespace mbed
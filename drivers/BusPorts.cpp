@@ -0,0 +1,132 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2013 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/BusPorts.h"
+
+#if DEVICE_PORTIN || DEVICE_PORTOUT
+
+namespace mbed {
+
+BusPorts::BusPorts() : _count(0) {
+}
+
+int BusPorts::init(const PinName pins[16], PinDirection dir) {
+    _count = 0;
+    for (int i=0; i<16; i++) {
+        PortName name;
+        _port_pin[i] = (pins[i] != NC) ? port_pin_number(pins[i], &name) : -1;
+        if (_port_pin[i] < 0) {
+            continue;
+        }
+
+        int p = 0;
+        while (p < _count && _ports[p].name != name) {
+            p++;
+        }
+        if (p == _count) {
+            if (_count == MAX_PORTS) {
+                _port_pin[i] = -1;
+                continue;
+            }
+            _ports[p].name = name;
+            _ports[p].bus_mask = 0;
+            _ports[p].shift = _port_pin[i] - i;
+            _count++;
+        }
+
+        _ports[p].bus_mask |= 1 << i;
+        if (_ports[p].shift != _port_pin[i] - i) {
+            _ports[p].shift = SHIFT_NONE;
+        }
+    }
+
+    // A single pin is written just as well without a read-modify-write of its port
+    int mask = 0;
+    int count = 0;
+    for (int p=0; p<_count; p++) {
+        uint16_t bus_mask = _ports[p].bus_mask;
+        if (!(bus_mask & (bus_mask - 1))) {
+            continue;
+        }
+
+        uint32_t port_mask = 0;
+        for (int i=0; i<16; i++) {
+            if (bus_mask & (1 << i)) {
+                port_mask |= 1UL << _port_pin[i];
+            }
+        }
+
+        _ports[count] = _ports[p];
+        port_init(&_ports[count].port, _ports[count].name, (int)port_mask, dir);
+        mask |= bus_mask;
+        count++;
+    }
+    _count = count;
+
+    return mask;
+}
+
+void BusPorts::write(int value) {
+    for (int p=0; p<_count; p++) {
+        port_group_t &port = _ports[p];
+        uint32_t bits = value & port.bus_mask;
+        uint32_t v = 0;
+
+        if (port.shift == SHIFT_NONE) {
+            for (int i=0; i<16; i++) {
+                if (bits & (1 << i)) {
+                    v |= 1UL << _port_pin[i];
+                }
+            }
+        } else if (port.shift >= 0) {
+            v = bits << port.shift;
+        } else {
+            v = bits >> -port.shift;
+        }
+
+        port_write(&port.port, (int)v);
+    }
+}
+
+int BusPorts::read() {
+    int value = 0;
+    for (int p=0; p<_count; p++) {
+        port_group_t &port = _ports[p];
+        uint32_t v = port_read(&port.port);
+
+        if (port.shift == SHIFT_NONE) {
+            for (int i=0; i<16; i++) {
+                if ((port.bus_mask & (1 << i)) && (v & (1UL << _port_pin[i]))) {
+                    value |= 1 << i;
+                }
+            }
+        } else if (port.shift >= 0) {
+            value |= (v >> port.shift) & port.bus_mask;
+        } else {
+            value |= (v << -port.shift) & port.bus_mask;
+        }
+    }
+    return value;
+}
+
+void BusPorts::dir(PinDirection dir) {
+    for (int p=0; p<_count; p++) {
+        port_dir(&_ports[p].port, dir);
+    }
+}
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,104 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2013 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BUSPORTS_H
+#define MBED_BUSPORTS_H
+
+#include "platform/platform.h"
+
+#if DEVICE_PORTIN || DEVICE_PORTOUT
+
+#include "hal/port_api.h"
+
+#ifndef MBED_CONF_DRIVERS_BUS_MAX_PORTS
+#define MBED_CONF_DRIVERS_BUS_MAX_PORTS 2
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** Accesses the pins of a bus through their ports
+ *
+ * Groups the pins of a bus by port, so a bus value is written with a single
+ * masked port write per port instead of a write per pin. Pins the target
+ * can't map to a port, pins on more than MAX_PORTS ports and pins alone on
+ * their port are left to the bus to access individually.
+ *
+ * @Note Synchronization level: Not protected
+ */
+class BusPorts {
+public:
+    /** Maximum number of ports a bus is grouped into
+     *
+     *  Every port costs a port_t in each bus object. Buses on a contiguous
+     *  run of pins span one or two ports, drivers.bus-max-ports raises the
+     *  limit for buses spread wider, such as over a whole Arduino header.
+     */
+    static const int MAX_PORTS = MBED_CONF_DRIVERS_BUS_MAX_PORTS;
+
+    BusPorts();
+
+    /** Group the pins of a bus and initialize the ports
+     *
+     *  @param pins Pins of the bus, NC for bits that are not connected
+     *  @param dir  Initial direction of the ports
+     *  @returns
+     *    Mask of the bus bits accessed through a port
+     */
+    int init(const PinName pins[16], PinDirection dir);
+
+    /** Write the port grouped bits of a bus value
+     *
+     *  @param value The bus value
+     */
+    void write(int value);
+
+    /** Read the port grouped bits of the bus
+     *
+     *  @returns
+     *    The port grouped bits of the bus value, other bits are 0
+     */
+    int read();
+
+    /** Set the direction of the ports
+     *
+     *  @param dir The port direction
+     */
+    void dir(PinDirection dir);
+
+private:
+    /* Marks a port whose pins are not in bus order */
+    static const int8_t SHIFT_NONE = -128;
+
+    struct port_group_t {
+        port_t port;
+        PortName name;
+        uint16_t bus_mask;  /* bus bits on this port */
+        int8_t shift;       /* port bit minus bus bit, or SHIFT_NONE */
+    };
+
+    port_group_t _ports[MAX_PORTS];
+    int _count;
+    int8_t _port_pin[16];   /* port pin number of every bus bit */
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
+
+/** @}*/
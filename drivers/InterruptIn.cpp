@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "drivers/InterruptIn.h"
+#include "drivers/Timeout.h"
+#include "platform/mbed_assert.h"
 
 #if DEVICE_INTERRUPTIN
 
@@ -24,7 +26,23 @@ static void donothing() {}
 InterruptIn::InterruptIn(PinName pin) : gpio(),
                                         gpio_irq(),
                                         _rise(),
-                                        _fall() {
+                                        _fall(),
+                                        _rise_enabled(false),
+                                        _fall_enabled(false),
+                                        _capture_buffer(NULL),
+                                        _capture_size(0),
+                                        _capture_head(0),
+                                        _capture_tail(0),
+                                        _capture_overruns(0),
+                                        _capture_func(),
+                                        _debounce(NULL),
+                                        _debounce_us(0),
+                                        _debounce_time(0),
+                                        _debounce_level(0),
+                                        _edge_count(0),
+                                        _rate_count(0),
+                                        _rate_time(0),
+                                        _rate_started(false) {
     // No lock needed in the constructor
 
     _rise = donothing;
@@ -37,6 +55,7 @@ InterruptIn::InterruptIn(PinName pin) : gpio(),
 InterruptIn::~InterruptIn() {
     // No lock needed in the destructor
     gpio_irq_free(&gpio_irq);
+    delete _debounce;
 }
 
 int InterruptIn::read() {
@@ -54,11 +73,12 @@ void InterruptIn::rise(Callback<void()> func) {
     core_util_critical_section_enter();
     if (func) {
         _rise = func;
-        gpio_irq_set(&gpio_irq, IRQ_RISE, 1);
+        _rise_enabled = true;
     } else {
         _rise = donothing;
-        gpio_irq_set(&gpio_irq, IRQ_RISE, 0);
+        _rise_enabled = false;
     }
+    _update_irq();
     core_util_critical_section_exit();
 }
 
@@ -66,21 +86,143 @@ void InterruptIn::fall(Callback<void()> func) {
     core_util_critical_section_enter();
     if (func) {
         _fall = func;
-        gpio_irq_set(&gpio_irq, IRQ_FALL, 1);
+        _fall_enabled = true;
     } else {
         _fall = donothing;
-        gpio_irq_set(&gpio_irq, IRQ_FALL, 0);
+        _fall_enabled = false;
     }
+    _update_irq();
     core_util_critical_section_exit();
 }
 
 void InterruptIn::_irq_handler(uint32_t id, gpio_irq_event event) {
     InterruptIn *handler = (InterruptIn*)id;
-    switch (event) {
-        case IRQ_RISE: handler->_rise(); break;
-        case IRQ_FALL: handler->_fall(); break;
-        case IRQ_NONE: break;
+    if (event == IRQ_NONE) {
+        return;
     }
+
+    if (handler->_debounce_us) {
+        // Restart the filter, the edge is reported once the input is stable
+        handler->_debounce_time = us_ticker_read();
+        handler->_debounce->attach_us(callback(handler, &InterruptIn::_debounce_handler), handler->_debounce_us);
+        return;
+    }
+
+    handler->_edge(event == IRQ_RISE, handler->_capture_buffer ? us_ticker_read() : 0);
+}
+
+void InterruptIn::_debounce_handler() {
+    int level = gpio_read(&gpio);
+    if (level != _debounce_level) {
+        _debounce_level = level;
+        _edge(level, _debounce_time);
+    }
+}
+
+void InterruptIn::_edge(bool rise, timestamp_t time) {
+    _edge_count++;
+
+    if (_capture_buffer) {
+        uint32_t head = _capture_head;
+        uint32_t next = (head + 1 == _capture_size) ? 0 : head + 1;
+        if (next != _capture_tail) {
+            _capture_buffer[head].time = time;
+            _capture_buffer[head].rise = rise;
+            _capture_head = next;
+            if (head == _capture_tail && _capture_func) {
+                _capture_func();
+            }
+        } else {
+            _capture_overruns++;
+        }
+    }
+
+    if (rise) {
+        _rise();
+    } else {
+        _fall();
+    }
+}
+
+void InterruptIn::_update_irq() {
+    // Capturing and debouncing need to see every edge
+    bool all = _capture_buffer || _debounce_us;
+    gpio_irq_set(&gpio_irq, IRQ_RISE, _rise_enabled || all);
+    gpio_irq_set(&gpio_irq, IRQ_FALL, _fall_enabled || all);
+}
+
+void InterruptIn::capture(edge_t *buffer, size_t size, Callback<void()> func) {
+    MBED_ASSERT(!buffer || size > 1);
+    core_util_critical_section_enter();
+    _capture_buffer = buffer;
+    _capture_size = size;
+    _capture_head = 0;
+    _capture_tail = 0;
+    _capture_overruns = 0;
+    _capture_func = func;
+    _update_irq();
+    core_util_critical_section_exit();
+}
+
+size_t InterruptIn::read_edges(edge_t *edges, size_t count) {
+    // Only the interrupt handler moves the head, only the reader moves the tail
+    size_t n = 0;
+    uint32_t tail = _capture_tail;
+    while (n < count && _capture_buffer && tail != _capture_head) {
+        edges[n].time = _capture_buffer[tail].time;
+        edges[n].rise = _capture_buffer[tail].rise;
+        tail = (tail + 1 == _capture_size) ? 0 : tail + 1;
+        n++;
+    }
+    _capture_tail = tail;
+    return n;
+}
+
+uint32_t InterruptIn::overruns() {
+    // Read only
+    return _capture_overruns;
+}
+
+void InterruptIn::debounce(timestamp_t us) {
+    Timeout *timeout = NULL;
+    if (us && !_debounce) {
+        timeout = new Timeout();
+    }
+
+    core_util_critical_section_enter();
+    if (timeout) {
+        _debounce = timeout;
+    }
+    if (_debounce && !us) {
+        _debounce->detach();
+    }
+    _debounce_us = us;
+    _debounce_level = gpio_read(&gpio);
+    _update_irq();
+    core_util_critical_section_exit();
+}
+
+uint32_t InterruptIn::edge_count() {
+    // Read only
+    return _edge_count;
+}
+
+float InterruptIn::edge_rate() {
+    core_util_critical_section_enter();
+    uint32_t count = _edge_count;
+    timestamp_t now = us_ticker_read();
+    uint32_t edges = count - _rate_count;
+    timestamp_t elapsed = now - _rate_time;
+    bool started = _rate_started;
+    _rate_count = count;
+    _rate_time = now;
+    _rate_started = true;
+    core_util_critical_section_exit();
+
+    if (!started || !elapsed) {
+        return 0.0f;
+    }
+    return edges * 1000000.0f / elapsed;
 }
 
 void InterruptIn::enable_irq() {
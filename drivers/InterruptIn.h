@@ -22,6 +22,7 @@
 
 #include "hal/gpio_api.h"
 #include "hal/gpio_irq_api.h"
+#include "hal/us_ticker_api.h"
 #include "platform/Callback.h"
 #include "platform/mbed_critical.h"
 #include "platform/mbed_toolchain.h"
@@ -30,6 +31,8 @@ namespace mbed {
 /** \addtogroup drivers */
 /** @{*/
 
+class Timeout;
+
 /** A digital interrupt input, used to call a function on a rising or falling edge
  *
  * @Note Synchronization level: Interrupt safe
@@ -55,10 +58,38 @@ namespace mbed {
  *     }
  * }
  * @endcode
+ *
+ * Edges can also be captured with their us_ticker timestamp into a buffer
+ * and read back in batches from thread context, for example when decoding
+ * a pulse train:
+ * @code
+ * InterruptIn ir(p16);
+ * InterruptIn::edge_t edges[64];
+ * EventQueue queue;
+ *
+ * void decode() {
+ *     InterruptIn::edge_t batch[16];
+ *     size_t count;
+ *     while ((count = ir.read_edges(batch, 16)) > 0) {
+ *         // batch[i].time, batch[i].rise
+ *     }
+ * }
+ *
+ * int main() {
+ *     ir.capture(edges, 64, queue.event(decode));
+ *     queue.dispatch_forever();
+ * }
+ * @endcode
  */
 class InterruptIn {
 
 public:
+    /** An edge recorded in capture mode
+     */
+    struct edge_t {
+        timestamp_t time;   /**< us_ticker time of the edge */
+        bool rise;          /**< true for a rising edge, false for a falling edge */
+    };
 
     /** Create an InterruptIn connected to the specified pin
      *
@@ -145,14 +176,101 @@ public:
      */
     void disable_irq();
 
+    /** Record edges with their timestamp into a buffer
+     *
+     *  Edges are recorded in interrupt context and read back with read_edges().
+     *  The rise and fall functions are still called for every edge.
+     *
+     *  @param buffer Storage for the captured edges, or NULL to stop capturing
+     *  @param size Number of entries in the buffer, which holds up to size - 1 edges
+     *  @param func Function called in interrupt context when an edge is captured
+     *    into an empty buffer, for example to wake a thread or post to an EventQueue
+     *  @note Edges arriving while the buffer is full are dropped and counted by overruns()
+     */
+    void capture(edge_t *buffer, size_t size, Callback<void()> func = 0);
+
+    /** Read captured edges, oldest first
+     *
+     *  There must only be one reader of the captured edges at a time.
+     *
+     *  @param edges Array to fill with the captured edges
+     *  @param count Maximum number of edges to read
+     *  @returns
+     *    Number of edges read, 0 if no edges were captured
+     */
+    size_t read_edges(edge_t *edges, size_t count);
+
+    /** Number of edges dropped because the capture buffer was full
+     *
+     *  @returns
+     *    Number of dropped edges since capture() was called
+     */
+    uint32_t overruns();
+
+    /** Ignore pulses shorter than the debounce time
+     *
+     *  An edge is only reported once the input has held its new level for the
+     *  debounce time, with the timestamp of the last transition. Bouncing and
+     *  glitches are filtered without calling the rise and fall functions.
+     *
+     *  @param us Debounce time in microseconds, 0 to disable the filter
+     */
+    void debounce(timestamp_t us);
+
+    /** Number of edges reported since the InterruptIn was created
+     *
+     *  Only edges the InterruptIn listens for are counted: rising edges while a
+     *  rise function is attached, falling edges while a fall function is
+     *  attached, and every edge while capturing or debouncing. With debounce
+     *  enabled only the edges that passed the filter are counted.
+     *
+     *  @returns
+     *    Number of reported edges
+     */
+    uint32_t edge_count();
+
+    /** Rate of reported edges since the last call
+     *
+     *  The first call starts the measurement and returns 0.
+     *
+     *  @returns
+     *    Edges per second since the previous call to edge_rate()
+     */
+    float edge_rate();
+
     static void _irq_handler(uint32_t id, gpio_irq_event event);
 
 protected:
+    void _edge(bool rise, timestamp_t time);
+    void _debounce_handler();
+    void _update_irq();
+
     gpio_t gpio;
     gpio_irq_t gpio_irq;
 
     Callback<void()> _rise;
     Callback<void()> _fall;
+
+    /* Edges requested through rise() and fall() */
+    bool _rise_enabled;
+    bool _fall_enabled;
+
+    volatile edge_t *_capture_buffer;
+    size_t _capture_size;
+    volatile uint32_t _capture_head;
+    volatile uint32_t _capture_tail;
+    uint32_t _capture_overruns;
+    Callback<void()> _capture_func;
+
+    Timeout *_debounce;
+    timestamp_t _debounce_us;
+    timestamp_t _debounce_time;
+    int _debounce_level;
+
+    volatile uint32_t _edge_count;
+    uint32_t _rate_count;
+    timestamp_t _rate_time;
+    bool _rate_started;
 };
 
 } // namespace mbed
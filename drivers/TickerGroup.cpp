@@ -0,0 +1,168 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2013 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/TickerGroup.h"
+
+#include "hal/ticker_api.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_assert.h"
+
+namespace mbed {
+
+TickerGroup::Entry::Entry() : _group(NULL), _next(NULL), _function(), _divider(0),
+                              _countdown(0), _priority(0), _stats() {
+}
+
+TickerGroup::Entry::~Entry() {
+    if (_group) {
+        _group->detach(*this);
+    }
+}
+
+void TickerGroup::Entry::get_stats(stats_t *stats) {
+    core_util_critical_section_enter();
+    *stats = _stats;
+    core_util_critical_section_exit();
+}
+
+TickerGroup::TickerGroup(timestamp_t period) : TimerEvent(), _period(period), _ticks(0), _entries(NULL),
+                                               _iter_next(NULL) {
+    MBED_ASSERT(period > 0);
+}
+
+TickerGroup::TickerGroup(const ticker_data_t *data, timestamp_t period) : TimerEvent(data), _period(period),
+                                                                          _ticks(0), _entries(NULL), _iter_next(NULL) {
+    MBED_ASSERT(period > 0);
+    data->interface->init();
+}
+
+TickerGroup::~TickerGroup() {
+    core_util_critical_section_enter();
+    while (_entries) {
+        _detach(*_entries);
+    }
+    remove();
+    core_util_critical_section_exit();
+}
+
+timestamp_t TickerGroup::get_period() const {
+    return _period;
+}
+
+void TickerGroup::attach_us(Entry &entry, Callback<void()> func, timestamp_t t, int priority) {
+    MBED_ASSERT(t >= _period && t % _period == 0);
+
+    core_util_critical_section_enter();
+    if (entry._group) {
+        entry._group->_detach(entry);
+    }
+
+    bool start = !_entries;
+    if (start) {
+        _ticks = 0;
+    }
+
+    entry._group = this;
+    entry._function = func;
+    entry._divider = t / _period;
+    entry._countdown = entry._divider - _ticks % entry._divider;
+    entry._priority = priority;
+    entry._stats.calls = 0;
+    entry._stats.overruns = 0;
+    entry._stats.min_latency = (timestamp_t)-1;
+    entry._stats.max_latency = 0;
+
+    // keep the entries sorted by priority, in attach order for equal priorities
+    Entry **prev = &_entries;
+    while (*prev && (*prev)->_priority >= priority) {
+        prev = &(*prev)->_next;
+    }
+    entry._next = *prev;
+    *prev = &entry;
+
+    if (start) {
+        insert(ticker_read(_ticker_data) + _period);
+    }
+    core_util_critical_section_exit();
+}
+
+void TickerGroup::detach(Entry &entry) {
+    core_util_critical_section_enter();
+    if (entry._group == this) {
+        _detach(entry);
+    }
+    core_util_critical_section_exit();
+}
+
+void TickerGroup::_detach(Entry &entry) {
+    Entry **prev = &_entries;
+    while (*prev && *prev != &entry) {
+        prev = &(*prev)->_next;
+    }
+    if (*prev) {
+        *prev = entry._next;
+    }
+
+    // a function of the running tick removed the entry the tick would visit next
+    if (_iter_next == &entry) {
+        _iter_next = entry._next;
+    }
+
+    entry._group = NULL;
+    entry._next = NULL;
+    entry._function = 0;
+
+    if (!_entries) {
+        remove();
+    }
+}
+
+void TickerGroup::handler() {
+    timestamp_t scheduled = event.timestamp;
+
+    // skip ticks that are already over instead of calling back to back
+    uint32_t ticks = 1 + (ticker_read(_ticker_data) - scheduled) / _period;
+    _ticks += ticks;
+    insert(scheduled + ticks * _period);
+
+    // functions may detach, destroy or move any entry, so the next entry is
+    // kept in _iter_next where _detach can advance it
+    for (Entry *entry = _entries; entry; entry = _iter_next) {
+        _iter_next = entry->_next;
+
+        if (entry->_countdown > ticks) {
+            entry->_countdown -= ticks;
+        } else {
+            uint32_t late = ticks - entry->_countdown;
+            entry->_countdown = entry->_divider - late % entry->_divider;
+            entry->_stats.overruns += late / entry->_divider;
+
+            // latency against the last tick this entry was due
+            timestamp_t due = scheduled + (ticks - 1 - late % entry->_divider) * _period;
+            timestamp_t latency = ticker_read(_ticker_data) - due;
+            if (latency < entry->_stats.min_latency) {
+                entry->_stats.min_latency = latency;
+            }
+            if (latency > entry->_stats.max_latency) {
+                entry->_stats.max_latency = latency;
+            }
+            entry->_stats.calls++;
+
+            entry->_function();
+        }
+    }
+}
+
+} // namespace mbed
@@ -0,0 +1,155 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2013 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_TICKERGROUP_H
+#define MBED_TICKERGROUP_H
+
+#include "drivers/TimerEvent.h"
+#include "platform/Callback.h"
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** A TickerGroup calls several functions at harmonically related intervals
+ *  from a single timer event
+ *
+ * Every interval is a multiple of the base period of the group, and all
+ * functions due at the same base tick are called from the same interrupt,
+ * highest priority first. Unlike separate Tickers, n functions with
+ * related intervals cost one timer interrupt per base tick instead of n.
+ *
+ * The schedule is drift-free: each tick is set relative to the previous
+ * scheduled tick, not to when its functions finished. If the group falls a
+ * whole base period or more behind, it skips the missed ticks and counts
+ * an overrun for each call that was skipped.
+ *
+ * @Note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * // Run a 1 kHz current loop and a 250 Hz speed loop in phase
+ * #include "mbed.h"
+ *
+ * TickerGroup control(1000);
+ * TickerGroup::Entry current;
+ * TickerGroup::Entry speed;
+ *
+ * void current_loop() { ... }
+ * void speed_loop() { ... }
+ *
+ * int main() {
+ *     control.attach_us(current, current_loop, 1000, 1);
+ *     control.attach_us(speed, speed_loop, 4000, 0);
+ *     ...
+ * }
+ * @endcode
+ */
+class TickerGroup : public TimerEvent {
+
+public:
+    /** Timing statistics of a periodic function
+     */
+    struct stats_t {
+        uint32_t calls;             /**< Number of calls */
+        uint32_t overruns;          /**< Number of calls skipped because the group fell behind */
+        timestamp_t min_latency;    /**< Shortest time between a scheduled tick and the call, in microseconds */
+        timestamp_t max_latency;    /**< Longest time between a scheduled tick and the call, in microseconds */
+    };
+
+    /** A periodic function in a TickerGroup
+     *
+     * An Entry is detached from its group when it is destroyed.
+     */
+    class Entry {
+    public:
+        Entry();
+        ~Entry();
+
+        /** Get the timing statistics of this function
+         *
+         *  @param stats Filled with the statistics since the function was attached
+         *  @note max_latency - min_latency is the jitter of the function
+         */
+        void get_stats(stats_t *stats);
+
+    private:
+        friend class TickerGroup;
+
+        TickerGroup *_group;
+        Entry *_next;
+        Callback<void()> _function;
+        uint32_t _divider;
+        uint32_t _countdown;
+        int _priority;
+        stats_t _stats;
+    };
+
+    /** Create a TickerGroup
+     *
+     *  @param period Base period of the group in micro-seconds
+     */
+    TickerGroup(timestamp_t period);
+
+    /** Create a TickerGroup on a specific ticker
+     *
+     *  @param data The ticker to schedule the group on
+     *  @param period Base period of the group in micro-seconds
+     */
+    TickerGroup(const ticker_data_t *data, timestamp_t period);
+
+    virtual ~TickerGroup();
+
+    /** Attach a function to be called at a recurring interval
+     *
+     *  The first call happens at the next base tick that is a multiple of the
+     *  interval since the group started, so functions with related intervals
+     *  stay phase aligned. An entry that is already attached is moved.
+     *
+     *  @param entry Entry to hold the function
+     *  @param func The function to be called
+     *  @param t The time between calls in micro-seconds, a multiple of the base period
+     *  @param priority Functions due at the same tick are called highest priority first
+     */
+    void attach_us(Entry &entry, Callback<void()> func, timestamp_t t, int priority = 0);
+
+    /** Detach a function
+     *
+     *  @param entry Entry to detach, nothing happens if it is not attached
+     */
+    void detach(Entry &entry);
+
+    /** Get the base period of the group
+     *
+     *  @returns Base period in micro-seconds
+     */
+    timestamp_t get_period() const;
+
+protected:
+    virtual void handler();
+
+    void _detach(Entry &entry);
+
+    timestamp_t _period;
+    uint32_t _ticks;
+    Entry *_entries;
+    Entry *_iter_next;  // next entry of the running tick, advanced by _detach
+};
+
+} // namespace mbed
+
+#endif
+
+/** @}*/
@@ -89,6 +89,53 @@ extern int8_t sn_coap_protocol_destroy(struct coap_s *handle);
  */
 extern int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param);
 
+/**
+ * \fn int16_t sn_coap_protocol_build_in_place(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
+ *
+ * \brief Builds Packet data from given CoAP header structure into memory owned by the library
+ *
+ *        Same as sn_coap_protocol_build(), but the caller does not need to calculate
+ *        the packet size and allocate a buffer for it. Confirmable messages are built
+ *        directly into the re-sending queue, so the packet is not copied for resending.
+ *        Other messages are built into a buffer allocated with the library malloc function.
+ *
+ *        Built packet must be released with sn_coap_protocol_release_packet() after it has
+ *        been sent. It stays valid until then, even if the confirmable message is
+ *        acknowledged or its resending gives up in the meantime.
+ *
+ * \param *handle Pointer to CoAP library handle
+ *
+ * \param *dst_addr_ptr is pointer to destination address where CoAP message
+ *        will be sent
+ *
+ * \param **dst_packet_data_pptr is set to point to the built Packet data
+ *
+ * \param *src_coap_msg_ptr is pointer to source of built Packet data
+ *
+ * \param param void pointer that will be passed to tx/rx function callback when those are called.
+ *
+ * \return Return value is byte count of built Packet data.\n
+ *         In failure cases:\n
+ *          -1 = Failure in CoAP header structure\n
+ *          -2 = Failure in given pointer (= NULL) or out of memory\n
+ */
+extern int16_t sn_coap_protocol_build_in_place(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param);
+
+/**
+ * \fn void sn_coap_protocol_release_packet(struct coap_s *handle, uint8_t *packet_data_ptr)
+ *
+ * \brief Releases Packet data built with sn_coap_protocol_build_in_place()
+ *
+ *        Packet data still owned by the re-sending queue is left in place and
+ *        freed when the message is acknowledged or resending gives up. Each
+ *        built packet must be released exactly once.
+ *
+ * \param *handle Pointer to CoAP library handle
+ *
+ * \param *packet_data_ptr Packet data to be released
+ */
+extern void sn_coap_protocol_release_packet(struct coap_s *handle, uint8_t *packet_data_ptr);
+
 /**
  * \fn sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr)
  *
@@ -144,6 +144,7 @@ typedef struct coap_send_msg_ {
     uint32_t            resending_time;     /* Tells next resending time */
 
     sn_nsdl_transmit_s *send_msg_ptr;
+    bool                packet_held;        /* Packet data is still used by the caller of sn_coap_protocol_build_in_place() */
 
     struct coap_s       *coap;              /* CoAP library handle */
     void                *param;             /* Extra parameter that will be passed to TX/RX callback functions */
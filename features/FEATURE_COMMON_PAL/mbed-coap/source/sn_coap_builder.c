@@ -38,16 +38,11 @@
 #define TRACE_GROUP "coap"
 /* * * * LOCAL FUNCTION PROTOTYPES * * * */
 static int8_t   sn_coap_builder_header_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr);
-static int8_t   sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr);
-static uint16_t sn_coap_builder_options_calc_option_size(uint16_t query_len, uint8_t *query_ptr, sn_coap_option_numbers_e option);
-static int16_t  sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet_data_pptr, uint16_t option_len, uint8_t *option_ptr, sn_coap_option_numbers_e option_number, uint16_t *previous_option_number);
-static int16_t  sn_coap_builder_options_build_add_multiple_option(uint8_t **dst_packet_data_pptr, uint8_t **src_pptr, uint16_t *src_len_ptr, sn_coap_option_numbers_e option, uint16_t *previous_option_number);
+static int16_t  sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr);
+static uint16_t sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet_data_pptr, uint16_t option_len, uint8_t *option_ptr, sn_coap_option_numbers_e option_number, uint16_t *previous_option_number);
+static int16_t  sn_coap_builder_options_build_add_multiple_option(uint8_t **dst_packet_data_pptr, uint8_t *src_ptr, uint16_t src_len, sn_coap_option_numbers_e option, uint16_t *previous_option_number);
 static uint8_t  sn_coap_builder_options_build_add_uint_option(uint8_t **dst_packet_data_pptr, uint32_t value, sn_coap_option_numbers_e option_number, uint16_t *previous_option_number);
-static uint8_t  sn_coap_builder_options_get_option_part_count(uint16_t query_len, uint8_t *query_ptr, sn_coap_option_numbers_e option);
-static uint16_t sn_coap_builder_options_get_option_part_length_from_whole_option_string(uint16_t query_len, uint8_t *query_ptr, uint8_t query_index, sn_coap_option_numbers_e option);
-static int16_t  sn_coap_builder_options_get_option_part_position(uint16_t query_len, uint8_t *query_ptr, uint8_t query_index, sn_coap_option_numbers_e option);
 static void     sn_coap_builder_payload_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr);
-static uint8_t  sn_coap_builder_options_calculate_jump_need(sn_coap_hdr_s *src_coap_msg_ptr/*, uint8_t block_option*/);
 
 sn_coap_hdr_s *sn_coap_build_response(struct coap_s *handle, sn_coap_hdr_s *coap_packet_ptr, uint8_t msg_code)
 {
@@ -98,6 +93,7 @@ int16_t sn_coap_builder(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_ms
 
 int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size)
 {
+    (void)blockwise_payload_size;
     tr_debug("sn_coap_builder_2");
     uint8_t *base_packet_data_ptr = NULL;
 
@@ -106,18 +102,12 @@ int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_
         return -2;
     }
 
-    /* Initialize given Packet data memory area with zero values */
-    uint16_t dst_byte_count_to_be_built = sn_coap_builder_calc_needed_packet_data_size_2(src_coap_msg_ptr, blockwise_payload_size);
-    tr_debug("sn_coap_builder_2 - message len: [%d]", dst_byte_count_to_be_built);
-    if (!dst_byte_count_to_be_built) {
-        return -1;
-    }
-
-    memset(dst_packet_data_ptr, 0, dst_byte_count_to_be_built);
-
     /* * * * Store base (= original) destination Packet data pointer for later usage * * * */
     base_packet_data_ptr = dst_packet_data_ptr;
 
+    /* Message is built in a single pass, every byte except the first Header byte is written as is */
+    *dst_packet_data_ptr = 0;
+
     /* * * * * * * * * * * * * * * * * * */
     /* * * * Header part building  * * * */
     /* * * * * * * * * * * * * * * * * * */
@@ -131,13 +121,18 @@ int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_
         /* * * * * * * * * * * * * * * * * * */
         /* * * * Options part building * * * */
         /* * * * * * * * * * * * * * * * * * */
-        sn_coap_builder_options_build(&dst_packet_data_ptr, src_coap_msg_ptr);
+        if (sn_coap_builder_options_build(&dst_packet_data_ptr, src_coap_msg_ptr) < 0) {
+            /* Invalid option */
+            return -1;
+        }
 
         /* * * * * * * * * * * * * * * * * * */
         /* * * * Payload part building * * * */
         /* * * * * * * * * * * * * * * * * * */
         sn_coap_builder_payload_build(&dst_packet_data_ptr, src_coap_msg_ptr);
     }
+    tr_debug("sn_coap_builder_2 - message len: [%d]", (int)(dst_packet_data_ptr - base_packet_data_ptr));
+
     /* * * * Return built Packet data length * * * */
     return (dst_packet_data_ptr - base_packet_data_ptr);
 }
@@ -164,169 +159,13 @@ uint16_t sn_coap_builder_calc_needed_packet_data_size_2(sn_coap_hdr_s *src_coap_
 
     /* If else than Reset message because Reset message must be empty */
     if (src_coap_msg_ptr->msg_type != COAP_MSG_TYPE_RESET) {
-        uint16_t repeatable_option_size = 0;
-        /* TOKEN - Length is 1-8 bytes */
-        if (src_coap_msg_ptr->token_ptr != NULL) {
-            if (src_coap_msg_ptr->token_len > 8 || src_coap_msg_ptr->token_len < 1) { /* Check that option is not longer than defined */
-                return 0;
-            }
-
-            returned_byte_count += src_coap_msg_ptr->token_len;
-        }
-        /* URI PATH - Repeatable option. Length of one option is 0-255 */
-        /* Do not add uri-path for notification message.
-         * Uri-path is needed for cancelling observation with RESET message */
-        if (!src_coap_msg_ptr->options_list_ptr ||
-                (src_coap_msg_ptr->options_list_ptr &&
-                 COAP_OBSERVE_NONE == src_coap_msg_ptr->options_list_ptr->observe)) {
-            if (src_coap_msg_ptr->uri_path_ptr != NULL) {
-                repeatable_option_size = sn_coap_builder_options_calc_option_size(src_coap_msg_ptr->uri_path_len,
-                                         src_coap_msg_ptr->uri_path_ptr, COAP_OPTION_URI_PATH);
-                if (repeatable_option_size) {
-                    returned_byte_count += repeatable_option_size;
-                } else {
-                    return 0;
-                }
-            }
-        }
-        uint16_t tempInt = 0;
-        /* CONTENT FORMAT - An integer option, up to 2 bytes */
-        if (src_coap_msg_ptr->content_format != COAP_CT_NONE) {
-            if ((uint32_t) src_coap_msg_ptr->content_format > 0xffff) {
-                return 0;
-            }
-
-            returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->content_format, COAP_OPTION_CONTENT_FORMAT, &tempInt);
+        /* Options are sized by the same code that builds them, without writing anything */
+        int16_t options_size = sn_coap_builder_options_build(NULL, src_coap_msg_ptr);
+        if (options_size < 0) {
+            return 0;
         }
-        /* If options list pointer exists */
-        if (src_coap_msg_ptr->options_list_ptr != NULL) {
-            /* ACCEPT - An integer option, up to 2 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->accept != COAP_CT_NONE) {
-                if ((uint32_t) src_coap_msg_ptr->options_list_ptr->accept > 0xffff) {
-                    return 0;
-                }
-
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->accept, COAP_OPTION_ACCEPT, &tempInt);
-            }
-            /* MAX AGE - An integer option, omitted for default. Up to 4 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->max_age != COAP_OPTION_MAX_AGE_DEFAULT) {
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->max_age, COAP_OPTION_MAX_AGE, &tempInt);
-            }
-            /* PROXY URI - Length of this option is  1-1034 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->proxy_uri_ptr != NULL) {
-                if (src_coap_msg_ptr->options_list_ptr->proxy_uri_len >= 1 && src_coap_msg_ptr->options_list_ptr->proxy_uri_len <= 12) {            /* Add option header byte(s) - depending of option length */
-                    returned_byte_count++;
-                }
-
-                else if (src_coap_msg_ptr->options_list_ptr->proxy_uri_len >= 13 && src_coap_msg_ptr->options_list_ptr->proxy_uri_len <= 269) {
-                    returned_byte_count += 2;
-                }
-
-                else if (src_coap_msg_ptr->options_list_ptr->proxy_uri_len >= 270 && src_coap_msg_ptr->options_list_ptr->proxy_uri_len <= 1034) {
-                    returned_byte_count += 3;
-                }
-
-                else {
-                    return 0;
-                }
-
-                /* Add needed memory for Option value */
-                returned_byte_count += src_coap_msg_ptr->options_list_ptr->proxy_uri_len;
-            }
-            /* ETAG - Repeatable option. Length of this option is 1-8 bytes*/
-            if (src_coap_msg_ptr->options_list_ptr->etag_ptr != NULL) {
-                repeatable_option_size = sn_coap_builder_options_calc_option_size(src_coap_msg_ptr->options_list_ptr->etag_len,
-                                         src_coap_msg_ptr->options_list_ptr->etag_ptr, COAP_OPTION_ETAG);
-                if (repeatable_option_size) {
-                    returned_byte_count += repeatable_option_size;
-                } else {
-                    return 0;
-                }
-            }
-            /* URI HOST - Length of this option is 1-255 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->uri_host_ptr != NULL) {
-                if (src_coap_msg_ptr->options_list_ptr->uri_host_len > 0 && src_coap_msg_ptr->options_list_ptr->uri_host_len <= 12) {
-                    returned_byte_count++;
-                }
-
-                else if (src_coap_msg_ptr->options_list_ptr->uri_host_len >= 13 && src_coap_msg_ptr->options_list_ptr->uri_host_len <= 255) {
-                    returned_byte_count += 2;
-                }
-
-                else {
-                    return 0;
-                }
+        returned_byte_count += options_size;
 
-                returned_byte_count += src_coap_msg_ptr->options_list_ptr->uri_host_len;
-            }
-            /* LOCATION PATH - Repeatable option. Length of this option is 0-255 bytes*/
-            if (src_coap_msg_ptr->options_list_ptr->location_path_ptr != NULL) {
-                repeatable_option_size = sn_coap_builder_options_calc_option_size(src_coap_msg_ptr->options_list_ptr->location_path_len,
-                                         src_coap_msg_ptr->options_list_ptr->location_path_ptr, COAP_OPTION_LOCATION_PATH);
-                if (repeatable_option_size) {
-                    returned_byte_count += repeatable_option_size;
-                } else {
-                    return 0;
-                }
-            }
-            /* URI PORT - An integer option, up to 2 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->uri_port != COAP_OPTION_URI_PORT_NONE) {
-                if ((uint32_t) src_coap_msg_ptr->options_list_ptr->uri_port > 0xffff) {
-                    return 0;
-                }
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->uri_port, COAP_OPTION_URI_PORT, &tempInt);
-            }
-            /* lOCATION QUERY - Repeatable option. Length of this option is 0-255 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->location_query_ptr != NULL) {
-                repeatable_option_size = sn_coap_builder_options_calc_option_size(src_coap_msg_ptr->options_list_ptr->location_query_len,
-                                         src_coap_msg_ptr->options_list_ptr->location_query_ptr, COAP_OPTION_LOCATION_QUERY);
-                if (repeatable_option_size) {
-                    returned_byte_count += repeatable_option_size;
-                } else {
-                    return 0;
-                }
-            }
-            /* OBSERVE - An integer option, up to 3 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->observe != COAP_OBSERVE_NONE) {
-                if ((uint32_t) src_coap_msg_ptr->options_list_ptr->observe > 0xffffff) {
-                    return 0;
-                }
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->observe, COAP_OPTION_OBSERVE, &tempInt);
-            }
-            /* URI QUERY - Repeatable option. Length of this option is 1-255 */
-            if (src_coap_msg_ptr->options_list_ptr->uri_query_ptr != NULL) {
-                repeatable_option_size = sn_coap_builder_options_calc_option_size(src_coap_msg_ptr->options_list_ptr->uri_query_len,
-                                         src_coap_msg_ptr->options_list_ptr->uri_query_ptr, COAP_OPTION_URI_QUERY);
-                if (repeatable_option_size) {
-                    returned_byte_count += repeatable_option_size;
-                } else {
-                    return 0;
-                }
-            }
-
-            /* BLOCK 1 - An integer option, up to 3 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->block1 != COAP_OPTION_BLOCK_NONE) {
-                if ((uint32_t) src_coap_msg_ptr->options_list_ptr->block1 > 0xffffff) {
-                    return 0;
-                }
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->block1, COAP_OPTION_BLOCK1, &tempInt);
-            }
-            /* SIZE1 - Length of this option is 0-4 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->use_size1) {
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->size1, COAP_OPTION_SIZE1, &tempInt);
-            }
-            /* BLOCK 2 - An integer option, up to 3 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->block2 != COAP_OPTION_BLOCK_NONE) {
-                if ((uint32_t) src_coap_msg_ptr->options_list_ptr->block2 > 0xffffff) {
-                    return 0;
-                }
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->block2, COAP_OPTION_BLOCK2, &tempInt);
-            }
-            /* SIZE2 - Length of this option is 0-4 bytes */
-            if (src_coap_msg_ptr->options_list_ptr->use_size2) {
-                returned_byte_count += sn_coap_builder_options_build_add_uint_option(NULL, src_coap_msg_ptr->options_list_ptr->size2, COAP_OPTION_SIZE2, &tempInt);
-            }
-        }
 #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE
         if ((src_coap_msg_ptr->payload_len > blockwise_payload_size) && (blockwise_payload_size > 0)) {
             returned_byte_count += blockwise_payload_size;
@@ -339,139 +178,9 @@ uint16_t sn_coap_builder_calc_needed_packet_data_size_2(sn_coap_hdr_s *src_coap_
         if (src_coap_msg_ptr->payload_len) {
             returned_byte_count ++;    /* For payload marker */
         }
-        returned_byte_count += sn_coap_builder_options_calculate_jump_need(src_coap_msg_ptr/*, 0*/);
     }
     return returned_byte_count;
 }
-/**
- * \fn static uint8_t sn_coap_builder_options_calculate_jump_need(sn_coap_hdr_s *src_coap_msg_ptr, uint8_t block_option)
- *
- * \brief Checks if there is need for option jump
- *
- * \param  *src_coap_msg_ptr is source of checked CoAP message
- *
- * \param  block option marks if block option is to be added to message later. 0 = no block option, 1 = block1 and 2 = block2
- *
- * \return Returns bytes needed for jumping
- */
-
-static uint8_t sn_coap_builder_options_calculate_jump_need(sn_coap_hdr_s *src_coap_msg_ptr/*, uint8_t block_option*/)
-{
-    uint8_t previous_option_number = 0;
-    uint8_t needed_space           = 0;
-
-    if (src_coap_msg_ptr->options_list_ptr != NULL) {
-        /* If option numbers greater than 12 is not used, then jumping is not needed */
-        //TODO: Check if this is really needed! Does it enhance perf? If not -> remove
-        if (!src_coap_msg_ptr->options_list_ptr->uri_query_ptr       &&
-                src_coap_msg_ptr->options_list_ptr->accept == COAP_CT_NONE &&
-                !src_coap_msg_ptr->options_list_ptr->location_query_ptr &&
-                src_coap_msg_ptr->options_list_ptr->block2 == COAP_OPTION_BLOCK_NONE &&
-                src_coap_msg_ptr->options_list_ptr->block1 == COAP_OPTION_BLOCK_NONE &&
-                !src_coap_msg_ptr->options_list_ptr->proxy_uri_ptr      &&
-                src_coap_msg_ptr->options_list_ptr->max_age == COAP_OPTION_MAX_AGE_DEFAULT &&
-                !src_coap_msg_ptr->options_list_ptr->use_size1          &&
-                !src_coap_msg_ptr->options_list_ptr->use_size2) {
-            return 0;
-        }
-
-        if (src_coap_msg_ptr->options_list_ptr->uri_host_ptr != NULL) {
-            previous_option_number = (COAP_OPTION_URI_HOST);
-        }
-
-        if (src_coap_msg_ptr->options_list_ptr->etag_ptr != NULL) {
-            previous_option_number = (COAP_OPTION_ETAG);
-        }
-
-        if (src_coap_msg_ptr->options_list_ptr->observe != COAP_OBSERVE_NONE) {
-            previous_option_number = (COAP_OPTION_OBSERVE);
-        }
-
-        if (src_coap_msg_ptr->options_list_ptr->uri_port != COAP_OPTION_URI_PORT_NONE) {
-            previous_option_number = (COAP_OPTION_URI_PORT);
-        }
-
-        if (src_coap_msg_ptr->options_list_ptr->location_path_ptr != NULL) {
-            previous_option_number = (COAP_OPTION_LOCATION_PATH);
-        }
-
-        if (src_coap_msg_ptr->uri_path_ptr != NULL) {
-            previous_option_number = (COAP_OPTION_URI_PATH);
-        }
-        if (src_coap_msg_ptr->content_format != COAP_CT_NONE) {
-            previous_option_number = (COAP_OPTION_CONTENT_FORMAT);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->max_age != COAP_OPTION_MAX_AGE_DEFAULT) {
-            if ((COAP_OPTION_MAX_AGE - previous_option_number) > 12) {
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_MAX_AGE);
-        }
-
-        if (src_coap_msg_ptr->options_list_ptr->uri_query_ptr != NULL) {
-            if ((COAP_OPTION_URI_QUERY - previous_option_number) > 12) {
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_URI_QUERY);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->accept != COAP_CT_NONE) {
-            if ((COAP_OPTION_ACCEPT - previous_option_number) > 12) {
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_ACCEPT);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->location_query_ptr != NULL) {
-            if ((COAP_OPTION_LOCATION_QUERY - previous_option_number) > 12) {
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_LOCATION_QUERY);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->block2 != COAP_OPTION_BLOCK_NONE) {
-            if ((COAP_OPTION_BLOCK2 - previous_option_number) > 12 ){
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_BLOCK2);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->block1 != COAP_OPTION_BLOCK_NONE) {
-            if ((COAP_OPTION_BLOCK1 - previous_option_number) > 12 ){
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_BLOCK1);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->use_size2) {
-            if ((COAP_OPTION_SIZE2 - previous_option_number) > 12) {
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_SIZE2);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->proxy_uri_ptr != NULL) {
-            if ((COAP_OPTION_PROXY_URI - previous_option_number) > 12) {
-                needed_space += 1;
-            }
-            if ((COAP_OPTION_PROXY_URI - previous_option_number) > 269) { //Can not happen
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_PROXY_URI);
-        }
-        if (src_coap_msg_ptr->options_list_ptr->use_size1 ) {
-            if ((COAP_OPTION_SIZE1 - previous_option_number) > 12) {
-                needed_space += 1;
-            }
-            previous_option_number = (COAP_OPTION_SIZE1);
-        }
-    }
-
-    else {
-        if (src_coap_msg_ptr->uri_path_ptr != 0) {
-            previous_option_number = (COAP_OPTION_URI_PATH);
-        }
-
-        if (src_coap_msg_ptr->content_format != COAP_CT_NONE) {
-            previous_option_number = (COAP_OPTION_CONTENT_FORMAT);
-        }
-    }
-    return needed_space;
-}
 
 /**
  * \fn static int8_t sn_coap_builder_header_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr)
@@ -516,29 +225,45 @@ static int8_t sn_coap_builder_header_build(uint8_t **dst_packet_data_pptr, sn_co
 }
 
 /**
- * \fn static int8_t sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr)
+ * \fn static int16_t sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr)
  *
  * \brief Builds Options part of Packet data
  *
- * \param **dst_packet_data_pptr is destination for built Packet data
+ * Same function is used for calculating the size of the Options part: when
+ * \p dst_packet_data_pptr is NULL, nothing is written and only the size is returned.
+ *
+ * \param **dst_packet_data_pptr is destination for built Packet data, NULL to compute size only
  *
  * \param *src_coap_msg_ptr is source for building Packet data
  *
- * \return Return value is 0 in every case
+ * \return Return value is size of Options part (including Token), or -1 if some option is invalid
  */
-static int8_t sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr)
+static int16_t sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr)
 {
+    sn_coap_options_list_s *options_ptr = src_coap_msg_ptr->options_list_ptr;
+    int16_t ret_value = 0;
+    int16_t repeatable_option_size;
+
     /* * * * Check if Options are used at all  * * * */
     if (src_coap_msg_ptr->uri_path_ptr == NULL && src_coap_msg_ptr->token_ptr == NULL &&
-            src_coap_msg_ptr->content_format == COAP_CT_NONE && src_coap_msg_ptr->options_list_ptr == NULL) {
+            src_coap_msg_ptr->content_format == COAP_CT_NONE && options_ptr == NULL) {
         return 0;
     }
 
     /* * * * First add Token option  * * * */
-    if (src_coap_msg_ptr->token_len && src_coap_msg_ptr->token_ptr) {
-        memcpy(*dst_packet_data_pptr, src_coap_msg_ptr->token_ptr, src_coap_msg_ptr->token_len);
+    if (src_coap_msg_ptr->token_ptr != NULL) {
+        /* TOKEN - Length is 1-8 bytes */
+        if (src_coap_msg_ptr->token_len > 8 || src_coap_msg_ptr->token_len < 1) {
+            return -1;
+        }
+        if (dst_packet_data_pptr) {
+            memcpy(*dst_packet_data_pptr, src_coap_msg_ptr->token_ptr, src_coap_msg_ptr->token_len);
+        }
+    }
+    if (dst_packet_data_pptr) {
+        (*dst_packet_data_pptr) += src_coap_msg_ptr->token_len;
     }
-    (*dst_packet_data_pptr) += src_coap_msg_ptr->token_len;
+    ret_value += src_coap_msg_ptr->token_len;
 
     /* Then build rest of the options */
 
@@ -548,109 +273,161 @@ static int8_t sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_c
     //missing: COAP_OPTION_IF_MATCH, COAP_OPTION_IF_NONE_MATCH, COAP_OPTION_SIZE
 
     /* Check if less used options are used at all */
-    if (src_coap_msg_ptr->options_list_ptr != NULL) {
+    if (options_ptr != NULL) {
         /* * * * Build Uri-Host option * * * */
-        sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->uri_host_len,
-                     src_coap_msg_ptr->options_list_ptr->uri_host_ptr, COAP_OPTION_URI_HOST, &previous_option_number);
+        /* URI HOST - Length of this option is 1-255 bytes */
+        if (options_ptr->uri_host_ptr != NULL &&
+                (options_ptr->uri_host_len < 1 || options_ptr->uri_host_len > 255)) {
+            return -1;
+        }
+        ret_value += sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, options_ptr->uri_host_len,
+                     options_ptr->uri_host_ptr, COAP_OPTION_URI_HOST, &previous_option_number);
 
         /* * * * Build ETag option  * * * */
-        sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, &src_coap_msg_ptr->options_list_ptr->etag_ptr,
-                     (uint16_t *)&src_coap_msg_ptr->options_list_ptr->etag_len, COAP_OPTION_ETAG, &previous_option_number);
+        repeatable_option_size = sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, options_ptr->etag_ptr,
+                                 options_ptr->etag_len, COAP_OPTION_ETAG, &previous_option_number);
+        if (repeatable_option_size < 0) {
+            return -1;
+        }
+        ret_value += repeatable_option_size;
 
         /* * * * Build Observe option  * * * * */
-        if (src_coap_msg_ptr->options_list_ptr->observe != COAP_OBSERVE_NONE) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->observe,
+        if (options_ptr->observe != COAP_OBSERVE_NONE) {
+            /* OBSERVE - An integer option, up to 3 bytes */
+            if ((uint32_t) options_ptr->observe > 0xffffff) {
+                return -1;
+            }
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->observe,
                          COAP_OPTION_OBSERVE, &previous_option_number);
         }
 
         /* * * * Build Uri-Port option * * * */
-        if (src_coap_msg_ptr->options_list_ptr->uri_port != COAP_OPTION_URI_PORT_NONE) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->uri_port,
+        if (options_ptr->uri_port != COAP_OPTION_URI_PORT_NONE) {
+            /* URI PORT - An integer option, up to 2 bytes */
+            if ((uint32_t) options_ptr->uri_port > 0xffff) {
+                return -1;
+            }
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->uri_port,
                          COAP_OPTION_URI_PORT, &previous_option_number);
         }
 
         /* * * * Build Location-Path option  * * * */
-        sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, &src_coap_msg_ptr->options_list_ptr->location_path_ptr,
-                     &src_coap_msg_ptr->options_list_ptr->location_path_len, COAP_OPTION_LOCATION_PATH, &previous_option_number);
+        repeatable_option_size = sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, options_ptr->location_path_ptr,
+                                 options_ptr->location_path_len, COAP_OPTION_LOCATION_PATH, &previous_option_number);
+        if (repeatable_option_size < 0) {
+            return -1;
+        }
+        ret_value += repeatable_option_size;
     }
     /* * * * Build Uri-Path option * * * */
     /* Do not add uri-path for notification message.
      * Uri-path is needed for cancelling observation with RESET message */
-    if (!src_coap_msg_ptr->options_list_ptr ||
-            (src_coap_msg_ptr->options_list_ptr &&
-             COAP_OBSERVE_NONE == src_coap_msg_ptr->options_list_ptr->observe))
-        sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, &src_coap_msg_ptr->uri_path_ptr,
-                 &src_coap_msg_ptr->uri_path_len, COAP_OPTION_URI_PATH, &previous_option_number);
+    if (!options_ptr || COAP_OBSERVE_NONE == options_ptr->observe) {
+        repeatable_option_size = sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, src_coap_msg_ptr->uri_path_ptr,
+                                 src_coap_msg_ptr->uri_path_len, COAP_OPTION_URI_PATH, &previous_option_number);
+        if (repeatable_option_size < 0) {
+            return -1;
+        }
+        ret_value += repeatable_option_size;
+    }
 
     /* * * * Build Content-Type option * * * */
     if (src_coap_msg_ptr->content_format != COAP_CT_NONE) {
-        sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->content_format,
+        /* CONTENT FORMAT - An integer option, up to 2 bytes */
+        if ((uint32_t) src_coap_msg_ptr->content_format > 0xffff) {
+            return -1;
+        }
+        ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->content_format,
                      COAP_OPTION_CONTENT_FORMAT, &previous_option_number);
     }
 
-    if (src_coap_msg_ptr->options_list_ptr != NULL) {
+    if (options_ptr != NULL) {
         /* * * * Build Max-Age option  * * * */
-        if (src_coap_msg_ptr->options_list_ptr->max_age != COAP_OPTION_MAX_AGE_DEFAULT) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->max_age,
+        if (options_ptr->max_age != COAP_OPTION_MAX_AGE_DEFAULT) {
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->max_age,
                          COAP_OPTION_MAX_AGE, &previous_option_number);
         }
 
         /* * * * Build Uri-Query option  * * * * */
-        sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, &src_coap_msg_ptr->options_list_ptr->uri_query_ptr,
-                     &src_coap_msg_ptr->options_list_ptr->uri_query_len, COAP_OPTION_URI_QUERY, &previous_option_number);
+        repeatable_option_size = sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, options_ptr->uri_query_ptr,
+                                 options_ptr->uri_query_len, COAP_OPTION_URI_QUERY, &previous_option_number);
+        if (repeatable_option_size < 0) {
+            return -1;
+        }
+        ret_value += repeatable_option_size;
 
         /* * * * Build Accept option  * * * * */
-        if (src_coap_msg_ptr->options_list_ptr->accept != COAP_CT_NONE) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->accept,
+        if (options_ptr->accept != COAP_CT_NONE) {
+            /* ACCEPT - An integer option, up to 2 bytes */
+            if ((uint32_t) options_ptr->accept > 0xffff) {
+                return -1;
+            }
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->accept,
                          COAP_OPTION_ACCEPT, &previous_option_number);
         }
-    }
 
-    if (src_coap_msg_ptr->options_list_ptr != NULL) {
         /* * * * Build Location-Query option * * * */
-        sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, &src_coap_msg_ptr->options_list_ptr->location_query_ptr,
-                     &src_coap_msg_ptr->options_list_ptr->location_query_len, COAP_OPTION_LOCATION_QUERY, &previous_option_number);
+        repeatable_option_size = sn_coap_builder_options_build_add_multiple_option(dst_packet_data_pptr, options_ptr->location_query_ptr,
+                                 options_ptr->location_query_len, COAP_OPTION_LOCATION_QUERY, &previous_option_number);
+        if (repeatable_option_size < 0) {
+            return -1;
+        }
+        ret_value += repeatable_option_size;
 
         /* * * * Build Block2 option * * * * */
-        if (src_coap_msg_ptr->options_list_ptr->block2 != COAP_OPTION_BLOCK_NONE) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->block2,
+        if (options_ptr->block2 != COAP_OPTION_BLOCK_NONE) {
+            /* BLOCK 2 - An integer option, up to 3 bytes */
+            if ((uint32_t) options_ptr->block2 > 0xffffff) {
+                return -1;
+            }
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->block2,
                          COAP_OPTION_BLOCK2, &previous_option_number);
         }
 
         /* * * * Build Block1 option * * * * */
-        if (src_coap_msg_ptr->options_list_ptr->block1 != COAP_OPTION_BLOCK_NONE) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->block1,
+        if (options_ptr->block1 != COAP_OPTION_BLOCK_NONE) {
+            /* BLOCK 1 - An integer option, up to 3 bytes */
+            if ((uint32_t) options_ptr->block1 > 0xffffff) {
+                return -1;
+            }
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->block1,
                          COAP_OPTION_BLOCK1, &previous_option_number);
         }
 
         /* * * * Build Size2 option * * * */
-        if (src_coap_msg_ptr->options_list_ptr->use_size2) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->size2,
+        if (options_ptr->use_size2) {
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->size2,
                          COAP_OPTION_SIZE2, &previous_option_number);
         }
 
         /* * * * Build Proxy-Uri option * * * */
-        sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->proxy_uri_len,
-                     src_coap_msg_ptr->options_list_ptr->proxy_uri_ptr, COAP_OPTION_PROXY_URI, &previous_option_number);
+        /* PROXY URI - Length of this option is  1-1034 bytes */
+        if (options_ptr->proxy_uri_ptr != NULL &&
+                (options_ptr->proxy_uri_len < 1 || options_ptr->proxy_uri_len > 1034)) {
+            return -1;
+        }
+        ret_value += sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, options_ptr->proxy_uri_len,
+                     options_ptr->proxy_uri_ptr, COAP_OPTION_PROXY_URI, &previous_option_number);
 
 
         /* * * * Build Size1 option * * * */
-        if (src_coap_msg_ptr->options_list_ptr->use_size1) {
-            sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, src_coap_msg_ptr->options_list_ptr->size1,
+        if (options_ptr->use_size1) {
+            ret_value += sn_coap_builder_options_build_add_uint_option(dst_packet_data_pptr, options_ptr->size1,
                          COAP_OPTION_SIZE1, &previous_option_number);
         }
     }
 
     /* Success */
-    return 0;
+    return ret_value;
 }
 
 /**
- * \fn static int16_t sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet_data_pptr, uint16_t option_value_len, uint8_t *option_value_ptr, sn_coap_option_numbers_e option_number)
+ * \fn static uint16_t sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet_data_pptr, uint16_t option_value_len, uint8_t *option_value_ptr, sn_coap_option_numbers_e option_number)
  *
  * \brief Adds Options part of Packet data
  *
- * \param **dst_packet_data_pptr is destination for built Packet data
+ * \param **dst_packet_data_pptr is destination for built Packet data; NULL
+ *        to compute size only.
  *
  * \param option_value_len is Option value length to be added
  *
@@ -658,16 +435,29 @@ static int8_t sn_coap_builder_options_build(uint8_t **dst_packet_data_pptr, sn_c
  *
  * \param option_number is Option number to be added
  *
- * \return Return value is 0 if option was not added, 1 if added
+ * \return Return value is total option size, 0 if option was not added
  */
-static int16_t sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet_data_pptr, uint16_t option_len,
+static uint16_t sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet_data_pptr, uint16_t option_len,
         uint8_t *option_ptr, sn_coap_option_numbers_e option_number, uint16_t *previous_option_number)
 {
     /* Check if there is option at all */
     if (option_ptr != NULL) {
         uint16_t option_delta;
+        uint16_t header_len = 1;
 
         option_delta = (option_number - *previous_option_number);
+        *previous_option_number = option_number;
+
+        if (option_delta > 12) {
+            header_len += (option_delta < 269) ? 1 : 2;
+        }
+        if (option_len > 12) {
+            header_len += (option_len < 269) ? 1 : 2;
+        }
+
+        if (!dst_packet_data_pptr) {
+            return header_len + option_len;
+        }
 
         /* * * Build option header * * */
 
@@ -719,15 +509,13 @@ static int16_t sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet
             *dst_packet_data_pptr += 2;
         }
 
-        *previous_option_number = option_number;
-
         /* Write Option value */
         memcpy(*dst_packet_data_pptr, option_ptr, option_len);
 
         /* Increase destination Packet data pointer */
         (*dst_packet_data_pptr) += option_len;
 
-        return 1;
+        return header_len + option_len;
     }
 
     /* Success */
@@ -744,7 +532,7 @@ static int16_t sn_coap_builder_options_build_add_one_option(uint8_t **dst_packet
  *
  * \param option_number is Option number to be added
  *
- * \return Return value is total option size, or -1 in write failure case
+ * \return Return value is total option size
  */
 static uint8_t sn_coap_builder_options_build_add_uint_option(uint8_t **dst_packet_data_pptr, uint32_t option_value, sn_coap_option_numbers_e option_number, uint16_t *previous_option_number)
 {
@@ -758,297 +546,90 @@ static uint8_t sn_coap_builder_options_build_add_uint_option(uint8_t **dst_packe
         option_value <<= 8;
     }
 
-    /* If output pointer isn't NULL, write it out */
-    if (dst_packet_data_pptr) {
-        int16_t ret = sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, len, payload, option_number, previous_option_number);
-        /* Allow for failure returns when writing (why even permit failure returns?) */
-        if (ret < 0) {
-            return ret;
-        }
-    }
-
     /* Return the total option size */
-    return 1 + len;
+    return sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, len, payload, option_number, previous_option_number);
 }
 
 /**
- * \fn static int16_t sn_coap_builder_options_build_add_multiple_option(uint8_t **dst_packet_data_pptr, uint8_t **src_pptr, uint16_t *src_len_ptr, sn_coap_option_numbers_e option)
- *
- * \brief Builds Option Uri-Query from given CoAP Header structure to Packet data
- *
- * \param **dst_packet_data_pptr is destination for built Packet data
- *
- * \param uint8_t **src_pptr
+ * \fn static int16_t sn_coap_builder_options_build_add_multiple_option(uint8_t **dst_packet_data_pptr, uint8_t *src_ptr, uint16_t src_len, sn_coap_option_numbers_e option, uint16_t *previous_option_number)
  *
- *  \param uint16_t *src_len_ptr
+ * \brief Builds repeatable Option (Uri-Path, Uri-Query, ETag...) from given option string to Packet data
  *
- *  \paramsn_coap_option_numbers_e option option to be added
+ * Option string is split to parts in a single pass; a leading separator (or
+ * '\0') and a trailing separator do not start a new part. Parts are
+ * separated by '/' for paths and by '&' for other options.
  *
- * \return Return value is 0 always
- */
-static int16_t sn_coap_builder_options_build_add_multiple_option(uint8_t **dst_packet_data_pptr, uint8_t **src_pptr, uint16_t *src_len_ptr, sn_coap_option_numbers_e option, uint16_t *previous_option_number)
-{
-    /* Check if there is option at all */
-    if (*src_pptr != NULL) {
-        uint8_t    *query_ptr               = *src_pptr;
-        uint8_t     query_part_count        = 0;
-        uint16_t    query_len               = *src_len_ptr;
-        uint8_t     i                       = 0;
-        uint16_t    query_part_offset       = 0;
-
-        /* Get query part count */
-        query_part_count = sn_coap_builder_options_get_option_part_count(query_len, query_ptr, option);
-
-        /* * * * Options by adding all parts to option * * * */
-        for (i = 0; i < query_part_count; i++) {
-            /* Get length of query part */
-            uint16_t one_query_part_len = sn_coap_builder_options_get_option_part_length_from_whole_option_string(query_len, query_ptr, i, option);
-
-            /* Get position of query part */
-            query_part_offset = sn_coap_builder_options_get_option_part_position(query_len, query_ptr, i, option);
-
-            /* Add Uri-query's one part to Options */
-            sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, one_query_part_len, *src_pptr + query_part_offset, option, previous_option_number);
-        }
-    }
-    /* Success */
-    return 0;
-}
-
-
-/**
- * \fn static uint16_t sn_coap_builder_options_calc_option_size(uint16_t query_len, uint8_t *query_ptr, sn_coap_option_numbers_e option)
- *
- * \brief Calculates needed Packet data memory size for option
- *
- * \param path_len is length of calculated strting(s)
- *
- * \param *path_ptr is pointer to calculated options
- *
- * \return Return value is count of needed memory as bytes for Uri-query option
- */
-static uint16_t sn_coap_builder_options_calc_option_size(uint16_t query_len, uint8_t *query_ptr, sn_coap_option_numbers_e option)
-{
-    uint8_t     query_part_count    = sn_coap_builder_options_get_option_part_count(query_len, query_ptr, option);
-    uint8_t     i                   = 0;
-    uint16_t    ret_value           = 0;
-
-    /* * * * * * * * * * * * * * * * * * * * * * * * */
-    /* * * * Calculate Uri-query options length  * * */
-    /* * * * * * * * * * * * * * * * * * * * * * * * */
-    for (i = 0; i < query_part_count; i++) {
-        /* * * Length of Option number and Option value length * * */
-
-        /* Get length of Query part */
-        uint16_t one_query_part_len = sn_coap_builder_options_get_option_part_length_from_whole_option_string(query_len, query_ptr, i, option);
-
-        /* Check option length */
-        switch (option) {
-            case (COAP_OPTION_ETAG):            /* Length 1-8 */
-                if (one_query_part_len < 1 || one_query_part_len > 8) {
-                    return 0;
-                }
-                break;
-            case (COAP_OPTION_LOCATION_PATH):   /* Length 0-255 */
-            case (COAP_OPTION_URI_PATH):        /* Length 0-255 */
-            case (COAP_OPTION_LOCATION_QUERY):  /* Length 0-255 */
-                if (one_query_part_len > 255) {
-                    return 0;
-                }
-                break;
-            case (COAP_OPTION_URI_QUERY):       /* Length 1-255 */
-                if (one_query_part_len < 1 || one_query_part_len > 255) {
-                    return 0;
-                }
-                break;
-//            case (COAP_OPTION_ACCEPT):          /* Length 0-2 */
-//                if (one_query_part_len > 2) {
-//                    return 0;
-//                }
-//                break;
-            default:
-                break; //impossible scenario currently
-        }
-
-        /* Check if 4 bits are enough for writing Option value length */
-        if (one_query_part_len <= 12) {
-            /* 4 bits are enough for Option value length */
-            ret_value++;
-        } else if (one_query_part_len >= 13 && one_query_part_len < 269) {
-            /* Extra byte for Option value length is needed */
-            ret_value += 2;
-        }
-        //This can only happen if we are in default case above, currently is not happening
-        else if (one_query_part_len >= 270 && one_query_part_len < 1034) {
-            /* Extra bytes for Option value length is needed */
-            ret_value += 3;
-        }
-
-
-        /* * * Length of Option value * * */
-
-        /* Increase options length */
-        ret_value += one_query_part_len;
-    }
-
-    /* Success */
-    return ret_value;
-}
-
-
-
-/**
- * \fn static uint8_t sn_coap_builder_options_get_option_part_count(uint16_t query_len, uint8_t *query_ptr, sn_coap_option_numbers_e option)
+ * \param **dst_packet_data_pptr is destination for built Packet data; NULL
+ *        to compute size only.
  *
- * \brief Gets query part count from whole option string
+ * \param *src_ptr is pointer to the whole option string, NULL if option is not used
  *
- * \param query_len is length of whole Path
+ * \param src_len is length of the whole option string
  *
- * \param *query_ptr is pointer to the start of whole Path
+ * \param option is option number of the parts to be added
  *
- * \return Return value is count of query parts
+ * \return Return value is total size of all added parts, or -1 if some part has invalid length
  */
-static uint8_t sn_coap_builder_options_get_option_part_count(uint16_t query_len, uint8_t *query_ptr, sn_coap_option_numbers_e option)
+static int16_t sn_coap_builder_options_build_add_multiple_option(uint8_t **dst_packet_data_pptr, uint8_t *src_ptr, uint16_t src_len, sn_coap_option_numbers_e option, uint16_t *previous_option_number)
 {
-    uint8_t  returned_query_count = 0;
-    uint16_t query_len_index      = 0;
-    uint8_t  char_to_search       = '&';
+    int16_t ret_value = 0;
 
-    if (option == COAP_OPTION_URI_PATH || option == COAP_OPTION_LOCATION_PATH) {
-        char_to_search = '/';
-    }
+    /* Check if there is option at all */
+    if (src_ptr != NULL) {
+        uint8_t  char_to_search = '&';
+        uint8_t *part_ptr       = src_ptr;
+        uint8_t *end_ptr        = src_ptr + src_len;
+        uint8_t *separator_ptr;
 
-    /* Loop whole query and search '\0' characters (not first and last char) */
-    for (query_len_index = 1; query_len_index < query_len - 1; query_len_index++) {
-        /* If new query part starts */
-        if (*(query_ptr + query_len_index) == char_to_search) { /* If match */
-            returned_query_count++;
+        if (option == COAP_OPTION_URI_PATH || option == COAP_OPTION_LOCATION_PATH) {
+            char_to_search = '/';
         }
-    }
 
-    returned_query_count++;
-
-    return returned_query_count;
-}
-
-/**
- * \fn static uint16_t sn_coap_builder_options_get_option_part_length_from_whole_option_string(uint16_t query_len,
-                                                                             uint8_t *query_ptr,
-                                                                             uint8_t query_index, sn_coap_option_numbers_e option)
- *
- * \brief Gets one's query part length from whole query string
- *
- * \param query_len is length of whole string
- *
- * \param *query_ptr is pointer to the start of whole string
- *
- * \param query_index is query part index to be found
- *
- * \param sn_coap_option_numbers_e option is option number of the option
- *
- * \return Return value is length of query part
- */
-static uint16_t sn_coap_builder_options_get_option_part_length_from_whole_option_string(uint16_t query_len, uint8_t *query_ptr,
-        uint8_t query_index, sn_coap_option_numbers_e option)
-{
-    uint16_t returned_query_part_len = 0;
-    uint8_t  temp_query_index        = 0;
-    uint16_t query_len_index         = 0;
-    uint8_t  char_to_search          = '&';
-
-    if (option == COAP_OPTION_URI_PATH || option == COAP_OPTION_LOCATION_PATH) {
-        char_to_search = '/';
-    }
-
-    /* Loop whole query and search '\0' characters */
-    for (query_len_index = 0; query_len_index < query_len; query_len_index++) {
-        /* Store character to temp_char for helping debugging */
-        uint8_t temp_char = *query_ptr;
-
-        /* If new query part starts */
-        if (temp_char == char_to_search && returned_query_part_len > 0) { /* returned_query_part_len > 0 is for querys which start with "\0" */
-            /* If query part index is wanted */
-            if (temp_query_index == query_index) {
-                /* Return length of query part */
-                return returned_query_part_len;
-            } else {
-                /* Reset length of query part because wanted query part finding continues*/
-                returned_query_part_len = 0;
-            }
-
-            /* Next query part is looped */
-            temp_query_index++;
-        } else if (temp_char != char_to_search) { /* Else if query part continues */
-            /* Increase query part length */
-            returned_query_part_len++;
+        /* Leading and trailing separators are not part of any option */
+        if (src_len > 0 && (*part_ptr == 0 || *part_ptr == char_to_search)) {
+            part_ptr++;
         }
-
-        query_ptr++;
-    }
-
-    /* Return length of query part in cases that query part does not finish to '\0' character (last query part can be like that) */
-    return returned_query_part_len;
-}
-
-/**
- * \fn static uint16_t sn_coap_builder_options_get_option_part_position(uint16_t query_len,
-                                                               uint8_t *query_ptr,
-                                                               uint8_t query_index, sn_coap_option_numbers_e option)
- *
- * \brief Gets query part position in whole query
- *
- * \param query_len is length of whole query
- *
- * \param *query_ptr is pointer to the start of whole query
- *
- * \param query_index is query part index to be found
- *
- * \return Return value is position (= offset) of query part in whole query. In
- *         fail cases -1 is returned.
- */
-static int16_t sn_coap_builder_options_get_option_part_position(uint16_t query_len, uint8_t *query_ptr,
-        uint8_t query_index, sn_coap_option_numbers_e option)
-{
-    uint16_t returned_query_part_offset = 0;
-    uint8_t  temp_query_index           = 0;
-    uint16_t query_len_index            = 0;
-    uint8_t  char_to_search             = '&';
-
-    if (option == COAP_OPTION_URI_PATH || option == COAP_OPTION_LOCATION_PATH) {
-        char_to_search = '/';
-    }
-
-    if (query_index == 0) {
-        if (*query_ptr == 0 || *query_ptr == char_to_search) {
-            return 1;
-        } else {
-            return 0;
+        if (end_ptr > part_ptr && *(end_ptr - 1) == char_to_search) {
+            end_ptr--;
         }
-    }
 
-    /* Loop whole query and search separator characters */
-    for (query_len_index = 0; query_len_index < query_len; query_len_index++) {
-        /* Store character to temp_char for helping debugging */
-        uint8_t temp_char = *query_ptr;
-
-        /* If new query part starts */
-        if (temp_char == char_to_search && returned_query_part_offset > 0) { /* returned_query_part_offset > 0 is for querys which start with searched char */
-            /* If query part index is wanted */
-            if (temp_query_index == (query_index - 1)) {
-                /* Return offset of query part */
-                return (returned_query_part_offset + 1); /* Plus one is for passing separator */
+        /* * * * Options by adding all parts to option * * * */
+        do {
+            uint16_t part_len;
+
+            separator_ptr = memchr(part_ptr, char_to_search, end_ptr - part_ptr);
+            part_len = (separator_ptr ? separator_ptr : end_ptr) - part_ptr;
+
+            /* Check option length */
+            switch (option) {
+                case (COAP_OPTION_ETAG):            /* Length 1-8 */
+                    if (part_len < 1 || part_len > 8) {
+                        return -1;
+                    }
+                    break;
+                case (COAP_OPTION_URI_QUERY):       /* Length 1-255 */
+                    if (part_len < 1 || part_len > 255) {
+                        return -1;
+                    }
+                    break;
+                case (COAP_OPTION_LOCATION_PATH):   /* Length 0-255 */
+                case (COAP_OPTION_URI_PATH):        /* Length 0-255 */
+                case (COAP_OPTION_LOCATION_QUERY):  /* Length 0-255 */
+                default:
+                    if (part_len > 255) {
+                        return -1;
+                    }
+                    break;
             }
 
-            /* Next query part is looped */
-            temp_query_index++;
-        }
-
-        returned_query_part_offset++;
+            /* Add one part to Options */
+            ret_value += sn_coap_builder_options_build_add_one_option(dst_packet_data_pptr, part_len, part_ptr, option, previous_option_number);
 
-        query_ptr++;
+            part_ptr = separator_ptr + 1;
+        } while (separator_ptr);
     }
-
-    return -1; //Dead code?
+    /* Success */
+    return ret_value;
 }
 
 
@@ -48,6 +48,8 @@
 /* * * * * * * * * * * * * * * * * * * * */
 
 static void                  sn_coap_protocol_send_rst(struct coap_s *handle, uint16_t msg_id, sn_nsdl_addr_s *addr_ptr, void *param);
+static int16_t               sn_coap_protocol_build_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t *dst_packet_data_ptr, uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param);
+static void                  sn_coap_protocol_discard_built_packet(struct coap_s *handle, uint8_t *packet_data_ptr);
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT/* If Message duplication detection is not used at all, this part of code will not be compiled */
 static void                  sn_coap_protocol_linked_list_duplication_info_store(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
 static int8_t                sn_coap_protocol_linked_list_duplication_info_search(struct coap_s *handle, sn_nsdl_addr_s *scr_addr_ptr, uint16_t msg_id);
@@ -68,6 +70,7 @@ static sn_coap_hdr_s        *sn_coap_protocol_copy_header(struct coap_s *handle,
 #endif
 #if ENABLE_RESENDINGS
 static void                  sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint8_t *send_packet_data_ptr, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len);
+static coap_send_msg_s      *sn_coap_protocol_linked_list_send_msg_alloc(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len);
 static sn_nsdl_transmit_s   *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
 static void                  sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
 static coap_send_msg_s      *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t packet_data_len);
@@ -309,7 +312,8 @@ void sn_coap_protocol_clear_retransmission_buffer(struct coap_s *handle)
                 handle->sn_coap_protocol_free(tmp->send_msg_ptr->dst_addr_ptr);
                 tmp->send_msg_ptr->dst_addr_ptr = 0;
             }
-            if (tmp->send_msg_ptr->packet_ptr) {
+            /* Packet data still used by the caller is freed by sn_coap_protocol_release_packet() */
+            if (tmp->send_msg_ptr->packet_ptr && !tmp->packet_held) {
                 handle->sn_coap_protocol_free(tmp->send_msg_ptr->packet_ptr);
                 tmp->send_msg_ptr->packet_ptr = 0;
             }
@@ -392,15 +396,91 @@ int8_t prepare_blockwise_message(struct coap_s *handle, sn_coap_hdr_s *src_coap_
 int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr,
                                uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
 {
-    tr_debug("sn_coap_protocol_build - payload len %d", src_coap_msg_ptr->payload_len);
+    if (dst_packet_data_ptr == NULL) {
+        return -2;
+    }
+
+    return sn_coap_protocol_build_msg(handle, dst_addr_ptr, dst_packet_data_ptr, NULL, src_coap_msg_ptr, param);
+}
+
+int16_t sn_coap_protocol_build_in_place(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr,
+                                        uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
+{
+    if (dst_packet_data_pptr == NULL) {
+        return -2;
+    }
+    *dst_packet_data_pptr = NULL;
+
+    return sn_coap_protocol_build_msg(handle, dst_addr_ptr, NULL, dst_packet_data_pptr, src_coap_msg_ptr, param);
+}
+
+void sn_coap_protocol_release_packet(struct coap_s *handle, uint8_t *packet_data_ptr)
+{
+    if (handle == NULL || packet_data_ptr == NULL) {
+        return;
+    }
+
+#if ENABLE_RESENDINGS
+    /* Packet data of a queued message is freed together with the message. If the
+     * message was already removed, the Packet data was left to the caller. */
+    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
+        if (stored_msg_ptr->packet_held && stored_msg_ptr->send_msg_ptr->packet_ptr == packet_data_ptr) {
+            stored_msg_ptr->packet_held = false;
+            return;
+        }
+    }
+#endif
+
+    handle->sn_coap_protocol_free(packet_data_ptr);
+}
+
+/**
+ * \fn static void sn_coap_protocol_discard_built_packet(struct coap_s *handle, uint8_t *packet_data_ptr)
+ *
+ * \brief Frees Packet data allocated by sn_coap_protocol_build_msg() when building fails, and
+ *        removes the Confirmable message it was built for from the resending queue
+ */
+static void sn_coap_protocol_discard_built_packet(struct coap_s *handle, uint8_t *packet_data_ptr)
+{
+#if ENABLE_RESENDINGS
+    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
+        if (stored_msg_ptr->send_msg_ptr->packet_ptr == packet_data_ptr) {
+            stored_msg_ptr->packet_held = false;
+            ns_list_remove(&handle->linked_list_resent_msgs, stored_msg_ptr);
+            --handle->count_resent_msgs;
+            sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
+            return;
+        }
+    }
+#endif
+
+    handle->sn_coap_protocol_free(packet_data_ptr);
+}
+
+/**
+ * \fn static int16_t sn_coap_protocol_build_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t *dst_packet_data_ptr, uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
+ *
+ * \brief Builds Packet data to be sent, common part of sn_coap_protocol_build() and sn_coap_protocol_build_in_place()
+ *
+ * \param *dst_packet_data_ptr is destination of built Packet data, or NULL to build into memory allocated here
+ *
+ * \param **dst_packet_data_pptr is set to the allocated Packet data when \p dst_packet_data_ptr is NULL
+ */
+static int16_t sn_coap_protocol_build_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr,
+        uint8_t *dst_packet_data_ptr, uint8_t **dst_packet_data_pptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
+{
     int16_t  byte_count_built     = 0;
 #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE /* If Message blockwising is not used at all, this part of code will not be compiled */
     uint16_t original_payload_len = 0;
+#endif
+#if ENABLE_RESENDINGS
+    coap_send_msg_s *stored_msg_ptr = NULL;
 #endif
     /* * * * Check given pointers  * * * */
-    if ((dst_addr_ptr == NULL) || (dst_packet_data_ptr == NULL) || (src_coap_msg_ptr == NULL) || handle == NULL) {
+    if ((dst_addr_ptr == NULL) || (src_coap_msg_ptr == NULL) || handle == NULL) {
         return -2;
     }
+    tr_debug("sn_coap_protocol_build - payload len %d", src_coap_msg_ptr->payload_len);
 
     if (dst_addr_ptr->addr_ptr == NULL) {
         return -2;
@@ -434,16 +514,53 @@ int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_p
     /* * * * Build Packet data from CoAP message by using CoAP Header builder  * * * */
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+    if (dst_packet_data_ptr == NULL) {
+        /* Builder calculates exact size, so Packet data can be built straight into its final place */
+        uint16_t packet_data_len = sn_coap_builder_calc_needed_packet_data_size_2(src_coap_msg_ptr, handle->sn_coap_block_data_size);
+        if (!packet_data_len) {
+            return -1;
+        }
+
+#if ENABLE_RESENDINGS
+        /* Confirmable message is built directly to the resending slot, no copy is needed */
+        if (src_coap_msg_ptr->msg_type == COAP_MSG_TYPE_CONFIRMABLE) {
+            stored_msg_ptr = sn_coap_protocol_linked_list_send_msg_alloc(handle, dst_addr_ptr, packet_data_len,
+                             handle->system_time + (uint32_t)(handle->sn_coap_resending_intervall * RESPONSE_RANDOM_FACTOR),
+                             param, src_coap_msg_ptr->uri_path_ptr, src_coap_msg_ptr->uri_path_len);
+            if (stored_msg_ptr) {
+                dst_packet_data_ptr = stored_msg_ptr->send_msg_ptr->packet_ptr;
+            }
+        }
+#endif
+        if (dst_packet_data_ptr == NULL) {
+            dst_packet_data_ptr = handle->sn_coap_protocol_malloc(packet_data_len);
+            if (dst_packet_data_ptr == NULL) {
+                return -2;
+            }
+        }
+        *dst_packet_data_pptr = dst_packet_data_ptr;
+    }
+
     byte_count_built = sn_coap_builder_2(dst_packet_data_ptr, src_coap_msg_ptr, handle->sn_coap_block_data_size);
 
     if (byte_count_built < 0) {
+        if (dst_packet_data_pptr) {
+            sn_coap_protocol_discard_built_packet(handle, dst_packet_data_ptr);
+            *dst_packet_data_pptr = NULL;
+        }
         return byte_count_built;
     }
 
 #if ENABLE_RESENDINGS /* If Message resending is not used at all, this part of code will not be compiled */
 
+    if (stored_msg_ptr) {
+        /* Resend only what was built, and keep the Packet data until the caller releases it */
+        stored_msg_ptr->send_msg_ptr->packet_len = byte_count_built;
+        stored_msg_ptr->packet_held = true;
+    }
+
     /* Check if built Message type was confirmable, only these messages are resent */
-    if (src_coap_msg_ptr->msg_type == COAP_MSG_TYPE_CONFIRMABLE) {
+    if (src_coap_msg_ptr->msg_type == COAP_MSG_TYPE_CONFIRMABLE && dst_packet_data_pptr == NULL) {
         /* Store message to Linked list for resending purposes */
         sn_coap_protocol_linked_list_send_msg_store(handle, dst_addr_ptr, byte_count_built, dst_packet_data_ptr,
                 handle->system_time + (uint32_t)(handle->sn_coap_resending_intervall * RESPONSE_RANDOM_FACTOR),
@@ -477,6 +594,10 @@ int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_p
         if( stored_blockwise_msg_ptr->coap_msg_ptr == NULL ){
             handle->sn_coap_protocol_free(stored_blockwise_msg_ptr);
             stored_blockwise_msg_ptr = 0;
+            if (dst_packet_data_pptr) {
+                sn_coap_protocol_discard_built_packet(handle, *dst_packet_data_pptr);
+                *dst_packet_data_pptr = NULL;
+            }
             return -2;
         }
 
@@ -514,6 +635,10 @@ int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_p
         if( stored_blockwise_msg_ptr->coap_msg_ptr == NULL ){
             handle->sn_coap_protocol_free(stored_blockwise_msg_ptr);
             stored_blockwise_msg_ptr = 0;
+            if (dst_packet_data_pptr) {
+                sn_coap_protocol_discard_built_packet(handle, *dst_packet_data_pptr);
+                *dst_packet_data_pptr = NULL;
+            }
             return -2;
         }
 
@@ -815,24 +940,53 @@ int8_t sn_coap_protocol_exec(struct coap_s *handle, uint32_t current_time)
 static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len,
         uint8_t *send_packet_data_ptr, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len)
 {
+    coap_send_msg_s *stored_msg_ptr = sn_coap_protocol_linked_list_send_msg_alloc(handle, dst_addr_ptr, send_packet_data_len,
+                                      sending_time, param, uri_path_ptr, uri_path_len);
+
+    if (stored_msg_ptr) {
+        memcpy(stored_msg_ptr->send_msg_ptr->packet_ptr, send_packet_data_ptr, send_packet_data_len);
+    }
+}
+
+/**************************************************************************//**
+ * \fn static coap_send_msg_s *sn_coap_protocol_linked_list_send_msg_alloc(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len)
+ *
+ * \brief Allocates a message slot from Linked list for sending purposes.
+ *
+ * The slot is added to the Linked list with an uninitialized Packet data buffer
+ * of \p send_packet_data_len bytes, which the caller fills in.
+ *
+ * \param *dst_addr_ptr is pointer to destination address where CoAP message will be sent
+ *
+ * \param send_packet_data_len is length of Packet data to be stored
+ *
+ * \param sending_time is stored sending time
+ *
+ * \return Return value is pointer to the stored message, or NULL if resending is
+ *         disabled, the queue is full or memory allocation failed
+ *****************************************************************************/
+
+static coap_send_msg_s *sn_coap_protocol_linked_list_send_msg_alloc(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len,
+        uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len)
+{
 
     coap_send_msg_s *stored_msg_ptr              = NULL;
 
     /* If both queue parameters are "0" or resending count is "0", then re-sending is disabled */
     if (((handle->sn_coap_resending_queue_msgs == 0) && (handle->sn_coap_resending_queue_bytes == 0)) || (handle->sn_coap_resending_count == 0)) {
-        return;
+        return NULL;
     }
 
     if (handle->sn_coap_resending_queue_msgs > 0) {
         if (handle->count_resent_msgs >= handle->sn_coap_resending_queue_msgs) {
-            return;
+            return NULL;
         }
     }
 
     /* Count resending queue size, if buffer size is defined */
     if (handle->sn_coap_resending_queue_bytes > 0) {
         if ((sn_coap_count_linked_list_size(&handle->linked_list_resent_msgs) + send_packet_data_len) > handle->sn_coap_resending_queue_bytes) {
-            return;
+            return NULL;
         }
     }
 
@@ -840,7 +994,7 @@ static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, s
     stored_msg_ptr = sn_coap_protocol_allocate_mem_for_msg(handle, dst_addr_ptr, send_packet_data_len);
 
     if (stored_msg_ptr == 0) {
-        return;
+        return NULL;
     }
 
     /* Filling of coap_send_msg_s with initialization values */
@@ -850,7 +1004,6 @@ static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, s
     /* Filling of sn_nsdl_transmit_s */
     stored_msg_ptr->send_msg_ptr->protocol = SN_NSDL_PROTOCOL_COAP;
     stored_msg_ptr->send_msg_ptr->packet_len = send_packet_data_len;
-    memcpy(stored_msg_ptr->send_msg_ptr->packet_ptr, send_packet_data_ptr, send_packet_data_len);
 
     /* Filling of sn_nsdl_addr_s */
     stored_msg_ptr->send_msg_ptr->dst_addr_ptr->type = dst_addr_ptr->type;
@@ -864,7 +1017,8 @@ static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, s
     if (uri_path_len) {
         stored_msg_ptr->send_msg_ptr->uri_path_ptr = handle->sn_coap_protocol_malloc(uri_path_len);
         if (stored_msg_ptr->send_msg_ptr->uri_path_ptr == NULL){
-            return;
+            sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
+            return NULL;
         }
         stored_msg_ptr->send_msg_ptr->uri_path_len = uri_path_len;
         memcpy(stored_msg_ptr->send_msg_ptr->uri_path_ptr, uri_path_ptr, uri_path_len);
@@ -874,6 +1028,8 @@ static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, s
     /* Storing Resending message to Linked list */
     ns_list_add_to_end(&handle->linked_list_resent_msgs, stored_msg_ptr);
     ++handle->count_resent_msgs;
+
+    return stored_msg_ptr;
 }
 
 /**************************************************************************//**
@@ -1442,7 +1598,8 @@ static void sn_coap_protocol_release_allocated_send_msg_mem(struct coap_s *handl
                 freed_send_msg_ptr->send_msg_ptr->dst_addr_ptr = 0;
             }
 
-            if (freed_send_msg_ptr->send_msg_ptr->packet_ptr != NULL) {
+            /* Packet data still used by the caller is freed by sn_coap_protocol_release_packet() */
+            if (freed_send_msg_ptr->send_msg_ptr->packet_ptr != NULL && !freed_send_msg_ptr->packet_held) {
                 handle->sn_coap_protocol_free(freed_send_msg_ptr->send_msg_ptr->packet_ptr);
                 freed_send_msg_ptr->send_msg_ptr->packet_ptr = 0;
             }
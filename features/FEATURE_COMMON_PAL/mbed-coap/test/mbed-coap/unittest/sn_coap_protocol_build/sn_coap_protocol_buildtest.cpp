@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2017 ARM. All rights reserved.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_sn_coap_protocol_build.h"
+
+TEST_GROUP(sn_coap_protocol_build)
+{
+    void setup()
+    {
+    }
+
+    void teardown()
+    {
+    }
+};
+
+TEST(sn_coap_protocol_build, test_sn_coap_protocol_build_in_place_con)
+{
+    CHECK(test_sn_coap_protocol_build_in_place_con());
+}
+
+TEST(sn_coap_protocol_build, test_sn_coap_protocol_build_in_place_con_acked_before_release)
+{
+    CHECK(test_sn_coap_protocol_build_in_place_con_acked_before_release());
+}
+
+TEST(sn_coap_protocol_build, test_sn_coap_protocol_build_in_place_con_missing_payload)
+{
+    CHECK(test_sn_coap_protocol_build_in_place_con_missing_payload());
+}
+
+TEST(sn_coap_protocol_build, test_sn_coap_protocol_build_in_place_non)
+{
+    CHECK(test_sn_coap_protocol_build_in_place_non());
+}
+
+TEST(sn_coap_protocol_build, test_sn_coap_protocol_build_in_place_ack)
+{
+    CHECK(test_sn_coap_protocol_build_in_place_ack());
+}
+
+TEST(sn_coap_protocol_build, test_sn_coap_protocol_build_in_place_blockwise)
+{
+    CHECK(test_sn_coap_protocol_build_in_place_blockwise());
+}
+
+TEST(sn_coap_protocol_build, test_sn_coap_protocol_build_in_place_failure)
+{
+    CHECK(test_sn_coap_protocol_build_in_place_failure());
+}
@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2017 ARM. All rights reserved.
+ */
+#include "test_sn_coap_protocol_build.h"
+#include <stdlib.h>
+#include <string.h>
+#include "ns_types.h"
+#include "ns_list.h"
+#include "mbed-coap/sn_coap_protocol.h"
+#include "sn_coap_header_internal.h"
+#include "sn_coap_protocol_internal.h"
+
+#define MAX_ALLOCS 64
+
+/* Every allocation of the library is tracked, to find leaks and double frees */
+static void *allocs[MAX_ALLOCS];
+static int alloc_fail_after;
+static int bad_frees;
+
+static uint8_t tx_packet[64];
+static uint16_t tx_len;
+static int tx_count;
+
+static uint8_t addr[16] = {0x20, 0x01, 0x0d, 0xb8};
+static sn_nsdl_addr_s dst_addr = {16, SN_NSDL_ADDRESS_TYPE_IPV6, 5683, addr};
+
+static uint8_t uri_path[] = "test/path";
+static uint8_t payload[40];
+
+static void *test_malloc(uint16_t size)
+{
+    if (alloc_fail_after == 0) {
+        return NULL;
+    }
+    if (alloc_fail_after > 0) {
+        alloc_fail_after--;
+    }
+
+    void *ptr = malloc(size ? size : 1);
+    for (int i = 0; i < MAX_ALLOCS; i++) {
+        if (allocs[i] == NULL) {
+            allocs[i] = ptr;
+            return ptr;
+        }
+    }
+    free(ptr);
+    return NULL;
+}
+
+static void test_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    for (int i = 0; i < MAX_ALLOCS; i++) {
+        if (allocs[i] == ptr) {
+            allocs[i] = NULL;
+            free(ptr);
+            return;
+        }
+    }
+    bad_frees++;
+}
+
+static bool is_allocated(void *ptr)
+{
+    for (int i = 0; i < MAX_ALLOCS; i++) {
+        if (allocs[i] == ptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int live_allocs(void)
+{
+    int count = 0;
+    for (int i = 0; i < MAX_ALLOCS; i++) {
+        if (allocs[i]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static uint8_t test_tx(uint8_t *packet_ptr, uint16_t packet_len, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    tx_len = packet_len;
+    if (packet_len <= sizeof(tx_packet)) {
+        memcpy(tx_packet, packet_ptr, packet_len);
+    }
+    tx_count++;
+    return 1;
+}
+
+static int8_t test_rx(sn_coap_hdr_s *coap_msg_ptr, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    return 0;
+}
+
+static struct coap_s *start(sn_coap_hdr_s *msg, sn_coap_msg_type_e type, sn_coap_msg_code_e code)
+{
+    memset(allocs, 0, sizeof(allocs));
+    alloc_fail_after = -1;
+    bad_frees = 0;
+    tx_len = 0;
+    tx_count = 0;
+
+    memset(msg, 0, sizeof(*msg));
+    msg->msg_type = type;
+    msg->msg_code = code;
+    msg->content_format = COAP_CT_NONE;
+    msg->uri_path_ptr = uri_path;
+    msg->uri_path_len = sizeof(uri_path) - 1;
+
+    return sn_coap_protocol_init(test_malloc, test_free, test_tx, test_rx);
+}
+
+static bool finish(struct coap_s *handle)
+{
+    sn_coap_protocol_destroy(handle);
+    return live_allocs() == 0 && bad_frees == 0;
+}
+
+/* The packet must match what the plain builder makes of the same message */
+static bool matches_builder(struct coap_s *handle, sn_coap_hdr_s *msg, uint8_t *packet, int16_t len)
+{
+    uint8_t expected[64];
+    return sn_coap_builder_2(expected, msg, handle->sn_coap_block_data_size) == len &&
+           memcmp(expected, packet, len) == 0;
+}
+
+static coap_send_msg_s *queued(struct coap_s *handle, uint8_t *packet)
+{
+    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
+        if (stored_msg_ptr->send_msg_ptr->packet_ptr == packet) {
+            return stored_msg_ptr;
+        }
+    }
+    return NULL;
+}
+
+static bool receive_ack(struct coap_s *handle, uint16_t msg_id)
+{
+    uint8_t ack[4] = {0x60, 0x00, msg_id >> 8, msg_id & 0xff};
+    sn_coap_hdr_s *parsed = sn_coap_protocol_parse(handle, &dst_addr, sizeof(ack), ack, NULL);
+    if (parsed == NULL) {
+        return false;
+    }
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, parsed);
+    return true;
+}
+
+bool test_sn_coap_protocol_build_in_place_con()
+{
+    sn_coap_hdr_s msg;
+    struct coap_s *handle = start(&msg, COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_GET);
+    uint8_t *packet = NULL;
+
+    int16_t len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+    if (len <= 0 || packet == NULL || msg.msg_id == 0 || !matches_builder(handle, &msg, packet, len)) {
+        return false;
+    }
+
+    /* Built straight into the resending queue */
+    coap_send_msg_s *stored = queued(handle, packet);
+    if (handle->count_resent_msgs != 1 || stored == NULL || stored->send_msg_ptr->packet_len != len) {
+        return false;
+    }
+
+    /* Released by the caller, still owned by the queue */
+    sn_coap_protocol_release_packet(handle, packet);
+    if (!is_allocated(packet) || handle->count_resent_msgs != 1) {
+        return false;
+    }
+
+    /* Resent as built */
+    sn_coap_protocol_exec(handle, DEFAULT_RESPONSE_TIMEOUT * RESPONSE_RANDOM_FACTOR + 1);
+    if (tx_count != 1 || tx_len != len || !matches_builder(handle, &msg, tx_packet, tx_len)) {
+        return false;
+    }
+
+    if (!receive_ack(handle, msg.msg_id) || handle->count_resent_msgs != 0 || is_allocated(packet)) {
+        return false;
+    }
+
+    return finish(handle);
+}
+
+bool test_sn_coap_protocol_build_in_place_con_acked_before_release()
+{
+    sn_coap_hdr_s msg;
+    struct coap_s *handle = start(&msg, COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_GET);
+    uint8_t *packet = NULL;
+
+    int16_t len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+    if (len <= 0) {
+        return false;
+    }
+
+    /* The ACK arrives before the caller is done with the packet */
+    if (!receive_ack(handle, msg.msg_id) || handle->count_resent_msgs != 0) {
+        return false;
+    }
+    if (!is_allocated(packet) || !matches_builder(handle, &msg, packet, len)) {
+        return false;
+    }
+
+    sn_coap_protocol_release_packet(handle, packet);
+    if (is_allocated(packet)) {
+        return false;
+    }
+
+    /* Same when resending gives up or the queue is cleared */
+    packet = NULL;
+    msg.msg_id = 0;
+    len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+    if (len <= 0) {
+        return false;
+    }
+    sn_coap_protocol_clear_retransmission_buffer(handle);
+    if (!is_allocated(packet) || !matches_builder(handle, &msg, packet, len)) {
+        return false;
+    }
+    sn_coap_protocol_release_packet(handle, packet);
+
+    return finish(handle);
+}
+
+bool test_sn_coap_protocol_build_in_place_con_missing_payload()
+{
+    sn_coap_hdr_s msg;
+    struct coap_s *handle = start(&msg, COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_POST);
+    uint8_t *packet = NULL;
+
+    /* Sized with the payload, built without it */
+    msg.payload_len = 4;
+    msg.payload_ptr = NULL;
+
+    int16_t len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+    if (len <= 0) {
+        return false;
+    }
+
+    coap_send_msg_s *stored = queued(handle, packet);
+    if (stored == NULL || stored->send_msg_ptr->packet_len != len) {
+        return false;
+    }
+    sn_coap_protocol_release_packet(handle, packet);
+
+    /* Only the built bytes are resent */
+    sn_coap_protocol_exec(handle, DEFAULT_RESPONSE_TIMEOUT * RESPONSE_RANDOM_FACTOR + 1);
+    if (tx_count != 1 || tx_len != len) {
+        return false;
+    }
+
+    return finish(handle);
+}
+
+bool test_sn_coap_protocol_build_in_place_non()
+{
+    sn_coap_hdr_s msg;
+    struct coap_s *handle = start(&msg, COAP_MSG_TYPE_NON_CONFIRMABLE, COAP_MSG_CODE_REQUEST_POST);
+    uint8_t *packet = NULL;
+
+    memset(payload, 0xa5, sizeof(payload));
+    msg.payload_ptr = payload;
+    msg.payload_len = 8;
+
+    int16_t len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+    if (len <= 0 || packet == NULL || msg.msg_id == 0 || !matches_builder(handle, &msg, packet, len)) {
+        return false;
+    }
+    if (handle->count_resent_msgs != 0) {
+        return false;
+    }
+
+    sn_coap_protocol_release_packet(handle, packet);
+    if (is_allocated(packet)) {
+        return false;
+    }
+
+    return finish(handle);
+}
+
+bool test_sn_coap_protocol_build_in_place_ack()
+{
+    sn_coap_hdr_s msg;
+    struct coap_s *handle = start(&msg, COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT);
+    uint8_t *packet = NULL;
+
+    /* Acknowledgement keeps the Message ID of the request */
+    msg.msg_id = 0x1234;
+    msg.uri_path_ptr = NULL;
+    msg.uri_path_len = 0;
+
+    int16_t len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+    if (len != 4 || packet[2] != 0x12 || packet[3] != 0x34 || !matches_builder(handle, &msg, packet, len)) {
+        return false;
+    }
+    if (handle->count_resent_msgs != 0) {
+        return false;
+    }
+
+    sn_coap_protocol_release_packet(handle, packet);
+
+    return finish(handle);
+}
+
+bool test_sn_coap_protocol_build_in_place_blockwise()
+{
+    sn_coap_hdr_s msg;
+    struct coap_s *handle = start(&msg, COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_POST);
+    uint8_t *packet = NULL;
+    coap_version_e version;
+
+    for (uint8_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = i;
+    }
+    msg.payload_ptr = payload;
+    msg.payload_len = sizeof(payload);
+    if (sn_coap_parser_alloc_options(handle, &msg) == NULL) {
+        return false;
+    }
+    /* First 16 byte block, more to follow */
+    msg.options_list_ptr->block1 = 0x08;
+
+    int16_t len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+    if (len <= 0 || handle->sn_coap_block_data_size != 16) {
+        return false;
+    }
+
+    /* Only the first block is built, the rest is kept for the next requests */
+    sn_coap_hdr_s *parsed = sn_coap_parser(handle, len, packet, &version);
+    if (parsed == NULL) {
+        return false;
+    }
+    bool first_block = parsed->payload_len == 16 && memcmp(parsed->payload_ptr, payload, 16) == 0 &&
+                       parsed->options_list_ptr && parsed->options_list_ptr->block1 == 0x08;
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, parsed);
+    if (!first_block || ns_list_count(&handle->linked_list_blockwise_sent_msgs) != 1) {
+        return false;
+    }
+
+    coap_send_msg_s *stored = queued(handle, packet);
+    if (stored == NULL || stored->send_msg_ptr->packet_len != len) {
+        return false;
+    }
+
+    sn_coap_protocol_release_packet(handle, packet);
+    handle->sn_coap_protocol_free(msg.options_list_ptr);
+
+    return finish(handle);
+}
+
+bool test_sn_coap_protocol_build_in_place_failure()
+{
+    sn_coap_hdr_s msg;
+    struct coap_s *handle = start(&msg, COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_GET);
+    uint8_t *packet = NULL;
+    uint8_t token[9] = {0};
+    int baseline = live_allocs();
+
+    if (sn_coap_protocol_build_in_place(handle, &dst_addr, NULL, &msg, NULL) != -2) {
+        return false;
+    }
+    if (sn_coap_protocol_build_in_place(handle, NULL, &packet, &msg, NULL) != -2 || packet != NULL) {
+        return false;
+    }
+
+    /* Invalid header: nothing is queued or leaked */
+    msg.token_ptr = token;
+    msg.token_len = sizeof(token);
+    if (sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL) != -1 || packet != NULL) {
+        return false;
+    }
+    if (handle->count_resent_msgs != 0 || live_allocs() != baseline) {
+        return false;
+    }
+
+    /* Out of memory */
+    msg.token_ptr = NULL;
+    msg.token_len = 0;
+    msg.msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE;
+    alloc_fail_after = 0;
+    if (sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL) != -2 || packet != NULL) {
+        return false;
+    }
+    alloc_fail_after = -1;
+    if (live_allocs() != baseline) {
+        return false;
+    }
+
+    /* Out of memory at each allocation of a blockwise Confirmable message */
+    msg.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    msg.msg_code = COAP_MSG_CODE_REQUEST_POST;
+    msg.payload_ptr = payload;
+    for (int fail_after = 0; fail_after < 16; fail_after++) {
+        msg.msg_id = 0;
+        msg.payload_len = sizeof(payload);
+        packet = NULL;
+        baseline = live_allocs();
+        alloc_fail_after = fail_after;
+        int16_t len = sn_coap_protocol_build_in_place(handle, &dst_addr, &packet, &msg, NULL);
+        alloc_fail_after = -1;
+
+        if (len < 0) {
+            /* Nothing is left to be resent */
+            if (packet != NULL || handle->count_resent_msgs != 0 || live_allocs() != baseline) {
+                return false;
+            }
+        } else {
+            sn_coap_protocol_release_packet(handle, packet);
+            sn_coap_protocol_clear_retransmission_buffer(handle);
+        }
+    }
+
+    return finish(handle);
+}
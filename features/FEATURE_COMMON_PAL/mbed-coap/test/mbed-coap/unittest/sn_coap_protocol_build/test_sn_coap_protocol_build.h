@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2017 ARM. All rights reserved.
+ */
+#ifndef TEST_SN_COAP_PROTOCOL_BUILD_H
+#define TEST_SN_COAP_PROTOCOL_BUILD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+bool test_sn_coap_protocol_build_in_place_con();
+
+bool test_sn_coap_protocol_build_in_place_con_acked_before_release();
+
+bool test_sn_coap_protocol_build_in_place_con_missing_payload();
+
+bool test_sn_coap_protocol_build_in_place_non();
+
+bool test_sn_coap_protocol_build_in_place_ack();
+
+bool test_sn_coap_protocol_build_in_place_blockwise();
+
+bool test_sn_coap_protocol_build_in_place_failure();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_SN_COAP_PROTOCOL_BUILD_H
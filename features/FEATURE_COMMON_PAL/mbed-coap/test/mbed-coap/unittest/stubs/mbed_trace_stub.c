@@ -0,0 +1,9 @@
+/*
+ * Copyright (c) 2017 ARM. All rights reserved.
+ */
+#include <stdarg.h>
+#include <stdint.h>
+
+void mbed_tracef(uint8_t dlevel, const char *grp, const char *fmt, ...)
+{
+}
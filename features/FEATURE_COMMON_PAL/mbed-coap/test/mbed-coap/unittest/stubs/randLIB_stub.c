@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2017 ARM. All rights reserved.
+ */
+#include <stdint.h>
+#include "randLIB.h"
+
+uint16_t randLIB_stub_16bit = 1;
+
+void randLIB_seed_random(void)
+{
+}
+
+uint16_t randLIB_get_16bit(void)
+{
+    return randLIB_stub_16bit;
+}
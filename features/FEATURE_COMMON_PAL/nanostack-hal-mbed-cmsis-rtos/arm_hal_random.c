@@ -17,6 +17,7 @@
 #include "arm_hal_random.h"
 
 #include "mbedtls/entropy_poll.h"
+#include "platform/inc/mbed_rng.h"
 
 void arm_random_module_init(void)
 {
@@ -26,9 +27,11 @@ uint32_t arm_random_seed_get(void)
 {
     uint32_t result = 0;
 #ifdef MBEDTLS_ENTROPY_HARDWARE_ALT
-    /* Grab a seed from a function we provide for mbedtls */
-    size_t len;
-    mbedtls_hardware_poll(NULL, (uint8_t *) &result, sizeof result, &len);
+    /* Share the system RNG with mbedtls, fall back to the raw source */
+    if (mbed_rng_get_bytes((uint8_t *) &result, sizeof result) != 0) {
+        size_t len;
+        mbedtls_hardware_poll(NULL, (uint8_t *) &result, sizeof result, &len);
+    }
 #endif
     return result;
 }
@@ -52,12 +52,29 @@ uint_fast8_t ip6_prefix_tos(const void *prefix, uint_fast8_t prefix_len, char *p
  * Convert numeric IPv6 address string to a binary.
  *
  * IPv4 tunneling addresses are not covered.
+ * Unless the string is too long, the address is written even if it is malformed:
+ * fields are parsed up to the first non-hex character and missing ones are zero.
  *
  * \param ip6addr IPv6 address in string format.
- * \param len Lenght of ipv6 string, maximum of 41.
+ * \param len Lenght of ipv6 string, maximum of 39.
  * \param dest buffer for address. MUST be 16 bytes.
+ * \return true if `ip6addr` was a valid address, false if it was malformed or too long
  */
-void stoip6(const char *ip6addr, size_t len, void *dest);
+bool stoip6(const char *ip6addr, size_t len, void *dest);
+
+/**
+ * Convert numeric IPv6 address string with an optional prefix length to a binary.
+ *
+ * Accepts "addr" or "addr/len", e.g. "2001:db8::/32". The whole
+ * null-terminated string must be valid, `len` must be 0 to 128.
+ *
+ * \param ip6addr IPv6 address and prefix length in string format.
+ * \param dest buffer for address. MUST be 16 bytes.
+ * \param prefix_len_out prefix length, or -1 if not given. May be NULL.
+ * \return true on success, false if the string was malformed
+ */
+bool stoip6_prefix(const char *ip6addr, void *dest, int_fast16_t *prefix_len_out);
+
 /**
  * Find out numeric IPv6 address prefix length.
  *
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NS_HASHMAP_H_
+#define NS_HASHMAP_H_
+
+#include "ns_types.h"
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file
+ * \brief Intrusive hash map support library
+ *
+ * The ns_hashmap.h file provides an open-addressed hash map, finding entries
+ * by a fixed-size key stored inside the entry itself, in O(1) average time.
+ *
+ * The map only stores pointers to entries, in a bucket array provided by the
+ * user, so it never allocates memory. Collisions are resolved by linear
+ * probing, and removal moves later entries back instead of leaving
+ * "deleted" markers, so lookups do not slow down after many removals.
+ *
+ * Memory footprint is one pointer per bucket, plus the map head. Nothing is
+ * added to the entries.
+ *
+ * Example of an entry type that can be stored to this map, keyed by `id`.
+ * ~~~
+ *     typedef struct example_entry
+ *     {
+ *         uint16_t       id;
+ *         uint8_t        *data;
+ *     }
+ *     example_entry_t;
+ *
+ *     static void *my_buckets[32];
+ *     static ns_hashmap_t my_map;
+ *     ns_hashmap_init(&my_map, my_buckets, 32, example_entry_t, id);
+ *
+ *     ns_hashmap_insert(&my_map, entry);
+ *
+ *     uint16_t id = 7;
+ *     example_entry_t *found = ns_hashmap_find(&my_map, &id);
+ * ~~~
+ * The number of buckets must be a power of two. One bucket is always left
+ * empty, so a map with N buckets holds at most N-1 entries; keeping it under
+ * about 3/4 full keeps the probe sequences short.
+ *
+ * Keys are hashed and compared as raw bytes, so key fields must not contain
+ * padding, and must not be modified while the entry is in the map.
+ */
+
+/** \brief Hash map head.
+ *
+ * Users should not access the members directly, but use the functions below.
+ */
+typedef struct ns_hashmap {
+    void **buckets;             ///< User-provided bucket array, NULL for an empty bucket
+    uint_fast16_t mask;         ///< Number of buckets minus one
+    uint_fast16_t count;        ///< Number of entries in the map
+    uint_fast16_t key_offset;   ///< Offset of the key field in the entries
+    uint_fast8_t key_len;       ///< Size of the key field in bytes
+} ns_hashmap_t;
+
+/** \hideinitializer \brief Initialise a hash map
+ *
+ * \param map        `(ns_hashmap_t *)` Pointer to map.
+ * \param buckets    `(void **)`        Bucket array, contents are overwritten.
+ * \param size       `(uint_fast16_t)`  Number of buckets, a power of two.
+ * \param entry_type                    Entry type `(entry_t)`.
+ * \param key_field                     Name of the key member in the entry.
+ */
+#define ns_hashmap_init(map, buckets, size, entry_type, key_field) \
+    ns_hashmap_init_(map, buckets, size, offsetof(entry_type, key_field), sizeof ((entry_type *) 0)->key_field)
+
+/** \brief Get number of entries in a hash map.
+ *
+ * \param map `(const ns_hashmap_t *)` Pointer to map.
+ *
+ * \return    `(uint_fast16_t)`        Number of entries.
+ */
+#define ns_hashmap_count(map) ((map)->count)
+
+/** \brief Add an entry to a hash map.
+ *
+ * \param map   Pointer to map.
+ * \param entry Pointer to new entry to add.
+ *
+ * \return true if added, false if the map is full or an entry with the same
+ *         key is already in the map.
+ */
+NS_INLINE bool ns_hashmap_insert(ns_hashmap_t *map, void *entry);
+
+/** \brief Find an entry by key.
+ *
+ * \param map Pointer to map.
+ * \param key Pointer to key, the same size as the entry key field.
+ *
+ * \return Pointer to entry, or NULL if no entry has this key.
+ */
+NS_INLINE void *ns_hashmap_find(const ns_hashmap_t *map, const void *key);
+
+/** \brief Remove an entry from a hash map.
+ *
+ * \param map   Pointer to map.
+ * \param entry Entry to remove.
+ *
+ * \return true if removed, false if the entry was not in the map.
+ */
+NS_INLINE bool ns_hashmap_remove(ns_hashmap_t *map, void *entry);
+
+/** \privatesection
+ *  Internal functions - designed to be accessed using corresponding macros above
+ */
+NS_INLINE void ns_hashmap_init_(ns_hashmap_t *map, void **buckets, uint_fast16_t size, uint_fast16_t key_offset, uint_fast8_t key_len);
+NS_INLINE uint_fast16_t ns_hashmap_bucket_(const ns_hashmap_t *map, const void *key);
+
+/* Provide definitions, either for inlining, or for ns_hashmap.c */
+#if defined NS_ALLOW_INLINING || defined NS_HASHMAP_FN
+#ifndef NS_HASHMAP_FN
+#define NS_HASHMAP_FN NS_INLINE
+#endif
+
+/* Pointer to the key in entry e */
+#define NS_HASHMAP_KEY_(map, e) ((const uint8_t *)(e) + (map)->key_offset)
+
+NS_HASHMAP_FN void ns_hashmap_init_(ns_hashmap_t *map, void **buckets, uint_fast16_t size, uint_fast16_t key_offset, uint_fast8_t key_len)
+{
+    map->buckets = buckets;
+    map->mask = size - 1;
+    map->count = 0;
+    map->key_offset = key_offset;
+    map->key_len = key_len;
+
+    for (uint_fast16_t i = 0; i < size; i++) {
+        buckets[i] = NULL;
+    }
+}
+
+/* First bucket to probe for key - FNV-1a, high bits folded down */
+NS_HASHMAP_FN uint_fast16_t ns_hashmap_bucket_(const ns_hashmap_t *map, const void *key)
+{
+    const uint8_t *k = key;
+    uint32_t hash = 2166136261u;
+
+    for (uint_fast8_t i = 0; i < map->key_len; i++) {
+        hash = (hash ^ k[i]) * 16777619u;
+    }
+
+    return (hash ^ (hash >> 16)) & map->mask;
+}
+
+NS_HASHMAP_FN bool ns_hashmap_insert(ns_hashmap_t *map, void *entry)
+{
+    const uint8_t *key = NS_HASHMAP_KEY_(map, entry);
+    uint_fast16_t i;
+    void *cur;
+
+    if (map->count >= map->mask) {
+        return false;
+    }
+
+    for (i = ns_hashmap_bucket_(map, key); (cur = map->buckets[i]) != NULL; i = (i + 1) & map->mask) {
+        if (cur == entry || memcmp(NS_HASHMAP_KEY_(map, cur), key, map->key_len) == 0) {
+            return false;
+        }
+    }
+
+    map->buckets[i] = entry;
+    map->count++;
+    return true;
+}
+
+NS_HASHMAP_FN void *ns_hashmap_find(const ns_hashmap_t *map, const void *key)
+{
+    void *cur;
+
+    for (uint_fast16_t i = ns_hashmap_bucket_(map, key); (cur = map->buckets[i]) != NULL; i = (i + 1) & map->mask) {
+        if (memcmp(NS_HASHMAP_KEY_(map, cur), key, map->key_len) == 0) {
+            return cur;
+        }
+    }
+
+    return NULL;
+}
+
+NS_HASHMAP_FN bool ns_hashmap_remove(ns_hashmap_t *map, void *entry)
+{
+    uint_fast16_t i, j;
+    void *cur;
+
+    for (i = ns_hashmap_bucket_(map, NS_HASHMAP_KEY_(map, entry)); map->buckets[i] != entry; i = (i + 1) & map->mask) {
+        if (!map->buckets[i]) {
+            return false;
+        }
+    }
+
+    // Move back any later entry in the same probe run that can no longer be
+    // reached past the hole. An entry at j whose first bucket k lies
+    // cyclically in (i, j] is still reachable, and stays put.
+    for (j = (i + 1) & map->mask; (cur = map->buckets[j]) != NULL; j = (j + 1) & map->mask) {
+        uint_fast16_t k = ns_hashmap_bucket_(map, NS_HASHMAP_KEY_(map, cur));
+
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+            continue;
+        }
+
+        map->buckets[i] = cur;
+        i = j;
+    }
+
+    map->buckets[i] = NULL;
+    map->count--;
+    return true;
+}
+#endif /* defined NS_ALLOW_INLINING || defined NS_HASHMAP_FN */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NS_HASHMAP_H_ */
+
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NS_HEAP_H_
+#define NS_HEAP_H_
+
+#include "ns_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file
+ * \brief Binary min-heap support library
+ *
+ * The ns_heap.h file provides a priority queue, giving O(1) access to the
+ * entry with the smallest key and O(log n) insertion and removal. It suits
+ * timer and retransmission queues, where the next entry to expire is needed
+ * often and entries come and go in any order.
+ *
+ * The heap only stores pointers to entries, in an array provided by the
+ * user, so it never allocates memory. Keys are stored inside the entries and
+ * ordered by a user-supplied comparison function, which is given pointers to
+ * two keys.
+ *
+ * Example of an entry type that can be stored to this heap, keyed by `expiry`.
+ * ~~~
+ *     typedef struct example_entry
+ *     {
+ *         uint32_t       expiry;
+ *         uint8_t        *data;
+ *     }
+ *     example_entry_t;
+ *
+ *     static int compare_expiry(const void *a, const void *b)
+ *     {
+ *         return (int32_t) (*(const uint32_t *) a - *(const uint32_t *) b);
+ *     }
+ *
+ *     static void *my_entries[16];
+ *     static ns_heap_t my_heap;
+ *     ns_heap_init(&my_heap, my_entries, 16, example_entry_t, expiry, compare_expiry);
+ *
+ *     ns_heap_insert(&my_heap, entry);
+ *
+ *     example_entry_t *next = ns_heap_get_first(&my_heap);
+ * ~~~
+ * Entries with equal keys come out in unspecified order. Keys must not be
+ * modified while the entry is in the heap - remove it, change the key, and
+ * insert it again.
+ */
+
+/** \brief Key comparison function.
+ *
+ * \param a Pointer to first key.
+ * \param b Pointer to second key.
+ *
+ * \return negative if a < b, zero if a == b, positive if a > b.
+ */
+typedef int ns_heap_compare_t(const void *a, const void *b);
+
+/** \brief Heap head.
+ *
+ * Users should not access the members directly, but use the functions below.
+ */
+typedef struct ns_heap {
+    void **entries;                 ///< User-provided array of entry pointers, in heap order
+    uint_fast16_t size;             ///< Capacity of entries
+    uint_fast16_t count;            ///< Number of entries in the heap
+    uint_fast16_t key_offset;       ///< Offset of the key field in the entries
+    ns_heap_compare_t *compare;     ///< Key comparison function
+} ns_heap_t;
+
+/** \hideinitializer \brief Initialise a heap
+ *
+ * \param heap       `(ns_heap_t *)`          Pointer to heap.
+ * \param entries    `(void **)`              Array for entry pointers.
+ * \param size       `(uint_fast16_t)`        Number of elements in entries.
+ * \param entry_type                          Entry type `(entry_t)`.
+ * \param key_field                           Name of the key member in the entry.
+ * \param compare    `(ns_heap_compare_t *)`  Key comparison function.
+ */
+#define ns_heap_init(heap, entries, size, entry_type, key_field, compare) \
+    ns_heap_init_(heap, entries, size, offsetof(entry_type, key_field), compare)
+
+/** \brief Get number of entries in a heap.
+ *
+ * \param heap `(const ns_heap_t *)` Pointer to heap.
+ *
+ * \return     `(uint_fast16_t)`     Number of entries.
+ */
+#define ns_heap_count(heap) ((heap)->count)
+
+/** \brief Get the entry with the smallest key, without removing it.
+ *
+ * \param heap `(const ns_heap_t *)` Pointer to heap.
+ *
+ * \return     `(void *)`            Pointer to entry, or NULL if heap is empty.
+ */
+#define ns_heap_get_first(heap) ((heap)->count ? (heap)->entries[0] : NULL)
+
+/** \brief Add an entry to a heap.
+ *
+ * \param heap  Pointer to heap.
+ * \param entry Pointer to new entry to add.
+ *
+ * \return true if added, false if the heap is full.
+ */
+NS_INLINE bool ns_heap_insert(ns_heap_t *heap, void *entry);
+
+/** \brief Remove and return the entry with the smallest key.
+ *
+ * \param heap Pointer to heap.
+ *
+ * \return Pointer to entry, or NULL if heap is empty.
+ */
+NS_INLINE void *ns_heap_remove_first(ns_heap_t *heap);
+
+/** \brief Remove an entry from a heap.
+ *
+ * Finding the entry is O(n); removing it once found is O(log n).
+ *
+ * \param heap  Pointer to heap.
+ * \param entry Entry to remove.
+ *
+ * \return true if removed, false if the entry was not in the heap.
+ */
+NS_INLINE bool ns_heap_remove(ns_heap_t *heap, void *entry);
+
+/** \privatesection
+ *  Internal functions - designed to be accessed using corresponding macros above
+ */
+NS_INLINE void ns_heap_init_(ns_heap_t *heap, void **entries, uint_fast16_t size, uint_fast16_t key_offset, ns_heap_compare_t *compare);
+NS_INLINE void ns_heap_remove_at_(ns_heap_t *heap, uint_fast16_t pos);
+
+/* Provide definitions, either for inlining, or for ns_heap.c */
+#if defined NS_ALLOW_INLINING || defined NS_HEAP_FN
+#ifndef NS_HEAP_FN
+#define NS_HEAP_FN NS_INLINE
+#endif
+
+/* True if the key of entry a is less than the key of entry b */
+#define NS_HEAP_LESS_(heap, a, b) \
+    ((heap)->compare((const char *)(a) + (heap)->key_offset, (const char *)(b) + (heap)->key_offset) < 0)
+
+NS_HEAP_FN void ns_heap_init_(ns_heap_t *heap, void **entries, uint_fast16_t size, uint_fast16_t key_offset, ns_heap_compare_t *compare)
+{
+    heap->entries = entries;
+    heap->size = size;
+    heap->count = 0;
+    heap->key_offset = key_offset;
+    heap->compare = compare;
+}
+
+NS_HEAP_FN bool ns_heap_insert(ns_heap_t *heap, void *entry)
+{
+    uint_fast16_t pos;
+
+    if (heap->count >= heap->size) {
+        return false;
+    }
+
+    // Sift up - move parents down until entry's place is found
+    for (pos = heap->count++; pos > 0; ) {
+        uint_fast16_t parent = (pos - 1) / 2;
+
+        if (!NS_HEAP_LESS_(heap, entry, heap->entries[parent])) {
+            break;
+        }
+        heap->entries[pos] = heap->entries[parent];
+        pos = parent;
+    }
+    heap->entries[pos] = entry;
+
+    return true;
+}
+
+/* Fill the hole at pos with the last entry, sifting it up or down */
+NS_HEAP_FN void ns_heap_remove_at_(ns_heap_t *heap, uint_fast16_t pos)
+{
+    void *last = heap->entries[--heap->count];
+
+    if (pos == heap->count) {
+        return;
+    }
+
+    while (pos > 0) {
+        uint_fast16_t parent = (pos - 1) / 2;
+
+        if (!NS_HEAP_LESS_(heap, last, heap->entries[parent])) {
+            break;
+        }
+        heap->entries[pos] = heap->entries[parent];
+        pos = parent;
+    }
+
+    for (;;) {
+        uint_fast16_t child = 2 * pos + 1;
+
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && NS_HEAP_LESS_(heap, heap->entries[child + 1], heap->entries[child])) {
+            child++;
+        }
+        if (!NS_HEAP_LESS_(heap, heap->entries[child], last)) {
+            break;
+        }
+        heap->entries[pos] = heap->entries[child];
+        pos = child;
+    }
+    heap->entries[pos] = last;
+}
+
+NS_HEAP_FN void *ns_heap_remove_first(ns_heap_t *heap)
+{
+    void *first;
+
+    if (!heap->count) {
+        return NULL;
+    }
+
+    first = heap->entries[0];
+    ns_heap_remove_at_(heap, 0);
+    return first;
+}
+
+NS_HEAP_FN bool ns_heap_remove(ns_heap_t *heap, void *entry)
+{
+    for (uint_fast16_t pos = 0; pos < heap->count; pos++) {
+        if (heap->entries[pos] == entry) {
+            ns_heap_remove_at_(heap, pos);
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif /* defined NS_ALLOW_INLINING || defined NS_HEAP_FN */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NS_HEAP_H_ */
+
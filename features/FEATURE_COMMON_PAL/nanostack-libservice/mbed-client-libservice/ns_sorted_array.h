@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NS_SORTED_ARRAY_H_
+#define NS_SORTED_ARRAY_H_
+
+#include "ns_types.h"
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file
+ * \brief Sorted array set support library
+ *
+ * The ns_sorted_array.h file provides a set of entries kept in key order in
+ * an array, found by binary search in O(log n) time. Insertion and removal
+ * move the later entries, so are O(n), but for the small, mostly-read sets
+ * typical here that is cheaper than maintaining a tree.
+ *
+ * The set only stores pointers to entries, in an array provided by the user,
+ * so it never allocates memory. Keys are stored inside the entries and
+ * ordered by a user-supplied comparison function, which is given pointers to
+ * two keys.
+ *
+ * Example of an entry type that can be stored to this set, keyed by `id`.
+ * ~~~
+ *     typedef struct example_entry
+ *     {
+ *         uint16_t       id;
+ *         uint8_t        *data;
+ *     }
+ *     example_entry_t;
+ *
+ *     static int compare_id(const void *a, const void *b)
+ *     {
+ *         return *(const uint16_t *) a - *(const uint16_t *) b;
+ *     }
+ *
+ *     static void *my_entries[16];
+ *     static ns_sorted_array_t my_set;
+ *     ns_sorted_array_init(&my_set, my_entries, 16, example_entry_t, id, compare_id);
+ *
+ *     ns_sorted_array_insert(&my_set, entry);
+ *
+ *     uint16_t id = 7;
+ *     example_entry_t *found = ns_sorted_array_find(&my_set, &id);
+ * ~~~
+ * Entries can be walked in key order with ns_sorted_array_foreach(). Keys
+ * must not be modified while the entry is in the set.
+ */
+
+/** \brief Key comparison function.
+ *
+ * \param a Pointer to first key.
+ * \param b Pointer to second key.
+ *
+ * \return negative if a < b, zero if a == b, positive if a > b.
+ */
+typedef int ns_sorted_array_compare_t(const void *a, const void *b);
+
+/** \brief Sorted array head.
+ *
+ * Users should not access the members directly, but use the functions below.
+ */
+typedef struct ns_sorted_array {
+    void **entries;                         ///< User-provided array of entry pointers, in key order
+    uint_fast16_t size;                     ///< Capacity of entries
+    uint_fast16_t count;                    ///< Number of entries in the set
+    uint_fast16_t key_offset;               ///< Offset of the key field in the entries
+    ns_sorted_array_compare_t *compare;     ///< Key comparison function
+} ns_sorted_array_t;
+
+/** \hideinitializer \brief Initialise a sorted array
+ *
+ * \param array      `(ns_sorted_array_t *)`           Pointer to set.
+ * \param entries    `(void **)`                       Array for entry pointers.
+ * \param size       `(uint_fast16_t)`                 Number of elements in entries.
+ * \param entry_type                                   Entry type `(entry_t)`.
+ * \param key_field                                    Name of the key member in the entry.
+ * \param compare    `(ns_sorted_array_compare_t *)`   Key comparison function.
+ */
+#define ns_sorted_array_init(array, entries, size, entry_type, key_field, compare) \
+    ns_sorted_array_init_(array, entries, size, offsetof(entry_type, key_field), compare)
+
+/** \brief Get number of entries in a sorted array.
+ *
+ * \param array `(const ns_sorted_array_t *)` Pointer to set.
+ *
+ * \return      `(uint_fast16_t)`             Number of entries.
+ */
+#define ns_sorted_array_count(array) ((array)->count)
+
+/** \brief Get entry by position.
+ *
+ * \param array `(const ns_sorted_array_t *)` Pointer to set.
+ * \param index `(uint_fast16_t)`             Position in key order, less than count.
+ *
+ * \return      `(void *)`                    Pointer to entry.
+ */
+#define ns_sorted_array_get(array, index) ((array)->entries[index])
+
+/** \brief Iterate over a sorted array in key order.
+ *
+ * Insertion and removal are not permitted during the iteration.
+ *
+ * \param type                               Entry type `([const] entry_t)`.
+ * \param e                                  Name for iteration pointer to be defined
+ *                                           inside the loop.
+ * \param array `(const ns_sorted_array_t *)` Pointer to set - evaluated multiple times.
+ */
+#define ns_sorted_array_foreach(type, e, array) \
+    for (type *e, **_pos##e = (type **) (array)->entries; \
+        _pos##e < (type **) (array)->entries + (array)->count && (e = *_pos##e, true); _pos##e++)
+
+/** \brief Find the position of the first entry with key not less than `key`.
+ *
+ * \param array Pointer to set.
+ * \param key   Pointer to key.
+ *
+ * \return Position, from 0 to count inclusive.
+ */
+NS_INLINE uint_fast16_t ns_sorted_array_lower_bound(const ns_sorted_array_t *array, const void *key);
+
+/** \brief Find an entry by key.
+ *
+ * \param array Pointer to set.
+ * \param key   Pointer to key.
+ *
+ * \return Pointer to entry, or NULL if no entry has this key.
+ */
+NS_INLINE void *ns_sorted_array_find(const ns_sorted_array_t *array, const void *key);
+
+/** \brief Add an entry to a sorted array.
+ *
+ * \param array Pointer to set.
+ * \param entry Pointer to new entry to add.
+ *
+ * \return true if added, false if the set is full or an entry with the same
+ *         key is already in the set.
+ */
+NS_INLINE bool ns_sorted_array_insert(ns_sorted_array_t *array, void *entry);
+
+/** \brief Remove an entry from a sorted array.
+ *
+ * \param array Pointer to set.
+ * \param entry Entry to remove.
+ *
+ * \return true if removed, false if the entry was not in the set.
+ */
+NS_INLINE bool ns_sorted_array_remove(ns_sorted_array_t *array, void *entry);
+
+/** \privatesection
+ *  Internal functions - designed to be accessed using corresponding macros above
+ */
+NS_INLINE void ns_sorted_array_init_(ns_sorted_array_t *array, void **entries, uint_fast16_t size, uint_fast16_t key_offset, ns_sorted_array_compare_t *compare);
+
+/* Provide definitions, either for inlining, or for ns_sorted_array.c */
+#if defined NS_ALLOW_INLINING || defined NS_SORTED_ARRAY_FN
+#ifndef NS_SORTED_ARRAY_FN
+#define NS_SORTED_ARRAY_FN NS_INLINE
+#endif
+
+/* Pointer to the key in entry e */
+#define NS_SORTED_ARRAY_KEY_(array, e) ((const char *)(e) + (array)->key_offset)
+
+NS_SORTED_ARRAY_FN void ns_sorted_array_init_(ns_sorted_array_t *array, void **entries, uint_fast16_t size, uint_fast16_t key_offset, ns_sorted_array_compare_t *compare)
+{
+    array->entries = entries;
+    array->size = size;
+    array->count = 0;
+    array->key_offset = key_offset;
+    array->compare = compare;
+}
+
+NS_SORTED_ARRAY_FN uint_fast16_t ns_sorted_array_lower_bound(const ns_sorted_array_t *array, const void *key)
+{
+    uint_fast16_t lo = 0, hi = array->count;
+
+    while (lo < hi) {
+        uint_fast16_t mid = lo + (hi - lo) / 2;
+
+        if (array->compare(NS_SORTED_ARRAY_KEY_(array, array->entries[mid]), key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+NS_SORTED_ARRAY_FN void *ns_sorted_array_find(const ns_sorted_array_t *array, const void *key)
+{
+    uint_fast16_t pos = ns_sorted_array_lower_bound(array, key);
+
+    if (pos < array->count && array->compare(NS_SORTED_ARRAY_KEY_(array, array->entries[pos]), key) == 0) {
+        return array->entries[pos];
+    }
+
+    return NULL;
+}
+
+NS_SORTED_ARRAY_FN bool ns_sorted_array_insert(ns_sorted_array_t *array, void *entry)
+{
+    const void *key = NS_SORTED_ARRAY_KEY_(array, entry);
+    uint_fast16_t pos;
+
+    if (array->count >= array->size) {
+        return false;
+    }
+
+    pos = ns_sorted_array_lower_bound(array, key);
+    if (pos < array->count && array->compare(NS_SORTED_ARRAY_KEY_(array, array->entries[pos]), key) == 0) {
+        return false;
+    }
+
+    memmove(&array->entries[pos + 1], &array->entries[pos], (array->count - pos) * sizeof array->entries[0]);
+    array->entries[pos] = entry;
+    array->count++;
+    return true;
+}
+
+NS_SORTED_ARRAY_FN bool ns_sorted_array_remove(ns_sorted_array_t *array, void *entry)
+{
+    uint_fast16_t pos = ns_sorted_array_lower_bound(array, NS_SORTED_ARRAY_KEY_(array, entry));
+
+    if (pos >= array->count || array->entries[pos] != entry) {
+        return false;
+    }
+
+    array->count--;
+    memmove(&array->entries[pos], &array->entries[pos + 1], (array->count - pos) * sizeof array->entries[0]);
+    return true;
+}
+#endif /* defined NS_ALLOW_INLINING || defined NS_SORTED_ARRAY_FN */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NS_SORTED_ARRAY_H_ */
+
@@ -13,75 +13,77 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include <stdio.h>
-#include <string.h>
-#include "common_functions.h"
 #include "ip6string.h"
 
-/**
- * Print binary IPv6 address to a string.
- * String must contain enough room for full address, 40 bytes exact.
- * IPv4 tunneling addresses are not covered.
- * \param addr IPv6 address.
- * \p buffer to write string to.
+static const char hex_digits[] = "0123456789abcdef";
+
+/* Write one part as lower-case hex without leading zeros */
+static char *part_tos(uint_fast16_t part, char *p)
+{
+    if (part >= 0x1000) {
+        *p++ = hex_digits[part >> 12];
+    }
+    if (part >= 0x100) {
+        *p++ = hex_digits[(part >> 8) & 0xf];
+    }
+    if (part >= 0x10) {
+        *p++ = hex_digits[(part >> 4) & 0xf];
+    }
+    *p++ = hex_digits[part & 0xf];
+    return p;
+}
+
+/* Print the first `bits` bits of an address, treating the rest as zero.
+ * Bytes past the last one holding those bits are not read.
  */
-uint_fast8_t ip6tos(const void *ip6addr, char *p)
+static uint_fast8_t ip6_bits_tos(const uint8_t *addr, uint_fast8_t bits, char *p)
 {
     char *p_orig = p;
-    uint_fast8_t zero_start = 255, zero_len = 1;
-    const uint8_t *addr = ip6addr;
-    uint_fast16_t part;
+    uint_fast16_t part[8];
+    uint_fast8_t zero_start = 255, zero_len = 1, run = 0;
 
-    /* Follow RFC 5952 - pre-scan for longest run of zeros */
+    /* Load the parts and find the longest run of zeros in the same pass.
+     * Follow RFC 5952 - on equal length the first run wins (S4.2.3), and
+     * zero_len starting at 1 stops us shortening a 1-part run (S4.2.2).
+     */
     for (uint_fast8_t n = 0; n < 8; n++) {
-        part = *addr++;
-        part = (part << 8) | *addr++;
-        if (part != 0) {
-            continue;
-        }
+        uint_fast8_t hi = 0, lo = 0;
 
-        /* We're at the start of a run of zeros - scan to non-zero (or end) */
-        uint_fast8_t n0 = n;
-        for (n = n0 + 1; n < 8; n++) {
-            part = *addr++;
-            part = (part << 8) | *addr++;
-            if (part != 0) {
-                break;
-            }
+        if (bits >= 16) {
+            hi = addr[0];
+            lo = addr[1];
+            bits -= 16;
+        } else if (bits > 8) {
+            hi = addr[0];
+            lo = addr[1] & (0xff00 >> (bits - 8));
+            bits = 0;
+        } else if (bits > 0) {
+            hi = addr[0] & (0xff00 >> bits);
+            bits = 0;
         }
+        addr += 2;
 
-        /* Now n0->initial zero of run, n->after final zero in run. Is this the
-         * longest run yet? If equal, we stick with the previous one - RFC 5952
-         * S4.2.3. Note that zero_len being initialised to 1 stops us
-         * shortening a 1-part run (S4.2.2.)
-         */
-        if (n - n0 > zero_len) {
-            zero_start = n0;
-            zero_len = n - n0;
+        part[n] = (hi << 8) | lo;
+        if (part[n] != 0) {
+            run = 0;
+        } else if (++run > zero_len) {
+            zero_len = run;
+            zero_start = n + 1 - run;
         }
-
-        /* Continue scan for initial zeros from part n+1 - we've already
-         * consumed part n, and know it's non-zero. */
     }
 
-    /* Now go back and print, jumping over any zero run */
-    addr = ip6addr;
+    /* Now print, jumping over any zero run */
     for (uint_fast8_t n = 0; n < 8;) {
         if (n == zero_start) {
             if (n == 0) {
                 *p++ = ':';
             }
             *p++ = ':';
-            addr += 2 * zero_len;
             n += zero_len;
             continue;
         }
 
-        part = *addr++;
-        part = (part << 8) | *addr++;
-        n++;
-
-        p += sprintf(p, "%"PRIxFAST16, part);
+        p = part_tos(part[n++], p);
 
         /* One iteration writes "part:" rather than ":part", and has the
          * explicit check for n == 8 below, to allow easy extension for
@@ -99,20 +101,39 @@ uint_fast8_t ip6tos(const void *ip6addr, char *p)
     return p - p_orig;
 }
 
+/**
+ * Print binary IPv6 address to a string.
+ * String must contain enough room for full address, 40 bytes exact.
+ * IPv4 tunneling addresses are not covered.
+ * \param addr IPv6 address.
+ * \p buffer to write string to.
+ */
+uint_fast8_t ip6tos(const void *ip6addr, char *p)
+{
+    return ip6_bits_tos(ip6addr, 128, p);
+}
+
 uint_fast8_t ip6_prefix_tos(const void *prefix, uint_fast8_t prefix_len, char *p)
 {
     char *wptr = p;
-    uint8_t addr[16] = {0};
 
     if (prefix_len > 128) {
         return 0;
     }
 
-    // Generate prefix part of the string
-    bitcopy(addr, prefix, prefix_len);
-    wptr += ip6tos(addr, wptr);
+    // Generate prefix part of the string, bits past prefix_len print as zero
+    wptr += ip6_bits_tos(prefix, prefix_len, wptr);
+
     // Add the prefix length part of the string
-    wptr += sprintf(wptr, "/%"PRIuFAST8, prefix_len);
+    *wptr++ = '/';
+    if (prefix_len >= 100) {
+        *wptr++ = '0' + prefix_len / 100;
+    }
+    if (prefix_len >= 10) {
+        *wptr++ = '0' + (prefix_len / 10) % 10;
+    }
+    *wptr++ = '0' + prefix_len % 10;
+    *wptr = '\0';
 
     // Return total length of generated string
     return wptr - p;
@@ -19,7 +19,23 @@
 #include "common_functions.h"
 #include "ip6string.h"
 
-static uint16_t hex(const char *p);
+/* Value of each character from '0' to 'f', -1 for non-hex characters */
+static const int8_t hex_values['f' - '0' + 1] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9,                           /* 0-9 */
+    -1, -1, -1, -1, -1, -1, -1,                             /* :-@ */
+    10, 11, 12, 13, 14, 15,                                 /* A-F */
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,     /* G-S */
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,     /* T-` */
+    10, 11, 12, 13, 14, 15                                  /* a-f */
+};
+
+static int_fast8_t hex(char c)
+{
+    if (c >= '0' && c <= 'f') {
+        return hex_values[c - '0'];
+    }
+    return -1;
+}
 
 /**
  * Convert numeric IPv6 address string to a binary.
@@ -27,36 +43,74 @@ static uint16_t hex(const char *p);
  * \param ip6addr IPv6 address in string format.
  * \param len Length of ipv6 string.
  * \param dest buffer for address. MUST be 16 bytes.
+ * \return true if the whole string was a valid address
  */
-void stoip6(const char *ip6addr, size_t len, void *dest)
+bool stoip6(const char *ip6addr, size_t len, void *dest)
 {
-    uint8_t *addr;
-    const char *p, *q;
-    int_fast8_t field_no, coloncolon = -1;
-
-    addr = dest;
+    uint8_t *addr = dest;
+    const char *p = ip6addr;
+    const char *end = ip6addr + len;
+    uint_fast8_t field_no = 0;
+    int_fast8_t coloncolon = -1;
+    bool valid = true;
 
     if (len > 39) { // Too long, not possible. We do not support IPv4-mapped IPv6 addresses
-        return;
+        return false;
     }
 
-    // First go forward the string, until end, noting :: position if any
-    for (field_no = 0, p = ip6addr; (len > (p - ip6addr)) && *p && field_no < 8; p = q + 1) {
-        q = p;
-        // Seek for ':' or end
-        while (*q && (*q != ':')) {
-            q++;
+    if (p + 1 < end && p[0] == ':' && p[1] == ':') {
+        coloncolon = 0;
+        p += 2;
+    }
+
+    // Single pass over the string, writing fields and noting :: position if any
+    while (field_no < 8 && p < end && *p) {
+        uint_fast16_t value = 0;
+        uint_fast8_t digits = 0;
+        int_fast8_t v;
+
+        while (p < end && (v = hex(*p)) >= 0) {
+            value = (value << 4) | v;
+            digits++;
+            p++;
         }
-        //Convert and write this part, (high-endian AKA network byte order)
-        addr = common_write_16_bit(hex(p), addr);
+        if (digits == 0 || digits > 4) {
+            valid = false;
+        }
+
+        // Garbage up to the next ':' is skipped
+        if (p < end && *p && *p != ':') {
+            valid = false;
+            while (p < end && *p && *p != ':') {
+                p++;
+            }
+        }
+
+        //Write this part, (high-endian AKA network byte order)
+        addr = common_write_16_bit(value, addr);
         field_no++;
+
+        if (p >= end || !*p) {
+            break;
+        }
+        p++;
+
         //Check if we reached "::"
-        if ((len > (q - ip6addr)) && *q && (q[0] == ':') && (q[1] == ':')) {
+        if (p < end && *p == ':') {
+            if (coloncolon != -1) {
+                valid = false;
+            }
             coloncolon = field_no;
-            q++;
+            p++;
+        } else if (p >= end || !*p) {
+            valid = false; // Trailing single ':'
         }
     }
 
+    if (p < end && *p) {
+        valid = false; // Too many fields
+    }
+
     if (coloncolon != -1) {
         /* Insert zeros in the appropriate place */
         uint_fast8_t head_size = 2 * coloncolon;
@@ -65,11 +119,49 @@ void stoip6(const char *ip6addr, size_t len, void *dest)
         addr = dest;
         memmove(addr + head_size + inserted_size, addr + head_size, tail_size);
         memset(addr + head_size, 0, inserted_size);
+        if (field_no == 8) {
+            valid = false; // "::" must stand for at least one zero field
+        }
     } else if (field_no != 8) {
-        /* Should really report an error if we didn't get 8 fields */
         memset(addr, 0, 16 - field_no * 2);
+        valid = false;
+    }
+
+    return valid;
+}
+
+bool stoip6_prefix(const char *ip6addr, void *dest, int_fast16_t *prefix_len_out)
+{
+    const char *slash = ip6addr;
+    int_fast16_t prefix_len = -1;
+
+    // Address part ends at '/' or end of string
+    while (*slash && *slash != '/') {
+        slash++;
+    }
+
+    if (*slash == '/') {
+        const char *p = slash + 1;
+
+        prefix_len = 0;
+        while (*p >= '0' && *p <= '9' && prefix_len <= 128) {
+            prefix_len = prefix_len * 10 + (*p++ - '0');
+        }
+        if (p == slash + 1 || *p || prefix_len > 128) {
+            return false;
+        }
     }
+
+    if (!stoip6(ip6addr, slash - ip6addr, dest)) {
+        return false;
+    }
+
+    if (prefix_len_out) {
+        *prefix_len_out = prefix_len;
+    }
+    return true;
 }
+
 unsigned char  sipv6_prefixlength(const char *ip6addr)
 {
     char *ptr = strchr(ip6addr, '/');
@@ -78,21 +170,3 @@ unsigned char  sipv6_prefixlength(const char *ip6addr)
     }
     return 0;
 }
-static uint16_t hex(const char *p)
-{
-    uint16_t val = 0;
-
-    for (;;) {
-        char c = *p++;
-        if ((c >= '0') && (c <= '9')) {
-            val = (val << 4) | (c - '0');
-        } else if ((c >= 'A') && (c <= 'F')) {
-            val = (val << 4) | (10 + (c - 'A'));
-        } else if ((c >= 'a') && (c <= 'f')) {
-            val = (val << 4) | (10 + (c - 'a'));
-        } else {
-            break; // Non hex character
-        }
-    }
-    return val;
-}
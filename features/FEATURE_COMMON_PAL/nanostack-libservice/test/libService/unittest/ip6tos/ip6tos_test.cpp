@@ -18,6 +18,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <time.h>
 
 TEST_GROUP(ip6tos)
 {
@@ -61,6 +63,60 @@ TEST(ip6tos, ip6_prefix_tos_func)
     CHECK(str_len == 0);
 }
 
+TEST(ip6tos, ip6_prefix_tos_partial_byte)
+{
+    char prefix_str[45];
+
+    // Bits past the prefix length are not shown
+    uint8_t prefix[] = { 0x20, 0x01, 0x0d, 0xbf };
+    CHECK(13 == ip6_prefix_tos(prefix, 29, prefix_str));
+    STRCMP_EQUAL("2001:db8::/29", prefix_str);
+
+    uint8_t prefix_2[] = { 0xff };
+    CHECK(8 == ip6_prefix_tos(prefix_2, 1, prefix_str));
+    STRCMP_EQUAL("8000::/1", prefix_str);
+
+    CHECK(8 == ip6_prefix_tos(prefix, 9, prefix_str));
+    STRCMP_EQUAL("2000::/9", prefix_str);
+}
+
+TEST(ip6tos, longest_zero_run)
+{
+    char str[40];
+
+    // Longest run is compressed, the first one on a tie
+    uint8_t addr[16] = { 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1 };
+    ip6tos(addr, str);
+    STRCMP_EQUAL("1:0:0:1::1", str);
+
+    uint8_t addr_2[16] = { 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1 };
+    ip6tos(addr_2, str);
+    STRCMP_EQUAL("1::1:0:0:1:1", str);
+
+    // A single zero part is not compressed
+    uint8_t addr_3[16] = { 0, 1, 0, 0, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1 };
+    ip6tos(addr_3, str);
+    STRCMP_EQUAL("1:0:1:1:1:1:1:1", str);
+}
+
+TEST(ip6tos, throughput)
+{
+    const int rounds = 100000;
+    char str[40];
+    uint8_t addr[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55 };
+    unsigned long total = 0;
+    clock_t start = clock();
+
+    for (int n = 0; n < rounds; n++) {
+        addr[15] = n;
+        total += ip6tos(addr, str);
+    }
+
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("\nip6tos: %d addresses in %.3f s (%.0f ns each)\n", rounds, secs, secs * 1e9 / rounds);
+    CHECK(total > 0);
+}
+
 /***********************************************************/
 /* Second test group for the old tests that were once lost */
 
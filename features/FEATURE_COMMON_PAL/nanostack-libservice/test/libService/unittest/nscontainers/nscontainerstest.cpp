@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "ns_hashmap.h"
+#include "ns_sorted_array.h"
+#include "ns_heap.h"
+#include "ns_list.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#define ENTRIES 1000
+
+typedef struct test_entry {
+    uint16_t id;
+    uint8_t addr[16];
+    uint32_t expiry;
+    ns_list_link_t link;
+} test_entry_t;
+
+static test_entry_t entries[ENTRIES];
+
+static void fill_entries(void)
+{
+    srand(1);
+    for (int i = 0; i < ENTRIES; i++) {
+        entries[i].id = i * 7 + 3;
+        memset(entries[i].addr, 0, 16);
+        entries[i].addr[0] = 0xfe;
+        entries[i].addr[1] = 0x80;
+        entries[i].addr[14] = i >> 8;
+        entries[i].addr[15] = i;
+        entries[i].expiry = rand();
+    }
+}
+
+static int compare_uint16(const void *a, const void *b)
+{
+    return *(const uint16_t *) a - *(const uint16_t *) b;
+}
+
+static int compare_uint32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+    return x < y ? -1 : x > y;
+}
+
+static void print_rate(const char *what, int lookups, clock_t start)
+{
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("\n%s: %d lookups in %.3f s (%.1f ns each)\n", what, lookups, secs, secs * 1e9 / lookups);
+}
+
+/*************************************************************/
+
+TEST_GROUP(ns_hashmap)
+{
+    void setup() {
+        fill_entries();
+    }
+
+    void teardown() {
+    }
+};
+
+TEST(ns_hashmap, insert_find_remove)
+{
+    void *buckets[2048];
+    ns_hashmap_t map;
+    ns_hashmap_init(&map, buckets, 2048, test_entry_t, addr);
+
+    for (int i = 0; i < ENTRIES; i++) {
+        CHECK(ns_hashmap_insert(&map, &entries[i]));
+    }
+    CHECK(ns_hashmap_count(&map) == ENTRIES);
+
+    // Same entry, or another entry with the same key, is refused
+    CHECK(!ns_hashmap_insert(&map, &entries[5]));
+    test_entry_t dup = entries[5];
+    CHECK(!ns_hashmap_insert(&map, &dup));
+
+    for (int i = 0; i < ENTRIES; i++) {
+        CHECK(ns_hashmap_find(&map, entries[i].addr) == &entries[i]);
+    }
+    uint8_t missing[16];
+    memcpy(missing, entries[0].addr, 16);
+    missing[14] = 0xff;
+    CHECK(ns_hashmap_find(&map, missing) == NULL);
+
+    // Remove every other entry, the rest must stay reachable
+    for (int i = 0; i < ENTRIES; i += 2) {
+        CHECK(ns_hashmap_remove(&map, &entries[i]));
+    }
+    CHECK(!ns_hashmap_remove(&map, &entries[0]));
+    CHECK(ns_hashmap_count(&map) == ENTRIES / 2);
+    for (int i = 0; i < ENTRIES; i++) {
+        CHECK(ns_hashmap_find(&map, entries[i].addr) == (i & 1 ? &entries[i] : NULL));
+    }
+}
+
+TEST(ns_hashmap, full_with_collisions)
+{
+    void *buckets[8];
+    ns_hashmap_t map;
+    ns_hashmap_init(&map, buckets, 8, test_entry_t, id);
+
+    // One bucket always stays empty
+    for (int i = 0; i < 7; i++) {
+        CHECK(ns_hashmap_insert(&map, &entries[i]));
+    }
+    CHECK(!ns_hashmap_insert(&map, &entries[7]));
+
+    // Removal in any order keeps the probe runs intact
+    for (int round = 0; round < 200; round++) {
+        int out = rand() % 7;
+        test_entry_t *e = (test_entry_t *) ns_hashmap_find(&map, &entries[out].id);
+        CHECK(e == &entries[out]);
+        CHECK(ns_hashmap_remove(&map, e));
+        for (int i = 0; i < 7; i++) {
+            CHECK(ns_hashmap_find(&map, &entries[i].id) == (i == out ? NULL : &entries[i]));
+        }
+        CHECK(ns_hashmap_insert(&map, e));
+    }
+}
+
+TEST(ns_hashmap, lookup_benchmark)
+{
+    void *buckets[2048];
+    ns_hashmap_t map;
+    NS_LIST_DEFINE(list, test_entry_t, link);
+    const int lookups = 200000;
+    clock_t start;
+    int found = 0;
+
+    ns_hashmap_init(&map, buckets, 2048, test_entry_t, addr);
+    for (int i = 0; i < ENTRIES; i++) {
+        ns_hashmap_insert(&map, &entries[i]);
+        ns_list_add_to_end(&list, &entries[i]);
+    }
+
+    start = clock();
+    for (int n = 0; n < lookups; n++) {
+        found += ns_hashmap_find(&map, entries[(n * 7919) % ENTRIES].addr) != NULL;
+    }
+    print_rate("ns_hashmap 1000 addresses", lookups, start);
+    CHECK(found == lookups);
+
+    found = 0;
+    start = clock();
+    for (int n = 0; n < lookups / 100; n++) {
+        const uint8_t *addr = entries[(n * 7919) % ENTRIES].addr;
+        ns_list_foreach(test_entry_t, cur, &list) {
+            if (memcmp(cur->addr, addr, 16) == 0) {
+                found++;
+                break;
+            }
+        }
+    }
+    print_rate("ns_list 1000 addresses", lookups / 100, start);
+    CHECK(found == lookups / 100);
+}
+
+/*************************************************************/
+
+TEST_GROUP(ns_sorted_array)
+{
+    void setup() {
+        fill_entries();
+    }
+
+    void teardown() {
+    }
+};
+
+TEST(ns_sorted_array, insert_find_remove)
+{
+    void *slots[ENTRIES];
+    ns_sorted_array_t set;
+    ns_sorted_array_init(&set, slots, ENTRIES, test_entry_t, id, compare_uint16);
+
+    // Insert in scrambled order
+    for (int i = 0; i < ENTRIES; i++) {
+        CHECK(ns_sorted_array_insert(&set, &entries[(i * 7919) % ENTRIES]));
+    }
+    CHECK(ns_sorted_array_count(&set) == ENTRIES);
+    CHECK(!ns_sorted_array_insert(&set, &entries[0]));
+
+    uint16_t prev = 0;
+    int n = 0;
+    ns_sorted_array_foreach(const test_entry_t, e, &set) {
+        CHECK(n == 0 || e->id > prev);
+        prev = e->id;
+        n++;
+    }
+    CHECK(n == ENTRIES);
+
+    for (int i = 0; i < ENTRIES; i++) {
+        CHECK(ns_sorted_array_find(&set, &entries[i].id) == &entries[i]);
+        uint16_t missing = entries[i].id + 1;
+        CHECK(ns_sorted_array_find(&set, &missing) == NULL);
+    }
+
+    uint16_t key = 10;
+    CHECK(ns_sorted_array_lower_bound(&set, &key) == 1);
+    key = 0;
+    CHECK(ns_sorted_array_lower_bound(&set, &key) == 0);
+    key = 0xffff;
+    CHECK(ns_sorted_array_lower_bound(&set, &key) == ENTRIES);
+
+    for (int i = 0; i < ENTRIES; i += 2) {
+        CHECK(ns_sorted_array_remove(&set, &entries[i]));
+    }
+    CHECK(!ns_sorted_array_remove(&set, &entries[0]));
+    CHECK(ns_sorted_array_count(&set) == ENTRIES / 2);
+    CHECK(ns_sorted_array_get(&set, 0) == &entries[1]);
+}
+
+TEST(ns_sorted_array, full)
+{
+    void *slots[4];
+    ns_sorted_array_t set;
+    ns_sorted_array_init(&set, slots, 4, test_entry_t, id, compare_uint16);
+
+    for (int i = 0; i < 4; i++) {
+        CHECK(ns_sorted_array_insert(&set, &entries[i]));
+    }
+    CHECK(!ns_sorted_array_insert(&set, &entries[4]));
+}
+
+TEST(ns_sorted_array, lookup_benchmark)
+{
+    void *slots[ENTRIES];
+    ns_sorted_array_t set;
+    const int lookups = 200000;
+    int found = 0;
+
+    ns_sorted_array_init(&set, slots, ENTRIES, test_entry_t, id, compare_uint16);
+    for (int i = 0; i < ENTRIES; i++) {
+        ns_sorted_array_insert(&set, &entries[i]);
+    }
+
+    clock_t start = clock();
+    for (int n = 0; n < lookups; n++) {
+        found += ns_sorted_array_find(&set, &entries[(n * 7919) % ENTRIES].id) != NULL;
+    }
+    print_rate("ns_sorted_array 1000 ids", lookups, start);
+    CHECK(found == lookups);
+}
+
+/*************************************************************/
+
+TEST_GROUP(ns_heap)
+{
+    void setup() {
+        fill_entries();
+    }
+
+    void teardown() {
+    }
+};
+
+TEST(ns_heap, ordering)
+{
+    void *slots[ENTRIES];
+    ns_heap_t heap;
+    ns_heap_init(&heap, slots, ENTRIES, test_entry_t, expiry, compare_uint32);
+
+    CHECK(ns_heap_get_first(&heap) == NULL);
+    CHECK(ns_heap_remove_first(&heap) == NULL);
+
+    for (int i = 0; i < ENTRIES; i++) {
+        CHECK(ns_heap_insert(&heap, &entries[i]));
+    }
+    CHECK(!ns_heap_insert(&heap, &entries[0]));
+
+    // Drop a few from the middle
+    for (int i = 0; i < ENTRIES; i += 10) {
+        CHECK(ns_heap_remove(&heap, &entries[i]));
+    }
+    CHECK(!ns_heap_remove(&heap, &entries[0]));
+    CHECK(ns_heap_count(&heap) == ENTRIES - ENTRIES / 10);
+
+    uint32_t prev = 0;
+    int n = 0;
+    test_entry_t *e;
+    while ((e = (test_entry_t *) ns_heap_remove_first(&heap)) != NULL) {
+        CHECK(e->expiry >= prev);
+        CHECK((e - entries) % 10 != 0);
+        prev = e->expiry;
+        n++;
+    }
+    CHECK(n == ENTRIES - ENTRIES / 10);
+}
+
+TEST(ns_heap, benchmark)
+{
+    void *slots[ENTRIES];
+    ns_heap_t heap;
+    const int rounds = 200000;
+
+    ns_heap_init(&heap, slots, ENTRIES, test_entry_t, expiry, compare_uint32);
+    for (int i = 0; i < ENTRIES; i++) {
+        ns_heap_insert(&heap, &entries[i]);
+    }
+
+    // Timer-style churn: expire the first, reschedule it later
+    clock_t start = clock();
+    for (int n = 0; n < rounds; n++) {
+        test_entry_t *first = (test_entry_t *) ns_heap_remove_first(&heap);
+        first->expiry += rand() % 1000000;
+        ns_heap_insert(&heap, first);
+    }
+    print_rate("ns_heap 1000 entries, remove_first+insert", rounds, start);
+    CHECK(ns_heap_count(&heap) == ENTRIES);
+}
@@ -18,6 +18,8 @@
 #include "ipv6_test_values.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
+#include <time.h>
 
 TEST_GROUP(stoip6)
 {
@@ -80,6 +82,92 @@ TEST(stoip6, Prefixlen)
     CHECK(64 == sipv6_prefixlength("::/64"));
 }
 
+TEST(stoip6, ValidAddresses)
+{
+    for (int i = 0; ipv6_test_values[i].addr; i++) {
+        uint8_t ip[16];
+        char *addr = ipv6_test_values[i].addr;
+        CHECK(stoip6(addr, strlen(addr), ip));
+    }
+    uint8_t ip[16];
+    CHECK(stoip6("1:2:3:4:5:6:7::", 15, ip));
+    CHECK(stoip6("::2:3:4:5:6:7:8", 15, ip));
+}
+
+TEST(stoip6, InvalidAddresses)
+{
+    const char *invalid[] = {
+        "",
+        ":",
+        ":1::",
+        "1::2::3",
+        "12345::",
+        "1:2:3:4:5:6:7",
+        "1:2:3:4:5:6:7:8:",
+        "1:2:3:4:5:6:7:8::",
+        "1:2:3:4:5:6:7:8:9",
+        "1:2:3:4:5:6::7:8:9",
+        "1::2:",
+        "fe80::g",
+        "::1 ",
+        NULL
+    };
+    for (int i = 0; invalid[i]; i++) {
+        uint8_t ip[16];
+        CHECK(!stoip6(invalid[i], strlen(invalid[i]), ip));
+    }
+}
+
+TEST(stoip6, LengthLimitsParse)
+{
+    // Only the first len characters are looked at
+    uint8_t ip[16];
+    uint8_t correct[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+    CHECK(stoip6("2001:db8::1234", 10, ip));
+    CHECK(0 == memcmp(ip, correct, 16));
+}
+
+TEST(stoip6, PrefixParse)
+{
+    uint8_t ip[16];
+    int_fast16_t prefix_len;
+    uint8_t correct[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+
+    CHECK(stoip6_prefix("2001:db8::/32", ip, &prefix_len));
+    CHECK(32 == prefix_len);
+    CHECK(0 == memcmp(ip, correct, 16));
+
+    CHECK(stoip6_prefix("2001:db8::", ip, &prefix_len));
+    CHECK(-1 == prefix_len);
+
+    CHECK(stoip6_prefix("::/0", ip, &prefix_len));
+    CHECK(0 == prefix_len);
+    CHECK(stoip6_prefix("::1/128", ip, NULL));
+
+    CHECK(!stoip6_prefix("::/129", ip, &prefix_len));
+    CHECK(!stoip6_prefix("::/", ip, &prefix_len));
+    CHECK(!stoip6_prefix("::/64x", ip, &prefix_len));
+    CHECK(!stoip6_prefix("::/1000000000000", ip, &prefix_len));
+    CHECK(!stoip6_prefix("2001:::/64", ip, &prefix_len));
+}
+
+TEST(stoip6, Throughput)
+{
+    const int rounds = 100000;
+    uint8_t ip[16];
+    int parsed = 0;
+    clock_t start = clock();
+
+    for (int n = 0; n < rounds; n++) {
+        char *addr = ipv6_test_values[n % 13].addr;
+        parsed += stoip6(addr, strlen(addr), ip);
+    }
+
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("\nstoip6: %d addresses in %.3f s (%.0f ns each)\n", rounds, secs, secs * 1e9 / rounds);
+    CHECK(parsed == rounds);
+}
+
 // This test revealed a off-by-one error in stoip6() when the code was ran under valgrind.
 // The IP address is copied from the test_2duts_ping -test, where the valgrind message
 // was originally spotted.
@@ -85,6 +85,65 @@ void test_read_write() {
 }
 
 
+// Test for small records going through the file buffer
+template <ssize_t TEST_SIZE, ssize_t RECORD_SIZE>
+void test_read_write_buffered() {
+    FATFileSystem fs("fat");
+
+    int err = fs.mount(&bd);
+    TEST_ASSERT_EQUAL(0, err);
+
+    uint8_t record[RECORD_SIZE];
+
+    // write file in small records
+    File file;
+    err = file.set_buffer(BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    err = file.open(&fs, "test_read_write_buffered.dat", O_WRONLY | O_CREAT);
+    TEST_ASSERT_EQUAL(0, err);
+
+    srand(1);
+    for (int i = 0; i < TEST_SIZE; i += RECORD_SIZE) {
+        for (int j = 0; j < RECORD_SIZE; j++) {
+            record[j] = 0xff & rand();
+        }
+
+        ssize_t size = file.write(record, RECORD_SIZE);
+        TEST_ASSERT_EQUAL(RECORD_SIZE, size);
+        TEST_ASSERT_EQUAL(i + RECORD_SIZE, file.tell());
+        TEST_ASSERT_EQUAL(i + RECORD_SIZE, file.size());
+    }
+
+    err = file.close();
+    TEST_ASSERT_EQUAL(0, err);
+
+    // read file back in small records
+    err = file.open(&fs, "test_read_write_buffered.dat", O_RDONLY);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(((TEST_SIZE + RECORD_SIZE-1) / RECORD_SIZE) * RECORD_SIZE, file.size());
+
+    srand(1);
+    for (int i = 0; i < TEST_SIZE; i += RECORD_SIZE) {
+        ssize_t size = file.read(record, RECORD_SIZE);
+        TEST_ASSERT_EQUAL(RECORD_SIZE, size);
+
+        // Check that the data was unmodified
+        for (int j = 0; j < RECORD_SIZE; j++) {
+            TEST_ASSERT_EQUAL(0xff & rand(), record[j]);
+        }
+    }
+
+    ssize_t size = file.read(record, RECORD_SIZE);
+    TEST_ASSERT_EQUAL(0, size);
+
+    err = file.close();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = fs.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+
 // Simple test for iterating dir entries
 void test_read_dir() {
     FATFileSystem fs("fat");
@@ -140,9 +199,76 @@ void test_read_dir() {
 }
 
 
+// Benchmark of path lookup latency against directory size
+void test_lookup_latency() {
+    FATFileSystem fs("fat");
+
+    int err = fs.mount(&bd);
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = fs.mkdir("test_lookup_latency", S_IRWXU | S_IRWXG | S_IRWXO);
+    TEST_ASSERT_EQUAL(0, err);
+
+    const int iterations = 16;
+    const int dir_sizes[] = {8, 32, 128};
+    char path[64];
+    int count = 0;
+    Timer timer;
+
+    for (unsigned i = 0; i < sizeof(dir_sizes)/sizeof(dir_sizes[0]); i++) {
+        // Grow the directory with long file names
+        File file;
+        for (; count < dir_sizes[i]; count++) {
+            snprintf(path, sizeof(path), "test_lookup_latency/long_file_name_%04d.dat", count);
+            err = file.open(&fs, path, O_WRONLY | O_CREAT);
+            TEST_ASSERT_EQUAL(0, err);
+            err = file.close();
+            TEST_ASSERT_EQUAL(0, err);
+        }
+
+        // Look up the last entry in the directory
+        snprintf(path, sizeof(path), "test_lookup_latency/long_file_name_%04d.dat", count-1);
+
+        struct stat st;
+        timer.reset();
+        timer.start();
+        for (int j = 0; j < iterations; j++) {
+            err = fs.stat(path, &st);
+            TEST_ASSERT_EQUAL(0, err);
+        }
+        timer.stop();
+        int stat_us = timer.read_us() / iterations;
+
+        timer.reset();
+        timer.start();
+        for (int j = 0; j < iterations; j++) {
+            err = file.open(&fs, path, O_RDONLY);
+            TEST_ASSERT_EQUAL(0, err);
+            err = file.close();
+            TEST_ASSERT_EQUAL(0, err);
+        }
+        timer.stop();
+        int open_us = timer.read_us() / iterations;
+
+        printf("%d entries: stat %d us, open/close %d us\n", count, stat_us, open_us);
+    }
+
+    // Removed entries must not be found through the cache
+    err = fs.remove(path);
+    TEST_ASSERT_EQUAL(0, err);
+
+    struct stat st;
+    err = fs.stat(path, &st);
+    TEST_ASSERT_EQUAL(-ENOENT, err);
+
+    err = fs.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
-    GREENTEA_SETUP(10, "default_auto");
+    GREENTEA_SETUP(60, "default_auto");
     return verbose_test_setup_handler(number_of_cases);
 }
 
@@ -150,7 +276,9 @@ Case cases[] = {
     Case("Testing formating", test_format),
     Case("Testing read write < block", test_read_write<BLOCK_SIZE/2>),
     Case("Testing read write > block", test_read_write<2*BLOCK_SIZE>),
+    Case("Testing buffered read write of small records", test_read_write_buffered<4*BLOCK_SIZE, 24>),
     Case("Testing dir iteration", test_read_dir),
+    Case("Testing lookup latency", test_lookup_latency),
 };
 
 Specification specification(test_setup, cases);
@@ -21,6 +21,7 @@
 #include "HeapBlockDevice.h"
 #include "SlicingBlockDevice.h"
 #include "ChainingBlockDevice.h"
+#include "StripingBlockDevice.h"
 #include <stdlib.h>
 
 using namespace utest::v1;
@@ -35,6 +36,9 @@ using namespace utest::v1;
 #define BLOCK_SIZE 512
 #define UTIL_BLOCK_DEVICE_TEST_01         test_slicing
 #define UTIL_BLOCK_DEVICE_TEST_02         test_chaining
+#define UTIL_BLOCK_DEVICE_TEST_03         test_striping
+#define UTIL_BLOCK_DEVICE_TEST_04         test_striping_throughput
+#define SLOW_BLOCK_DEVICE_DELAY_MS 5
 uint8_t write_block[BLOCK_SIZE];
 uint8_t read_block[BLOCK_SIZE];
 
@@ -178,10 +182,133 @@ void test_chaining() {
     TEST_ASSERT_EQUAL(0, err);
 }
 
+// Simple test which read/writes blocks on a stripe of block devices
+void test_striping() {
+    HeapBlockDevice bd1((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+    HeapBlockDevice bd2((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+
+    // Test with stripe of block device
+    BlockDevice *bds[] = {&bd1, &bd2};
+    StripingBlockDevice stripe(bds);
+
+    int err = stripe.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, stripe.get_program_size());
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, stripe.get_stripe_size());
+    TEST_ASSERT_EQUAL(BLOCK_COUNT*BLOCK_SIZE, stripe.size());
+
+    // Fill with random sequence
+    srand(1);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        write_block[i] = 0xff & rand();
+    }
+
+    // Write, sync, and read the blocks, spanning both block devices
+    for (int i = 0; i < 4; i++) {
+        err = stripe.program(write_block, i*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    uint8_t *read_blocks = new uint8_t[4*BLOCK_SIZE];
+    err = stripe.read(read_blocks, 0, 4*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+
+    // Check that the data was unmodified
+    for (int i = 0; i < 4; i++) {
+        srand(1);
+        for (int j = 0; j < BLOCK_SIZE; j++) {
+            TEST_ASSERT_EQUAL(0xff & rand(), read_blocks[i*BLOCK_SIZE + j]);
+        }
+    }
+    delete[] read_blocks;
+
+    // Check that odd blocks ended up on the second block device
+    err = bd2.read(read_block, BLOCK_SIZE, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+
+    srand(1);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0xff & rand(), read_block[i]);
+    }
+
+    err = stripe.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+// Heap block device which simulates the access latency of an external device
+class SlowHeapBlockDevice : public HeapBlockDevice
+{
+public:
+    SlowHeapBlockDevice(bd_size_t size, bd_size_t block)
+        : HeapBlockDevice(size, block)
+    {
+    }
+
+    virtual int read(void *buffer, bd_addr_t addr, bd_size_t size)
+    {
+        Thread::wait(SLOW_BLOCK_DEVICE_DELAY_MS * (size / get_read_size()));
+        return HeapBlockDevice::read(buffer, addr, size);
+    }
+
+    virtual int program(const void *buffer, bd_addr_t addr, bd_size_t size)
+    {
+        Thread::wait(SLOW_BLOCK_DEVICE_DELAY_MS * (size / get_program_size()));
+        return HeapBlockDevice::program(buffer, addr, size);
+    }
+};
+
+static int time_transfer(BlockDevice *bd, uint8_t *buffer, bd_size_t size) {
+    Timer timer;
+    timer.start();
+
+    int err = bd->program(buffer, 0, size);
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = bd->read(buffer, 0, size);
+    TEST_ASSERT_EQUAL(0, err);
+
+    timer.stop();
+    return timer.read_us();
+}
+
+// Test that striping services the underlying block devices concurrently
+void test_striping_throughput() {
+    SlowHeapBlockDevice bd1((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+    SlowHeapBlockDevice bd2((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+    BlockDevice *bds[] = {&bd1, &bd2};
+    uint8_t *buffer = new uint8_t[BLOCK_COUNT*BLOCK_SIZE];
+    memset(buffer, 0x5a, BLOCK_COUNT*BLOCK_SIZE);
+
+    ChainingBlockDevice chain(bds);
+    int err = chain.init();
+    TEST_ASSERT_EQUAL(0, err);
+    int chain_us = time_transfer(&chain, buffer, BLOCK_COUNT*BLOCK_SIZE);
+    err = chain.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+
+    StripingBlockDevice stripe(bds);
+    err = stripe.init();
+    TEST_ASSERT_EQUAL(0, err);
+    int stripe_us = time_transfer(&stripe, buffer, BLOCK_COUNT*BLOCK_SIZE);
+    err = stripe.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+
+    delete[] buffer;
+
+    printf("chaining: %d us, striping: %d us for %d bytes\r\n",
+            chain_us, stripe_us, 2*BLOCK_COUNT*BLOCK_SIZE);
+
+    // Two devices working in parallel should take roughly half the time
+    TEST_ASSERT(stripe_us < (3*chain_us)/4);
+}
+
 #else   /* ! defined(TOOLCHAIN_IAR) && ! defined(TARGET_KL25Z) && ! defined(MBED_STACK_STATS_ENABLED) */
 
 #define UTIL_BLOCK_DEVICE_TEST_01      util_block_device_test_dummy
 #define UTIL_BLOCK_DEVICE_TEST_02      util_block_device_test_dummy
+#define UTIL_BLOCK_DEVICE_TEST_03      util_block_device_test_dummy
+#define UTIL_BLOCK_DEVICE_TEST_04      util_block_device_test_dummy
 
 /** @brief  util_block_device_test_dummy    Dummy test case for testing when KL25Z being built with stack statistics enabled.
  *
@@ -197,13 +324,15 @@ static control_t util_block_device_test_dummy()
 
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
-    GREENTEA_SETUP(10, "default_auto");
+    GREENTEA_SETUP(30, "default_auto");
     return verbose_test_setup_handler(number_of_cases);
 }
 
 Case cases[] = {
     Case("Testing slicing of a block device", UTIL_BLOCK_DEVICE_TEST_01),
     Case("Testing chaining of block devices", UTIL_BLOCK_DEVICE_TEST_02),
+    Case("Testing striping of block devices", UTIL_BLOCK_DEVICE_TEST_03),
+    Case("Testing striping throughput", UTIL_BLOCK_DEVICE_TEST_04),
 };
 
 Specification specification(test_setup, cases);
@@ -21,11 +21,17 @@
 
 File::File()
     : _fs(0), _file(0)
+    , _buffer(0), _buffer_size(MBED_CONF_FILESYSTEM_FILE_BUFFER_SIZE)
+    , _buffer_pos(0), _buffer_len(0), _buffer_off(0), _buffer_dirty(false)
+    , _read_end(0)
 {
 }
 
 File::File(FileSystem *fs, const char *path, int flags)
     : FileLike(path), _fs(0), _file(0)
+    , _buffer(0), _buffer_size(MBED_CONF_FILESYSTEM_FILE_BUFFER_SIZE)
+    , _buffer_pos(0), _buffer_len(0), _buffer_off(0), _buffer_dirty(false)
+    , _read_end(0)
 {
     open(fs, path, flags);
 }
@@ -46,6 +52,11 @@ int File::open(FileSystem *fs, const char *path, int flags)
     int err = fs->file_open(&_file, path, flags);
     if (!err) {
         _fs = fs;
+        _buffer_pos = _buffer_size ? _fs->file_tell(_file) : 0;
+        _buffer_len = 0;
+        _buffer_off = 0;
+        _buffer_dirty = false;
+        _read_end = _buffer_pos;
     }
 
     return err;
@@ -57,26 +68,232 @@ int File::close()
         return -EINVAL;
     }
 
+    int flush_err = flush_buffer();
     int err = _fs->file_close(_file);
     _fs = 0;
-    return err;
+
+    delete[] _buffer;
+    _buffer = 0;
+    return flush_err ? flush_err : err;
+}
+
+int File::set_buffer(size_t size)
+{
+    if (_fs) {
+        int err = flush_buffer();
+        if (err) {
+            return err;
+        }
+    }
+
+    delete[] _buffer;
+    _buffer = 0;
+    _buffer_size = size;
+
+    if (_fs && _buffer_size) {
+        _buffer_pos = _fs->file_tell(_file);
+        _read_end = _buffer_pos;
+    }
+
+    return 0;
+}
+
+int File::flush_buffer()
+{
+    if (_buffer_dirty) {
+        // Pass coalesced writes on to the filesystem
+        size_t done = 0;
+        int err = 0;
+        while (done < _buffer_len) {
+            ssize_t res = _fs->file_write(_file, _buffer + done, _buffer_len - done);
+            if (res <= 0) {
+                err = res < 0 ? res : -EIO;
+                break;
+            }
+
+            done += res;
+        }
+
+        _buffer_pos = _fs->file_tell(_file);
+        if (err) {
+            // Keep what did not make it dirty, so a later
+            // write, sync or close reports the error again
+            memmove(_buffer, _buffer + done, _buffer_len - done);
+            _buffer_len -= done;
+            return err;
+        }
+
+        _buffer_len = 0;
+        _buffer_dirty = false;
+        return 0;
+    }
+
+    if (_buffer_off < _buffer_len) {
+        // Drop unconsumed read-ahead, the filesystem is ahead of us
+        off_t res = _fs->file_seek(_file, _buffer_pos + _buffer_off, SEEK_SET);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    _buffer_pos += _buffer_off;
+    _buffer_len = 0;
+    _buffer_off = 0;
+    return 0;
 }
 
 ssize_t File::read(void *buffer, size_t len)
 {
     MBED_ASSERT(_fs);
-    return _fs->file_read(_file, buffer, len);
+    if (!_buffer_size) {
+        return _fs->file_read(_file, buffer, len);
+    }
+
+    if (_buffer_dirty) {
+        int err = flush_buffer();
+        if (err) {
+            return err;
+        }
+    }
+
+    uint8_t *data = static_cast<uint8_t*>(buffer);
+    size_t count = 0;
+    ssize_t res = 0;
+
+    while (count < len) {
+        // Serve as much as possible from the read-ahead
+        if (_buffer_off < _buffer_len) {
+            size_t chunk = _buffer_len - _buffer_off;
+            if (chunk > len - count) {
+                chunk = len - count;
+            }
+
+            memcpy(data + count, _buffer + _buffer_off, chunk);
+            _buffer_off += chunk;
+            count += chunk;
+            continue;
+        }
+
+        _buffer_pos += _buffer_len;
+        _buffer_len = 0;
+        _buffer_off = 0;
+
+        // Random or large reads go straight to the filesystem, only
+        // sequential small reads are worth reading ahead for
+        size_t remaining = len - count;
+        if (_buffer_pos != _read_end || remaining >= _buffer_size) {
+            res = _fs->file_read(_file, data + count, remaining);
+            if (res > 0) {
+                count += res;
+                _buffer_pos += res;
+            }
+            break;
+        }
+
+        if (!_buffer) {
+            _buffer = new uint8_t[_buffer_size];
+        }
+
+        // Read up to the next buffer-aligned offset so that
+        // following reads stay sector aligned
+        size_t fill = _buffer_size - (_buffer_pos % _buffer_size);
+        res = _fs->file_read(_file, _buffer, fill);
+        if (res <= 0) {
+            break;
+        }
+
+        _buffer_len = res;
+    }
+
+    _read_end = _buffer_pos + _buffer_off;
+    if (count == 0 && res < 0) {
+        return res;
+    }
+
+    return count;
 }
 
 ssize_t File::write(const void *buffer, size_t len)
 {
     MBED_ASSERT(_fs);
-    return _fs->file_write(_file, buffer, len);
+    if (!_buffer_size) {
+        return _fs->file_write(_file, buffer, len);
+    }
+
+    if (!_buffer_dirty) {
+        int err = flush_buffer();
+        if (err) {
+            return err;
+        }
+    }
+
+    const uint8_t *data = static_cast<const uint8_t*>(buffer);
+    size_t count = 0;
+
+    while (count < len) {
+        // Flush at buffer-aligned offsets so the filesystem
+        // sees whole, aligned sectors
+        size_t cap = _buffer_size - (_buffer_pos % _buffer_size);
+        size_t remaining = len - count;
+
+        if (_buffer_len == cap) {
+            // Still full from a flush that failed earlier
+            int err = flush_buffer();
+            if (err) {
+                return count ? count : err;
+            }
+            continue;
+        }
+
+        if (_buffer_len == 0 && remaining >= cap) {
+            // Nothing to coalesce with, write whole chunks directly
+            size_t chunk = cap + ((remaining - cap) / _buffer_size) * _buffer_size;
+            ssize_t res = _fs->file_write(_file, data + count, chunk);
+            if (res < 0) {
+                return count ? count : res;
+            }
+
+            count += res;
+            _buffer_pos = _fs->file_tell(_file);
+            if ((size_t)res < chunk) {
+                break;
+            }
+            continue;
+        }
+
+        if (!_buffer) {
+            _buffer = new uint8_t[_buffer_size];
+        }
+
+        size_t chunk = cap - _buffer_len;
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
+
+        memcpy(_buffer + _buffer_len, data + count, chunk);
+        _buffer_len += chunk;
+        _buffer_dirty = true;
+        count += chunk;
+
+        if (_buffer_len == cap && flush_buffer()) {
+            // Accepted data stays buffered, the error
+            // is reported by the next write or sync
+            break;
+        }
+    }
+
+    _read_end = -1;
+    return count;
 }
 
 int File::sync()
 {
     MBED_ASSERT(_fs);
+    int err = flush_buffer();
+    if (err) {
+        return err;
+    }
+
     return _fs->file_sync(_file);
 }
 
@@ -89,24 +306,50 @@ int File::isatty()
 off_t File::seek(off_t offset, int whence)
 {
     MBED_ASSERT(_fs);
-    return _fs->file_seek(_file, offset, whence);
+    if (_buffer_size) {
+        int err = flush_buffer();
+        if (err) {
+            return err;
+        }
+    }
+
+    off_t res = _fs->file_seek(_file, offset, whence);
+    if (res >= 0 && _buffer_size) {
+        _buffer_pos = res;
+    }
+
+    return res;
 }
 
 off_t File::tell()
 {
     MBED_ASSERT(_fs);
+    if (_buffer_size) {
+        return _buffer_pos + (_buffer_dirty ? _buffer_len : _buffer_off);
+    }
+
     return _fs->file_tell(_file);
 }
 
 void File::rewind()
 {
     MBED_ASSERT(_fs);
+    if (_buffer_size) {
+        seek(0, SEEK_SET);
+        return;
+    }
+
     return _fs->file_rewind(_file);
 }
 
 size_t File::size()
 {
     MBED_ASSERT(_fs);
-    return _fs->file_size(_file);
-}
+    size_t size = _fs->file_size(_file);
+    if (_buffer_dirty && size < _buffer_pos + _buffer_len) {
+        // Account for buffered writes without flushing them
+        size = _buffer_pos + _buffer_len;
+    }
 
+    return size;
+}
@@ -126,9 +126,36 @@ public:
      */
     virtual size_t size();
 
+    /** Set the size of the file's buffer
+     *
+     *  Buffered files service small sequential reads from a read-ahead
+     *  buffer and coalesce small writes into buffer-aligned writes to the
+     *  underlying filesystem. Pending writes are flushed on sync, seek
+     *  and close. The buffer size should be a multiple of the sector size
+     *  of the underlying block device.
+     *
+     *  Files are created with a buffer of filesystem.file-buffer-size bytes,
+     *  a size of 0 disables buffering.
+     *
+     *  @param size     Size of the buffer in bytes, 0 to disable buffering
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int set_buffer(size_t size);
+
 private:
+    int flush_buffer();
+
     FileSystem *_fs;
     fs_file_t _file;
+
+    // Optional read-ahead/write coalescing buffer
+    uint8_t *_buffer;
+    size_t _buffer_size;
+    off_t _buffer_pos;      // File offset of the first byte in the buffer
+    size_t _buffer_len;     // Number of valid bytes in the buffer
+    size_t _buffer_off;     // Read position in the buffer
+    bool _buffer_dirty;     // Buffer holds writes not yet passed to the filesystem
+    off_t _read_end;        // Offset after the last read, used to detect sequential reads
 };
 
 
@@ -0,0 +1,323 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripingBlockDevice.h"
+
+
+struct StripingBlockDevice::stripe_worker {
+    StripingBlockDevice *parent;
+    size_t index;
+    int err;
+#ifdef MBED_CONF_RTOS_PRESENT
+    rtos::Thread *thread;
+    rtos::Semaphore start;
+#endif
+};
+
+StripingBlockDevice::StripingBlockDevice(BlockDevice **bds, size_t bd_count, bd_size_t stripe_size)
+    : _bds(bds), _bd_count(bd_count)
+    , _read_size(0), _program_size(0), _erase_size(0), _size(0)
+    , _stripe_size(stripe_size), _requested_stripe_size(stripe_size)
+    , _workers(0)
+{
+}
+
+StripingBlockDevice::~StripingBlockDevice()
+{
+    stop_workers(_bd_count);
+}
+
+static bool is_aligned(uint64_t x, uint64_t alignment)
+{
+    return (x / alignment) * alignment == x;
+}
+
+int StripingBlockDevice::init()
+{
+    _read_size = 0;
+    _program_size = 0;
+    _erase_size = 0;
+    _size = 0;
+
+    // Initialize children block devices, find all sizes and
+    // assert that block sizes are similar. We can't do this in
+    // the constructor since some block devices may need to be
+    // initialized before they know their block size/count
+    bd_size_t min_size = 0;
+    for (size_t i = 0; i < _bd_count; i++) {
+        int err = _bds[i]->init();
+        if (err) {
+            return err;
+        }
+
+        bd_size_t read = _bds[i]->get_read_size();
+        if (i == 0 || (read >= _read_size && is_aligned(read, _read_size))) {
+            _read_size = read;
+        } else {
+            MBED_ASSERT(_read_size > read && is_aligned(_read_size, read));
+        }
+
+        bd_size_t program = _bds[i]->get_program_size();
+        if (i == 0 || (program >= _program_size && is_aligned(program, _program_size))) {
+            _program_size = program;
+        } else {
+            MBED_ASSERT(_program_size > program && is_aligned(_program_size, program));
+        }
+
+        bd_size_t erase = _bds[i]->get_erase_size();
+        if (i == 0 || (erase >= _erase_size && is_aligned(erase, _erase_size))) {
+            _erase_size = erase;
+        } else {
+            MBED_ASSERT(_erase_size > erase && is_aligned(_erase_size, erase));
+        }
+
+        bd_size_t size = _bds[i]->size();
+        if (i == 0 || size < min_size) {
+            min_size = size;
+        }
+    }
+
+    // Stripes must cover whole erase blocks so that every
+    // erase can be forwarded to exactly one block device
+    _stripe_size = _requested_stripe_size ? _requested_stripe_size : _erase_size;
+    MBED_ASSERT(_stripe_size > 0 && is_aligned(_stripe_size, _erase_size));
+    _size = (min_size / _stripe_size) * _stripe_size * _bd_count;
+
+#ifdef MBED_CONF_RTOS_PRESENT
+    // The calling thread services the first block device itself,
+    // every other block device gets a dedicated worker thread
+    if (!_workers && _bd_count > 1) {
+        _workers = new stripe_worker[_bd_count];
+        for (size_t i = 1; i < _bd_count; i++) {
+            _workers[i].parent = this;
+            _workers[i].index = i;
+            _workers[i].err = 0;
+            _workers[i].thread = new rtos::Thread(osPriorityNormal,
+                    MBED_CONF_FILESYSTEM_STRIPING_STACK_SIZE);
+
+            osStatus status = _workers[i].thread->start(
+                    callback(&StripingBlockDevice::worker_loop, &_workers[i]));
+            if (status != osOK) {
+                delete _workers[i].thread;
+                stop_workers(i);
+                return BD_ERROR_DEVICE_ERROR;
+            }
+        }
+    }
+#endif
+
+    return 0;
+}
+
+int StripingBlockDevice::deinit()
+{
+    stop_workers(_bd_count);
+
+    for (size_t i = 0; i < _bd_count; i++) {
+        int err = _bds[i]->deinit();
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+void StripingBlockDevice::stop_workers(size_t count)
+{
+#ifdef MBED_CONF_RTOS_PRESENT
+    if (!_workers) {
+        return;
+    }
+
+    _op = STRIPE_EXIT;
+    for (size_t i = 1; i < count; i++) {
+        _workers[i].start.release();
+        _workers[i].thread->join();
+        delete _workers[i].thread;
+    }
+
+    delete[] _workers;
+    _workers = 0;
+#endif
+}
+
+void StripingBlockDevice::worker_loop(stripe_worker *worker)
+{
+#ifdef MBED_CONF_RTOS_PRESENT
+    StripingBlockDevice *parent = worker->parent;
+
+    while (true) {
+        worker->start.wait();
+        if (parent->_op == STRIPE_EXIT) {
+            return;
+        }
+
+        worker->err = parent->service(worker->index);
+        parent->_done.release();
+    }
+#endif
+}
+
+int StripingBlockDevice::service(size_t index)
+{
+    bd_addr_t addr = _addr;
+    bd_addr_t end = _addr + _req_size;
+
+    // Find the first stripe at or after addr that lives on this block device,
+    // every _bd_count'th stripe after that lives on this block device as well
+    bd_addr_t stripe = addr / _stripe_size;
+    stripe += (index + _bd_count - (stripe % _bd_count)) % _bd_count;
+
+    for (; stripe * _stripe_size < end; stripe += _bd_count) {
+        bd_addr_t start = stripe * _stripe_size;
+        bd_addr_t stop = start + _stripe_size;
+        if (start < addr) {
+            start = addr;
+        }
+        if (stop > end) {
+            stop = end;
+        }
+
+        bd_addr_t bdaddr = (stripe / _bd_count) * _stripe_size
+                + (start - stripe * _stripe_size);
+        uint8_t *buffer = _buffer + (start - addr);
+
+        int err = 0;
+        switch (_op) {
+            case STRIPE_READ:
+                err = _bds[index]->read(buffer, bdaddr, stop - start);
+                break;
+            case STRIPE_PROGRAM:
+                err = _bds[index]->program(buffer, bdaddr, stop - start);
+                break;
+            case STRIPE_ERASE:
+                err = _bds[index]->erase(bdaddr, stop - start);
+                break;
+            default:
+                break;
+        }
+
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+int StripingBlockDevice::dispatch(stripe_op op, void *buffer, bd_addr_t addr, bd_size_t size)
+{
+#ifdef MBED_CONF_RTOS_PRESENT
+    _mutex.lock();
+#endif
+
+    _op = op;
+    _buffer = static_cast<uint8_t*>(buffer);
+    _addr = addr;
+    _req_size = size;
+
+    // Only wake up the block devices that take part in the request
+    bd_size_t stripes = (addr + size + _stripe_size - 1) / _stripe_size
+            - addr / _stripe_size;
+    size_t first = (addr / _stripe_size) % _bd_count;
+    size_t active = stripes < _bd_count ? stripes : _bd_count;
+
+    int err = 0;
+    if (_workers) {
+#ifdef MBED_CONF_RTOS_PRESENT
+        bool local = false;
+        for (size_t i = 0; i < active; i++) {
+            size_t index = (first + i) % _bd_count;
+            if (index == 0) {
+                local = true;
+            } else {
+                _workers[index].start.release();
+            }
+        }
+
+        if (local) {
+            err = service(0);
+        }
+
+        for (size_t i = 0; i < active; i++) {
+            size_t index = (first + i) % _bd_count;
+            if (index != 0) {
+                _done.wait();
+            }
+        }
+
+        for (size_t i = 0; i < active && !err; i++) {
+            size_t index = (first + i) % _bd_count;
+            if (index != 0) {
+                err = _workers[index].err;
+            }
+        }
+#endif
+    } else {
+        for (size_t i = 0; i < active && !err; i++) {
+            err = service((first + i) % _bd_count);
+        }
+    }
+
+#ifdef MBED_CONF_RTOS_PRESENT
+    _mutex.unlock();
+#endif
+    return err;
+}
+
+int StripingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_read(addr, size));
+    return dispatch(STRIPE_READ, b, addr, size);
+}
+
+int StripingBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_program(addr, size));
+    return dispatch(STRIPE_PROGRAM, const_cast<void*>(b), addr, size);
+}
+
+int StripingBlockDevice::erase(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return dispatch(STRIPE_ERASE, 0, addr, size);
+}
+
+bd_size_t StripingBlockDevice::get_read_size() const
+{
+    return _read_size;
+}
+
+bd_size_t StripingBlockDevice::get_program_size() const
+{
+    return _program_size;
+}
+
+bd_size_t StripingBlockDevice::get_erase_size() const
+{
+    return _erase_size;
+}
+
+bd_size_t StripingBlockDevice::get_stripe_size() const
+{
+    return _stripe_size;
+}
+
+bd_size_t StripingBlockDevice::size()
+{
+    return _size;
+}
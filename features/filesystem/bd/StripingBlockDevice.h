@@ -0,0 +1,205 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_STRIPING_BLOCK_DEVICE_H
+#define MBED_STRIPING_BLOCK_DEVICE_H
+
+#include "BlockDevice.h"
+#include "mbed.h"
+
+
+/** Block device for striping multiple block devices
+ *  with similar block sizes into a single interleaved address space
+ *
+ *  Consecutive stripes of the striped device are spread round-robin
+ *  across the underlying block devices (RAID-0). Requests that span
+ *  multiple stripes are split, and each underlying block device is
+ *  serviced by its own worker thread so that independent devices,
+ *  such as flash chips on separate buses, operate concurrently.
+ *
+ *  The stripe size defaults to the erase size of the underlying block
+ *  devices. The size of the striped device is limited by the smallest
+ *  underlying block device.
+ *
+ *  @code
+ *  #include "mbed.h"
+ *  #include "HeapBlockDevice.h"
+ *  #include "StripingBlockDevice.h"
+ *
+ *  // Create two block devices with 64 blocks of size 512 bytes
+ *  HeapBlockDevice mem1(64*512, 512);
+ *  HeapBlockDevice mem2(64*512, 512);
+ *
+ *  // Create a block device backed by mem1 and mem2
+ *  // contains 128 blocks of size 512 bytes, block 0 lives
+ *  // on mem1, block 1 on mem2, block 2 on mem1 and so on
+ *  BlockDevice *bds[] = {&mem1, &mem2};
+ *  StripingBlockDevice stripemem(bds);
+ */
+class StripingBlockDevice : public BlockDevice
+{
+public:
+    /** Lifetime of the memory block device
+     *
+     *  @param bds          Array of block devices to stripe across
+     *  @param bd_count     Number of block devices to stripe across
+     *  @param stripe_size  Size of a stripe in bytes, must be a multiple of
+     *                      the erase size, defaults to the erase size
+     *  @note All block devices must have the same block size
+     */
+    StripingBlockDevice(BlockDevice **bds, size_t bd_count, bd_size_t stripe_size = 0);
+
+    /** Lifetime of the memory block device
+     *
+     *  @param bds          Array of block devices to stripe across
+     *  @note All block devices must have the same block size
+     *  @note The stripe size defaults to the erase size
+     */
+    template <size_t Size>
+    StripingBlockDevice(BlockDevice *(&bds)[Size])
+        : _bds(bds), _bd_count(sizeof(bds) / sizeof(bds[0]))
+        , _read_size(0), _program_size(0), _erase_size(0), _size(0)
+        , _stripe_size(0), _requested_stripe_size(0)
+        , _workers(0)
+    {
+    }
+
+    /** Lifetime of the memory block device
+     */
+    virtual ~StripingBlockDevice();
+
+    /** Initialize a block device
+     *
+     *  Initializes the underlying block devices and starts a worker
+     *  thread for each underlying block device beyond the first
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int init();
+
+    /** Deinitialize a block device
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int deinit();
+
+    /** Read blocks from a block device
+     *
+     *  @param buffer   Buffer to write blocks to
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int read(void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Program blocks to a block device
+     *
+     *  The blocks must have been erased prior to being programmed
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int program(const void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Erase blocks on a block device
+     *
+     *  The state of an erased block is undefined until it has been programmed
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int erase(bd_addr_t addr, bd_size_t size);
+
+    /** Get the size of a readable block
+     *
+     *  @return         Size of a readable block in bytes
+     */
+    virtual bd_size_t get_read_size() const;
+
+    /** Get the size of a programable block
+     *
+     *  @return         Size of a programable block in bytes
+     *  @note Must be a multiple of the read size
+     */
+    virtual bd_size_t get_program_size() const;
+
+    /** Get the size of a eraseable block
+     *
+     *  @return         Size of a eraseable block in bytes
+     *  @note Must be a multiple of the program size
+     */
+    virtual bd_size_t get_erase_size() const;
+
+    /** Get the size of a stripe
+     *
+     *  @return         Size of a stripe in bytes
+     *  @note Must be a multiple of the erase size
+     */
+    virtual bd_size_t get_stripe_size() const;
+
+    /** Get the total size of the underlying device
+     *
+     *  @return         Size of the underlying device in bytes
+     */
+    virtual bd_size_t size();
+
+protected:
+    enum stripe_op {
+        STRIPE_READ,
+        STRIPE_PROGRAM,
+        STRIPE_ERASE,
+        STRIPE_EXIT,
+    };
+
+    struct stripe_worker;
+
+    int dispatch(stripe_op op, void *buffer, bd_addr_t addr, bd_size_t size);
+    int service(size_t index);
+    void stop_workers(size_t count);
+    static void worker_loop(stripe_worker *worker);
+
+    BlockDevice **_bds;
+    size_t _bd_count;
+    bd_size_t _read_size;
+    bd_size_t _program_size;
+    bd_size_t _erase_size;
+    bd_size_t _size;
+    bd_size_t _stripe_size;
+    bd_size_t _requested_stripe_size;
+
+    // Currently dispatched request, shared with the workers
+    stripe_op _op;
+    uint8_t *_buffer;
+    bd_addr_t _addr;
+    bd_size_t _req_size;
+
+    stripe_worker *_workers;
+#ifdef MBED_CONF_RTOS_PRESENT
+    rtos::Mutex _mutex;
+    rtos::Semaphore _done;
+#endif
+};
+
+
+#endif
@@ -1455,8 +1455,10 @@ BYTE sum_sfn (
 /*-----------------------------------------------------------------------*/
 
 static
-FRESULT dir_find (	/* FR_OK(0):succeeded, !=0:error */
-	FATFS_DIR* dp			/* Pointer to the directory object linked to the file name */
+FRESULT dir_find_range (	/* FR_OK(0):succeeded, !=0:error */
+	FATFS_DIR* dp,			/* Pointer to the directory object linked to the file name */
+	UINT start,				/* Index of the first entry to search */
+	UINT end				/* Index of the last entry to search */
 )
 {
 	FRESULT res;
@@ -1465,7 +1467,7 @@ FRESULT dir_find (	/* FR_OK(0):succeeded, !=0:error */
 	BYTE a, ord, sum;
 #endif
 
-	res = dir_sdi(dp, 0);			/* Rewind directory object */
+	res = dir_sdi(dp, start);		/* Move directory object to the first entry */
 	if (res != FR_OK) return res;
 
 #if _USE_LFN
@@ -1503,12 +1505,107 @@ FRESULT dir_find (	/* FR_OK(0):succeeded, !=0:error */
 			break;
 #endif
 		res = dir_next(dp, 0);		/* Next entry */
+		if (res == FR_OK && dp->index > end) res = FR_NO_FILE;	/* Reached to end of range */
 	} while (res == FR_OK);
 
 	return res;
 }
 
 
+static
+FRESULT dir_find (	/* FR_OK(0):succeeded, !=0:error */
+	FATFS_DIR* dp			/* Pointer to the directory object linked to the file name */
+)
+{
+	return dir_find_range(dp, 0, 0xFFFF);
+}
+
+
+
+
+#if _FS_DCACHE
+/*-----------------------------------------------------------------------*/
+/* Directory entry cache                                                 */
+/*-----------------------------------------------------------------------*/
+
+static
+DWORD dcache_hash (		/* Returns the hash of the path up to the end of the segment */
+	DWORD hash,			/* Hash of the path up to the segment */
+	const TCHAR* path	/* Pointer to the segment in the path name */
+)
+{
+	WCHAR c;
+
+
+	for (;;) {			/* FNV-1a over the segment, case insensitive as FAT names are */
+		c = (WCHAR)*path++;
+		if (c < ' ' || c == '/' || c == '\\') break;
+		if (IsLower(c)) c -= 0x20;
+		hash = (hash ^ c) * 16777619;
+	}
+	hash = (hash ^ '/') * 16777619;
+
+	return hash ? hash : 1;	/* 0 is reserved for unused entries */
+}
+
+
+static
+void dcache_flush (
+	FATFS* fs			/* File system object */
+)
+{
+	mem_set(fs->dcache, 0, sizeof fs->dcache);
+}
+
+
+static
+void dcache_store (
+	FATFS_DIR* dp,		/* Directory object pointing the found entry */
+	DWORD hash			/* Hash of the path to the entry */
+)
+{
+	DCENT* ent = &dp->fs->dcache[hash % _FS_DCACHE];
+
+
+	ent->hash = hash;
+	ent->sclust = dp->sclust;
+	ent->index = dp->index;
+#if _USE_LFN
+	ent->lfn_idx = dp->lfn_idx;
+#endif
+}
+
+
+static
+FRESULT dir_find_cached (	/* FR_OK(0):succeeded, !=0:error */
+	FATFS_DIR* dp,			/* Pointer to the directory object linked to the file name */
+	DWORD hash				/* Hash of the path to the entry */
+)
+{
+	FRESULT res;
+	DCENT* ent = &dp->fs->dcache[hash % _FS_DCACHE];
+	UINT start;
+
+
+	if (ent->hash == hash && ent->sclust == dp->sclust) {
+		/* Cache hit, verify the name against the cached entries only */
+		start = ent->index;
+#if _USE_LFN
+		if (ent->lfn_idx != 0xFFFF) start = ent->lfn_idx;
+#endif
+		res = dir_find_range(dp, start, ent->index);
+		if (res == FR_OK && dp->index == ent->index) return FR_OK;
+		ent->hash = 0;		/* Stale or colliding entry */
+	}
+
+	res = dir_find(dp);		/* Cache miss, scan the whole directory */
+	if (res == FR_OK) dcache_store(dp, hash);
+
+	return res;
+}
+#endif
+
+
 
 
 /*-----------------------------------------------------------------------*/
@@ -2074,10 +2171,22 @@ FRESULT follow_path (	/* FR_OK(0): successful, !=0: error code */
 		res = dir_sdi(dp, 0);
 		dp->dir = 0;
 	} else {								/* Follow path */
+#if _FS_DCACHE
+		DWORD hash = 2166136261U;			/* Path hash, seeded with the FNV offset basis */
+		const TCHAR* seg;
+#endif
 		for (;;) {
+#if _FS_DCACHE
+			seg = path;
+#endif
 			res = create_name(dp, &path);	/* Get a segment name of the path */
 			if (res != FR_OK) break;
+#if _FS_DCACHE
+			hash = dcache_hash(hash, seg);
+			res = dir_find_cached(dp, hash);	/* Find an object with the sagment name */
+#else
 			res = dir_find(dp);				/* Find an object with the sagment name */
+#endif
 			ns = dp->fn[NSFLAG];
 			if (res != FR_OK) {				/* Failed to find the object */
 				if (res == FR_NO_FILE) {	/* Object is not found */
@@ -2351,6 +2460,9 @@ FRESULT find_volume (	/* FR_OK(0): successful, !=0: any error occurred */
 #endif
 	fs->fs_type = fmt;	/* FAT sub-type */
 	fs->id = ++Fsid;	/* File system mount ID */
+#if _FS_DCACHE
+	dcache_flush(fs);	/* Drop directory entries of the previous volume */
+#endif
 #if _FS_RPATH
 	fs->cdir = 0;		/* Set current directory to root */
 #endif
@@ -3593,6 +3705,9 @@ FRESULT f_unlink (
 				if (res == FR_OK) res = sync_fs(dj.fs);
 			}
 		}
+#if _FS_DCACHE
+		dcache_flush(dj.fs);		/* Directory entries may have moved */
+#endif
 		FREE_BUF();
 	}
 
@@ -3667,6 +3782,9 @@ FRESULT f_mkdir (
 				res = sync_fs(dj.fs);
 			}
 		}
+#if _FS_DCACHE
+		dcache_flush(dj.fs);		/* Directory entries may have moved */
+#endif
 		FREE_BUF();
 	}
 
@@ -3787,6 +3905,9 @@ FRESULT f_rename (
 				}
 			}
 		}
+#if _FS_DCACHE
+		dcache_flush(djo.fs);		/* Directory entries may have moved */
+#endif
 		FREE_BUF();
 	}
 
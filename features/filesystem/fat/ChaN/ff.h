@@ -73,6 +73,19 @@ typedef char TCHAR;
 
 
 
+/* Directory entry cache item (DCENT) */
+
+#if _FS_DCACHE
+typedef struct {
+	DWORD	hash;			/* Hash of the path up to and including the entry name (0:unused) */
+	DWORD	sclust;			/* Start cluster of the directory containing the entry */
+	WORD	index;			/* Index of the SFN entry in the directory */
+	WORD	lfn_idx;		/* Index of the first LFN entry (0xFFFF:No LFN) */
+} DCENT;
+#endif
+
+
+
 /* File system object structure (FATFS) */
 
 typedef struct {
@@ -104,6 +117,9 @@ typedef struct {
 	DWORD	dirbase;		/* Root directory start sector (FAT32:Cluster#) */
 	DWORD	database;		/* Data start sector */
 	DWORD	winsect;		/* Current sector appearing in the win[] */
+#if _FS_DCACHE
+	DCENT	dcache[_FS_DCACHE];	/* Directory entry cache */
+#endif
 	BYTE	win[_MAX_SS];	/* Disk access window for Directory, FAT (and file data at tiny cfg) */
 } FATFS;
 
@@ -228,6 +228,22 @@
 /      lock feature is independent of re-entrancy. */
 
 
+#ifdef MBED_CONF_FILESYSTEM_FAT_DENTRY_CACHE
+#define _FS_DCACHE	MBED_CONF_FILESYSTEM_FAT_DENTRY_CACHE
+#else
+#define _FS_DCACHE	0
+#endif
+/* The _FS_DCACHE option switches the directory entry cache. Each volume keeps
+/  a direct-mapped table of path hash -> (directory start cluster, entry index)
+/  so that path lookups skip the linear directory scan for recently resolved
+/  path segments. Cached entries are always verified against the directory
+/  entry itself and the table is flushed on remove, rename and mkdir.
+/
+/  0:  Disable directory entry cache.
+/  >0: Enable directory entry cache. The value defines the number of cache
+/      entries per volume, each entry takes 12 bytes in the FATFS object. */
+
+
 #define _FS_REENTRANT	0
 #define _FS_TIMEOUT		1000
 #define	_SYNC_t			HANDLE
@@ -31,6 +31,7 @@
 #include "bd/BlockDevice.h"
 #include "bd/BlockDevice.h"
 #include "bd/ChainingBlockDevice.h"
+#include "bd/StripingBlockDevice.h"
 #include "bd/SlicingBlockDevice.h"
 #include "bd/HeapBlockDevice.h"
 
@@ -4,6 +4,8 @@
 #ifndef GREENTEA_METRICS_H
 #define GREENTEA_METRICS_H
 
+#include <stdint.h>
+
 /**
  *  Setup platform specific metrics
  */
@@ -14,6 +16,16 @@ void greentea_metrics_setup(void);
  */
 void greentea_metrics_report(void);
 
+/**
+ *  Report the timing statistics of a benchmark
+ *
+ *  Sent to the host as {{__benchmark;"name",iterations,min,median,p99,max}}
+ *  with all times in microseconds
+ */
+void greentea_metrics_benchmark(const char *name, uint32_t iterations,
+                                uint32_t min_us, uint32_t median_us,
+                                uint32_t p99_us, uint32_t max_us);
+
 #endif
 
 /** @}*/
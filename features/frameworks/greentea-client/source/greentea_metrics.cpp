@@ -35,8 +35,8 @@ typedef struct {
 
 // Mutex to protect "buf"
 static SingletonPtr<Mutex> mutex;
-#if defined(MBED_STACK_STATS_ENABLED) && MBED_STACK_STATS_ENABLED
 static char buf[128];
+#if defined(MBED_STACK_STATS_ENABLED) && MBED_STACK_STATS_ENABLED
 static SingletonPtr<CircularBuffer<thread_info_t, THREAD_BUF_COUNT> > queue;
 #endif
 
@@ -49,8 +49,8 @@ static void deque_and_print_thread_info(void);
 
 // sprintf uses a lot of stack so use these instead
 static uint32_t print_hex(char *buf, uint32_t value);
-static uint32_t print_dec(char *buf, uint32_t value);
 #endif
+static uint32_t print_dec(char *buf, uint32_t value);
 
 void greentea_metrics_setup()
 {
@@ -68,6 +68,37 @@ void greentea_metrics_report()
 #endif
 }
 
+void greentea_metrics_benchmark(const char *name, uint32_t iterations,
+                                uint32_t min_us, uint32_t median_us,
+                                uint32_t p99_us, uint32_t max_us)
+{
+    mutex->lock();
+
+    // Leave room for the five values and separators
+    uint32_t pos = 0;
+    buf[pos++] = '\"';
+    while (*name && pos < sizeof(buf) - 5*11 - 3) {
+        char c = *name++;
+        // Keep the key-value framing intact
+        buf[pos++] = (c == ';' || c == '{' || c == '}' || c == '\"' || c == ',') ? '_' : c;
+    }
+    buf[pos++] = '\"';
+    buf[pos++] = ',';
+    pos += print_dec(buf + pos, iterations);
+    buf[pos++] = ',';
+    pos += print_dec(buf + pos, min_us);
+    buf[pos++] = ',';
+    pos += print_dec(buf + pos, median_us);
+    buf[pos++] = ',';
+    pos += print_dec(buf + pos, p99_us);
+    buf[pos++] = ',';
+    pos += print_dec(buf + pos, max_us);
+    buf[pos++] = 0;
+    greentea_send_kv("__benchmark", buf);
+
+    mutex->unlock();
+}
+
 static void send_heap_info()
 {
     mbed_stats_heap_t heap_stats;
@@ -182,6 +213,8 @@ static uint32_t print_hex(char *buf, uint32_t value)
     return pos;
 }
 
+#endif
+
 static uint32_t print_dec(char *buf, uint32_t value)
 {
     uint32_t pos = 0;
@@ -210,5 +243,3 @@ static uint32_t print_dec(char *buf, uint32_t value)
 
     return pos;
 }
-
-#endif
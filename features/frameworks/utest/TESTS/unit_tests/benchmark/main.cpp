@@ -0,0 +1,59 @@
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/utest_stack_trace.h"
+#include <string.h>
+
+using namespace utest::v1;
+
+static uint8_t src[256];
+static uint8_t dst[256];
+static volatile uint32_t counter;
+
+void bench_memcpy() {
+    memcpy(dst, src, sizeof(dst));
+}
+
+void bench_empty() {
+    counter++;
+}
+
+void test_benchmark_run() {
+    UTEST_LOG_FUNCTION();
+    counter = 0;
+    benchmark_result_t result = benchmark_run("counter", bench_empty, 5, 100);
+
+    // Warmup calls are not part of the statistics
+    TEST_ASSERT_EQUAL(105, counter);
+    TEST_ASSERT_EQUAL(100, result.iterations);
+    TEST_ASSERT(result.min_us <= result.median_us);
+    TEST_ASSERT(result.median_us <= result.p99_us);
+    TEST_ASSERT(result.p99_us <= result.max_us);
+
+    result = benchmark_run("none", bench_empty, 0, 0);
+    TEST_ASSERT_EQUAL(0, result.iterations);
+}
+
+// Custom setup handler required for proper Greentea support
+utest::v1::status_t greentea_setup(const size_t number_of_cases) {
+    UTEST_LOG_FUNCTION();
+    GREENTEA_SETUP(20, "benchmark_auto");
+    // Call the default reporting function
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// Specify all your test cases here
+Case cases[] = {
+    Case("Benchmark statistics", test_benchmark_run),
+    BENCHMARK_CASE("memcpy 256 bytes", bench_memcpy, 10, 1000),
+};
+
+// Declare your test specification with a custom setup handler
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    UTEST_LOG_FUNCTION();
+    Harness::run(specification);
+}
@@ -21,6 +21,8 @@
 
 using namespace utest::v1;
 
+// POSIX hosts provide their own critical sections with the scheduler
+#if !UTEST_SHIM_SCHEDULER_USE_POSIX
 void utest_v1_enter_critical_section(void)
 {
     core_util_critical_section_enter();
@@ -30,3 +32,4 @@ void utest_v1_leave_critical_section(void)
 {
     core_util_critical_section_exit();
 }
+#endif
@@ -0,0 +1,84 @@
+/****************************************************************************
+ * Copyright (c) 2015, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/utest_benchmark.h"
+#include "utest/utest_default_handlers.h"
+#include "greentea-client/greentea_metrics.h"
+#include "hal/us_ticker_api.h"
+#include <stdlib.h>
+#include <new>
+
+using namespace utest::v1;
+
+static const char *benchmark_name = "";
+
+static int compare_samples(const void *a, const void *b)
+{
+    const uint32_t x = *static_cast<const uint32_t*>(a);
+    const uint32_t y = *static_cast<const uint32_t*>(b);
+    return (x > y) - (x < y);
+}
+
+benchmark_result_t utest::v1::benchmark_run(const char *name, const benchmark_handler_t handler,
+                                            const uint32_t warmup, const uint32_t iterations)
+{
+    benchmark_result_t result = {};
+
+    if (!iterations) {
+        return result;
+    }
+
+    uint32_t *samples = new (std::nothrow) uint32_t[iterations];
+    if (!samples) {
+        return result;
+    }
+
+    for (uint32_t i = 0; i < warmup; i++) {
+        handler();
+    }
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t start = us_ticker_read();
+        handler();
+        samples[i] = us_ticker_read() - start;
+    }
+
+    qsort(samples, iterations, sizeof(samples[0]), compare_samples);
+
+    result.iterations = iterations;
+    result.min_us = samples[0];
+    result.median_us = samples[iterations / 2];
+    result.p99_us = samples[(iterations * 99) / 100];
+    result.max_us = samples[iterations - 1];
+    delete[] samples;
+
+    greentea_metrics_benchmark(name, result.iterations,
+        result.min_us, result.median_us, result.p99_us, result.max_us);
+    return result;
+}
+
+utest::v1::status_t utest::v1::benchmark_case_setup_handler(const Case *const source, const size_t index_of_case)
+{
+    benchmark_name = source->get_description();
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+const char *utest::v1::benchmark_case_name()
+{
+    return benchmark_name;
+}
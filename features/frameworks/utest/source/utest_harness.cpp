@@ -57,6 +57,8 @@ namespace
 
     location_t location = LOCATION_UNKNOWN;
 
+    bool notify_cases = true;
+
     utest_v1_scheduler_t scheduler = {NULL, NULL, NULL, NULL};
 }
 
@@ -95,6 +97,16 @@ bool Harness::run(const Specification& specification, size_t)
     return run(specification);
 }
 
+#if UTEST_SHIM_SCHEDULER_USE_POSIX
+bool Harness::run_worker(const Specification& specification)
+{
+    UTEST_LOG_FUNCTION();
+    // the parallel runner already announced the cases
+    notify_cases = false;
+    return run(specification);
+}
+#endif
+
 bool Harness::run(const Specification& specification)
 {
     UTEST_LOG_FUNCTION();
@@ -146,7 +158,8 @@ bool Harness::run(const Specification& specification)
         exit(1);
     }
 
-    notify_testcases();
+    if (notify_cases)
+        notify_testcases();
 
     case_index = setup_status;
     case_current = &test_cases[case_index];
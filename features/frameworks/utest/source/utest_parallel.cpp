@@ -0,0 +1,260 @@
+/****************************************************************************
+ * Copyright (c) 2015, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/utest_harness.h"
+#include "utest/utest_stack_trace.h"
+#include "utest/utest_serial.h"
+#include "greentea-client/test_env.h"
+
+#if UTEST_SHIM_SCHEDULER_USE_POSIX
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+using namespace utest::v1;
+
+namespace
+{
+    // State of the worker process running a single case
+    struct worker_t
+    {
+        pid_t pid;
+        int fd;
+        bool done;
+        bool failed;
+        int signal;
+        char *output;
+        size_t output_len;
+        size_t output_size;
+    };
+
+    unsigned env_unsigned(const char *name, unsigned fallback)
+    {
+        const char *value = getenv(name);
+        if (!value || !*value) return fallback;
+
+        char *end;
+        unsigned long result = strtoul(value, &end, 10);
+        return *end ? fallback : unsigned(result);
+    }
+
+    void append_output(worker_t &worker, const char *data, size_t len)
+    {
+        if (worker.output_len + len > worker.output_size) {
+            size_t size = worker.output_size ? 2*worker.output_size : 256;
+            while (size < worker.output_len + len) size *= 2;
+
+            char *output = static_cast<char*>(realloc(worker.output, size));
+            if (!output) return;
+            worker.output = output;
+            worker.output_size = size;
+        }
+
+        memcpy(worker.output + worker.output_len, data, len);
+        worker.output_len += len;
+    }
+
+    // Drain the output of the worker, returns false once the worker closed its end
+    bool read_output(worker_t &worker)
+    {
+        char buffer[512];
+        ssize_t res = read(worker.fd, buffer, sizeof(buffer));
+        if (res < 0 && errno == EINTR) return true;
+        if (res <= 0) return false;
+
+        append_output(worker, buffer, res);
+        return true;
+    }
+
+    void finish_worker(worker_t &worker)
+    {
+        close(worker.fd);
+        worker.fd = -1;
+
+        int status = 0;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) ;
+
+        // the harness exits with the number of failed cases
+        worker.failed = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        worker.signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+        worker.done = true;
+    }
+}
+
+parallel_options_t parallel_options_t::from_env()
+{
+    parallel_options_t options;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    options.jobs = env_unsigned("UTEST_JOBS", cpus > 0 ? unsigned(cpus) : 1);
+    options.shard_count = env_unsigned("UTEST_SHARD_COUNT", 1);
+    options.shard_index = env_unsigned("UTEST_SHARD_INDEX", 0);
+    return options;
+}
+
+bool Harness::run_parallel(const Specification& specification, const parallel_options_t& options)
+{
+    UTEST_LOG_FUNCTION();
+    if (is_busy())
+        return false;
+
+    const unsigned jobs = options.jobs ? options.jobs : 1;
+    const unsigned shard_count = options.shard_count ? options.shard_count : 1;
+    if (options.shard_index >= shard_count)
+        return false;
+
+    const handlers_t &defaults = specification.defaults;
+    test_setup_handler_t test_setup = defaults.get_handler(specification.setup_handler);
+    test_teardown_handler_t test_teardown = defaults.get_handler(specification.teardown_handler);
+    test_failure_handler_t test_failure = defaults.get_handler(specification.failure_handler);
+
+    // Select the cases of this shard
+    size_t *indices = new size_t[specification.length];
+    size_t count = 0;
+    for (size_t i = 0; i < specification.length; i++) {
+        if (i % shard_count == options.shard_index) {
+            indices[count++] = i;
+        }
+    }
+
+    int setup_status = 0;
+    failure_t failure(REASON_NONE, LOCATION_TEST_SETUP);
+    if (test_setup) {
+        setup_status = test_setup(count);
+        if (setup_status == STATUS_CONTINUE) setup_status = 0;
+        else if (setup_status < STATUS_CONTINUE)  failure.reason = REASON_TEST_SETUP;
+        else if (setup_status > signed(count))    failure.reason = REASON_CASE_INDEX;
+    }
+
+    if (failure.reason != REASON_NONE) {
+        if (test_failure) test_failure(failure);
+        if (test_teardown) test_teardown(0, 0, failure);
+        delete[] indices;
+        exit(1);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        greentea_testcase_notification_handler(specification.cases[indices[i]].get_description());
+    }
+
+    worker_t *workers = new worker_t[count];
+    memset(workers, 0, count * sizeof(worker_t));
+    struct pollfd *fds = new struct pollfd[jobs];
+    size_t *polled = new size_t[jobs];
+
+    size_t next_start = setup_status;
+    size_t next_report = setup_status;
+    size_t running = 0;
+    size_t test_passed = 0;
+    size_t test_failed = 0;
+
+    while (next_report < count) {
+        // Keep up to `jobs` workers running
+        while (running < jobs && next_start < count) {
+            worker_t &worker = workers[next_start];
+            int fd[2];
+            fflush(stdout);
+            worker.pid = -1;
+            if (pipe(fd) == 0 && (worker.pid = fork()) < 0) {
+                close(fd[0]);
+                close(fd[1]);
+            }
+            if (worker.pid < 0) {
+                utest_printf(">>> Could not start worker for '%s'\n",
+                        specification.cases[indices[next_start]].get_description());
+                worker.fd = -1;
+                worker.done = true;
+                worker.failed = true;
+                next_start++;
+                continue;
+            }
+
+            if (worker.pid == 0) {
+                // Worker: report through the pipe and run only this case
+                close(fd[0]);
+                dup2(fd[1], STDOUT_FILENO);
+                close(fd[1]);
+                setvbuf(stdout, NULL, _IONBF, 0);
+                Harness::run_worker(Specification(specification, indices[next_start]));
+                exit(1);
+            }
+
+            close(fd[1]);
+            worker.fd = fd[0];
+            running++;
+            next_start++;
+        }
+
+        // Wait for output of any running worker
+        size_t nfds = 0;
+        for (size_t i = next_report; i < next_start && nfds < jobs; i++) {
+            if (workers[i].fd >= 0 && !workers[i].done) {
+                fds[nfds].fd = workers[i].fd;
+                fds[nfds].events = POLLIN;
+                fds[nfds].revents = 0;
+                polled[nfds++] = i;
+            }
+        }
+
+        if (nfds && poll(fds, nfds, -1) > 0) {
+            for (size_t i = 0; i < nfds; i++) {
+                if (fds[i].revents && !read_output(workers[polled[i]])) {
+                    finish_worker(workers[polled[i]]);
+                    running--;
+                }
+            }
+        }
+
+        // Replay finished workers in case order
+        while (next_report < count && workers[next_report].done) {
+            worker_t &worker = workers[next_report];
+            if (worker.output_len) {
+                fwrite(worker.output, 1, worker.output_len, stdout);
+                fflush(stdout);
+            }
+            free(worker.output);
+
+            if (worker.signal) {
+                // the case never reported its result, do it on its behalf
+                const char *description = specification.cases[indices[next_report]].get_description();
+                utest_printf(">>> '%s': worker terminated by signal %d\n", description, worker.signal);
+                GREENTEA_TESTCASE_FINISH(description, 0, 1);
+            }
+
+            if (worker.failed) test_failed++;
+            else test_passed++;
+            next_report++;
+        }
+    }
+
+    delete[] polled;
+    delete[] fds;
+    delete[] workers;
+    delete[] indices;
+
+    if (test_teardown) {
+        test_teardown(test_passed, test_failed,
+            test_failed ? failure_t(REASON_CASES, LOCATION_UNKNOWN) : failure_t(REASON_NONE));
+    }
+    exit(test_failed);
+    return true;
+}
+
+#endif // UTEST_SHIM_SCHEDULER_USE_POSIX
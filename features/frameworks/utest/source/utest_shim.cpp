@@ -140,6 +140,140 @@ utest_v1_scheduler_t utest_v1_get_scheduler()
     return utest_v1_scheduler;
 }
 }
+
+#elif UTEST_SHIM_SCHEDULER_USE_POSIX
+#include <pthread.h>
+#include <time.h>
+
+// guards the callback slots below, the harness only ever has
+// one immediate and one delayed callback outstanding
+static pthread_mutex_t posix_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t posix_cond = PTHREAD_COND_INITIALIZER;
+static utest_v1_harness_callback_t posix_callback;
+static utest_v1_harness_callback_t posix_timed_callback;
+static struct timespec posix_deadline;
+static uintptr_t posix_timed_handle;
+
+// recursive lock used for the harness critical sections
+static pthread_once_t posix_critical_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t posix_critical_mutex;
+
+static void posix_critical_init()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&posix_critical_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+static bool posix_deadline_passed()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (now.tv_sec > posix_deadline.tv_sec) ||
+           (now.tv_sec == posix_deadline.tv_sec && now.tv_nsec >= posix_deadline.tv_nsec);
+}
+
+static int32_t utest_posix_init()
+{
+    UTEST_LOG_FUNCTION();
+    pthread_mutex_lock(&posix_mutex);
+    posix_callback = NULL;
+    posix_timed_callback = NULL;
+    pthread_mutex_unlock(&posix_mutex);
+    return 0;
+}
+static void *utest_posix_post(const utest_v1_harness_callback_t callback, timestamp_t delay_ms)
+{
+    UTEST_LOG_FUNCTION();
+    void *handle = (void*)1;
+
+    pthread_mutex_lock(&posix_mutex);
+    if (delay_ms) {
+        clock_gettime(CLOCK_REALTIME, &posix_deadline);
+        posix_deadline.tv_sec += delay_ms / 1000;
+        posix_deadline.tv_nsec += (delay_ms % 1000) * 1000000L;
+        if (posix_deadline.tv_nsec >= 1000000000L) {
+            posix_deadline.tv_sec += 1;
+            posix_deadline.tv_nsec -= 1000000000L;
+        }
+        posix_timed_callback = callback;
+        // handles are unique so that stale cancels are ignored
+        posix_timed_handle += 2;
+        handle = (void*)posix_timed_handle;
+    }
+    else {
+        posix_callback = callback;
+    }
+    pthread_cond_signal(&posix_cond);
+    pthread_mutex_unlock(&posix_mutex);
+
+    return handle;
+}
+static int32_t utest_posix_cancel(void *handle)
+{
+    UTEST_LOG_FUNCTION();
+    pthread_mutex_lock(&posix_mutex);
+    if (handle == (void*)posix_timed_handle) {
+        posix_timed_callback = NULL;
+    }
+    pthread_mutex_unlock(&posix_mutex);
+    return 0;
+}
+static int32_t utest_posix_run()
+{
+    UTEST_LOG_FUNCTION();
+    while(1)
+    {
+        pthread_mutex_lock(&posix_mutex);
+        while (!posix_callback) {
+            if (posix_timed_callback && posix_deadline_passed()) {
+                // the delayed callback is due
+                posix_callback = posix_timed_callback;
+                posix_timed_callback = NULL;
+            } else if (posix_timed_callback) {
+                pthread_cond_timedwait(&posix_cond, &posix_mutex, &posix_deadline);
+            } else {
+                pthread_cond_wait(&posix_cond, &posix_mutex);
+            }
+        }
+        // copy and reset the shared callback
+        utest_v1_harness_callback_t callback = posix_callback;
+        posix_callback = NULL;
+        pthread_mutex_unlock(&posix_mutex);
+
+        // execute the copied callback
+        callback();
+    }
+}
+
+
+extern "C" {
+static const utest_v1_scheduler_t utest_v1_scheduler =
+{
+    utest_posix_init,
+    utest_posix_post,
+    utest_posix_cancel,
+    utest_posix_run
+};
+utest_v1_scheduler_t utest_v1_get_scheduler()
+{
+    UTEST_LOG_FUNCTION();
+    return utest_v1_scheduler;
+}
+
+void utest_v1_enter_critical_section(void)
+{
+    pthread_once(&posix_critical_once, posix_critical_init);
+    pthread_mutex_lock(&posix_critical_mutex);
+}
+
+void utest_v1_leave_critical_section(void)
+{
+    pthread_mutex_unlock(&posix_critical_mutex);
+}
+}
 #endif
 
 #ifdef YOTTA_CORE_UTIL_VERSION_STRING
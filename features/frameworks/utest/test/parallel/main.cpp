@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host test of Harness::run_parallel. The specification runs in a child
+// process, since the harness exits when done, and its greentea output is
+// then checked against the report of a sequential run.
+
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace utest::v1;
+
+static int global_counter;
+
+void test_pass_first()
+{
+    // every worker starts from the state of the parent
+    TEST_ASSERT_EQUAL(0, global_counter++);
+}
+
+void test_fail()
+{
+    TEST_ASSERT_EQUAL(1, 2);
+}
+
+void test_crash()
+{
+    raise(SIGSEGV);
+}
+
+void test_pass_last()
+{
+    TEST_ASSERT_EQUAL(0, global_counter++);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    // no host to handshake with, only report
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Passing case", test_pass_first),
+    Case("Failing case", test_fail),
+    Case("Crashing case", test_crash),
+    Case("Passing case after crash", test_pass_last),
+};
+
+Specification specification(test_setup, cases, greentea_test_teardown_handler, greentea_continue_handlers);
+
+// Lines the report must contain, in this order
+static const char *const expected[] = {
+    "{{__testcase_count;4}}",
+    "{{__testcase_name;Passing case}}",
+    "{{__testcase_name;Failing case}}",
+    "{{__testcase_name;Crashing case}}",
+    "{{__testcase_name;Passing case after crash}}",
+    "{{__testcase_start;Passing case}}",
+    "{{__testcase_finish;Passing case;1;0}}",
+    "{{__testcase_start;Failing case}}",
+    "{{__testcase_finish;Failing case;0;1}}",
+    "{{__testcase_start;Crashing case}}",
+    "{{__testcase_finish;Crashing case;0;1}}",
+    "{{__testcase_start;Passing case after crash}}",
+    "{{__testcase_finish;Passing case after crash;1;0}}",
+    "{{__testcase_summary;2;2}}",
+    "{{end;failure}}",
+};
+
+static int count(const char *haystack, const char *needle)
+{
+    int n = 0;
+    for (const char *p = strstr(haystack, needle); p; p = strstr(p + 1, needle)) {
+        n++;
+    }
+    return n;
+}
+
+int main()
+{
+    char path[] = "/tmp/utest_parallel_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(fd, STDOUT_FILENO);
+        parallel_options_t options = { 2, 0, 1 };
+        Harness::run_parallel(specification, options);
+        _exit(100);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    static char output[16384];
+    ssize_t len = pread(fd, output, sizeof(output) - 1, 0);
+    close(fd);
+    unlink(path);
+    output[len > 0 ? len : 0] = '\0';
+
+    int failures = 0;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 2) {
+        printf("FAIL: expected exit status 2 for two failed cases, got 0x%x\n", status);
+        failures++;
+    }
+
+    const char *pos = output;
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        const char *found = strstr(pos, expected[i]);
+        if (!found) {
+            printf("FAIL: '%s' missing or out of order\n", expected[i]);
+            failures++;
+            continue;
+        }
+        pos = found + strlen(expected[i]);
+    }
+
+    // each case is announced exactly once, by the parent
+    if (count(output, "__testcase_name;") != 4 || count(output, "__testcase_count;") != 1) {
+        printf("FAIL: cases announced more than once\n");
+        failures++;
+    }
+
+    if (failures || getenv("VERBOSE")) {
+        printf("--- output ---\n%s--------------\n", output);
+        return 1;
+    }
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAWSERIAL_H_STUB
+#define RAWSERIAL_H_STUB
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#define USBTX 0
+#define USBRX 1
+#define MBED_CONF_PLATFORM_STDIO_BAUD_RATE 9600
+
+namespace mbed {
+
+// Serial port on stdout, with nothing to read
+class RawSerial {
+public:
+    RawSerial(int, int, int) {}
+
+    int putc(int c)
+    {
+        return fputc(c, stdout);
+    }
+
+    int getc()
+    {
+        return EOF;
+    }
+
+    int printf(const char *format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        int res = vfprintf(stdout, format, args);
+        va_end(args);
+        return res;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * Copyright (c) 2015, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_BENCHMARK_H
+#define UTEST_BENCHMARK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "utest/utest_types.h"
+#include "utest/utest_case.h"
+
+
+namespace utest {
+/** \addtogroup frameworks */
+/** @{*/
+namespace v1 {
+
+    /// Timing statistics of a benchmark, all times in microseconds
+    struct benchmark_result_t
+    {
+        uint32_t iterations;
+        uint32_t min_us;
+        uint32_t median_us;
+        uint32_t p99_us;
+        uint32_t max_us;
+    };
+
+    /// Function under benchmark, called once per iteration
+    typedef void (*benchmark_handler_t)(void);
+
+    /** Run and report a benchmark.
+     *
+     * Calls the handler `warmup` times without timing it, then `iterations` times,
+     * timing each call with the us ticker. The statistics are sent to the host
+     * as a `__benchmark` key-value pair so that host tests can collect and
+     * compare them across runs.
+     *
+     * @param name          Name the results are reported under
+     * @param handler       Function under benchmark
+     * @param warmup        Number of untimed calls before measuring
+     * @param iterations    Number of timed calls
+     * @returns the measured statistics, all zero if no samples could be stored
+     */
+    benchmark_result_t benchmark_run(const char *name, const benchmark_handler_t handler,
+                                     const uint32_t warmup, const uint32_t iterations);
+
+    /** Case setup handler used by `BENCHMARK_CASE`.
+     *
+     * Records the case description as the benchmark name and then
+     * forwards to the greentea case setup handler.
+     */
+    utest::v1::status_t benchmark_case_setup_handler(const Case *const source, const size_t index_of_case);
+
+    /// @cond
+    const char *benchmark_case_name();
+
+    template <benchmark_handler_t handler, uint32_t warmup, uint32_t iterations>
+    void benchmark_case_handler()
+    {
+        benchmark_run(benchmark_case_name(), handler, warmup, iterations);
+    }
+    /// @endcond
+
+}   // namespace v1
+}   // namespace utest
+
+/** Declare a test case which benchmarks a function.
+ *
+ * The case description is used as the benchmark name.
+ *
+ * @code
+ * Case cases[] = {
+ *     BENCHMARK_CASE("memcpy 1K", test_memcpy, 10, 1000),
+ * };
+ * @endcode
+ */
+#define BENCHMARK_CASE(description, handler, warmup, iterations) \
+    utest::v1::Case(description, utest::v1::benchmark_case_setup_handler, \
+                    utest::v1::benchmark_case_handler<handler, warmup, iterations>)
+
+#endif // UTEST_BENCHMARK_H
+
+/** @}*/
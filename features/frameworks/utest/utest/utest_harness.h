@@ -28,6 +28,7 @@
 #include "utest/utest_default_handlers.h"
 #include "utest/utest_specification.h"
 #include "utest/utest_scheduler.h"
+#include "utest/utest_shim.h"
 
 
 namespace utest {
@@ -35,6 +36,20 @@ namespace utest {
 /** @{*/
 namespace v1 {
 
+#if UTEST_SHIM_SCHEDULER_USE_POSIX
+    /// Options for running a specification in parallel.
+    struct parallel_options_t
+    {
+        unsigned jobs;          ///< maximum number of cases running at the same time
+        unsigned shard_index;   ///< index of the shard to run, `0 <= shard_index < shard_count`
+        unsigned shard_count;   ///< number of shards the cases are split into
+
+        /// Reads the options from the `UTEST_JOBS`, `UTEST_SHARD_INDEX` and `UTEST_SHARD_COUNT`
+        /// environment variables, by default one job per online processor in a single shard.
+        static parallel_options_t from_env();
+    };
+#endif
+
     /** Test Harness.
      *
      * This class runs a test specification for you and calls all required handlers.
@@ -61,6 +76,24 @@ namespace v1 {
         static bool run(const Specification& specification, size_t start_case);
         /// @endcond
 
+#if UTEST_SHIM_SCHEDULER_USE_POSIX
+        /// Runs every case of a test specification in its own worker process.
+        ///
+        /// The test setup and teardown handlers run once in the calling process, each
+        /// case then runs in a forked process with its own copy of all global state.
+        /// The calling process announces the cases, the workers only report the cases
+        /// they run. Their output is buffered and replayed in case order, so the
+        /// greentea report matches a sequential run. A worker killed by a signal
+        /// is reported as a failed case.
+        /// Cases must not depend on side effects of earlier cases.
+        /// @note Case selection by returning an index from a case teardown handler
+        ///       is not supported.
+        /// @retval `true`  if the specification can be run
+        /// @retval `false` if another specification is currently running
+        static bool run_parallel(const Specification& specification,
+                                 const parallel_options_t& options = parallel_options_t::from_env());
+#endif
+
         /// @returns `true` if a test specification is being executed, `false` otherwise
         static bool is_busy();
 
@@ -95,6 +128,9 @@ namespace v1 {
         static void schedule_next_case();
     private:
         static void notify_testcases();
+#if UTEST_SHIM_SCHEDULER_USE_POSIX
+        static bool run_worker(const Specification& specification);
+#endif
     };
 
 }   // namespace v1
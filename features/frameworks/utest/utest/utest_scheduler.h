@@ -22,11 +22,17 @@
 #ifndef UTEST_SCHEDULER_H
 #define UTEST_SCHEDULER_H
 
-#include "mbed.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
 
+// Hosts running the POSIX scheduler build utest without mbed
+#if defined(__MBED__) || !(defined(__unix__) || defined(__APPLE__))
+#include "mbed.h"
+#else
+typedef uint32_t timestamp_t;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
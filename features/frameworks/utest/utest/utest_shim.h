@@ -70,6 +70,13 @@
 #           define UTEST_SHIM_SCHEDULER_USE_US_TICKER 0
 #       endif
 #   endif
+#   ifndef UTEST_SHIM_SCHEDULER_USE_POSIX
+#       if !defined(__MBED__) && (defined(__unix__) || defined(__APPLE__))
+#           define UTEST_SHIM_SCHEDULER_USE_POSIX 1
+#       else
+#           define UTEST_SHIM_SCHEDULER_USE_POSIX 0
+#       endif
+#   endif
 #endif  // YOTTA_CFG_UTEST_USE_CUSTOM_SCHEDULER
 
 #ifdef __cplusplus
@@ -125,6 +125,13 @@ namespace v1 {
         {}
 
     private:
+        /// Specification running a single case of another specification without its test handlers
+        Specification(const Specification& parent, const size_t index) :
+            setup_handler(ignore_handler), teardown_handler(ignore_handler), failure_handler(parent.failure_handler),
+            cases(parent.cases + index), length(1),
+            defaults(parent.defaults)
+        {}
+
         const test_setup_handler_t setup_handler;
         const test_teardown_handler_t teardown_handler;
         const test_failure_handler_t failure_handler;
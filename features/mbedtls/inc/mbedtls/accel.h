@@ -0,0 +1,215 @@
+/**
+ * \file accel.h
+ *
+ * \brief Runtime dispatch of primitives to hardware accelerators
+ *
+ *  Copyright (C) 2006-2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  This file is part of mbed TLS (https://tls.mbed.org)
+ */
+#ifndef MBEDTLS_ACCEL_H
+#define MBEDTLS_ACCEL_H
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bignum.h"
+
+#if defined(MBEDTLS_THREADING_C)
+#include "threading.h"
+#endif
+
+#define MBEDTLS_ERR_ACCEL_UNSUPPORTED                     -0x0054  /**< The accelerator does not support the requested operation. */
+#define MBEDTLS_ERR_ACCEL_BUSY                            -0x0056  /**< The accelerator has too many pending requests. */
+#define MBEDTLS_ERR_ACCEL_HW_FAILED                       -0x0058  /**< The accelerator reported a hardware failure. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          Primitives that can be offloaded to an accelerator
+ */
+typedef enum
+{
+    MBEDTLS_ACCEL_AES = 0,          /*!< single block AES encryption/decryption */
+    MBEDTLS_ACCEL_SHA256,           /*!< SHA-224/256 block compression */
+    MBEDTLS_ACCEL_MPI_EXP_MOD,      /*!< modular exponentiation */
+    MBEDTLS_ACCEL_PRIMITIVE_COUNT
+}
+mbedtls_accel_primitive_t;
+
+/**
+ * \brief          Accelerator entry points
+ *
+ *                 Each entry may be NULL if the engine does not implement the
+ *                 primitive. An entry returns 0 when it has done the work,
+ *                 MBEDTLS_ERR_ACCEL_UNSUPPORTED when it declines the request
+ *                 (e.g. an unsupported key or operand size) or any other
+ *                 error on hardware failure. In every case but 0 the
+ *                 software implementation is used instead, so an entry must
+ *                 not modify its outputs unless it succeeds.
+ */
+typedef struct
+{
+    /** Encrypt or decrypt a single block with a raw AES key */
+    int (*aes_crypt_ecb)( void *p_ctx, const unsigned char *key,
+                          unsigned int keybits, int mode,
+                          const unsigned char input[16],
+                          unsigned char output[16] );
+
+    /** Compress one 64-byte block into the SHA-224/256 state */
+    int (*sha256_process)( void *p_ctx, uint32_t state[8],
+                           const unsigned char data[64] );
+
+    /** X = A^E mod N */
+    int (*mpi_exp_mod)( void *p_ctx, mbedtls_mpi *X, const mbedtls_mpi *A,
+                        const mbedtls_mpi *E, const mbedtls_mpi *N );
+}
+mbedtls_accel_ops;
+
+/**
+ * \brief          Accelerator engine
+ *
+ *                 An engine processes one request at a time. Up to
+ *                 max_pending further requests wait for it to become free;
+ *                 beyond that callers fall back to software right away
+ *                 instead of queueing.
+ */
+typedef struct
+{
+    const char *name;               /*!<  engine name (for diagnostics)   */
+    const mbedtls_accel_ops *ops;   /*!<  entry points                    */
+    void *p_ctx;                    /*!<  context passed to entry points  */
+    unsigned int max_pending;       /*!<  requests allowed to wait        */
+    unsigned int pending;           /*!<  requests running or waiting     */
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_threading_mutex_t state_mutex;  /*!< protects pending and statistics */
+    mbedtls_threading_mutex_t engine_mutex; /*!< held while the engine runs      */
+#endif
+}
+mbedtls_accel_engine;
+
+/**
+ * \brief          Offload statistics for one primitive
+ *
+ *                 Calls made while no engine is registered for the primitive
+ *                 are not counted.
+ */
+typedef struct
+{
+    uint32_t offloaded;             /*!<  done by the accelerator                 */
+    uint32_t unsupported;           /*!<  declined by the accelerator             */
+    uint32_t busy;                  /*!<  accelerator queue was full              */
+    uint32_t failed;                /*!<  accelerator error, done in software     */
+}
+mbedtls_accel_stats;
+
+/**
+ * \brief          Initialize an accelerator engine
+ *
+ * \param engine   engine to initialize
+ * \param name     engine name
+ * \param ops      entry points, must stay valid while the engine is in use
+ * \param p_ctx    context passed to the entry points
+ * \param max_pending number of requests allowed to wait for the engine
+ *                 while it is running another one. With 0 a request that
+ *                 finds the engine busy is done in software.
+ */
+void mbedtls_accel_engine_init( mbedtls_accel_engine *engine, const char *name,
+                                const mbedtls_accel_ops *ops, void *p_ctx,
+                                unsigned int max_pending );
+
+/**
+ * \brief          Free an accelerator engine
+ *
+ * \note           The engine must not be registered.
+ *
+ * \param engine   engine to free
+ */
+void mbedtls_accel_engine_free( mbedtls_accel_engine *engine );
+
+/**
+ * \brief          Route every primitive the engine implements to it
+ *
+ *                 A primitive already served by another engine is taken
+ *                 over by this one.
+ *
+ * \note           Registration is not synchronized with running
+ *                 operations: register engines before they can be used
+ *                 from other threads, typically at startup.
+ *
+ * \param engine   initialized engine
+ *
+ * \return         0 if successful, or MBEDTLS_ERR_ACCEL_UNSUPPORTED if the
+ *                 engine implements no primitive
+ */
+int mbedtls_accel_register( mbedtls_accel_engine *engine );
+
+/**
+ * \brief          Stop routing primitives to an engine
+ *
+ * \note           Same restrictions as mbedtls_accel_register().
+ *
+ * \param engine   registered engine
+ */
+void mbedtls_accel_unregister( mbedtls_accel_engine *engine );
+
+/**
+ * \brief          Read the offload statistics of a primitive
+ *
+ * \note           The statistics are read under the state mutex of the
+ *                 engine serving the primitive, so they may be read while
+ *                 other threads use it.
+ *
+ * \param primitive primitive to query
+ * \param stats    receives the statistics
+ */
+void mbedtls_accel_get_stats( mbedtls_accel_primitive_t primitive,
+                              mbedtls_accel_stats *stats );
+
+/**
+ * \brief          Clear the offload statistics of all primitives
+ *
+ * \note           Same locking as mbedtls_accel_get_stats().
+ */
+void mbedtls_accel_reset_stats( void );
+
+/*
+ * Dispatch functions, called by the software implementations. Each returns
+ * 0 if a registered engine did the work, or an error if the caller must
+ * do it in software.
+ */
+int mbedtls_accel_aes_crypt_ecb( const unsigned char *key, unsigned int keybits,
+                                 int mode, const unsigned char input[16],
+                                 unsigned char output[16] );
+
+int mbedtls_accel_sha256_process( uint32_t state[8], const unsigned char data[64] );
+
+int mbedtls_accel_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
+                               const mbedtls_mpi *E, const mbedtls_mpi *N );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* accel.h */
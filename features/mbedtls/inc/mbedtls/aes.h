@@ -60,6 +60,10 @@ typedef struct
     int nr;                     /*!<  number of rounds  */
     uint32_t *rk;               /*!<  AES round keys    */
     uint32_t buf[68];           /*!<  unaligned data    */
+#if defined(MBEDTLS_ACCEL_C)
+    unsigned char key[32];      /*!<  raw key, for accelerators */
+    unsigned int keybits;       /*!<  raw key size in bits      */
+#endif
 }
 mbedtls_aes_context;
 
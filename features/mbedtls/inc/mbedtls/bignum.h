@@ -65,6 +65,15 @@
 #define MBEDTLS_MPI_WINDOW_SIZE                           6        /**< Maximum windows size used. */
 #endif /* !MBEDTLS_MPI_WINDOW_SIZE */
 
+#if !defined(MBEDTLS_MPI_EXP_MOD_SHORT_BITS)
+/*
+ * Exponents up to this many bits use plain square-and-multiply in modular
+ * exponentiation, without a sliding window table. Default: 17, which covers
+ * the usual RSA public exponent 65537. Set to 0 to always use the table.
+ */
+#define MBEDTLS_MPI_EXP_MOD_SHORT_BITS                    17       /**< Maximum bits of a short exponent. */
+#endif /* !MBEDTLS_MPI_EXP_MOD_SHORT_BITS */
+
 #if !defined(MBEDTLS_MPI_MAX_SIZE)
 /*
  * Maximum size of MPIs allowed in bits and bytes for user-MPIs.
@@ -626,9 +635,37 @@ int mbedtls_mpi_mod_int( mbedtls_mpi_uint *r, const mbedtls_mpi *A, mbedtls_mpi_
  * \note           _RR is used to avoid re-computing R*R mod N across
  *                 multiple calls, which speeds up things a bit. It can
  *                 be set to NULL if the extra performance is unneeded.
+ *
+ * \note           With MBEDTLS_ACCEL_C the exponentiation is first offered
+ *                 to a registered accelerator. mbedtls_mpi_exp_mod_ext()
+ *                 always runs in software.
  */
 int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi *E, const mbedtls_mpi *N, mbedtls_mpi *_RR );
 
+/**
+ * \brief          Sliding-window exponentiation with a per-call window size
+ *                 limit: X = A^E mod N
+ *
+ *                 Same as mbedtls_mpi_exp_mod(), but the window table is
+ *                 limited to 2^(max_window_size - 1) entries of the size of
+ *                 N. If the table does not fit in the heap, smaller windows
+ *                 are tried before failing.
+ *
+ * \param X        Destination MPI
+ * \param A        Left-hand MPI
+ * \param E        Exponent MPI
+ * \param N        Modular MPI
+ * \param _RR      Speed-up MPI used for recalculations
+ * \param max_window_size Maximum window size, 1 to MBEDTLS_MPI_WINDOW_SIZE
+ *
+ * \return         0 if successful,
+ *                 MBEDTLS_ERR_MPI_ALLOC_FAILED if memory allocation failed,
+ *                 MBEDTLS_ERR_MPI_BAD_INPUT_DATA if N is negative or even or
+ *                 if E is negative
+ */
+int mbedtls_mpi_exp_mod_ext( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi *E, const mbedtls_mpi *N, mbedtls_mpi *_RR,
+                             size_t max_window_size );
+
 /**
  * \brief          Fill an MPI X with size bytes of random
  *
@@ -478,6 +478,27 @@
  */
 #define MBEDTLS_ECP_NIST_OPTIM
 
+/**
+ * \def MBEDTLS_ECP_RESTARTABLE
+ *
+ * Enable "non-blocking" ECC operations that can return early and be resumed.
+ *
+ * This allows various functions to pause by returning
+ * #MBEDTLS_ERR_ECP_IN_PROGRESS (or, for functions in the SSL module,
+ * #MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS) and then be called later again in
+ * order to further progress and eventually complete their operation. This is
+ * controlled through mbedtls_ecp_set_max_ops() which limits the maximum
+ * number of ECC operations a function may perform before pausing; see
+ * mbedtls_ecp_set_max_ops() for more information.
+ *
+ * This is useful in non-threaded environments if you want to avoid blocking
+ * for too long on ECC (and, hence, X.509 or SSL/TLS) operations, e.g. to
+ * run the handshake from an event loop.
+ *
+ * Uncomment this macro to enable restartable ECC computations.
+ */
+//#define MBEDTLS_ECP_RESTARTABLE
+
 /**
  * \def MBEDTLS_ECDSA_DETERMINISTIC
  *
@@ -798,6 +819,22 @@
  */
 //#define MBEDTLS_FS_IO
 
+/**
+ * \def MBEDTLS_GCM_LARGE_TABLE
+ *
+ * Use 8-bit tables for the GHASH multiplication in GCM instead of 4-bit
+ * tables.
+ *
+ * This processes a byte instead of a nibble per table lookup, which roughly
+ * halves the cost of GHASH, at the expense of 3840 more bytes of RAM per GCM
+ * context and 384 more bytes of ROM.
+ *
+ * Requires: MBEDTLS_GCM_C
+ *
+ * Uncomment to use the large GHASH tables.
+ */
+//#define MBEDTLS_GCM_LARGE_TABLE
+
 /**
  * \def MBEDTLS_NO_DEFAULT_ENTROPY_SOURCES
  *
@@ -1404,6 +1441,23 @@
  * \{
  */
 
+/**
+ * \def MBEDTLS_ACCEL_C
+ *
+ * Enable runtime dispatch of primitives to hardware accelerators.
+ *
+ * Module:  library/accel.c
+ * Caller:  library/aes.c
+ *          library/sha256.c
+ *          library/bignum.c
+ *
+ * This module lets an application register an accelerator engine for AES
+ * block encryption, SHA-256 block processing and modular exponentiation at
+ * runtime. Requests the engine declines, fails or is too busy to accept are
+ * done in software, and per-primitive offload statistics are kept.
+ */
+//#define MBEDTLS_ACCEL_C
+
 /**
  * \def MBEDTLS_AESNI_C
  *
@@ -2510,6 +2564,7 @@
 //#define MBEDTLS_CTR_DRBG_MAX_INPUT                256 /**< Maximum number of additional input bytes */
 //#define MBEDTLS_CTR_DRBG_MAX_REQUEST             1024 /**< Maximum number of requested bytes per call */
 //#define MBEDTLS_CTR_DRBG_MAX_SEED_INPUT           384 /**< Maximum size of (re)seed buffer */
+//#define MBEDTLS_CTR_DRBG_BUFFER_SIZE             128 /**< Size of the output buffer of a buffered CTR_DRBG */
 
 /* HMAC_DRBG options */
 //#define MBEDTLS_HMAC_DRBG_RESEED_INTERVAL   10000 /**< Interval before reseed is performed by default */
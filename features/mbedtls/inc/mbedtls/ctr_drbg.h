@@ -72,6 +72,14 @@
 #define MBEDTLS_CTR_DRBG_MAX_SEED_INPUT     384     /**< Maximum size of (re)seed buffer */
 #endif
 
+#if !defined(MBEDTLS_CTR_DRBG_BUFFER_SIZE)
+#define MBEDTLS_CTR_DRBG_BUFFER_SIZE        128     /**< Size of the output buffer of a buffered CTR_DRBG */
+#endif
+
+#if MBEDTLS_CTR_DRBG_BUFFER_SIZE > MBEDTLS_CTR_DRBG_MAX_REQUEST
+#error "MBEDTLS_CTR_DRBG_BUFFER_SIZE must not exceed MBEDTLS_CTR_DRBG_MAX_REQUEST"
+#endif
+
 /* \} name SECTION: Module settings */
 
 #define MBEDTLS_CTR_DRBG_PR_OFF             0       /**< No prediction resistance       */
@@ -109,6 +117,22 @@ typedef struct
 }
 mbedtls_ctr_drbg_context;
 
+/**
+ * \brief          Buffered CTR_DRBG context structure
+ *
+ * Random data is generated MBEDTLS_CTR_DRBG_BUFFER_SIZE bytes at a time and
+ * small requests are served from the buffer, so the cost of the state update
+ * after each generate call is shared by several requests.
+ */
+typedef struct
+{
+    mbedtls_ctr_drbg_context drbg;  /*!<  underlying CTR_DRBG, also holds the
+                                          mutex of the buffered context   */
+    unsigned char buf[MBEDTLS_CTR_DRBG_BUFFER_SIZE];    /*!<  generated output  */
+    size_t buf_left;                /*!<  unused bytes at the end of buf  */
+}
+mbedtls_ctr_drbg_buffered_context;
+
 /**
  * \brief               CTR_DRBG context initialization
  *                      Makes the context ready for mbedtls_ctr_drbg_seed() or
@@ -271,6 +295,84 @@ int mbedtls_ctr_drbg_write_seed_file( mbedtls_ctr_drbg_context *ctx, const char
 int mbedtls_ctr_drbg_update_seed_file( mbedtls_ctr_drbg_context *ctx, const char *path );
 #endif /* MBEDTLS_FS_IO */
 
+/**
+ * \brief               Buffered CTR_DRBG context initialization
+ *
+ * \param ctx           Buffered CTR_DRBG context to be initialized
+ */
+void mbedtls_ctr_drbg_buffered_init( mbedtls_ctr_drbg_buffered_context *ctx );
+
+/**
+ * \brief               Buffered CTR_DRBG initial seeding
+ *                      See mbedtls_ctr_drbg_seed().
+ *
+ * Note: Prediction resistance, entropy length and reseed interval are set
+ *       on ctx->drbg with the mbedtls_ctr_drbg_set_xxx() functions. The reseed
+ *       interval counts refills of the buffer, not calls to
+ *       mbedtls_ctr_drbg_buffered_random().
+ *
+ * \param ctx           Buffered CTR_DRBG context to be seeded
+ * \param f_entropy     Entropy callback (p_entropy, buffer to fill, buffer
+ *                      length)
+ * \param p_entropy     Entropy context
+ * \param custom        Personalization data (Device specific identifiers)
+ *                      (Can be NULL)
+ * \param len           Length of personalization data
+ *
+ * \return              0 if successful, or
+ *                      MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED
+ */
+int mbedtls_ctr_drbg_buffered_seed( mbedtls_ctr_drbg_buffered_context *ctx,
+                   int (*f_entropy)(void *, unsigned char *, size_t),
+                   void *p_entropy,
+                   const unsigned char *custom,
+                   size_t len );
+
+/**
+ * \brief               Clear buffered CTR_DRBG context data, including any
+ *                      buffered output
+ *
+ * \param ctx           Buffered CTR_DRBG context to clear
+ */
+void mbedtls_ctr_drbg_buffered_free( mbedtls_ctr_drbg_buffered_context *ctx );
+
+/**
+ * \brief               Buffered CTR_DRBG reseeding. Buffered output generated
+ *                      before the reseed is discarded.
+ *
+ * \param ctx           Buffered CTR_DRBG context
+ * \param additional    Additional data to add to state (Can be NULL)
+ * \param len           Length of additional data
+ *
+ * \return              0 if successful, or
+ *                      MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED
+ */
+int mbedtls_ctr_drbg_buffered_reseed( mbedtls_ctr_drbg_buffered_context *ctx,
+                     const unsigned char *additional, size_t len );
+
+/**
+ * \brief               Buffered CTR_DRBG generate random
+ *
+ * Requests smaller than MBEDTLS_CTR_DRBG_BUFFER_SIZE are served from the
+ * buffer, which is refilled by a single generate call when it runs out.
+ * Served bytes are wiped from the buffer. Larger requests, and all requests
+ * when prediction resistance is enabled, bypass the buffer.
+ *
+ * Note: Output waiting in the buffer is not protected by the backtracking
+ *       resistance of CTR_DRBG: it can be recovered from a compromised state
+ *       until it is handed out.
+ *
+ * \param p_rng         Buffered CTR_DRBG context
+ * \param output        Buffer to fill
+ * \param output_len    Length of the buffer
+ *
+ * \return              0 if successful, or
+ *                      MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED, or
+ *                      MBEDTLS_ERR_CTR_DRBG_REQUEST_TOO_BIG
+ */
+int mbedtls_ctr_drbg_buffered_random( void *p_rng,
+                     unsigned char *output, size_t output_len );
+
 /**
  * \brief               Checkup routine
  *
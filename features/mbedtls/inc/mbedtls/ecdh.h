@@ -52,6 +52,10 @@ typedef struct
     mbedtls_ecp_point Vi;       /*!<  blinding value (for later)                    */
     mbedtls_ecp_point Vf;       /*!<  un-blinding value (for later)                 */
     mbedtls_mpi _d;             /*!<  previous d (for later)                        */
+#if defined(MBEDTLS_ECP_RESTARTABLE)
+    int restart_enabled;        /*!<  enable restartable EC computations?           */
+    mbedtls_ecp_restart_ctx rs; /*!<  restart context for EC computations           */
+#endif
 }
 mbedtls_ecdh_context;
 
@@ -189,6 +193,21 @@ int mbedtls_ecdh_make_public( mbedtls_ecdh_context *ctx, size_t *olen,
 int mbedtls_ecdh_read_public( mbedtls_ecdh_context *ctx,
                       const unsigned char *buf, size_t blen );
 
+#if defined(MBEDTLS_ECP_RESTARTABLE)
+/**
+ * \brief           Enable restartable EC computations for this context.
+ *
+ *                  mbedtls_ecdh_make_params(), mbedtls_ecdh_make_public()
+ *                  and mbedtls_ecdh_calc_secret() may then return
+ *                  MBEDTLS_ERR_ECP_IN_PROGRESS, in which case they must be
+ *                  called again with the same arguments to resume. See
+ *                  mbedtls_ecp_set_max_ops().
+ *
+ * \param ctx       ECDH context
+ */
+void mbedtls_ecdh_enable_restart( mbedtls_ecdh_context *ctx );
+#endif /* MBEDTLS_ECP_RESTARTABLE */
+
 /**
  * \brief           Derive and export the shared secret.
  *                  (Last function used by both TLS client en servers.)
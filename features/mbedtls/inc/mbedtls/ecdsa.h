@@ -51,6 +51,26 @@
  */
 typedef mbedtls_ecp_keypair mbedtls_ecdsa_context;
 
+#if defined(MBEDTLS_ECP_RESTARTABLE)
+/**
+ * \brief           Restart context for ECDSA operations
+ *
+ *                  Holds the state of an interrupted signature or
+ *                  verification, see mbedtls_ecp_set_max_ops().
+ */
+typedef struct
+{
+    mbedtls_ecp_restart_ctx ecp;    /*!<  state of the ECP operation      */
+    mbedtls_mpi k;                  /*!<  ephemeral key of a signature    */
+    int sign_tries;                 /*!<  signature attempts so far       */
+    int key_tries;                  /*!<  ephemeral key attempts so far   */
+}
+mbedtls_ecdsa_restart_ctx;
+#else
+/* We want to declare restartable versions of existing functions anyway */
+typedef void mbedtls_ecdsa_restart_ctx;
+#endif /* MBEDTLS_ECP_RESTARTABLE */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -115,6 +135,80 @@ int mbedtls_ecdsa_verify( mbedtls_ecp_group *grp,
                   const unsigned char *buf, size_t blen,
                   const mbedtls_ecp_point *Q, const mbedtls_mpi *r, const mbedtls_mpi *s);
 
+#if defined(MBEDTLS_ECP_RESTARTABLE)
+/**
+ * \brief           Initialize an ECDSA restart context
+ *
+ * \param ctx       Context to initialize
+ */
+void mbedtls_ecdsa_restart_init( mbedtls_ecdsa_restart_ctx *ctx );
+
+/**
+ * \brief           Free an ECDSA restart context, abandoning the
+ *                  operation in progress if any
+ *
+ * \param ctx       Context to free
+ */
+void mbedtls_ecdsa_restart_free( mbedtls_ecdsa_restart_ctx *ctx );
+
+/**
+ * \brief           Compute ECDSA signature of a previously hashed message,
+ *                  in slices of bounded duration
+ *
+ *                  Same as mbedtls_ecdsa_sign(), but returns
+ *                  MBEDTLS_ERR_ECP_IN_PROGRESS when the budget set with
+ *                  mbedtls_ecp_set_max_ops() is exhausted. Call it again
+ *                  with the same arguments to resume.
+ *
+ * \param grp       ECP group
+ * \param r         First output integer
+ * \param s         Second output integer
+ * \param d         Private signing key
+ * \param buf       Message hash
+ * \param blen      Length of buf
+ * \param f_rng     RNG function
+ * \param p_rng     RNG parameter
+ * \param rs_ctx    Restart context, or NULL to disable restart
+ *
+ * \return          0 if successful,
+ *                  MBEDTLS_ERR_ECP_IN_PROGRESS if the operation was interrupted,
+ *                  or a MBEDTLS_ERR_ECP_XXX or MBEDTLS_MPI_XXX error code
+ */
+int mbedtls_ecdsa_sign_restartable( mbedtls_ecp_group *grp,
+                mbedtls_mpi *r, mbedtls_mpi *s,
+                const mbedtls_mpi *d, const unsigned char *buf, size_t blen,
+                int (*f_rng)(void *, unsigned char *, size_t), void *p_rng,
+                mbedtls_ecdsa_restart_ctx *rs_ctx );
+
+/**
+ * \brief           Verify ECDSA signature of a previously hashed message,
+ *                  in slices of bounded duration
+ *
+ *                  Same as mbedtls_ecdsa_verify(), but returns
+ *                  MBEDTLS_ERR_ECP_IN_PROGRESS when the budget set with
+ *                  mbedtls_ecp_set_max_ops() is exhausted. Call it again
+ *                  with the same arguments to resume.
+ *
+ * \param grp       ECP group
+ * \param buf       Message hash
+ * \param blen      Length of buf
+ * \param Q         Public key to use for verification
+ * \param r         First integer of the signature
+ * \param s         Second integer of the signature
+ * \param rs_ctx    Restart context, or NULL to disable restart
+ *
+ * \return          0 if successful,
+ *                  MBEDTLS_ERR_ECP_IN_PROGRESS if the operation was interrupted,
+ *                  MBEDTLS_ERR_ECP_BAD_INPUT_DATA if signature is invalid
+ *                  or a MBEDTLS_ERR_ECP_XXX or MBEDTLS_MPI_XXX error code
+ */
+int mbedtls_ecdsa_verify_restartable( mbedtls_ecp_group *grp,
+                  const unsigned char *buf, size_t blen,
+                  const mbedtls_ecp_point *Q,
+                  const mbedtls_mpi *r, const mbedtls_mpi *s,
+                  mbedtls_ecdsa_restart_ctx *rs_ctx );
+#endif /* MBEDTLS_ECP_RESTARTABLE */
+
 /**
  * \brief           Compute ECDSA signature and write it to buffer,
  *                  serialized as defined in RFC 4492 page 20.
@@ -203,6 +297,32 @@ int mbedtls_ecdsa_read_signature( mbedtls_ecdsa_context *ctx,
                           const unsigned char *hash, size_t hlen,
                           const unsigned char *sig, size_t slen );
 
+#if defined(MBEDTLS_ECP_RESTARTABLE)
+/**
+ * \brief           Read and verify an ECDSA signature, in slices of bounded
+ *                  duration
+ *
+ *                  Same as mbedtls_ecdsa_read_signature(), but returns
+ *                  MBEDTLS_ERR_ECP_IN_PROGRESS when the budget set with
+ *                  mbedtls_ecp_set_max_ops() is exhausted. Call it again
+ *                  with the same arguments to resume.
+ *
+ * \param ctx       ECDSA context
+ * \param hash      Message hash
+ * \param hlen      Size of hash
+ * \param sig       Signature to read and verify
+ * \param slen      Size of sig
+ * \param rs_ctx    Restart context, or NULL to disable restart
+ *
+ * \return          Same as mbedtls_ecdsa_read_signature(), or
+ *                  MBEDTLS_ERR_ECP_IN_PROGRESS if the operation was interrupted
+ */
+int mbedtls_ecdsa_read_signature_restartable( mbedtls_ecdsa_context *ctx,
+                          const unsigned char *hash, size_t hlen,
+                          const unsigned char *sig, size_t slen,
+                          mbedtls_ecdsa_restart_ctx *rs_ctx );
+#endif /* MBEDTLS_ECP_RESTARTABLE */
+
 /**
  * \brief           Generate an ECDSA keypair on the given curve
  *
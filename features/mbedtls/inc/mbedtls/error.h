@@ -62,6 +62,7 @@
  * CTR_DBRG  4  0x0034-0x003A
  * ENTROPY   3  0x003C-0x0040   0x003D-0x003F
  * NET      11  0x0042-0x0052   0x0043-0x0045
+ * ACCEL     3  0x0054-0x0058
  * ASN1      7  0x0060-0x006C
  * PBKDF2    1  0x007C-0x007C
  * HMAC_DRBG 4  0x0003-0x0009
@@ -76,10 +77,10 @@
  * DHM       3   9
  * PK        3   14 (Started from top)
  * RSA       4   9
- * ECP       4   8 (Started from top)
+ * ECP       4   9 (Started from top)
  * MD        5   4
  * CIPHER    6   6
- * SSL       6   17 (Started from top)
+ * SSL       6   18 (Started from top)
  * SSL       7   31
  *
  * Module dependent error code (5 bits 0x.00.-0x.F8.)
@@ -33,6 +33,12 @@
 #define MBEDTLS_ERR_GCM_AUTH_FAILED                       -0x0012  /**< Authenticated decryption failed. */
 #define MBEDTLS_ERR_GCM_BAD_INPUT                         -0x0014  /**< Bad input parameters to function. */
 
+#if defined(MBEDTLS_GCM_LARGE_TABLE)
+#define MBEDTLS_GCM_HTABLE_SIZE 256     /**< Entries of the GHASH tables, 8 bits of input per lookup */
+#else
+#define MBEDTLS_GCM_HTABLE_SIZE 16      /**< Entries of the GHASH tables, 4 bits of input per lookup */
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -42,8 +48,8 @@ extern "C" {
  */
 typedef struct {
     mbedtls_cipher_context_t cipher_ctx;/*!< cipher context used */
-    uint64_t HL[16];            /*!< Precalculated HTable */
-    uint64_t HH[16];            /*!< Precalculated HTable */
+    uint64_t HL[MBEDTLS_GCM_HTABLE_SIZE]; /*!< Precalculated HTable */
+    uint64_t HH[MBEDTLS_GCM_HTABLE_SIZE]; /*!< Precalculated HTable */
     uint64_t len;               /*!< Total data length */
     uint64_t add_len;           /*!< Total add length */
     unsigned char base_ectr[16];/*!< First ECTR for tag */
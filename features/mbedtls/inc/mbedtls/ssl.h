@@ -109,6 +109,7 @@
 #define MBEDTLS_ERR_SSL_UNEXPECTED_RECORD                 -0x6700  /**< Record header looks valid but is not expected. */
 #define MBEDTLS_ERR_SSL_NON_FATAL                         -0x6680  /**< The alert message received indicates a non-fatal error. */
 #define MBEDTLS_ERR_SSL_INVALID_VERIFY_HASH               -0x6600  /**< Couldn't set the hash for verifying CertificateVerify */
+#define MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS                -0x6580  /**< A cryptographic operation is in progress. Try again later. */
 
 /*
  * Various constants
@@ -652,6 +653,7 @@ struct mbedtls_ssl_config
     mbedtls_ssl_key_cert *key_cert; /*!< own certificate/key pair(s)        */
     mbedtls_x509_crt *ca_chain;     /*!< trusted CAs                        */
     mbedtls_x509_crl *ca_crl;       /*!< trusted CAs CRLs                   */
+    mbedtls_x509_crt_store *ca_store; /*!< shared store holding ca_chain    */
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
 #if defined(MBEDTLS_KEY_EXCHANGE__WITH_CERT__ENABLED)
@@ -1584,6 +1586,21 @@ void mbedtls_ssl_conf_ca_chain( mbedtls_ssl_config *conf,
                                mbedtls_x509_crt *ca_chain,
                                mbedtls_x509_crl *ca_crl );
 
+/**
+ * \brief          Set the trusted CAs from a shared CA store
+ *
+ * \note           The configuration takes a reference to the store, which
+ *                 is released by mbedtls_ssl_config_free() or when other
+ *                 trusted CAs are set.
+ *
+ * \param conf     SSL configuration
+ * \param ca_store sealed CA store (see mbedtls_x509_crt_store_seal())
+ * \param ca_crl   trusted CA CRLs
+ */
+void mbedtls_ssl_conf_ca_store( mbedtls_ssl_config *conf,
+                                mbedtls_x509_crt_store *ca_store,
+                                mbedtls_x509_crl *ca_crl );
+
 /**
  * \brief          Set own certificate chain and private key
  *
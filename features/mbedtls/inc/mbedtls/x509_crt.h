@@ -32,6 +32,10 @@
 #include "x509.h"
 #include "x509_crl.h"
 
+#if defined(MBEDTLS_THREADING_C)
+#include "threading.h"
+#endif
+
 /**
  * \addtogroup x509_module
  * \{
@@ -89,10 +93,48 @@ typedef struct mbedtls_x509_crt
     mbedtls_pk_type_t sig_pk;           /**< Internal representation of the Public Key algorithm of the signature algorithm, e.g. MBEDTLS_PK_RSA */
     void *sig_opts;             /**< Signature options to be passed to mbedtls_pk_verify_ext(), e.g. for RSASSA-PSS */
 
+    int own_buffer;             /**< Indicates if raw is owned by the structure (1) or references external data (0). */
+    struct mbedtls_x509_crt_store *store;   /**< Sealed CA store this certificate belongs to, or NULL. */
+
     struct mbedtls_x509_crt *next;     /**< Next certificate in the CA-chain. */
 }
 mbedtls_x509_crt;
 
+/**
+ * Entry of the subject index of a CA store.
+ */
+typedef struct
+{
+    uint32_t hash;              /**< Hash of the normalised subject name. */
+    mbedtls_x509_crt *crt;      /**< Certificate with this subject. */
+}
+mbedtls_x509_crt_store_entry;
+
+/**
+ * Shared, read-only set of trusted CA certificates.
+ *
+ * The certificates are parsed into chain, then the store is sealed, which
+ * builds an index of the subject names. Certificate verification with
+ * &store->chain as the trusted CA list looks up the issuer in the index
+ * instead of walking the whole list.
+ *
+ * The store is reference counted, so that several SSL configurations can
+ * use the same store. Its contents are freed when the last reference is
+ * released.
+ */
+typedef struct mbedtls_x509_crt_store
+{
+    mbedtls_x509_crt chain;             /**< Trusted CA certificates. */
+    mbedtls_x509_crt_store_entry *index;    /**< Subject index, sorted by hash. NULL until sealed. */
+    size_t count;                       /**< Number of entries in index. */
+    unsigned int refcount;              /**< Number of references to the store. */
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_threading_mutex_t mutex;
+#endif
+}
+mbedtls_x509_crt_store;
+
 /**
  * Build flag from an algorithm/curve identifier (pk, md, ecp)
  * Since 0 is always XXX_NONE, ignore it.
@@ -173,6 +215,24 @@ extern const mbedtls_x509_crt_profile mbedtls_x509_crt_profile_suiteb;
 int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *buf,
                         size_t buflen );
 
+/**
+ * \brief          Parse a single DER formatted certificate and add it
+ *                 to the chained list, without copying the DER data.
+ *
+ * \note           The certificate references buf directly, so buf must
+ *                 stay valid and unmodified until the certificate is freed.
+ *                 This is intended for certificates in read-only memory,
+ *                 such as a CA bundle compiled into flash.
+ *
+ * \param chain    points to the start of the chain
+ * \param buf      buffer holding the certificate DER data
+ * \param buflen   size of the buffer
+ *
+ * \return         0 if successful, or a specific X509 or PEM error code
+ */
+int mbedtls_x509_crt_parse_der_nocopy( mbedtls_x509_crt *chain, const unsigned char *buf,
+                        size_t buflen );
+
 /**
  * \brief          Parse one or more certificates and add them
  *                 to the chained list. Parses permissively. If some
@@ -408,6 +468,42 @@ void mbedtls_x509_crt_init( mbedtls_x509_crt *crt );
  * \param crt      Certificate chain to free
  */
 void mbedtls_x509_crt_free( mbedtls_x509_crt *crt );
+
+/**
+ * \brief          Initialize a CA store, with one reference held by the
+ *                 caller. Certificates are then parsed into store->chain
+ *                 with any of the mbedtls_x509_crt_parse functions.
+ *
+ * \param store    CA store to initialize
+ */
+void mbedtls_x509_crt_store_init( mbedtls_x509_crt_store *store );
+
+/**
+ * \brief          Build the subject index of a CA store. After this call,
+ *                 the store must not be modified anymore.
+ *
+ * \param store    CA store to seal
+ *
+ * \return         0 if successful, or MBEDTLS_ERR_X509_ALLOC_FAILED
+ */
+int mbedtls_x509_crt_store_seal( mbedtls_x509_crt_store *store );
+
+/**
+ * \brief          Take a reference to a CA store
+ *
+ * \param store    CA store
+ */
+void mbedtls_x509_crt_store_acquire( mbedtls_x509_crt_store *store );
+
+/**
+ * \brief          Release a reference to a CA store. When the last
+ *                 reference is released, the certificates and the index
+ *                 are freed. The store structure itself is not freed.
+ *
+ * \param store    CA store
+ */
+void mbedtls_x509_crt_store_release( mbedtls_x509_crt_store *store );
+
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
 /* \} name */
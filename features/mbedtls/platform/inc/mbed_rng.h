@@ -0,0 +1,52 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_RNG_H
+#define MBED_RNG_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Fill a buffer from the system-wide random number generator
+ *
+ * The generator is a buffered CTR_DRBG shared by all users, seeded from the
+ * mbed TLS entropy sources on first use. It is safe to call from multiple
+ * threads, but not from interrupt context.
+ *
+ * @param output Buffer to fill
+ * @param len    Number of bytes to generate
+ * @return 0 on success, or non-zero if the generator could not be seeded or
+ *         is not available
+ */
+int mbed_rng_get_bytes(unsigned char *output, size_t len);
+
+/** Random number callback for mbed TLS functions taking f_rng and p_rng
+ *
+ * @param p_rng  Ignored, may be NULL
+ * @param output Buffer to fill
+ * @param len    Number of bytes to generate
+ * @return Same as mbed_rng_get_bytes()
+ */
+int mbed_rng_random(void *p_rng, unsigned char *output, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#include "platform/inc/mbed_rng.h"
+
+#if defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C)
+
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "platform/SingletonPtr.h"
+#include "platform/PlatformMutex.h"
+
+static SingletonPtr<PlatformMutex> _mutex;
+static mbedtls_entropy_context _entropy;
+static mbedtls_ctr_drbg_buffered_context _drbg;
+static bool _seeded = false;
+
+static const unsigned char _personalization[] = "mbed_rng";
+
+static int _seed()
+{
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_ctr_drbg_buffered_init(&_drbg);
+
+    int ret = mbedtls_ctr_drbg_buffered_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                                             _personalization, sizeof(_personalization) - 1);
+    if (ret != 0) {
+        mbedtls_ctr_drbg_buffered_free(&_drbg);
+        mbedtls_entropy_free(&_entropy);
+        return ret;
+    }
+
+    _seeded = true;
+    return 0;
+}
+
+int mbed_rng_get_bytes(unsigned char *output, size_t len)
+{
+    int ret = 0;
+
+    _mutex->lock();
+
+    if (!_seeded) {
+        ret = _seed();
+    }
+
+    while (ret == 0 && len > 0) {
+        size_t chunk = len > MBEDTLS_CTR_DRBG_MAX_REQUEST ? MBEDTLS_CTR_DRBG_MAX_REQUEST : len;
+        ret = mbedtls_ctr_drbg_buffered_random(&_drbg, output, chunk);
+        output += chunk;
+        len -= chunk;
+    }
+
+    _mutex->unlock();
+
+    return ret;
+}
+
+#else
+
+int mbed_rng_get_bytes(unsigned char *output, size_t len)
+{
+    (void)output;
+    (void)len;
+    return -1;
+}
+
+#endif
+
+int mbed_rng_random(void *p_rng, unsigned char *output, size_t len)
+{
+    (void)p_rng;
+    return mbed_rng_get_bytes(output, len);
+}
@@ -0,0 +1,295 @@
+/*
+ *  Runtime dispatch of primitives to hardware accelerators
+ *
+ *  Copyright (C) 2006-2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  This file is part of mbed TLS (https://tls.mbed.org)
+ */
+/*
+ *  The software implementations of AES, SHA-256 and modular exponentiation
+ *  call into this module before doing the work themselves. When an engine
+ *  is registered for the primitive the request is handed to it; if the
+ *  engine declines, fails or has too many pending requests, the caller
+ *  carries on in software, so an accelerator never makes an operation fail
+ *  that would have succeeded without it.
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_ACCEL_C)
+
+#include "mbedtls/accel.h"
+
+#include <string.h>
+
+/* Engine serving each primitive, NULL for software only */
+static mbedtls_accel_engine *accel_table[MBEDTLS_ACCEL_PRIMITIVE_COUNT];
+
+/* Protected by the state mutex of the engine serving the primitive */
+static mbedtls_accel_stats accel_stats[MBEDTLS_ACCEL_PRIMITIVE_COUNT];
+
+void mbedtls_accel_engine_init( mbedtls_accel_engine *engine, const char *name,
+                                const mbedtls_accel_ops *ops, void *p_ctx,
+                                unsigned int max_pending )
+{
+    memset( engine, 0, sizeof( mbedtls_accel_engine ) );
+
+    engine->name = name;
+    engine->ops = ops;
+    engine->p_ctx = p_ctx;
+    engine->max_pending = max_pending;
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_init( &engine->state_mutex );
+    mbedtls_mutex_init( &engine->engine_mutex );
+#endif
+}
+
+void mbedtls_accel_engine_free( mbedtls_accel_engine *engine )
+{
+    if( engine == NULL )
+        return;
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_free( &engine->state_mutex );
+    mbedtls_mutex_free( &engine->engine_mutex );
+#endif
+
+    memset( engine, 0, sizeof( mbedtls_accel_engine ) );
+}
+
+int mbedtls_accel_register( mbedtls_accel_engine *engine )
+{
+    const mbedtls_accel_ops *ops = engine->ops;
+    int registered = 0;
+
+    if( ops == NULL )
+        return( MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+
+    if( ops->aes_crypt_ecb != NULL )
+    {
+        accel_table[MBEDTLS_ACCEL_AES] = engine;
+        registered = 1;
+    }
+
+    if( ops->sha256_process != NULL )
+    {
+        accel_table[MBEDTLS_ACCEL_SHA256] = engine;
+        registered = 1;
+    }
+
+    if( ops->mpi_exp_mod != NULL )
+    {
+        accel_table[MBEDTLS_ACCEL_MPI_EXP_MOD] = engine;
+        registered = 1;
+    }
+
+    return( registered ? 0 : MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+}
+
+void mbedtls_accel_unregister( mbedtls_accel_engine *engine )
+{
+    int i;
+
+    for( i = 0; i < MBEDTLS_ACCEL_PRIMITIVE_COUNT; i++ )
+    {
+        if( accel_table[i] == engine )
+            accel_table[i] = NULL;
+    }
+}
+
+void mbedtls_accel_get_stats( mbedtls_accel_primitive_t primitive,
+                              mbedtls_accel_stats *stats )
+{
+    mbedtls_accel_engine *e;
+
+    if( (int) primitive < 0 || primitive >= MBEDTLS_ACCEL_PRIMITIVE_COUNT )
+    {
+        memset( stats, 0, sizeof( mbedtls_accel_stats ) );
+        return;
+    }
+
+    e = accel_table[primitive];
+
+#if defined(MBEDTLS_THREADING_C)
+    if( e != NULL && mbedtls_mutex_lock( &e->state_mutex ) != 0 )
+    {
+        memset( stats, 0, sizeof( mbedtls_accel_stats ) );
+        return;
+    }
+#endif
+
+    *stats = accel_stats[primitive];
+
+#if defined(MBEDTLS_THREADING_C)
+    if( e != NULL )
+        mbedtls_mutex_unlock( &e->state_mutex );
+#endif
+}
+
+void mbedtls_accel_reset_stats( void )
+{
+    mbedtls_accel_engine *e;
+    int i;
+
+    for( i = 0; i < MBEDTLS_ACCEL_PRIMITIVE_COUNT; i++ )
+    {
+        e = accel_table[i];
+
+#if defined(MBEDTLS_THREADING_C)
+        if( e != NULL && mbedtls_mutex_lock( &e->state_mutex ) != 0 )
+            continue;
+#endif
+
+        memset( &accel_stats[i], 0, sizeof( mbedtls_accel_stats ) );
+
+#if defined(MBEDTLS_THREADING_C)
+        if( e != NULL )
+            mbedtls_mutex_unlock( &e->state_mutex );
+#endif
+    }
+}
+
+/*
+ * Claim the engine serving a primitive, waiting for it if the queue is not
+ * full. On success the engine is returned in *engine and must be handed
+ * back with accel_leave().
+ */
+static int accel_enter( mbedtls_accel_primitive_t primitive,
+                        mbedtls_accel_engine **engine )
+{
+    mbedtls_accel_engine *e = accel_table[primitive];
+    int busy;
+
+    if( e == NULL )
+        return( MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+
+#if defined(MBEDTLS_THREADING_C)
+    if( mbedtls_mutex_lock( &e->state_mutex ) != 0 )
+        return( MBEDTLS_ERR_ACCEL_BUSY );
+#endif
+
+    /* One request runs, max_pending more may wait */
+    busy = ( e->pending > e->max_pending );
+    if( busy )
+        accel_stats[primitive].busy++;
+    else
+        e->pending++;
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_unlock( &e->state_mutex );
+#endif
+
+    if( busy )
+        return( MBEDTLS_ERR_ACCEL_BUSY );
+
+#if defined(MBEDTLS_THREADING_C)
+    if( mbedtls_mutex_lock( &e->engine_mutex ) != 0 )
+    {
+        if( mbedtls_mutex_lock( &e->state_mutex ) == 0 )
+        {
+            e->pending--;
+            accel_stats[primitive].busy++;
+            mbedtls_mutex_unlock( &e->state_mutex );
+        }
+        return( MBEDTLS_ERR_ACCEL_BUSY );
+    }
+#endif
+
+    *engine = e;
+    return( 0 );
+}
+
+/*
+ * Release the engine and account for the result of the request
+ */
+static int accel_leave( mbedtls_accel_primitive_t primitive,
+                        mbedtls_accel_engine *e, int ret )
+{
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_unlock( &e->engine_mutex );
+
+    if( mbedtls_mutex_lock( &e->state_mutex ) != 0 )
+        return( ret );
+#endif
+
+    e->pending--;
+
+    if( ret == 0 )
+        accel_stats[primitive].offloaded++;
+    else if( ret == MBEDTLS_ERR_ACCEL_UNSUPPORTED )
+        accel_stats[primitive].unsupported++;
+    else
+        accel_stats[primitive].failed++;
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_unlock( &e->state_mutex );
+#endif
+
+    return( ret );
+}
+
+int mbedtls_accel_aes_crypt_ecb( const unsigned char *key, unsigned int keybits,
+                                 int mode, const unsigned char input[16],
+                                 unsigned char output[16] )
+{
+    mbedtls_accel_engine *e;
+    int ret;
+
+    /* No raw key if the key schedule was set up by an alternative setkey */
+    if( keybits == 0 )
+        return( MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+
+    if( ( ret = accel_enter( MBEDTLS_ACCEL_AES, &e ) ) != 0 )
+        return( ret );
+
+    ret = e->ops->aes_crypt_ecb( e->p_ctx, key, keybits, mode, input, output );
+
+    return( accel_leave( MBEDTLS_ACCEL_AES, e, ret ) );
+}
+
+int mbedtls_accel_sha256_process( uint32_t state[8], const unsigned char data[64] )
+{
+    mbedtls_accel_engine *e;
+    int ret;
+
+    if( ( ret = accel_enter( MBEDTLS_ACCEL_SHA256, &e ) ) != 0 )
+        return( ret );
+
+    ret = e->ops->sha256_process( e->p_ctx, state, data );
+
+    return( accel_leave( MBEDTLS_ACCEL_SHA256, e, ret ) );
+}
+
+int mbedtls_accel_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
+                               const mbedtls_mpi *E, const mbedtls_mpi *N )
+{
+    mbedtls_accel_engine *e;
+    int ret;
+
+    if( ( ret = accel_enter( MBEDTLS_ACCEL_MPI_EXP_MOD, &e ) ) != 0 )
+        return( ret );
+
+    ret = e->ops->mpi_exp_mod( e->p_ctx, X, A, E, N );
+
+    return( accel_leave( MBEDTLS_ACCEL_MPI_EXP_MOD, e, ret ) );
+}
+
+#endif /* MBEDTLS_ACCEL_C */
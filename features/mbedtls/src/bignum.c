@@ -46,6 +46,10 @@
 #include "mbedtls/bignum.h"
 #include "mbedtls/bn_mul.h"
 
+#if defined(MBEDTLS_ACCEL_C)
+#include "mbedtls/accel.h"
+#endif
+
 #include <string.h>
 
 #if defined(MBEDTLS_PLATFORM_C)
@@ -1582,6 +1586,84 @@ static int mpi_montmul( mbedtls_mpi *A, const mbedtls_mpi *B, const mbedtls_mpi
     return( 0 );
 }
 
+/*
+ * Montgomery squaring: A = A * A * R^-1 mod N
+ *
+ * The cross products a[i] * a[j], i < j, are computed once and doubled, which
+ * saves almost half of the limb multiplications of mpi_montmul( A, A ). The
+ * 2n-limb square is then reduced in place.
+ */
+static int mpi_montsqr( mbedtls_mpi *A, const mbedtls_mpi *N, mbedtls_mpi_uint mm,
+                         const mbedtls_mpi *T )
+{
+    size_t i, n;
+    mbedtls_mpi_uint c, t, *d;
+
+    n = N->n;
+
+    if( T->n < 2 * n + 2 || T->p == NULL )
+        return( MBEDTLS_ERR_MPI_BAD_INPUT_DATA );
+
+    memset( T->p, 0, T->n * ciL );
+
+    d = T->p;
+
+    /*
+     * T = sum of a[i] * a[j] * 2^(biL * (i + j)) for i < j
+     */
+    for( i = 0; i + 1 < n; i++ )
+        mpi_mul_hlp( n - i - 1, A->p + i + 1, d + 2 * i + 1, A->p[i] );
+
+    /*
+     * T = 2 * T + sum of a[i]^2 * 2^(2 * biL * i)
+     */
+#if defined(MBEDTLS_HAVE_UDBL)
+    for( i = 0, c = 0, t = 0; i < n; i++ )
+    {
+        mbedtls_t_udbl r;
+        mbedtls_mpi_uint lo = d[2 * i], hi = d[2 * i + 1];
+
+        r  = (mbedtls_t_udbl) A->p[i] * A->p[i] + c;
+        r += ( lo << 1 ) | t;
+        d[2 * i] = (mbedtls_mpi_uint) r;
+
+        r  = ( r >> biL ) + ( ( hi << 1 ) | ( lo >> ( biL - 1 ) ) );
+        d[2 * i + 1] = (mbedtls_mpi_uint) r;
+
+        c = (mbedtls_mpi_uint)( r >> biL );
+        t = hi >> ( biL - 1 );
+    }
+    d[2 * n] = c + t;
+#else
+    for( i = 0, c = 0; i < 2 * n; i++ )
+    {
+        t = d[i] >> ( biL - 1 );
+        d[i] = ( d[i] << 1 ) | c;
+        c = t;
+    }
+    d[2 * n] = c;
+
+    for( i = 0; i < n; i++ )
+        mpi_mul_hlp( 1, A->p + i, d + 2 * i, A->p[i] );
+#endif
+
+    /*
+     * T = T / R, clearing one limb per step
+     */
+    for( i = 0; i < n; i++ )
+        mpi_mul_hlp( n, N->p, d + i, d[i] * mm );
+
+    memcpy( A->p, d + n, ( n + 1 ) * ciL );
+
+    if( mbedtls_mpi_cmp_abs( A, N ) >= 0 )
+        mpi_sub_hlp( n, N->p, A->p );
+    else
+        /* prevent timing attacks */
+        mpi_sub_hlp( n, A->p, T->p );
+
+    return( 0 );
+}
+
 /*
  * Montgomery reduction: A = A * R^-1 mod N
  */
@@ -1596,14 +1678,75 @@ static int mpi_montred( mbedtls_mpi *A, const mbedtls_mpi *N, mbedtls_mpi_uint m
     return( mpi_montmul( A, &U, N, mm, T ) );
 }
 
+/*
+ * Precompute the upper half of the sliding window table,
+ * W[i] = W[1]^i * R for 2^(wsize - 1) <= i < 2^wsize.
+ * On failure, the entries allocated so far are freed again.
+ */
+static int mpi_exp_mod_table( mbedtls_mpi *W, size_t wsize, const mbedtls_mpi *N,
+                              mbedtls_mpi_uint mm, const mbedtls_mpi *T )
+{
+    int ret = 0;
+    size_t i, j, one = 1;
+
+    if( wsize <= 1 )
+        return( 0 );
+
+    /*
+     * W[1 << (wsize - 1)] = W[1] ^ (wsize - 1)
+     */
+    j =  one << ( wsize - 1 );
+
+    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &W[j], N->n + 1 ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_copy( &W[j], &W[1]    ) );
+
+    for( i = 0; i < wsize - 1; i++ )
+        MBEDTLS_MPI_CHK( mpi_montsqr( &W[j], N, mm, T ) );
+
+    /*
+     * W[i] = W[i - 1] * W[1]
+     */
+    for( i = j + 1; i < ( one << wsize ); i++ )
+    {
+        MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &W[i], N->n + 1 ) );
+        MBEDTLS_MPI_CHK( mbedtls_mpi_copy( &W[i], &W[i - 1] ) );
+
+        MBEDTLS_MPI_CHK( mpi_montmul( &W[i], &W[1], N, mm, T ) );
+    }
+
+cleanup:
+
+    if( ret != 0 )
+    {
+        for( i = ( one << ( wsize - 1 ) ); i < ( one << wsize ); i++ )
+            mbedtls_mpi_free( &W[i] );
+    }
+
+    return( ret );
+}
+
 /*
  * Sliding-window exponentiation: X = A^E mod N  (HAC 14.85)
  */
 int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi *E, const mbedtls_mpi *N, mbedtls_mpi *_RR )
+{
+#if defined(MBEDTLS_ACCEL_C)
+    /* Invalid input is left to the software path to report */
+    if( mbedtls_mpi_cmp_int( N, 0 ) > 0 && ( N->p[0] & 1 ) != 0 &&
+        mbedtls_mpi_cmp_int( E, 0 ) >= 0 &&
+        mbedtls_accel_mpi_exp_mod( X, A, E, N ) == 0 )
+        return( 0 );
+#endif
+
+    return( mbedtls_mpi_exp_mod_ext( X, A, E, N, _RR, MBEDTLS_MPI_WINDOW_SIZE ) );
+}
+
+int mbedtls_mpi_exp_mod_ext( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi *E, const mbedtls_mpi *N, mbedtls_mpi *_RR,
+                             size_t max_window_size )
 {
     int ret;
     size_t wbits, wsize, one = 1;
-    size_t i, j, nblimbs;
+    size_t i, nblimbs, ebits;
     size_t bufsize, nbits;
     mbedtls_mpi_uint ei, mm, state;
     mbedtls_mpi RR, T, W[ 2 << MBEDTLS_MPI_WINDOW_SIZE ], Apos;
@@ -1623,18 +1766,23 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi
     mbedtls_mpi_init( &Apos );
     memset( W, 0, sizeof( W ) );
 
-    i = mbedtls_mpi_bitlen( E );
+    ebits = mbedtls_mpi_bitlen( E );
+
+    wsize = ( ebits > 671 ) ? 6 : ( ebits > 239 ) ? 5 :
+            ( ebits >  79 ) ? 4 : ( ebits >  23 ) ? 3 : 1;
 
-    wsize = ( i > 671 ) ? 6 : ( i > 239 ) ? 5 :
-            ( i >  79 ) ? 4 : ( i >  23 ) ? 3 : 1;
+    if( max_window_size < 1 )
+        max_window_size = 1;
+
+    if( wsize > max_window_size )
+        wsize = max_window_size;
 
     if( wsize > MBEDTLS_MPI_WINDOW_SIZE )
         wsize = MBEDTLS_MPI_WINDOW_SIZE;
 
-    j = N->n + 1;
-    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( X, j ) );
-    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &W[1],  j ) );
-    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &T, j * 2 ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( X, N->n + 1 ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &W[1],  N->n + 1 ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &T, ( N->n + 1 ) * 2 ) );
 
     /*
      * Compensate for negative A (and correct at the end)
@@ -1672,112 +1820,117 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi
 
     MBEDTLS_MPI_CHK( mpi_montmul( &W[1], &RR, N, mm, &T ) );
 
-    /*
-     * X = R^2 * R^-1 mod N = R mod N
-     */
-    MBEDTLS_MPI_CHK( mbedtls_mpi_copy( X, &RR ) );
-    MBEDTLS_MPI_CHK( mpi_montred( X, N, mm, &T ) );
-
-    if( wsize > 1 )
+    if( ebits > 0 && ebits <= MBEDTLS_MPI_EXP_MOD_SHORT_BITS )
     {
         /*
-         * W[1 << (wsize - 1)] = W[1] ^ (wsize - 1)
+         * Short (public) exponent such as 65537: plain left-to-right
+         * square-and-multiply starting from X = W[1], without a window
+         * table and without squaring R first.
          */
-        j =  one << ( wsize - 1 );
+        MBEDTLS_MPI_CHK( mbedtls_mpi_copy( X, &W[1] ) );
 
-        MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &W[j], N->n + 1 ) );
-        MBEDTLS_MPI_CHK( mbedtls_mpi_copy( &W[j], &W[1]    ) );
+        for( i = ebits - 1; i > 0; i-- )
+        {
+            MBEDTLS_MPI_CHK( mpi_montsqr( X, N, mm, &T ) );
 
-        for( i = 0; i < wsize - 1; i++ )
-            MBEDTLS_MPI_CHK( mpi_montmul( &W[j], &W[j], N, mm, &T ) );
+            if( mbedtls_mpi_get_bit( E, i - 1 ) )
+                MBEDTLS_MPI_CHK( mpi_montmul( X, &W[1], N, mm, &T ) );
+        }
+    }
+    else
+    {
+        /*
+         * X = R^2 * R^-1 mod N = R mod N
+         */
+        MBEDTLS_MPI_CHK( mbedtls_mpi_copy( X, &RR ) );
+        MBEDTLS_MPI_CHK( mpi_montred( X, N, mm, &T ) );
 
         /*
-         * W[i] = W[i - 1] * W[1]
+         * Use the largest window whose table fits in the heap
          */
-        for( i = j + 1; i < ( one << wsize ); i++ )
+        while( ( ret = mpi_exp_mod_table( W, wsize, N, mm, &T ) ) == MBEDTLS_ERR_MPI_ALLOC_FAILED &&
+               wsize > 1 )
         {
-            MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &W[i], N->n + 1 ) );
-            MBEDTLS_MPI_CHK( mbedtls_mpi_copy( &W[i], &W[i - 1] ) );
-
-            MBEDTLS_MPI_CHK( mpi_montmul( &W[i], &W[1], N, mm, &T ) );
+            wsize--;
         }
-    }
+        MBEDTLS_MPI_CHK( ret );
 
-    nblimbs = E->n;
-    bufsize = 0;
-    nbits   = 0;
-    wbits   = 0;
-    state   = 0;
+        nblimbs = E->n;
+        bufsize = 0;
+        nbits   = 0;
+        wbits   = 0;
+        state   = 0;
 
-    while( 1 )
-    {
-        if( bufsize == 0 )
+        while( 1 )
         {
-            if( nblimbs == 0 )
-                break;
-
-            nblimbs--;
+            if( bufsize == 0 )
+            {
+                if( nblimbs == 0 )
+                    break;
 
-            bufsize = sizeof( mbedtls_mpi_uint ) << 3;
-        }
+                nblimbs--;
 
-        bufsize--;
+                bufsize = sizeof( mbedtls_mpi_uint ) << 3;
+            }
 
-        ei = (E->p[nblimbs] >> bufsize) & 1;
+            bufsize--;
 
-        /*
-         * skip leading 0s
-         */
-        if( ei == 0 && state == 0 )
-            continue;
+            ei = (E->p[nblimbs] >> bufsize) & 1;
 
-        if( ei == 0 && state == 1 )
-        {
             /*
-             * out of window, square X
+             * skip leading 0s
              */
-            MBEDTLS_MPI_CHK( mpi_montmul( X, X, N, mm, &T ) );
-            continue;
-        }
-
-        /*
-         * add ei to current window
-         */
-        state = 2;
+            if( ei == 0 && state == 0 )
+                continue;
 
-        nbits++;
-        wbits |= ( ei << ( wsize - nbits ) );
+            if( ei == 0 && state == 1 )
+            {
+                /*
+                 * out of window, square X
+                 */
+                MBEDTLS_MPI_CHK( mpi_montsqr( X, N, mm, &T ) );
+                continue;
+            }
 
-        if( nbits == wsize )
-        {
             /*
-             * X = X^wsize R^-1 mod N
+             * add ei to current window
              */
-            for( i = 0; i < wsize; i++ )
-                MBEDTLS_MPI_CHK( mpi_montmul( X, X, N, mm, &T ) );
+            state = 2;
 
-            /*
-             * X = X * W[wbits] R^-1 mod N
-             */
-            MBEDTLS_MPI_CHK( mpi_montmul( X, &W[wbits], N, mm, &T ) );
+            nbits++;
+            wbits |= ( ei << ( wsize - nbits ) );
 
-            state--;
-            nbits = 0;
-            wbits = 0;
+            if( nbits == wsize )
+            {
+                /*
+                 * X = X^wsize R^-1 mod N
+                 */
+                for( i = 0; i < wsize; i++ )
+                    MBEDTLS_MPI_CHK( mpi_montsqr( X, N, mm, &T ) );
+
+                /*
+                 * X = X * W[wbits] R^-1 mod N
+                 */
+                MBEDTLS_MPI_CHK( mpi_montmul( X, &W[wbits], N, mm, &T ) );
+
+                state--;
+                nbits = 0;
+                wbits = 0;
+            }
         }
-    }
 
-    /*
-     * process the remaining bits
-     */
-    for( i = 0; i < nbits; i++ )
-    {
-        MBEDTLS_MPI_CHK( mpi_montmul( X, X, N, mm, &T ) );
+        /*
+         * process the remaining bits
+         */
+        for( i = 0; i < nbits; i++ )
+        {
+            MBEDTLS_MPI_CHK( mpi_montsqr( X, N, mm, &T ) );
 
-        wbits <<= 1;
+            wbits <<= 1;
 
-        if( ( wbits & ( one << wsize ) ) != 0 )
-            MBEDTLS_MPI_CHK( mpi_montmul( X, &W[1], N, mm, &T ) );
+            if( ( wbits & ( one << wsize ) ) != 0 )
+                MBEDTLS_MPI_CHK( mpi_montmul( X, &W[1], N, mm, &T ) );
+        }
     }
 
     /*
@@ -415,6 +415,133 @@ int mbedtls_ctr_drbg_random( void *p_rng, unsigned char *output, size_t output_l
     return( ret );
 }
 
+/*
+ * Buffered CTR_DRBG
+ */
+void mbedtls_ctr_drbg_buffered_init( mbedtls_ctr_drbg_buffered_context *ctx )
+{
+    memset( ctx, 0, sizeof( mbedtls_ctr_drbg_buffered_context ) );
+
+    mbedtls_ctr_drbg_init( &ctx->drbg );
+}
+
+int mbedtls_ctr_drbg_buffered_seed( mbedtls_ctr_drbg_buffered_context *ctx,
+                   int (*f_entropy)(void *, unsigned char *, size_t),
+                   void *p_entropy,
+                   const unsigned char *custom,
+                   size_t len )
+{
+    mbedtls_zeroize( ctx->buf, MBEDTLS_CTR_DRBG_BUFFER_SIZE );
+    ctx->buf_left = 0;
+
+    return( mbedtls_ctr_drbg_seed( &ctx->drbg, f_entropy, p_entropy, custom, len ) );
+}
+
+void mbedtls_ctr_drbg_buffered_free( mbedtls_ctr_drbg_buffered_context *ctx )
+{
+    if( ctx == NULL )
+        return;
+
+    mbedtls_ctr_drbg_free( &ctx->drbg );
+    mbedtls_zeroize( ctx, sizeof( mbedtls_ctr_drbg_buffered_context ) );
+}
+
+int mbedtls_ctr_drbg_buffered_reseed( mbedtls_ctr_drbg_buffered_context *ctx,
+                     const unsigned char *additional, size_t len )
+{
+    int ret;
+
+#if defined(MBEDTLS_THREADING_C)
+    if( ( ret = mbedtls_mutex_lock( &ctx->drbg.mutex ) ) != 0 )
+        return( ret );
+#endif
+
+    mbedtls_zeroize( ctx->buf, MBEDTLS_CTR_DRBG_BUFFER_SIZE );
+    ctx->buf_left = 0;
+
+    ret = mbedtls_ctr_drbg_reseed( &ctx->drbg, additional, len );
+
+#if defined(MBEDTLS_THREADING_C)
+    if( mbedtls_mutex_unlock( &ctx->drbg.mutex ) != 0 )
+        return( MBEDTLS_ERR_THREADING_MUTEX_ERROR );
+#endif
+
+    return( ret );
+}
+
+static int ctr_drbg_buffered_random_internal( mbedtls_ctr_drbg_buffered_context *ctx,
+                                              unsigned char *output, size_t output_len )
+{
+    int ret;
+    size_t use_len;
+    unsigned char *p;
+
+    if( output_len > MBEDTLS_CTR_DRBG_MAX_REQUEST )
+        return( MBEDTLS_ERR_CTR_DRBG_REQUEST_TOO_BIG );
+
+    /*
+     * Prediction resistance requires a reseed before every request, so
+     * output generated earlier must not be handed out
+     */
+    if( ctx->drbg.prediction_resistance && ctx->buf_left > 0 )
+    {
+        mbedtls_zeroize( ctx->buf, MBEDTLS_CTR_DRBG_BUFFER_SIZE );
+        ctx->buf_left = 0;
+    }
+
+    if( ctx->drbg.prediction_resistance ||
+        output_len >= MBEDTLS_CTR_DRBG_BUFFER_SIZE )
+        return( mbedtls_ctr_drbg_random_with_add( &ctx->drbg, output, output_len,
+                                                  NULL, 0 ) );
+
+    while( output_len > 0 )
+    {
+        if( ctx->buf_left == 0 )
+        {
+            if( ( ret = mbedtls_ctr_drbg_random_with_add( &ctx->drbg, ctx->buf,
+                                MBEDTLS_CTR_DRBG_BUFFER_SIZE, NULL, 0 ) ) != 0 )
+                return( ret );
+
+            ctx->buf_left = MBEDTLS_CTR_DRBG_BUFFER_SIZE;
+        }
+
+        use_len = ( output_len > ctx->buf_left ) ? ctx->buf_left : output_len;
+        p = ctx->buf + MBEDTLS_CTR_DRBG_BUFFER_SIZE - ctx->buf_left;
+
+        /*
+         * Hand out the oldest bytes and wipe them from the buffer
+         */
+        memcpy( output, p, use_len );
+        mbedtls_zeroize( p, use_len );
+
+        output += use_len;
+        output_len -= use_len;
+        ctx->buf_left -= use_len;
+    }
+
+    return( 0 );
+}
+
+int mbedtls_ctr_drbg_buffered_random( void *p_rng, unsigned char *output, size_t output_len )
+{
+    int ret;
+    mbedtls_ctr_drbg_buffered_context *ctx = (mbedtls_ctr_drbg_buffered_context *) p_rng;
+
+#if defined(MBEDTLS_THREADING_C)
+    if( ( ret = mbedtls_mutex_lock( &ctx->drbg.mutex ) ) != 0 )
+        return( ret );
+#endif
+
+    ret = ctr_drbg_buffered_random_internal( ctx, output, output_len );
+
+#if defined(MBEDTLS_THREADING_C)
+    if( mbedtls_mutex_unlock( &ctx->drbg.mutex ) != 0 )
+        return( MBEDTLS_ERR_THREADING_MUTEX_ERROR );
+#endif
+
+    return( ret );
+}
+
 #if defined(MBEDTLS_FS_IO)
 int mbedtls_ctr_drbg_write_seed_file( mbedtls_ctr_drbg_context *ctx, const char *path )
 {
@@ -539,7 +666,9 @@ static int ctr_drbg_self_test_entropy( void *data, unsigned char *buf,
 int mbedtls_ctr_drbg_self_test( int verbose )
 {
     mbedtls_ctr_drbg_context ctx;
+    mbedtls_ctr_drbg_buffered_context bctx;
     unsigned char buf[16];
+    unsigned char ref[MBEDTLS_CTR_DRBG_BUFFER_SIZE];
 
     mbedtls_ctr_drbg_init( &ctx );
 
@@ -580,6 +709,34 @@ int mbedtls_ctr_drbg_self_test( int verbose )
 
     mbedtls_ctr_drbg_free( &ctx );
 
+    if( verbose != 0 )
+        mbedtls_printf( "passed\n" );
+
+    /*
+     * Buffered output must be the output of one large request
+     */
+    if( verbose != 0 )
+        mbedtls_printf( "  CTR_DRBG (buffered)  : " );
+
+    mbedtls_ctr_drbg_init( &ctx );
+    mbedtls_ctr_drbg_buffered_init( &bctx );
+
+    test_offset = 0;
+    CHK( mbedtls_ctr_drbg_seed_entropy_len( &ctx, ctr_drbg_self_test_entropy,
+                            (void *) entropy_source_nopr, nonce_pers_nopr, 16, 32 ) );
+    CHK( mbedtls_ctr_drbg_random( &ctx, ref, sizeof( ref ) ) );
+
+    test_offset = 0;
+    CHK( mbedtls_ctr_drbg_seed_entropy_len( &bctx.drbg, ctr_drbg_self_test_entropy,
+                            (void *) entropy_source_nopr, nonce_pers_nopr, 16, 32 ) );
+    CHK( mbedtls_ctr_drbg_buffered_random( &bctx, buf, 5 ) );
+    CHK( memcmp( buf, ref, 5 ) );
+    CHK( mbedtls_ctr_drbg_buffered_random( &bctx, buf, 16 ) );
+    CHK( memcmp( buf, ref + 5, 16 ) );
+
+    mbedtls_ctr_drbg_buffered_free( &bctx );
+    mbedtls_ctr_drbg_free( &ctx );
+
     if( verbose != 0 )
         mbedtls_printf( "passed\n" );
 
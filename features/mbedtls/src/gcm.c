@@ -27,6 +27,8 @@
  *
  * We use the algorithm described as Shoup's method with 4-bit tables in
  * [MGV] 4.1, pp. 12-13, to enhance speed without using too much memory.
+ * With MBEDTLS_GCM_LARGE_TABLE, 8-bit tables are used instead, trading
+ * 4 KB of context memory for half the table lookups.
  */
 
 #if !defined(MBEDTLS_CONFIG_FILE)
@@ -38,6 +40,7 @@
 #if defined(MBEDTLS_GCM_C)
 
 #include "mbedtls/gcm.h"
+#include "mbedtls/cipher_internal.h"
 
 #include <string.h>
 
@@ -90,6 +93,12 @@ void mbedtls_gcm_init( mbedtls_gcm_context *ctx )
     memset( ctx, 0, sizeof( mbedtls_gcm_context ) );
 }
 
+/*
+ * Index of H in the tables: with n-bit tables, the most significant bit of
+ * the index corresponds to 1 in GF(2^128)
+ */
+#define GCM_HTABLE_ONE  ( MBEDTLS_GCM_HTABLE_SIZE / 2 )
+
 /*
  * Precompute small multiples of H, that is set
  *      HH[i] || HL[i] = H times i,
@@ -119,9 +128,9 @@ static int gcm_gen_table( mbedtls_gcm_context *ctx )
     GET_UINT32_BE( lo, h,  12 );
     vl = (uint64_t) hi << 32 | lo;
 
-    /* 8 = 1000 corresponds to 1 in GF(2^128) */
-    ctx->HL[8] = vl;
-    ctx->HH[8] = vh;
+    /* 8 = 1000 (or 128 = 10000000) corresponds to 1 in GF(2^128) */
+    ctx->HL[GCM_HTABLE_ONE] = vl;
+    ctx->HH[GCM_HTABLE_ONE] = vh;
 
 #if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
     /* With CLMUL support, we need only h, not the rest of the table */
@@ -133,7 +142,7 @@ static int gcm_gen_table( mbedtls_gcm_context *ctx )
     ctx->HH[0] = 0;
     ctx->HL[0] = 0;
 
-    for( i = 4; i > 0; i >>= 1 )
+    for( i = GCM_HTABLE_ONE / 2; i > 0; i >>= 1 )
     {
         uint32_t T = ( vl & 1 ) * 0xe1000000U;
         vl  = ( vh << 63 ) | ( vl >> 1 );
@@ -143,7 +152,7 @@ static int gcm_gen_table( mbedtls_gcm_context *ctx )
         ctx->HH[i] = vh;
     }
 
-    for( i = 2; i <= 8; i *= 2 )
+    for( i = 2; i <= GCM_HTABLE_ONE; i *= 2 )
     {
         uint64_t *HiL = ctx->HL + i, *HiH = ctx->HH + i;
         vh = *HiH;
@@ -190,6 +199,7 @@ int mbedtls_gcm_setkey( mbedtls_gcm_context *ctx,
     return( 0 );
 }
 
+#if !defined(MBEDTLS_GCM_LARGE_TABLE)
 /*
  * Shoup's method for multiplication use this table with
  *      last4[x] = x times P^128
@@ -202,6 +212,110 @@ static const uint64_t last4[16] =
     0xe100, 0xfd20, 0xd940, 0xc560,
     0x9180, 0x8da0, 0xa9c0, 0xb5e0
 };
+#else
+/*
+ * Same with 8-bit tables,
+ *      last8[x] = x times P^128
+ */
+static const uint16_t last8[256] =
+{
+    0x0000, 0x01c2, 0x0384, 0x0246, 0x0708, 0x06ca, 0x048c, 0x054e,
+    0x0e10, 0x0fd2, 0x0d94, 0x0c56, 0x0918, 0x08da, 0x0a9c, 0x0b5e,
+    0x1c20, 0x1de2, 0x1fa4, 0x1e66, 0x1b28, 0x1aea, 0x18ac, 0x196e,
+    0x1230, 0x13f2, 0x11b4, 0x1076, 0x1538, 0x14fa, 0x16bc, 0x177e,
+    0x3840, 0x3982, 0x3bc4, 0x3a06, 0x3f48, 0x3e8a, 0x3ccc, 0x3d0e,
+    0x3650, 0x3792, 0x35d4, 0x3416, 0x3158, 0x309a, 0x32dc, 0x331e,
+    0x2460, 0x25a2, 0x27e4, 0x2626, 0x2368, 0x22aa, 0x20ec, 0x212e,
+    0x2a70, 0x2bb2, 0x29f4, 0x2836, 0x2d78, 0x2cba, 0x2efc, 0x2f3e,
+    0x7080, 0x7142, 0x7304, 0x72c6, 0x7788, 0x764a, 0x740c, 0x75ce,
+    0x7e90, 0x7f52, 0x7d14, 0x7cd6, 0x7998, 0x785a, 0x7a1c, 0x7bde,
+    0x6ca0, 0x6d62, 0x6f24, 0x6ee6, 0x6ba8, 0x6a6a, 0x682c, 0x69ee,
+    0x62b0, 0x6372, 0x6134, 0x60f6, 0x65b8, 0x647a, 0x663c, 0x67fe,
+    0x48c0, 0x4902, 0x4b44, 0x4a86, 0x4fc8, 0x4e0a, 0x4c4c, 0x4d8e,
+    0x46d0, 0x4712, 0x4554, 0x4496, 0x41d8, 0x401a, 0x425c, 0x439e,
+    0x54e0, 0x5522, 0x5764, 0x56a6, 0x53e8, 0x522a, 0x506c, 0x51ae,
+    0x5af0, 0x5b32, 0x5974, 0x58b6, 0x5df8, 0x5c3a, 0x5e7c, 0x5fbe,
+    0xe100, 0xe0c2, 0xe284, 0xe346, 0xe608, 0xe7ca, 0xe58c, 0xe44e,
+    0xef10, 0xeed2, 0xec94, 0xed56, 0xe818, 0xe9da, 0xeb9c, 0xea5e,
+    0xfd20, 0xfce2, 0xfea4, 0xff66, 0xfa28, 0xfbea, 0xf9ac, 0xf86e,
+    0xf330, 0xf2f2, 0xf0b4, 0xf176, 0xf438, 0xf5fa, 0xf7bc, 0xf67e,
+    0xd940, 0xd882, 0xdac4, 0xdb06, 0xde48, 0xdf8a, 0xddcc, 0xdc0e,
+    0xd750, 0xd692, 0xd4d4, 0xd516, 0xd058, 0xd19a, 0xd3dc, 0xd21e,
+    0xc560, 0xc4a2, 0xc6e4, 0xc726, 0xc268, 0xc3aa, 0xc1ec, 0xc02e,
+    0xcb70, 0xcab2, 0xc8f4, 0xc936, 0xcc78, 0xcdba, 0xcffc, 0xce3e,
+    0x9180, 0x9042, 0x9204, 0x93c6, 0x9688, 0x974a, 0x950c, 0x94ce,
+    0x9f90, 0x9e52, 0x9c14, 0x9dd6, 0x9898, 0x995a, 0x9b1c, 0x9ade,
+    0x8da0, 0x8c62, 0x8e24, 0x8fe6, 0x8aa8, 0x8b6a, 0x892c, 0x88ee,
+    0x83b0, 0x8272, 0x8034, 0x81f6, 0x84b8, 0x857a, 0x873c, 0x86fe,
+    0xa9c0, 0xa802, 0xaa44, 0xab86, 0xaec8, 0xaf0a, 0xad4c, 0xac8e,
+    0xa7d0, 0xa612, 0xa454, 0xa596, 0xa0d8, 0xa11a, 0xa35c, 0xa29e,
+    0xb5e0, 0xb422, 0xb664, 0xb7a6, 0xb2e8, 0xb32a, 0xb16c, 0xb0ae,
+    0xbbf0, 0xba32, 0xb874, 0xb9b6, 0xbcf8, 0xbd3a, 0xbf7c, 0xbebe
+};
+#endif /* !MBEDTLS_GCM_LARGE_TABLE */
+
+/*
+ * Sets X to X times H using the precomputed tables, with X held as two
+ * 64-bit ints in the same way as the tables.
+ */
+static void gcm_mult_u64( const mbedtls_gcm_context *ctx, uint64_t *xh, uint64_t *xl )
+{
+    int i;
+    unsigned char b, rem;
+    uint64_t x = *xl;
+    uint64_t zh = 0, zl = 0;
+
+    /* Bytes are processed from x[15] to x[0]; shifting the initial zero is harmless */
+    for( i = 15; i >= 0; i-- )
+    {
+        if( i == 7 )
+            x = *xh;
+        b = (unsigned char) x;
+        x >>= 8;
+
+#if defined(MBEDTLS_GCM_LARGE_TABLE)
+        rem = (unsigned char) zl;
+        zl = ( zh << 56 ) | ( zl >> 8 );
+        zh = ( zh >> 8 );
+        zh ^= (uint64_t) last8[rem] << 48;
+        zh ^= ctx->HH[b];
+        zl ^= ctx->HL[b];
+#else
+        rem = (unsigned char) zl & 0xf;
+        zl = ( zh << 60 ) | ( zl >> 4 );
+        zh = ( zh >> 4 );
+        zh ^= (uint64_t) last4[rem] << 48;
+        zh ^= ctx->HH[b & 0xf];
+        zl ^= ctx->HL[b & 0xf];
+
+        rem = (unsigned char) zl & 0xf;
+        zl = ( zh << 60 ) | ( zl >> 4 );
+        zh = ( zh >> 4 );
+        zh ^= (uint64_t) last4[rem] << 48;
+        zh ^= ctx->HH[b >> 4];
+        zl ^= ctx->HL[b >> 4];
+#endif /* MBEDTLS_GCM_LARGE_TABLE */
+    }
+
+    *xh = zh;
+    *xl = zl;
+}
+
+/*
+ * XOR a 16-byte block into X held as two 64-bit ints
+ */
+static void gcm_xor_u64( uint64_t *xh, uint64_t *xl, const unsigned char b[16] )
+{
+    uint32_t hi, lo;
+
+    GET_UINT32_BE( hi, b,  0  );
+    GET_UINT32_BE( lo, b,  4  );
+    *xh ^= (uint64_t) hi << 32 | lo;
+
+    GET_UINT32_BE( hi, b,  8  );
+    GET_UINT32_BE( lo, b,  12 );
+    *xl ^= (uint64_t) hi << 32 | lo;
+}
 
 /*
  * Sets output to x times H using the precomputed tables.
@@ -210,57 +324,82 @@ static const uint64_t last4[16] =
 static void gcm_mult( mbedtls_gcm_context *ctx, const unsigned char x[16],
                       unsigned char output[16] )
 {
-    int i = 0;
-    unsigned char lo, hi, rem;
-    uint64_t zh, zl;
+    uint64_t zh = 0, zl = 0;
 
 #if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
     if( mbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL ) ) {
         unsigned char h[16];
 
-        PUT_UINT32_BE( ctx->HH[8] >> 32, h,  0 );
-        PUT_UINT32_BE( ctx->HH[8],       h,  4 );
-        PUT_UINT32_BE( ctx->HL[8] >> 32, h,  8 );
-        PUT_UINT32_BE( ctx->HL[8],       h, 12 );
+        PUT_UINT32_BE( ctx->HH[GCM_HTABLE_ONE] >> 32, h,  0 );
+        PUT_UINT32_BE( ctx->HH[GCM_HTABLE_ONE],       h,  4 );
+        PUT_UINT32_BE( ctx->HL[GCM_HTABLE_ONE] >> 32, h,  8 );
+        PUT_UINT32_BE( ctx->HL[GCM_HTABLE_ONE],       h, 12 );
 
         mbedtls_aesni_gcm_mult( output, x, h );
         return;
     }
 #endif /* MBEDTLS_AESNI_C && MBEDTLS_HAVE_X86_64 */
 
-    lo = x[15] & 0xf;
+    gcm_xor_u64( &zh, &zl, x );
+    gcm_mult_u64( ctx, &zh, &zl );
 
-    zh = ctx->HH[lo];
-    zl = ctx->HL[lo];
+    PUT_UINT32_BE( zh >> 32, output, 0 );
+    PUT_UINT32_BE( zh, output, 4 );
+    PUT_UINT32_BE( zl >> 32, output, 8 );
+    PUT_UINT32_BE( zl, output, 12 );
+}
 
-    for( i = 15; i >= 0; i-- )
+/*
+ * CTR encryption and GHASH of whole blocks in a single pass. The GHASH
+ * state is kept in registers and the block cipher is called directly
+ * rather than through the generic cipher layer.
+ */
+static int gcm_crypt_blocks( mbedtls_gcm_context *ctx, size_t blocks,
+                             const unsigned char *input,
+                             unsigned char *output )
+{
+    int ret;
+    size_t i;
+    unsigned char ectr[16];
+    uint64_t xh = 0, xl = 0;
+    const mbedtls_cipher_base_t *base = ctx->cipher_ctx.cipher_info->base;
+
+    gcm_xor_u64( &xh, &xl, ctx->buf );
+
+    while( blocks-- > 0 )
     {
-        lo = x[i] & 0xf;
-        hi = x[i] >> 4;
+        for( i = 16; i > 12; i-- )
+            if( ++ctx->y[i - 1] != 0 )
+                break;
 
-        if( i != 15 )
+        if( ( ret = base->ecb_func( ctx->cipher_ctx.cipher_ctx, MBEDTLS_ENCRYPT,
+                                    ctx->y, ectr ) ) != 0 )
         {
-            rem = (unsigned char) zl & 0xf;
-            zl = ( zh << 60 ) | ( zl >> 4 );
-            zh = ( zh >> 4 );
-            zh ^= (uint64_t) last4[rem] << 48;
-            zh ^= ctx->HH[lo];
-            zl ^= ctx->HL[lo];
-
+            return( ret );
         }
 
-        rem = (unsigned char) zl & 0xf;
-        zl = ( zh << 60 ) | ( zl >> 4 );
-        zh = ( zh >> 4 );
-        zh ^= (uint64_t) last4[rem] << 48;
-        zh ^= ctx->HH[hi];
-        zl ^= ctx->HL[hi];
+        /* Input must be hashed before it is overwritten when decrypting in place */
+        if( ctx->mode == MBEDTLS_GCM_DECRYPT )
+            gcm_xor_u64( &xh, &xl, input );
+
+        for( i = 0; i < 16; i++ )
+            output[i] = ectr[i] ^ input[i];
+
+        if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
+            gcm_xor_u64( &xh, &xl, output );
+
+        gcm_mult_u64( ctx, &xh, &xl );
+
+        input += 16;
+        output += 16;
     }
 
-    PUT_UINT32_BE( zh >> 32, output, 0 );
-    PUT_UINT32_BE( zh, output, 4 );
-    PUT_UINT32_BE( zl >> 32, output, 8 );
-    PUT_UINT32_BE( zl, output, 12 );
+    PUT_UINT32_BE( xh >> 32, ctx->buf, 0 );
+    PUT_UINT32_BE( xh, ctx->buf, 4 );
+    PUT_UINT32_BE( xl >> 32, ctx->buf, 8 );
+    PUT_UINT32_BE( xl, ctx->buf, 12 );
+
+    return( 0 );
 }
 
 int mbedtls_gcm_starts( mbedtls_gcm_context *ctx,
@@ -370,6 +509,24 @@ int mbedtls_gcm_update( mbedtls_gcm_context *ctx,
     ctx->len += length;
 
     p = input;
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+    if( ! mbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL ) )
+#endif
+    {
+        /* Whole blocks first, the remaining partial block goes the generic way */
+        use_len = length & ~(size_t) 15;
+        if( use_len > 0 )
+        {
+            if( ( ret = gcm_crypt_blocks( ctx, use_len / 16, p, out_p ) ) != 0 )
+                return( ret );
+
+            length -= use_len;
+            p += use_len;
+            out_p += use_len;
+        }
+    }
+
     while( length > 0 )
     {
         use_len = ( length < 16 ) ? length : 16;
@@ -189,6 +189,42 @@ int mbedtls_pk_verify( mbedtls_pk_context *ctx, mbedtls_md_type_t md_alg,
                                        sig, sig_len ) );
 }
 
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_RESTARTABLE)
+/*
+ * Verify a signature, restartable for ECDSA
+ */
+int mbedtls_pk_verify_restartable( mbedtls_pk_context *ctx,
+               mbedtls_md_type_t md_alg,
+               const unsigned char *hash, size_t hash_len,
+               const unsigned char *sig, size_t sig_len,
+               mbedtls_ecdsa_restart_ctx *rs_ctx )
+{
+    int ret;
+
+    if( rs_ctx == NULL || ! mbedtls_ecp_restart_is_enabled() ||
+        ctx == NULL || ctx->pk_info == NULL ||
+        ( ctx->pk_info->type != MBEDTLS_PK_ECKEY &&
+          ctx->pk_info->type != MBEDTLS_PK_ECDSA ) )
+    {
+        return( mbedtls_pk_verify( ctx, md_alg, hash, hash_len,
+                                   sig, sig_len ) );
+    }
+
+    if( pk_hashlen_helper( md_alg, &hash_len ) != 0 )
+        return( MBEDTLS_ERR_PK_BAD_INPUT_DATA );
+
+    /* Both key types hold a mbedtls_ecp_keypair */
+    ret = mbedtls_ecdsa_read_signature_restartable(
+                (mbedtls_ecdsa_context *) ctx->pk_ctx,
+                hash, hash_len, sig, sig_len, rs_ctx );
+
+    if( ret == MBEDTLS_ERR_ECP_SIG_LEN_MISMATCH )
+        return( MBEDTLS_ERR_PK_SIG_LEN_MISMATCH );
+
+    return( ret );
+}
+#endif /* MBEDTLS_ECDSA_C && MBEDTLS_ECP_RESTARTABLE */
+
 /*
  * Verify a signature with options
  */
@@ -34,6 +34,10 @@
 
 #include "mbedtls/sha256.h"
 
+#if defined(MBEDTLS_ACCEL_C)
+#include "mbedtls/accel.h"
+#endif
+
 #include <string.h>
 
 #if defined(MBEDTLS_SELF_TEST)
@@ -235,6 +239,19 @@ void mbedtls_sha256_process( mbedtls_sha256_context *ctx, const unsigned char da
 }
 #endif /* !MBEDTLS_SHA256_PROCESS_ALT */
 
+/*
+ * Process one block, on an accelerator if one is registered
+ */
+static void sha256_block( mbedtls_sha256_context *ctx, const unsigned char data[64] )
+{
+#if defined(MBEDTLS_ACCEL_C)
+    if( mbedtls_accel_sha256_process( ctx->state, data ) == 0 )
+        return;
+#endif
+
+    mbedtls_sha256_process( ctx, data );
+}
+
 /*
  * SHA-256 process buffer
  */
@@ -259,7 +276,7 @@ void mbedtls_sha256_update( mbedtls_sha256_context *ctx, const unsigned char *in
     if( left && ilen >= fill )
     {
         memcpy( (void *) (ctx->buffer + left), input, fill );
-        mbedtls_sha256_process( ctx, ctx->buffer );
+        sha256_block( ctx, ctx->buffer );
         input += fill;
         ilen  -= fill;
         left = 0;
@@ -267,7 +284,7 @@ void mbedtls_sha256_update( mbedtls_sha256_context *ctx, const unsigned char *in
 
     while( ilen >= 64 )
     {
-        mbedtls_sha256_process( ctx, input );
+        sha256_block( ctx, input );
         input += 64;
         ilen  -= 64;
     }
@@ -5252,6 +5252,9 @@ static void ssl_handshake_params_init( mbedtls_ssl_handshake_params *handshake )
 #if defined(MBEDTLS_ECDH_C)
     mbedtls_ecdh_init( &handshake->ecdh_ctx );
 #endif
+#if defined(MBEDTLS_SSL__ECP_RESTARTABLE)
+    mbedtls_ecdsa_restart_init( &handshake->ecrs_ctx );
+#endif
 #if defined(MBEDTLS_KEY_EXCHANGE_ECJPAKE_ENABLED)
     mbedtls_ecjpake_init( &handshake->ecjpake_ctx );
 #if defined(MBEDTLS_SSL_CLI_C)
@@ -5333,6 +5336,15 @@ static int ssl_handshake_init( mbedtls_ssl_context *ssl )
     ssl_transform_init( ssl->transform_negotiate );
     ssl_handshake_params_init( ssl->handshake );
 
+#if defined(MBEDTLS_SSL__ECP_RESTARTABLE)
+    /* Slice the client's EC computations if a budget is set */
+    if( ssl->conf->endpoint == MBEDTLS_SSL_IS_CLIENT &&
+        mbedtls_ecp_restart_is_enabled() )
+    {
+        ssl->handshake->ecrs_enabled = 1;
+    }
+#endif
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     if( ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM )
     {
@@ -5763,9 +5775,24 @@ void mbedtls_ssl_conf_ca_chain( mbedtls_ssl_config *conf,
                                mbedtls_x509_crt *ca_chain,
                                mbedtls_x509_crl *ca_crl )
 {
+    mbedtls_x509_crt_store_release( conf->ca_store );
+    conf->ca_store   = NULL;
+
     conf->ca_chain   = ca_chain;
     conf->ca_crl     = ca_crl;
 }
+
+void mbedtls_ssl_conf_ca_store( mbedtls_ssl_config *conf,
+                                mbedtls_x509_crt_store *ca_store,
+                                mbedtls_x509_crl *ca_crl )
+{
+    mbedtls_x509_crt_store_acquire( ca_store );
+    mbedtls_x509_crt_store_release( conf->ca_store );
+
+    conf->ca_store   = ca_store;
+    conf->ca_chain   = &ca_store->chain;
+    conf->ca_crl     = ca_crl;
+}
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
 #if defined(MBEDTLS_SSL_SERVER_NAME_INDICATION)
@@ -6973,6 +7000,9 @@ void mbedtls_ssl_handshake_free( mbedtls_ssl_handshake_params *handshake )
 #if defined(MBEDTLS_ECDH_C)
     mbedtls_ecdh_free( &handshake->ecdh_ctx );
 #endif
+#if defined(MBEDTLS_SSL__ECP_RESTARTABLE)
+    mbedtls_ecdsa_restart_free( &handshake->ecrs_ctx );
+#endif
 #if defined(MBEDTLS_KEY_EXCHANGE_ECJPAKE_ENABLED)
     mbedtls_ecjpake_free( &handshake->ecjpake_ctx );
 #if defined(MBEDTLS_SSL_CLI_C)
@@ -7343,6 +7373,7 @@ void mbedtls_ssl_config_free( mbedtls_ssl_config *conf )
 
 #if defined(MBEDTLS_X509_CRT_PARSE_C)
     ssl_key_cert_free( conf->key_cert );
+    mbedtls_x509_crt_store_release( conf->ca_store );
 #endif
 
     mbedtls_zeroize( conf, sizeof( mbedtls_ssl_config ) );
@@ -660,7 +660,7 @@ static int x509_get_crt_ext( unsigned char **p,
  * Parse and fill a single X.509 certificate in DER format
  */
 static int x509_crt_parse_der_core( mbedtls_x509_crt *crt, const unsigned char *buf,
-                                    size_t buflen )
+                                    size_t buflen, int make_copy )
 {
     int ret;
     size_t len;
@@ -701,19 +701,30 @@ static int x509_crt_parse_der_core( mbedtls_x509_crt *crt, const unsigned char *
         return( MBEDTLS_ERR_X509_INVALID_FORMAT +
                 MBEDTLS_ERR_ASN1_LENGTH_MISMATCH );
     }
-    crt_end = p + len;
+    end = crt_end = p + len;
 
-    // Create and populate a new buffer for the raw field
     crt->raw.len = crt_end - buf;
-    crt->raw.p = p = mbedtls_calloc( 1, crt->raw.len );
-    if( p == NULL )
-        return( MBEDTLS_ERR_X509_ALLOC_FAILED );
 
-    memcpy( p, buf, crt->raw.len );
+    if( make_copy != 0 )
+    {
+        // Create and populate a new buffer for the raw field
+        crt->raw.p = p = mbedtls_calloc( 1, crt->raw.len );
+        if( p == NULL )
+            return( MBEDTLS_ERR_X509_ALLOC_FAILED );
 
-    // Direct pointers to the new buffer 
-    p += crt->raw.len - len;
-    end = crt_end = p + len;
+        memcpy( p, buf, crt->raw.len );
+        crt->own_buffer = 1;
+
+        // Direct pointers to the new buffer
+        p += crt->raw.len - len;
+        end = crt_end = p + len;
+    }
+    else
+    {
+        // Reference the original buffer
+        crt->raw.p = (unsigned char*) buf;
+        crt->own_buffer = 0;
+    }
 
     /*
      * TBSCertificate  ::=  SEQUENCE  {
@@ -916,8 +927,8 @@ static int x509_crt_parse_der_core( mbedtls_x509_crt *crt, const unsigned char *
  * Parse one X.509 certificate in DER format from a buffer and add them to a
  * chained list
  */
-int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *buf,
-                        size_t buflen )
+static int x509_crt_parse_der_internal( mbedtls_x509_crt *chain, const unsigned char *buf,
+                                        size_t buflen, int make_copy )
 {
     int ret;
     mbedtls_x509_crt *crt = chain, *prev = NULL;
@@ -949,7 +960,7 @@ int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *bu
         crt = crt->next;
     }
 
-    if( ( ret = x509_crt_parse_der_core( crt, buf, buflen ) ) != 0 )
+    if( ( ret = x509_crt_parse_der_core( crt, buf, buflen, make_copy ) ) != 0 )
     {
         if( prev )
             prev->next = NULL;
@@ -963,6 +974,18 @@ int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *bu
     return( 0 );
 }
 
+int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *buf,
+                        size_t buflen )
+{
+    return( x509_crt_parse_der_internal( chain, buf, buflen, 1 ) );
+}
+
+int mbedtls_x509_crt_parse_der_nocopy( mbedtls_x509_crt *chain, const unsigned char *buf,
+                        size_t buflen )
+{
+    return( x509_crt_parse_der_internal( chain, buf, buflen, 0 ) );
+}
+
 /*
  * Parse one or more PEM certificates from a buffer and add them to the chained
  * list
@@ -1046,7 +1069,22 @@ int mbedtls_x509_crt_parse( mbedtls_x509_crt *chain, const unsigned char *buf, s
             else
                 break;
 
-            ret = mbedtls_x509_crt_parse_der( chain, pem.buf, pem.buflen );
+            /*
+             * Hand the decoded buffer over to the certificate instead of
+             * copying it once more
+             */
+            ret = x509_crt_parse_der_internal( chain, pem.buf, pem.buflen, 0 );
+
+            if( ret == 0 )
+            {
+                mbedtls_x509_crt *crt = chain;
+
+                while( crt->next != NULL )
+                    crt = crt->next;
+
+                crt->own_buffer = 1;
+                pem.buf = NULL;
+            }
 
             mbedtls_pem_free( &pem );
 
@@ -1891,6 +1929,136 @@ static int x509_crt_check_parent( const mbedtls_x509_crt *child,
     return( 0 );
 }
 
+/*
+ * Hash of a Name (FNV-1a), equal for any two names that x509_name_cmp()
+ * considers equal: UTF8String and PrintableString values are hashed with
+ * the same tag and with ASCII letters folded to lower case.
+ */
+#define X509_NAME_HASH_INIT     0x811C9DC5
+#define X509_NAME_HASH_PRIME    0x01000193
+
+static uint32_t x509_name_hash_byte( uint32_t h, unsigned char c )
+{
+    return( ( h ^ c ) * X509_NAME_HASH_PRIME );
+}
+
+static uint32_t x509_name_hash( const mbedtls_x509_name *name )
+{
+    uint32_t h = X509_NAME_HASH_INIT;
+    size_t i;
+    int tag;
+    unsigned char c;
+
+    for( ; name != NULL; name = name->next )
+    {
+        h = x509_name_hash_byte( h, (unsigned char) name->oid.tag );
+        for( i = 0; i < name->oid.len; i++ )
+            h = x509_name_hash_byte( h, name->oid.p[i] );
+
+        tag = name->val.tag;
+        if( tag == MBEDTLS_ASN1_PRINTABLE_STRING )
+            tag = MBEDTLS_ASN1_UTF8_STRING;
+
+        h = x509_name_hash_byte( h, (unsigned char) tag );
+        for( i = 0; i < name->val.len; i++ )
+        {
+            c = name->val.p[i];
+            if( tag == MBEDTLS_ASN1_UTF8_STRING && c >= 'A' && c <= 'Z' )
+                c += 'a' - 'A';
+
+            h = x509_name_hash_byte( h, c );
+        }
+
+        h = x509_name_hash_byte( h, name->next_merged ? 1 : 0 );
+    }
+
+    return( h );
+}
+
+/*
+ * Iterator over the trusted CAs that may have issued a certificate: the whole
+ * list, or only the CAs with a matching subject hash if the list is the chain
+ * of a sealed CA store.
+ */
+typedef struct
+{
+    mbedtls_x509_crt *next;                 /* next CA of a plain list  */
+    const mbedtls_x509_crt_store_entry *pos; /* next index entry         */
+    const mbedtls_x509_crt_store_entry *end;
+    uint32_t hash;
+}
+x509_crt_ca_iter;
+
+static mbedtls_x509_crt *x509_crt_ca_next( x509_crt_ca_iter *it )
+{
+    mbedtls_x509_crt *ca;
+
+    if( it->pos != NULL )
+    {
+        if( it->pos == it->end || it->pos->hash != it->hash )
+            return( NULL );
+
+        return( ( it->pos++ )->crt );
+    }
+
+    ca = it->next;
+    if( ca != NULL )
+        it->next = ca->next;
+
+    return( ca );
+}
+
+static mbedtls_x509_crt *x509_crt_ca_first( x509_crt_ca_iter *it,
+                                            const mbedtls_x509_crt *child,
+                                            mbedtls_x509_crt *trust_ca )
+{
+    const mbedtls_x509_crt_store *store;
+    size_t lo, hi, mid;
+
+    memset( it, 0, sizeof( x509_crt_ca_iter ) );
+    it->next = trust_ca;
+
+    if( trust_ca != NULL && trust_ca->store != NULL &&
+        trust_ca->store->index != NULL )
+    {
+        store = trust_ca->store;
+        it->hash = x509_name_hash( &child->issuer );
+
+        /* Lower bound of the hash, the index is sorted */
+        lo = 0;
+        hi = store->count;
+        while( lo < hi )
+        {
+            mid = lo + ( hi - lo ) / 2;
+            if( store->index[mid].hash < it->hash )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        it->pos = store->index + lo;
+        it->end = store->index + store->count;
+
+        /*
+         * Resuming the search from a CA found earlier: skip the candidates
+         * that come before it in the chain
+         */
+        if( trust_ca != &store->chain )
+        {
+            while( it->pos != it->end && it->pos->hash == it->hash &&
+                   it->pos->crt != trust_ca )
+            {
+                it->pos++;
+            }
+
+            if( it->pos == it->end || it->pos->crt != trust_ca )
+                it->pos = NULL;
+        }
+    }
+
+    return( x509_crt_ca_next( it ) );
+}
+
 static int x509_crt_verify_top(
                 mbedtls_x509_crt *child, mbedtls_x509_crt *trust_ca,
                 mbedtls_x509_crl *ca_crl,
@@ -1904,6 +2072,7 @@ static int x509_crt_verify_top(
     int check_path_cnt;
     unsigned char hash[MBEDTLS_MD_MAX_SIZE];
     const mbedtls_md_info_t *md_info;
+    x509_crt_ca_iter ca_iter;
 
     if( mbedtls_x509_time_is_past( &child->valid_to ) )
         *flags |= MBEDTLS_X509_BADCERT_EXPIRED;
@@ -1933,7 +2102,9 @@ static int x509_crt_verify_top(
     else
         mbedtls_md( md_info, child->tbs.p, child->tbs.len, hash );
 
-    for( /* trust_ca */ ; trust_ca != NULL; trust_ca = trust_ca->next )
+    for( trust_ca = x509_crt_ca_first( &ca_iter, child, trust_ca );
+         trust_ca != NULL;
+         trust_ca = x509_crt_ca_next( &ca_iter ) )
     {
         if( x509_crt_check_parent( child, trust_ca, 1, path_cnt == 0 ) != 0 )
             continue;
@@ -2038,6 +2209,7 @@ static int x509_crt_verify_child(
     unsigned char hash[MBEDTLS_MD_MAX_SIZE];
     mbedtls_x509_crt *grandparent;
     const mbedtls_md_info_t *md_info;
+    x509_crt_ca_iter ca_iter;
 
     /* Counting intermediate self signed certificates */
     if( ( path_cnt != 0 ) && x509_name_cmp( &child->issuer, &child->subject ) == 0 )
@@ -2091,9 +2263,9 @@ static int x509_crt_verify_child(
 #endif
 
     /* Look for a grandparent in trusted CAs */
-    for( grandparent = trust_ca;
+    for( grandparent = x509_crt_ca_first( &ca_iter, parent, trust_ca );
          grandparent != NULL;
-         grandparent = grandparent->next )
+         grandparent = x509_crt_ca_next( &ca_iter ) )
     {
         if( x509_crt_check_parent( parent, grandparent,
                                    0, path_cnt == 0 ) == 0 )
@@ -2188,6 +2360,7 @@ int mbedtls_x509_crt_verify_with_profile( mbedtls_x509_crt *crt,
     int pathlen = 0, selfsigned = 0;
     mbedtls_x509_crt *parent;
     mbedtls_x509_name *name;
+    x509_crt_ca_iter ca_iter;
     mbedtls_x509_sequence *cur = NULL;
     mbedtls_pk_type_t pk_type;
 
@@ -2258,7 +2431,9 @@ int mbedtls_x509_crt_verify_with_profile( mbedtls_x509_crt *crt,
         *flags |= MBEDTLS_X509_BADCERT_BAD_KEY;
 
     /* Look for a parent in trusted CAs */
-    for( parent = trust_ca; parent != NULL; parent = parent->next )
+    for( parent = x509_crt_ca_first( &ca_iter, crt, trust_ca );
+         parent != NULL;
+         parent = x509_crt_ca_next( &ca_iter ) )
     {
         if( x509_crt_check_parent( crt, parent, 0, pathlen == 0 ) == 0 )
             break;
@@ -2368,7 +2543,7 @@ void mbedtls_x509_crt_free( mbedtls_x509_crt *crt )
             mbedtls_free( seq_prv );
         }
 
-        if( cert_cur->raw.p != NULL )
+        if( cert_cur->raw.p != NULL && cert_cur->own_buffer )
         {
             mbedtls_zeroize( cert_cur->raw.p, cert_cur->raw.len );
             mbedtls_free( cert_cur->raw.p );
@@ -2391,4 +2566,119 @@ void mbedtls_x509_crt_free( mbedtls_x509_crt *crt )
     while( cert_cur != NULL );
 }
 
+/*
+ * Initialize a CA store
+ */
+void mbedtls_x509_crt_store_init( mbedtls_x509_crt_store *store )
+{
+    memset( store, 0, sizeof( mbedtls_x509_crt_store ) );
+
+    mbedtls_x509_crt_init( &store->chain );
+    store->refcount = 1;
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_init( &store->mutex );
+#endif
+}
+
+/*
+ * Build the subject index of a CA store, sorted by hash and, for equal
+ * hashes, in chain order so that lookups find CAs in the same order as a
+ * walk of the chain would
+ */
+int mbedtls_x509_crt_store_seal( mbedtls_x509_crt_store *store )
+{
+    mbedtls_x509_crt *crt;
+    mbedtls_x509_crt_store_entry entry;
+    size_t i, j, count = 0;
+
+    if( store->index != NULL )
+        return( 0 );
+
+    for( crt = &store->chain; crt != NULL; crt = crt->next )
+        if( crt->version != 0 )
+            count++;
+
+    if( count == 0 )
+        return( 0 );
+
+    store->index = mbedtls_calloc( count, sizeof( mbedtls_x509_crt_store_entry ) );
+    if( store->index == NULL )
+        return( MBEDTLS_ERR_X509_ALLOC_FAILED );
+
+    for( crt = &store->chain, i = 0; crt != NULL; crt = crt->next )
+    {
+        if( crt->version == 0 )
+            continue;
+
+        entry.hash = x509_name_hash( &crt->subject );
+        entry.crt = crt;
+
+        /* Insertion sort, stable and fine for the size of a CA bundle */
+        for( j = i; j > 0 && store->index[j - 1].hash > entry.hash; j-- )
+            store->index[j] = store->index[j - 1];
+
+        store->index[j] = entry;
+        i++;
+    }
+
+    store->count = count;
+
+    for( crt = &store->chain; crt != NULL; crt = crt->next )
+        crt->store = store;
+
+    return( 0 );
+}
+
+void mbedtls_x509_crt_store_acquire( mbedtls_x509_crt_store *store )
+{
+#if defined(MBEDTLS_THREADING_C)
+    if( mbedtls_mutex_lock( &store->mutex ) != 0 )
+        return;
+#endif
+
+    store->refcount++;
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_unlock( &store->mutex );
+#endif
+}
+
+void mbedtls_x509_crt_store_release( mbedtls_x509_crt_store *store )
+{
+    unsigned int refcount;
+
+    if( store == NULL )
+        return;
+
+#if defined(MBEDTLS_THREADING_C)
+    if( mbedtls_mutex_lock( &store->mutex ) != 0 )
+        return;
+#endif
+
+    refcount = --store->refcount;
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_unlock( &store->mutex );
+#endif
+
+    if( refcount != 0 )
+        return;
+
+    mbedtls_x509_crt_free( &store->chain );
+
+    if( store->index != NULL )
+    {
+        mbedtls_zeroize( store->index,
+                         store->count * sizeof( mbedtls_x509_crt_store_entry ) );
+        mbedtls_free( store->index );
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_free( &store->mutex );
+#endif
+
+    mbedtls_zeroize( store, sizeof( mbedtls_x509_crt_store ) );
+}
+
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
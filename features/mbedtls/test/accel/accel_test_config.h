@@ -0,0 +1,7 @@
+/*
+ *  Additions to the mbed OS configuration for the host test of the
+ *  accelerator dispatch, included through MBEDTLS_USER_CONFIG_FILE
+ */
+#define MBEDTLS_ACCEL_C
+#define MBEDTLS_THREADING_C
+#define MBEDTLS_THREADING_PTHREAD
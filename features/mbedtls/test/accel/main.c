@@ -0,0 +1,426 @@
+/*
+ *  Host test of the accelerator dispatch table
+ *
+ *  Copyright (C) 2006-2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*
+ *  The engines are simulated with the software implementations, and the
+ *  threads are pthreads, so the dispatch can be tested without a target.
+ *  Build and run with "make" in this directory.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mbedtls/config.h"
+#include "mbedtls/accel.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/bignum.h"
+#include "mbedtls/sha256.h"
+
+static int failures;
+
+#define CHECK( cond )                                                   \
+    do {                                                                \
+        if( !( cond ) )                                                 \
+        {                                                               \
+            printf( "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond );    \
+            failures++;                                                 \
+        }                                                               \
+    } while( 0 )
+
+/*
+ * Simulated engine: counts its calls, only accepts 128-bit AES keys, and
+ * can be told to fail or to hold a request until released
+ */
+typedef struct
+{
+    unsigned int calls;
+    int fail;
+    int hold;
+    int held;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+}
+sim_state;
+
+static int sim_enter( sim_state *sim )
+{
+    int fail;
+
+    pthread_mutex_lock( &sim->mutex );
+    sim->calls++;
+    if( sim->hold )
+    {
+        sim->held = 1;
+        pthread_cond_broadcast( &sim->cond );
+        while( sim->hold )
+            pthread_cond_wait( &sim->cond, &sim->mutex );
+        sim->held = 0;
+    }
+    fail = sim->fail;
+    pthread_mutex_unlock( &sim->mutex );
+
+    return( fail ? MBEDTLS_ERR_ACCEL_HW_FAILED : 0 );
+}
+
+static int sim_aes_crypt_ecb( void *p_ctx, const unsigned char *key,
+                              unsigned int keybits, int mode,
+                              const unsigned char input[16],
+                              unsigned char output[16] )
+{
+    mbedtls_aes_context aes;
+    int ret;
+
+    if( keybits != 128 )
+        return( MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+
+    if( ( ret = sim_enter( p_ctx ) ) != 0 )
+        return( ret );
+
+    /* The block functions do not go through the dispatch */
+    mbedtls_aes_init( &aes );
+    if( mode == MBEDTLS_AES_ENCRYPT )
+    {
+        mbedtls_aes_setkey_enc( &aes, key, keybits );
+        mbedtls_aes_encrypt( &aes, input, output );
+    }
+    else
+    {
+        mbedtls_aes_setkey_dec( &aes, key, keybits );
+        mbedtls_aes_decrypt( &aes, input, output );
+    }
+    mbedtls_aes_free( &aes );
+
+    return( 0 );
+}
+
+static int sim_sha256_process( void *p_ctx, uint32_t state[8],
+                               const unsigned char data[64] )
+{
+    mbedtls_sha256_context sha;
+    int ret;
+
+    if( ( ret = sim_enter( p_ctx ) ) != 0 )
+        return( ret );
+
+    mbedtls_sha256_init( &sha );
+    memcpy( sha.state, state, sizeof( sha.state ) );
+    mbedtls_sha256_process( &sha, data );
+    memcpy( state, sha.state, sizeof( sha.state ) );
+    mbedtls_sha256_free( &sha );
+
+    return( 0 );
+}
+
+static int sim_mpi_exp_mod( void *p_ctx, mbedtls_mpi *X, const mbedtls_mpi *A,
+                            const mbedtls_mpi *E, const mbedtls_mpi *N )
+{
+    int ret;
+
+    if( ( ret = sim_enter( p_ctx ) ) != 0 )
+        return( ret );
+
+    return( mbedtls_mpi_exp_mod_ext( X, A, E, N, NULL, 1 ) );
+}
+
+static const mbedtls_accel_ops aes_ops = { sim_aes_crypt_ecb, NULL, NULL };
+static const mbedtls_accel_ops all_ops = { sim_aes_crypt_ecb, sim_sha256_process,
+                                           sim_mpi_exp_mod };
+static const mbedtls_accel_ops no_ops = { NULL, NULL, NULL };
+
+static sim_state sim_aes = { 0, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static sim_state sim_all = { 0, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+static const unsigned char key128[16] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                          0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+static const unsigned char key256[32] = { 0x60 };
+static const unsigned char plain[16] = { 0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+                                         0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a };
+/* FIPS-197 / SP 800-38A F.1.1 */
+static const unsigned char cipher128[16] = { 0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60,
+                                             0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97 };
+
+static void aes_encrypt( const unsigned char *key, unsigned int keybits,
+                         unsigned char output[16] )
+{
+    mbedtls_aes_context aes;
+
+    mbedtls_aes_init( &aes );
+    CHECK( mbedtls_aes_setkey_enc( &aes, key, keybits ) == 0 );
+    CHECK( mbedtls_aes_crypt_ecb( &aes, MBEDTLS_AES_ENCRYPT, plain, output ) == 0 );
+    mbedtls_aes_free( &aes );
+}
+
+static mbedtls_accel_stats get_stats( mbedtls_accel_primitive_t primitive )
+{
+    mbedtls_accel_stats stats;
+
+    mbedtls_accel_get_stats( primitive, &stats );
+    return( stats );
+}
+
+static void reset( void )
+{
+    sim_aes.calls = sim_aes.fail = 0;
+    sim_all.calls = sim_all.fail = 0;
+    mbedtls_accel_reset_stats();
+}
+
+/*
+ * Each primitive goes to the last engine registered for it
+ */
+static void test_table( void )
+{
+    mbedtls_accel_engine aes_engine, all_engine, none_engine;
+    unsigned char output[16];
+    uint32_t state[8] = { 0 };
+    unsigned char block[64] = { 0 };
+
+    reset();
+    mbedtls_accel_engine_init( &aes_engine, "aes", &aes_ops, &sim_aes, 0 );
+    mbedtls_accel_engine_init( &all_engine, "all", &all_ops, &sim_all, 0 );
+    mbedtls_accel_engine_init( &none_engine, "none", &no_ops, NULL, 0 );
+
+    /* Software only */
+    CHECK( mbedtls_accel_aes_crypt_ecb( key128, 128, MBEDTLS_AES_ENCRYPT, plain, output ) ==
+           MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+    CHECK( mbedtls_accel_register( &none_engine ) == MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+    aes_encrypt( key128, 128, output );
+    CHECK( memcmp( output, cipher128, 16 ) == 0 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 0 );
+
+    /* AES only */
+    CHECK( mbedtls_accel_register( &aes_engine ) == 0 );
+    aes_encrypt( key128, 128, output );
+    CHECK( memcmp( output, cipher128, 16 ) == 0 );
+    CHECK( sim_aes.calls == 1 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 1 );
+    CHECK( mbedtls_accel_sha256_process( state, block ) == MBEDTLS_ERR_ACCEL_UNSUPPORTED );
+    CHECK( get_stats( MBEDTLS_ACCEL_SHA256 ).offloaded == 0 );
+
+    /* Taken over by the engine registered last */
+    CHECK( mbedtls_accel_register( &all_engine ) == 0 );
+    aes_encrypt( key128, 128, output );
+    CHECK( memcmp( output, cipher128, 16 ) == 0 );
+    CHECK( sim_aes.calls == 1 );
+    CHECK( sim_all.calls == 1 );
+    CHECK( mbedtls_accel_sha256_process( state, block ) == 0 );
+    CHECK( sim_all.calls == 2 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 2 );
+    CHECK( get_stats( MBEDTLS_ACCEL_SHA256 ).offloaded == 1 );
+
+    /* Unregistering an engine that serves nothing anymore changes nothing */
+    mbedtls_accel_unregister( &aes_engine );
+    aes_encrypt( key128, 128, output );
+    CHECK( sim_all.calls == 3 );
+
+    mbedtls_accel_unregister( &all_engine );
+    aes_encrypt( key128, 128, output );
+    CHECK( memcmp( output, cipher128, 16 ) == 0 );
+    CHECK( sim_all.calls == 3 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 3 );
+
+    /* Out of range primitives read as zero */
+    mbedtls_accel_stats stats;
+    memset( &stats, 0xff, sizeof( stats ) );
+    mbedtls_accel_get_stats( MBEDTLS_ACCEL_PRIMITIVE_COUNT, &stats );
+    CHECK( stats.offloaded == 0 && stats.unsupported == 0 && stats.busy == 0 && stats.failed == 0 );
+
+    mbedtls_accel_reset_stats();
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 0 );
+
+    mbedtls_accel_engine_free( &aes_engine );
+    mbedtls_accel_engine_free( &all_engine );
+    mbedtls_accel_engine_free( &none_engine );
+}
+
+/*
+ * Requests the engine declines or fails are done in software
+ */
+static void test_fallback( void )
+{
+    mbedtls_accel_engine engine;
+    unsigned char reference[16], output[16];
+    mbedtls_mpi X, Y, A, E, N;
+
+    reset();
+    aes_encrypt( key256, 256, reference );
+
+    mbedtls_accel_engine_init( &engine, "all", &all_ops, &sim_all, 0 );
+    CHECK( mbedtls_accel_register( &engine ) == 0 );
+
+    aes_encrypt( key256, 256, output );
+    CHECK( memcmp( output, reference, 16 ) == 0 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).unsupported == 1 );
+    CHECK( sim_all.calls == 0 );
+
+    sim_all.fail = 1;
+    aes_encrypt( key128, 128, output );
+    CHECK( memcmp( output, cipher128, 16 ) == 0 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).failed == 1 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 0 );
+    sim_all.fail = 0;
+
+    /* 3^65537 mod 1000003, offloaded and in software */
+    mbedtls_mpi_init( &X ); mbedtls_mpi_init( &Y ); mbedtls_mpi_init( &A );
+    mbedtls_mpi_init( &E ); mbedtls_mpi_init( &N );
+    CHECK( mbedtls_mpi_lset( &A, 3 ) == 0 );
+    CHECK( mbedtls_mpi_lset( &E, 65537 ) == 0 );
+    CHECK( mbedtls_mpi_lset( &N, 1000003 ) == 0 );
+    CHECK( mbedtls_mpi_exp_mod( &X, &A, &E, &N, NULL ) == 0 );
+    CHECK( get_stats( MBEDTLS_ACCEL_MPI_EXP_MOD ).offloaded == 1 );
+
+    mbedtls_accel_unregister( &engine );
+    CHECK( mbedtls_mpi_exp_mod( &Y, &A, &E, &N, NULL ) == 0 );
+    CHECK( mbedtls_mpi_cmp_mpi( &X, &Y ) == 0 );
+
+    mbedtls_mpi_free( &X ); mbedtls_mpi_free( &Y ); mbedtls_mpi_free( &A );
+    mbedtls_mpi_free( &E ); mbedtls_mpi_free( &N );
+    mbedtls_accel_engine_free( &engine );
+}
+
+static void *aes_thread( void *arg )
+{
+    unsigned char *output = arg;
+
+    aes_encrypt( key128, 128, output );
+    return( NULL );
+}
+
+/*
+ * A request finding the queue full is done in software right away
+ */
+static void test_busy( void )
+{
+    mbedtls_accel_engine engine;
+    unsigned char held[16], output[16];
+    pthread_t thread;
+
+    reset();
+    mbedtls_accel_engine_init( &engine, "aes", &aes_ops, &sim_aes, 0 );
+    CHECK( mbedtls_accel_register( &engine ) == 0 );
+
+    sim_aes.hold = 1;
+    CHECK( pthread_create( &thread, NULL, aes_thread, held ) == 0 );
+    pthread_mutex_lock( &sim_aes.mutex );
+    while( !sim_aes.held )
+        pthread_cond_wait( &sim_aes.cond, &sim_aes.mutex );
+    pthread_mutex_unlock( &sim_aes.mutex );
+
+    aes_encrypt( key128, 128, output );
+    CHECK( memcmp( output, cipher128, 16 ) == 0 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).busy == 1 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 0 );
+
+    pthread_mutex_lock( &sim_aes.mutex );
+    sim_aes.hold = 0;
+    pthread_cond_broadcast( &sim_aes.cond );
+    pthread_mutex_unlock( &sim_aes.mutex );
+    pthread_join( thread, NULL );
+
+    CHECK( memcmp( held, cipher128, 16 ) == 0 );
+    CHECK( get_stats( MBEDTLS_ACCEL_AES ).offloaded == 1 );
+    CHECK( sim_aes.calls == 1 );
+
+    mbedtls_accel_unregister( &engine );
+    mbedtls_accel_engine_free( &engine );
+}
+
+#define STATS_THREADS   4
+#define STATS_BLOCKS    2000
+
+static void *sha256_thread( void *arg )
+{
+    uint32_t state[8] = { 0 };
+    unsigned char block[64] = { 0 };
+    int i;
+
+    (void) arg;
+
+    for( i = 0; i < STATS_BLOCKS; i++ )
+        mbedtls_accel_sha256_process( state, block );
+
+    return( NULL );
+}
+
+/*
+ * Statistics read and cleared while other threads update them
+ */
+static void test_stats_threads( void )
+{
+    mbedtls_accel_engine engine;
+    pthread_t threads[STATS_THREADS];
+    mbedtls_accel_stats stats;
+    uint32_t total, last = 0;
+    int i, done = 0;
+
+    reset();
+    mbedtls_accel_engine_init( &engine, "all", &all_ops, &sim_all, STATS_THREADS );
+    CHECK( mbedtls_accel_register( &engine ) == 0 );
+
+    for( i = 0; i < STATS_THREADS; i++ )
+        CHECK( pthread_create( &threads[i], NULL, sha256_thread, NULL ) == 0 );
+
+    /* Every request is counted once, in one of the counters */
+    while( !done )
+    {
+        stats = get_stats( MBEDTLS_ACCEL_SHA256 );
+        total = stats.offloaded + stats.busy;
+        CHECK( total >= last );
+        last = total;
+        done = ( total == STATS_THREADS * STATS_BLOCKS );
+    }
+
+    for( i = 0; i < STATS_THREADS; i++ )
+        pthread_join( threads[i], NULL );
+
+    stats = get_stats( MBEDTLS_ACCEL_SHA256 );
+    CHECK( stats.offloaded + stats.busy == STATS_THREADS * STATS_BLOCKS );
+    CHECK( stats.unsupported == 0 && stats.failed == 0 );
+
+    /* Clearing while running loses nothing counted afterwards */
+    for( i = 0; i < STATS_THREADS; i++ )
+        CHECK( pthread_create( &threads[i], NULL, sha256_thread, NULL ) == 0 );
+    for( i = 0; i < 100; i++ )
+        mbedtls_accel_reset_stats();
+    for( i = 0; i < STATS_THREADS; i++ )
+        pthread_join( threads[i], NULL );
+
+    stats = get_stats( MBEDTLS_ACCEL_SHA256 );
+    CHECK( stats.offloaded + stats.busy <= STATS_THREADS * STATS_BLOCKS );
+
+    mbedtls_accel_unregister( &engine );
+    mbedtls_accel_engine_free( &engine );
+}
+
+int main( void )
+{
+    test_table();
+    test_fallback();
+    test_busy();
+    test_stats_threads();
+
+    if( failures )
+    {
+        printf( "%d checks failed\n", failures );
+        return( 1 );
+    }
+
+    printf( "PASS\n" );
+    return( 0 );
+}
@@ -509,6 +509,96 @@ control_t cfstore_find_test_07_end(const size_t call_count)
 }
 
 
+/// @cond CFSTORE_DOXYGEN_DISABLE
+#define CFSTORE_FIND_TEST_08_NUM_KV         200
+#define CFSTORE_FIND_TEST_08_NUM_MATCH      4
+/// @endcond
+
+/* @brief   helper to enumerate all KVs matching key_name_query, returning the count */
+static int32_t cfstore_find_test_08_count(const char* key_name_query)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    int32_t find_count = 0;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_HANDLE_INIT(next);
+    ARM_CFSTORE_HANDLE_INIT(prev);
+
+    while((ret = drv->Find(key_name_query, prev, next)) == ARM_DRIVER_OK)
+    {
+        find_count++;
+        CFSTORE_HANDLE_SWAP(prev, next);
+    }
+    if(ret != ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND){
+        return ret;
+    }
+    return find_count;
+}
+
+/**
+ * @brief   test case to find a few KVs among hundreds, and report how long it takes
+ *
+ * Creates CFSTORE_FIND_TEST_08_NUM_KV KVs that do not match the queries and
+ * CFSTORE_FIND_TEST_08_NUM_MATCH that do, then times enumerating the matches
+ * with a prefix query, a suffix query and an infix query.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_find_test_08_end(const size_t call_count)
+{
+    const char* queries[] = { "com.arm.mbed.match.*", "*.matchdata", "com.arm.*{match}*", NULL };
+    const char** query = queries;
+    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    const char* value = "v";
+    ARM_CFSTORE_SIZE len = 0;
+    int32_t i = 0;
+    int32_t num_match = 0;
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_KEYDESC kdesc;
+    Timer timer;
+
+    (void) call_count;
+    memset(&kdesc, 0, sizeof(kdesc));
+    kdesc.drl = ARM_RETENTION_WHILE_DEVICE_ACTIVE;
+    for(i = 0; i < CFSTORE_FIND_TEST_08_NUM_KV + CFSTORE_FIND_TEST_08_NUM_MATCH; i++)
+    {
+        if(num_match < CFSTORE_FIND_TEST_08_NUM_MATCH
+                && i == num_match * (CFSTORE_FIND_TEST_08_NUM_KV + CFSTORE_FIND_TEST_08_NUM_MATCH) / CFSTORE_FIND_TEST_08_NUM_MATCH){
+            /* spread exactly CFSTORE_FIND_TEST_08_NUM_MATCH matching KVs through the area */
+            num_match++;
+            snprintf(key_name, sizeof(key_name), "com.arm.mbed.match.{match}%d.matchdata", (int) i);
+        } else {
+            snprintf(key_name, sizeof(key_name), "com.arm.mbed.other.{other}%d.otherdata", (int) i);
+        }
+        len = strlen(value);
+        ret = cfstore_test_create(key_name, value, &len, &kdesc);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    }
+
+    while(*query != NULL)
+    {
+        timer.reset();
+        timer.start();
+        ret = cfstore_find_test_08_count(*query);
+        timer.stop();
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: query %s found %d KVs, expected %d.\n", __func__, *query, (int) ret, (int) CFSTORE_FIND_TEST_08_NUM_MATCH);
+        TEST_ASSERT_MESSAGE(ret == CFSTORE_FIND_TEST_08_NUM_MATCH, cfstore_find_utest_msg_g);
+        CFSTORE_LOG("%s:Found %d of %d KVs with query %s in %d us\n", __func__, (int) ret, (int) (CFSTORE_FIND_TEST_08_NUM_KV + CFSTORE_FIND_TEST_08_NUM_MATCH), *query, (int) timer.read_us());
+        query++;
+    }
+
+    ret = cfstore_test_delete_all();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete all KVs (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed.\n", __func__);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    return CaseNext;
+}
+
+
 /// @cond CFSTORE_DOXYGEN_DISABLE
 utest::v1::status_t greentea_setup(const size_t number_of_cases)
 {
@@ -531,6 +621,8 @@ Case cases[] = {
         Case("FIND_test_06_end", cfstore_find_test_06_end),
         Case("FIND_test_07_start", cfstore_utest_default_start),
         Case("FIND_test_07_end", cfstore_find_test_07_end),
+        Case("FIND_test_08_start", cfstore_utest_default_start),
+        Case("FIND_test_08_end", cfstore_find_test_08_end),
 };
 
 
@@ -72,12 +72,18 @@ static cfstore_kv_data_t cfstore_flush_test_02_kv_data[] = {
         { NULL, NULL},
 };
 
+/* KV created while the flush of test_01 is in progress */
+static cfstore_kv_data_t cfstore_flush_test_01_bg_kv_data[] = {
+        { "com.arm.mbed.configurationstore.test.flush.cfstoreflushtest01bg", "2"},
+        { NULL, NULL},
+};
+
 /* async test version */
 
 typedef struct cfstore_flush_ctx_t
 {
-    int32_t status;
-    ARM_CFSTORE_OPCODE cmd_code;
+    volatile int32_t status;
+    volatile ARM_CFSTORE_OPCODE cmd_code;
 } cfstore_flush_ctx_t;
 /// @endcond
 
@@ -106,6 +112,56 @@ static void cfstore_flush_ctx_init(cfstore_flush_ctx_t* ctx)
 }
 
 
+/* @brief   record the completion notification in the test context before moving to the next case */
+static void cfstore_flush2_callback(int32_t status, ARM_CFSTORE_OPCODE cmd_code, void *client_context, ARM_CFSTORE_HANDLE handle)
+{
+    cfstore_flush_ctx_t* ctx = (cfstore_flush_ctx_t*) client_context;
+
+    CFSTORE_FENTRYLOG("%s:entered: status=%d, cmd_code=%d (%s) handle=%p\n", __func__, (int) status, (int) cmd_code, cfstore_test_opcode_str[cmd_code], handle);
+    ctx->status = status;
+    ctx->cmd_code = cmd_code;
+    Harness::validate_callback();
+}
+
+/* @brief   uninitialize and initialize cfstore again, so the area is read back from flash */
+static void cfstore_flush2_reinitialize(cfstore_flush_ctx_t* ctx)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    const ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed (ret=%d).\r\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
+
+    cfstore_flush_ctx_init(ctx);
+    ret = drv->Initialize(cfstore_flush2_callback, ctx);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to initialize CFSTORE (ret=%d)\r\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
+}
+
+/* @brief   check the flush notification reported success */
+static void cfstore_flush2_check_flushed(cfstore_flush_ctx_t* ctx)
+{
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: flush failed (cmd_code=%d, status=%d).\r\n", __func__, (int) ctx->cmd_code, (int) ctx->status);
+    TEST_ASSERT_MESSAGE(ctx->cmd_code == CFSTORE_OPCODE_FLUSH && ctx->status >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
+}
+
+/* @brief   check whether the KV created during the flush is present */
+static void cfstore_flush2_check_bg_kv(bool expected)
+{
+    bool bfound = false;
+    int32_t ret = ARM_DRIVER_ERROR;
+
+    ret = cfstore_test_kv_is_found(cfstore_flush_test_01_bg_kv_data->key_name, &bfound);
+    if(ret != ARM_DRIVER_OK && ret != ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND){
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: cfstore_test_kv_is_found() call failed (ret=%d).\r\n", __func__, (int) ret);
+        TEST_ASSERT_MESSAGE(false, cfstore_flush_utest_msg_g);
+    }
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: kv %s in flash (expected=%d).\r\n", __func__, bfound ? "found" : "not found", (int) expected);
+    TEST_ASSERT_MESSAGE(bfound == expected, cfstore_flush_utest_msg_g);
+}
+
+
 /* report whether built/configured for flash sync or async mode */
 static control_t cfstore_flush2_test_00(const size_t call_count)
 {
@@ -134,7 +190,7 @@ control_t  cfstore_flush2_test_01_start(const size_t call_count)
     CFSTORE_FENTRYLOG("%s:entered:\r\n", __func__);
     (void) call_count;
     cfstore_flush_ctx_init(ctx);
-    ret = drv->Initialize(cfstore_utest_default_callback, ctx);
+    ret = drv->Initialize(cfstore_flush2_callback, ctx);
     CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to initialize CFSTORE (ret=%d)\r\n", __func__, (int) ret);
     TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
     return CaseTimeout(100000);
@@ -154,6 +210,8 @@ control_t cfstore_flush2_test_01_mid(const size_t call_count)
     int32_t ivalue = 0;
     int32_t ret = ARM_DRIVER_ERROR;
     ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_CAPABILITIES caps = drv->GetCapabilities();
+    cfstore_flush_ctx_t* ctx = cfstore_flush_ctx_get();
     const char* key_name_query = "*";
     char value[CFSTORE_KEY_NAME_MAX_LENGTH+1];
     ARM_CFSTORE_SIZE len = CFSTORE_KEY_NAME_MAX_LENGTH+1;
@@ -213,6 +271,104 @@ control_t cfstore_flush2_test_01_mid(const size_t call_count)
         CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to flush data to cfstore flash (ret=%d).\r\n", __func__, (int) ret);
         TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
     }
+
+    /* the flush persists a snapshot of the area, so KVs can be created while it is in progress */
+    len = strlen(cfstore_flush_test_01_bg_kv_data->value);
+    ret = cfstore_test_create(cfstore_flush_test_01_bg_kv_data->key_name, cfstore_flush_test_01_bg_kv_data->value, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create kv during flush (ret=%d).\r\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
+
+    if(caps.asynchronous_ops){
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: flush completed before the kv was created.\r\n", __func__);
+        TEST_ASSERT_MESSAGE(ctx->cmd_code != CFSTORE_OPCODE_FLUSH, cfstore_flush_utest_msg_g);
+    }
+    return CaseTimeout(100000);
+}
+
+/**
+ * @brief   after the flush completes, read the area back from flash. The KV
+ *          created during the flush was not part of the snapshot.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_flush2_test_01_flushed(const size_t call_count)
+{
+    cfstore_flush_ctx_t* ctx = cfstore_flush_ctx_get();
+
+    CFSTORE_FENTRYLOG("%s:entered:\r\n", __func__);
+    (void) call_count;
+    cfstore_flush2_check_flushed(ctx);
+    cfstore_flush2_reinitialize(ctx);
+    return CaseTimeout(100000);
+}
+
+/**
+ * @brief   check the KV created during the flush is absent, then create it
+ *          again and flush.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_flush2_test_01_absent(const size_t call_count)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_KEYDESC kdesc;
+    const ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+
+    CFSTORE_FENTRYLOG("%s:entered:\r\n", __func__);
+    (void) call_count;
+    memset(&kdesc, 0, sizeof(kdesc));
+    cfstore_flush2_check_bg_kv(false);
+
+    len = strlen(cfstore_flush_test_01_bg_kv_data->value);
+    ret = cfstore_test_create(cfstore_flush_test_01_bg_kv_data->key_name, cfstore_flush_test_01_bg_kv_data->value, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create kv (ret=%d).\r\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
+
+    ret = drv->Flush();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to flush data to cfstore flash (ret=%d).\r\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
+    return CaseTimeout(100000);
+}
+
+/**
+ * @brief   read the area back from flash after the second flush.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_flush2_test_01_flushed_again(const size_t call_count)
+{
+    cfstore_flush_ctx_t* ctx = cfstore_flush_ctx_get();
+
+    CFSTORE_FENTRYLOG("%s:entered:\r\n", __func__);
+    (void) call_count;
+    cfstore_flush2_check_flushed(ctx);
+    cfstore_flush2_reinitialize(ctx);
+    return CaseTimeout(100000);
+}
+
+/**
+ * @brief   check the KV is now present, then delete it from flash so the
+ *          test can be run again.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_flush2_test_01_present(const size_t call_count)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    const ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+
+    CFSTORE_FENTRYLOG("%s:entered:\r\n", __func__);
+    (void) call_count;
+    cfstore_flush2_check_bg_kv(true);
+
+    ret = cfstore_test_delete(cfstore_flush_test_01_bg_kv_data->key_name);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete kv (ret=%d).\r\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
+
+    ret = drv->Flush();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:Error: failed to flush data to cfstore flash (ret=%d).\r\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
     return CaseTimeout(100000);
 }
 
@@ -228,6 +384,7 @@ control_t  cfstore_flush2_test_01_end(const size_t call_count)
 
     CFSTORE_FENTRYLOG("%s:entered:\r\n", __func__);
     (void) call_count;
+    cfstore_flush2_check_flushed(cfstore_flush_ctx_get());
     CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed.\n", __func__);
     TEST_ASSERT_MESSAGE(drv->Uninitialize() >= ARM_DRIVER_OK, cfstore_flush_utest_msg_g);
     return CaseNext;
@@ -263,6 +420,10 @@ Case cases[] = {
         Case("CFSTORE_FLUSH2_test_00", cfstore_flush2_test_00),
         Case("CFSTORE_FLUSH2_test_01_start", cfstore_flush2_test_01_start),
         Case("CFSTORE_FLUSH2_test_01_mid", cfstore_flush2_test_01_mid),
+        Case("CFSTORE_FLUSH2_test_01_flushed", cfstore_flush2_test_01_flushed),
+        Case("CFSTORE_FLUSH2_test_01_absent", cfstore_flush2_test_01_absent),
+        Case("CFSTORE_FLUSH2_test_01_flushed_again", cfstore_flush2_test_01_flushed_again),
+        Case("CFSTORE_FLUSH2_test_01_present", cfstore_flush2_test_01_present),
         Case("CFSTORE_FLUSH2_test_01_end", cfstore_flush2_test_01_end),
         Case("CFSTORE_FLUSH2_test_02_start", cfstore_utest_default_start),
         Case("CFSTORE_FLUSH2_test_02_end", cfstore_flush2_test_02),
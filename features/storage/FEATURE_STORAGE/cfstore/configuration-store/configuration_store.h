@@ -552,6 +552,15 @@ typedef struct _ARM_DRIVER_CFSTORE
      * All open key handles must be closed before flushing the CFSTORE to nv
      * backing store.
      *
+     * The flush persists a copy of the configuration taken when Flush() is
+     * called. While the flush is in progress, keys may still be created,
+     * opened, written, closed and deleted; these changes are persisted by the
+     * next flush. Only one flush may be in progress at a time, and
+     * ARM_CFSTORE_DRIVER::(*Uninitialize)() must wait for it to complete. If
+     * the copy cannot be allocated, the flush writes the configuration in
+     * place and these operations return
+     * ARM_CFSTORE_DRIVER_ERROR_OPERATION_PENDING until it completes.
+     *
      * @return
      * See REFERENCE_1 and the ARM_CFSTORE_CALLBACK documentation.
      * ARM_CFSTORE_DRIVER::(*Flush)() asynchronous completion command code
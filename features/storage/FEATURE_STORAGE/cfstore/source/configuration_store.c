@@ -19,7 +19,6 @@
 #include "cfstore_config.h"
 #include "cfstore_debug.h"
 #include "cfstore_list.h"
-#include "cfstore_fnmatch.h"
 #include "configuration_store.h"
 
 #if defined CFSTORE_CONFIG_MBED_OS_VERSION && CFSTORE_CONFIG_MBED_OS_VERSION == 3
@@ -167,6 +166,44 @@ typedef struct cfstore_client_notify_data_t
     ARM_CFSTORE_HANDLE handle;
 } cfstore_client_notify_data_t;
 
+
+/* @brief   key name query prepared for matching against many keys
+ *
+ * Queries only support the '*' wildcard, so a query is literal segments
+ * separated by '*'. The text before the first '*' must be a prefix of the
+ * key, the text after the last '*' a suffix, and the segments between them
+ * are found from left to right. Taking the leftmost occurrence of each
+ * segment is always correct for '*'-only patterns, so matching a key never
+ * backtracks.
+ *
+ * @param   pattern
+ *          the query string
+ *
+ * @param   len
+ *          length of the query string
+ *
+ * @param   prefix_len
+ *          number of literal characters before the first '*'
+ *
+ * @param   suffix_len
+ *          number of literal characters after the last '*'
+ *
+ * @param   min_key_len
+ *          number of non-'*' characters i.e. the shortest key that can match
+ *
+ * @param   wildcard
+ *          true if the query contains a '*'
+ */
+typedef struct cfstore_query_t
+{
+    const char* pattern;
+    uint8_t len;
+    uint8_t prefix_len;
+    uint8_t suffix_len;
+    uint8_t min_key_len;
+    bool wildcard;
+} cfstore_query_t;
+
 /* @brief  test fsm states and events */
 typedef enum cfstore_fsm_state_t {
     cfstore_fsm_state_stopped = 0,
@@ -362,6 +399,30 @@ static int32_t cfstore_get_key_name_ex(cfstore_area_hkvt_t *hkvt, char* key_name
  * @param   area_dirty_flag
  *          flag indicating that the area has been written and therefore is
  *          dirty with respect to the data persisted to flash.
+ *          - clients set this while a flush may be completing in intr
+ *            context, so it is not a bit field sharing a word with the
+ *            flags set by the fsm.
+ *
+ * @param   flush_commit_flag
+ *          flag indicating that the flush in progress has logged data to
+ *          the flash journal, which must now be committed. area_dirty_flag
+ *          is cleared when the data is logged so that changes made while
+ *          the flush is in progress are persisted by the next flush.
+ *
+ * @param   flush_snapshot_flag
+ *          flag indicating that the flush in progress is logging a private
+ *          copy of area_0 (flush_snapshot) rather than area_0 itself. While
+ *          set, clients may continue to change area_0.
+ *
+ * @param   flush_snapshot
+ *          buffer holding the copy of area_0 taken when the flush started,
+ *          padded to a multiple of program_unit, which is logged to the flash
+ *          journal. The flush completes in interrupt context where the buffer
+ *          cannot be freed, so it is kept for the next flush and freed when
+ *          the flash journal is de-initialised.
+ *
+ * @param   flush_snapshot_len
+ *          size of the flush_snapshot buffer.
  *
  * @expected_blob_size  expected_blob_size = area_0_tail - area_0_head + pad
  *          In the case of reading from flash into sram, this will be be size
@@ -390,9 +451,11 @@ typedef struct cfstore_ctx_t
     cfstore_client_notify_data_t client_notify_data;
 
     /* flags */
+    volatile bool area_dirty_flag;
     uint32_t client_callback_notify_flag : 1;
-    uint32_t area_dirty_flag : 1;
-    uint32_t f_reserved0 : 30;
+    uint32_t flush_commit_flag : 1;
+    uint32_t flush_snapshot_flag : 1;
+    uint32_t f_reserved0 : 29;
 
 #ifdef CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
     /* flash journal related data */
@@ -400,6 +463,8 @@ typedef struct cfstore_ctx_t
     FlashJournal_Info_t info;
     FlashJournal_OpCode_t cmd_code;
     uint64_t expected_blob_size;
+    uint8_t* flush_snapshot;
+    size_t flush_snapshot_len;
 #endif /* CFSTORE_CONFIG_BACKEND_FLASH_ENABLED */
 } cfstore_ctx_t;
 
@@ -1832,6 +1897,53 @@ static int32_t cfstore_fsm_read_on_exit(void* context)
 
 /* int32_t cfstore_fsm_log_on_entry(void* context){ (void) context;} */
 
+/* @brief   take a private copy of area_0 for the flush to log, so clients can carry on
+ *          changing area_0 while the flash journal is writing.
+ *
+ * If the copy cannot be allocated then area_0 is logged in place, and clients
+ * have to wait for the flush to complete as before.
+ */
+static void cfstore_flash_snapshot_take(cfstore_ctx_t* ctx)
+{
+    ARM_CFSTORE_SIZE kv_total_len = cfstore_ctx_get_kv_total_len();
+    uint8_t* ptr = NULL;
+
+#ifndef CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR
+    if(ctx->expected_blob_size > ctx->flush_snapshot_len){
+        ptr = (uint8_t*) realloc(ctx->flush_snapshot, ctx->expected_blob_size);
+        if(ptr == NULL){
+            CFSTORE_TP(CFSTORE_TP_FLUSH, "%s:unable to allocate snapshot (size=%d), logging area_0 in place\n", __func__, (int) ctx->expected_blob_size);
+            return;
+        }
+        ctx->flush_snapshot = ptr;
+        ctx->flush_snapshot_len = ctx->expected_blob_size;
+    }
+    if(ctx->expected_blob_size > 0){
+        memcpy(ctx->flush_snapshot, ctx->area_0_head, kv_total_len);
+        memset(ctx->flush_snapshot + kv_total_len, 0, ctx->expected_blob_size - kv_total_len);
+    }
+    ctx->flush_snapshot_flag = true;
+#else
+    /* area_0 lives in the client provided slab, which has no room for a copy */
+    (void) kv_total_len;
+    (void) ptr;
+#endif /* CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR */
+}
+
+/* @brief   finish with the flush snapshot when the flush completes or fails.
+ *
+ * On failure the logged data has not been persisted, so the area is marked
+ * dirty again for the next flush. May be called in interrupt context.
+ */
+static void cfstore_flash_snapshot_release(cfstore_ctx_t* ctx, int32_t status)
+{
+    if(ctx->flush_commit_flag && status < ARM_DRIVER_OK){
+        ctx->area_dirty_flag = true;
+    }
+    ctx->flush_commit_flag = false;
+    ctx->flush_snapshot_flag = false;
+}
+
 /* @brief   on entry to writing state, update value */
 int32_t cfstore_fsm_log_on_entry(void* context)
 {
@@ -1858,12 +1970,19 @@ int32_t cfstore_fsm_log_on_entry(void* context)
     /* log the changes to flash even when the area has shrunk to 0, as its necessary to erase the flash */
     if(ctx->area_dirty_flag == true)
     {
+        /* log a copy of the area, so changes made from now on are picked up by the next flush */
+        cfstore_flash_snapshot_take(ctx);
+        ctx->area_dirty_flag = false;
+        ctx->flush_commit_flag = true;
         if(ctx->expected_blob_size > 0){
-            CFSTORE_TP(CFSTORE_TP_FLUSH, "%s:logging: ctx->area_0_head=%p, ctx->expected_blob_size-%d\n", __func__, ctx->area_0_head, (int) ctx->expected_blob_size);
-            ret = FlashJournal_log(&ctx->jrnl, (const void*) ctx->area_0_head, ctx->expected_blob_size);
+            const uint8_t* blob = ctx->flush_snapshot_flag ? ctx->flush_snapshot : ctx->area_0_head;
+
+            CFSTORE_TP(CFSTORE_TP_FLUSH, "%s:logging: blob=%p, ctx->area_0_head=%p, ctx->expected_blob_size-%d\n", __func__, blob, ctx->area_0_head, (int) ctx->expected_blob_size);
+            ret = FlashJournal_log(&ctx->jrnl, (const void*) blob, ctx->expected_blob_size);
             if(ret < JOURNAL_STATUS_OK){
                 CFSTORE_ERRLOG("%s:Error: FlashJournal_commit() failed (ret=%d)\n", __func__, (int) ret);
-                ret = cfstore_flash_map_error(status);
+                ret = cfstore_flash_map_error(ret);
+                cfstore_flash_snapshot_release(ctx, ret);
                 /* move to ready state. cfstore client is expected to Uninitialize() before further calls */
                 cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_ready, ctx);
                 goto out0;
@@ -1903,6 +2022,7 @@ static int32_t cfstore_fsm_logging(void* context)
     /* check the correct amount of data was written */
     if(ctx->status < JOURNAL_STATUS_OK){
         CFSTORE_ERRLOG("%s:Error: FlashJournal_log() failed (ret=%d)\n", __func__, (int) ctx->status);
+        cfstore_flash_snapshot_release(ctx, ctx->status);
         /* move to ready state. cfstore client is expected to Uninitialize() before further calls */
         cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_ready, ctx);
         ctx->status = cfstore_flash_map_error(ctx->status);
@@ -1915,6 +2035,9 @@ static int32_t cfstore_fsm_logging(void* context)
         } else {
             CFSTORE_ERRLOG("%s:Error: FlashJournal_log() failed to log the expected number of bytes (ctx->expected_blob_size=%d, committed=%d)\n", __func__, (int) ctx->expected_blob_size, (int) ctx->status);
             ctx->status = ARM_DRIVER_ERROR;
+            cfstore_flash_snapshot_release(ctx, ctx->status);
+            /* move to ready state. cfstore client is expected to Uninitialize() before further calls */
+            cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_ready, ctx);
         }
     }
     return ctx->status;
@@ -1941,12 +2064,14 @@ static int32_t cfstore_fsm_commit_on_entry(void* context)
     cfstore_ctx_t* ctx = (cfstore_ctx_t*) context;
 
     CFSTORE_FENTRYLOG("%s:entered:\n", __func__);
-    if(ctx->area_dirty_flag == true)
+    if(ctx->flush_commit_flag == true)
     {
 		ret = FlashJournal_commit(&ctx->jrnl);
 		CFSTORE_TP(CFSTORE_TP_FSM, "%s:debug: FlashJournal_commit() (ret=%d)\n", __func__, (int) ret);
 		if(ret < JOURNAL_STATUS_OK){
 			CFSTORE_ERRLOG("%s:Error: FlashJournal_commit() failed (ret=%d)\n", __func__, (int) ret);
+			/* on exit from committing the failure marks the area dirty and is reported to the client */
+			ctx->status = ret;
 			/* move to ready state. cfstore client is expected to Uninitialize() before further calls */
 			cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_ready, ctx);
 		} else if(ret > 0){
@@ -2007,7 +2132,7 @@ static int32_t cfstore_fsm_commit_on_exit(void* context)
     cfstore_ctx_t* ctx = (cfstore_ctx_t*) context;
 
     CFSTORE_FENTRYLOG("%s:entered:\n", __func__);
-    ctx->area_dirty_flag = false;
+    cfstore_flash_snapshot_release(ctx, ctx->status);
     /* notify client of commit status */
     cfstore_client_notify_data_init(&ctx->client_notify_data, CFSTORE_OPCODE_FLUSH, ctx->status, NULL);
     ctx->client_callback_notify_flag = true;
@@ -2220,6 +2345,24 @@ static bool cfstore_flash_journal_is_async_op_pending(cfstore_ctx_t* ctx)
     return false;
 }
 
+/* @brief   check whether clients are prevented from changing area_0.
+ *
+ * A flush working from a snapshot doesnt touch area_0 itself, so only other
+ * flash journal operations (and a flush logging area_0 in place) block it.
+ */
+static bool cfstore_flash_journal_is_area_busy(cfstore_ctx_t* ctx)
+{
+    cfstore_fsm_state_t state = cfstore_fsm_state_get(&ctx->fsm);
+
+    if(state == cfstore_fsm_state_ready){
+        return false;
+    }
+    if((state == cfstore_fsm_state_logging || state == cfstore_fsm_state_committing) && ctx->flush_snapshot_flag){
+        return false;
+    }
+    return true;
+}
+
 static int32_t cfstore_flash_init(void)
 {
     int32_t ret = ARM_DRIVER_ERROR;
@@ -2228,6 +2371,10 @@ static int32_t cfstore_flash_init(void)
     CFSTORE_FENTRYLOG("%s:entered: \n", __func__);
     ctx->cmd_code = (FlashJournal_OpCode_t)((int) FLASH_JOURNAL_OPCODE_RESET+1);
     ctx->expected_blob_size = 0;
+    ctx->flush_snapshot = NULL;
+    ctx->flush_snapshot_len = 0;
+    ctx->flush_commit_flag = false;
+    ctx->flush_snapshot_flag = false;
     ctx->fsm.event = cfstore_fsm_event_max;
     ctx->fsm.state = cfstore_fsm_state_stopped;
     memset(&ctx->info, 0, sizeof(ctx->info));
@@ -2251,6 +2398,9 @@ static int32_t cfstore_flash_deinit(void)
     if(ret < 0){
         CFSTORE_TP(CFSTORE_TP_INIT, "%s:Error: cfstore_fsm_state_set() failed\n", __func__);
     }
+    free(ctx->flush_snapshot);
+    ctx->flush_snapshot = NULL;
+    ctx->flush_snapshot_len = 0;
     return ret;
 }
 
@@ -2291,6 +2441,7 @@ static int32_t cfstore_flash_flush(cfstore_ctx_t* ctx)
 #else /* CFSTORE_CONFIG_BACKEND_FLASH_ENABLED */
 
 static bool cfstore_flash_journal_is_async_op_pending(cfstore_ctx_t* ctx) { CFSTORE_FENTRYLOG("%s:SRAM:entered:\n", __func__); (void) ctx; return false; }
+static bool cfstore_flash_journal_is_area_busy(cfstore_ctx_t* ctx) { (void) ctx; return false; }
 
 /* @brief   generate the CFSTORE_OPCODE_INITIALIZE callback notification */
 static int32_t cfstore_flash_init(void)
@@ -3076,9 +3227,9 @@ static int32_t cfstore_delete(ARM_CFSTORE_HANDLE hkey)
         ret = ARM_CFSTORE_DRIVER_ERROR_UNINITIALISED;
         goto out0;
     }
-    /* deleting a key will change the sram area while a logging/flushing operation is pending, which
-     * should not happen while an async operation is outstanding */
-    if(cfstore_flash_journal_is_async_op_pending(ctx)) {
+    /* deleting a key will change the sram area, which should not happen while an async operation
+     * is using it (a flush logging a snapshot of the area doesnt) */
+    if(cfstore_flash_journal_is_area_busy(ctx)) {
         CFSTORE_TP(CFSTORE_TP_DELETE, "%s:Debug: flash journal operation pending (awaiting asynchronous notification).\n", __func__);
         ret = ARM_CFSTORE_DRIVER_ERROR_OPERATION_PENDING;
         goto out0;
@@ -3115,6 +3266,74 @@ out0:
 }
 
 
+/* @brief  prepare a validated key name query for cfstore_query_match() */
+static void cfstore_query_compile(cfstore_query_t* query, const char* key_name_query)
+{
+    const char* first = strchr(key_name_query, '*');
+    const char* last = strrchr(key_name_query, '*');
+    uint8_t i = 0;
+
+    query->pattern = key_name_query;
+    query->len = (uint8_t) strlen(key_name_query);
+    query->wildcard = first != NULL;
+    query->prefix_len = first ? (uint8_t) (first - key_name_query) : query->len;
+    query->suffix_len = last ? (uint8_t) (query->len - (last - key_name_query) - 1) : 0;
+    query->min_key_len = 0;
+    for(i = 0; i < query->len; i++){
+        if(key_name_query[i] != '*'){
+            query->min_key_len++;
+        }
+    }
+}
+
+
+/* @brief  test whether key (key_len chars, not null terminated) matches the query */
+static bool cfstore_query_match(const cfstore_query_t* query, const char* key, uint8_t key_len)
+{
+    const char* p = NULL;
+    const char* pend = NULL;
+    const char* k = NULL;
+    const char* kend = NULL;
+    uint8_t seg_len = 0;
+
+    if(!query->wildcard){
+        return key_len == query->len && memcmp(key, query->pattern, key_len) == 0;
+    }
+    /* cheapest rejections first: length, then the literal prefix and suffix */
+    if(key_len < query->min_key_len){
+        return false;
+    }
+    if(memcmp(key, query->pattern, query->prefix_len) != 0){
+        return false;
+    }
+    if(memcmp(key + key_len - query->suffix_len, query->pattern + query->len - query->suffix_len, query->suffix_len) != 0){
+        return false;
+    }
+    /* segments between the first and last '*' must occur in order in the rest of the key */
+    p = query->pattern + query->prefix_len + 1;
+    pend = query->pattern + query->len - query->suffix_len - 1;
+    k = key + query->prefix_len;
+    kend = key + key_len - query->suffix_len;
+    while(p < pend){
+        if(*p == '*'){
+            p++;
+            continue;
+        }
+        for(seg_len = 0; p + seg_len < pend && p[seg_len] != '*'; seg_len++)
+            ;
+        while(k + seg_len <= kend && memcmp(k, p, seg_len) != 0){
+            k++;
+        }
+        if(k + seg_len > kend){
+            return false;
+        }
+        k += seg_len;
+        p += seg_len;
+    }
+    return true;
+}
+
+
 /** @brief  Internal find function using hkvt's.
  *
  * @note
@@ -3132,8 +3351,7 @@ out0:
 static int32_t cfstore_find_ex(const char* key_name_query, cfstore_area_hkvt_t *prev, cfstore_area_hkvt_t *next)
 {
     int32_t ret = ARM_DRIVER_ERROR;
-    uint8_t next_key_len;
-    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    cfstore_query_t query;
     cfstore_ctx_t* ctx = cfstore_ctx_get();
 
     CFSTORE_TP((CFSTORE_TP_FIND|CFSTORE_TP_FENTRY), "%s:entered: key_name_query=\"%s\", prev=%p, next=%p\n", __func__, key_name_query, prev, next);
@@ -3169,6 +3387,8 @@ static int32_t cfstore_find_ex(const char* key_name_query, cfstore_area_hkvt_t *
         CFSTORE_TP(CFSTORE_TP_FIND, "%s:No more entries found\n", __func__);
         return ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND;
     }
+    /* prepare the query once rather than parsing it again for every KV */
+    cfstore_query_compile(&query, key_name_query);
     /* CFSTORE_TP(CFSTORE_TP_FIND, "%s:cfstore_ctx_g.area_0_head=%p, cfstore_ctx_g.area_0_tail=%p\n", __func__, cfstore_ctx_g.area_0_head, cfstore_ctx_g.area_0_tail);*/
     cfstore_hkvt_dump(next, __func__);
     while(cfstore_hkvt_is_valid(next, ctx->area_0_tail))
@@ -3194,21 +3414,14 @@ static int32_t cfstore_find_ex(const char* key_name_query, cfstore_area_hkvt_t *
             }
             continue;
         }
-        /* check if this key_name matches the query */
-        next_key_len = cfstore_hkvt_get_key_len(next);
-        next_key_len++;
-        cfstore_get_key_name_ex(next, key_name, &next_key_len);
-        ret = cfstore_fnmatch(key_name_query, key_name, 0);
-        if(ret == 0){
+        /* check if this key_name matches the query, in place in the area */
+        if(cfstore_query_match(&query, (const char*) next->key, cfstore_hkvt_get_key_len(next))){
             /* found the entry in the store. return handle */
-            CFSTORE_TP(CFSTORE_TP_FIND, "%s:Found matching key (key_name_query = \"%s\", next->key = \"%s\"),next_key_len=%d\n", __func__, key_name_query, key_name, (int) next_key_len);
+            CFSTORE_TP(CFSTORE_TP_FIND, "%s:Found matching key (key_name_query = \"%s\", next_key_len=%d)\n", __func__, key_name_query, (int) cfstore_hkvt_get_key_len(next));
             cfstore_hkvt_dump(next, __func__);
             return ARM_DRIVER_OK;
-        } else if(ret != CFSTORE_FNM_NOMATCH){
-            CFSTORE_ERRLOG("%s:Error: cfstore_fnmatch() error (ret=%d).\n", __func__, (int) ret);
-            return ARM_DRIVER_ERROR;
         }
-        /* CFSTORE_FNM_NOMATCH => get the next hkvt if any */
+        /* no match => get the next hkvt if any */
         ret = cfstore_get_next_hkvt(next, next);
         if(ret == ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND) {
             CFSTORE_TP(CFSTORE_TP_FIND, "%s:No more KVs found\n", __func__);
@@ -3438,8 +3651,8 @@ static int32_t cfstore_create(const char* key_name, ARM_CFSTORE_SIZE value_len,
         CFSTORE_ERRLOG("%s:Error: CFSTORE is not initialised.\n", __func__);
         return ARM_CFSTORE_DRIVER_ERROR_UNINITIALISED;
     }
-    /* creating a key cannot happen while a flashJournal_log() is pending as it would change the sram area being logged*/
-    if(cfstore_flash_journal_is_async_op_pending(ctx)) {
+    /* creating a key cannot happen while a flashJournal_log() of the sram area itself is pending as it would change the sram area being logged*/
+    if(cfstore_flash_journal_is_area_busy(ctx)) {
         CFSTORE_TP(CFSTORE_TP_CREATE, "%s:Debug: flash journal operation pending (awaiting asynchronous notification).\n", __func__);
         return ARM_CFSTORE_DRIVER_ERROR_OPERATION_PENDING;
     }
@@ -3587,8 +3800,8 @@ static int32_t cfstore_open(const char* key_name, ARM_CFSTORE_FMODE flags, ARM_C
     }
     if(flags.write){
         /* opening a pre-existing key for writing can result in the sram area being changed, which
-         * cannot happen while a flashJournal_xxx() async completion notification is outstanding */
-        if(cfstore_flash_journal_is_async_op_pending(ctx)) {
+         * cannot happen while a flashJournal_xxx() async operation using the sram area is outstanding */
+        if(cfstore_flash_journal_is_area_busy(ctx)) {
             CFSTORE_TP(CFSTORE_TP_OPEN, "%s:Debug: flash journal operation pending (awaiting asynchronous notification).\n", __func__);
             ret = ARM_CFSTORE_DRIVER_ERROR_OPERATION_PENDING;
             goto out1;
@@ -3669,8 +3882,8 @@ static int32_t cfstore_close(ARM_CFSTORE_HANDLE hkey)
         goto out0;
     }
     /* closing a key can lead to its deletion, which cannot happening while there are pending
-     * async operations outstanding */
-    if(cfstore_flash_journal_is_async_op_pending(ctx)) {
+     * async operations using the sram area outstanding */
+    if(cfstore_flash_journal_is_area_busy(ctx)) {
         CFSTORE_TP(CFSTORE_TP_CLOSE, "%s:Debug: flash journal operation pending (awaiting asynchronous notification).\n", __func__);
         ret = ARM_CFSTORE_DRIVER_ERROR_OPERATION_PENDING;
         goto out0;
@@ -3784,8 +3997,8 @@ static int32_t cfstore_write(ARM_CFSTORE_HANDLE hkey, const char* data, ARM_CFST
         ret = ARM_CFSTORE_DRIVER_ERROR_UNINITIALISED;
         goto out0;
     }
-    /* writing a key cannot happen while a flashJournal_xxx() async operation is pending */
-    if(cfstore_flash_journal_is_async_op_pending(ctx)) {
+    /* writing a key cannot happen while a flashJournal_xxx() async operation using the sram area is pending */
+    if(cfstore_flash_journal_is_area_busy(ctx)) {
         CFSTORE_TP(CFSTORE_TP_WRITE, "%s:Debug: flash journal operation pending (awaiting asynchronous notification).\n", __func__);
         ret = ARM_CFSTORE_DRIVER_ERROR_OPERATION_PENDING;
         goto out0;
@@ -56,6 +56,10 @@ USBAudio::USBAudio(uint32_t frequency_in, uint8_t channel_nb_in, uint32_t freque
 
     volume = 0;
 
+    ringStart(&rx_ring, NULL, 0, PACKET_SIZE_ISO_IN);
+    ringStart(&tx_ring, NULL, 0, PACKET_SIZE_ISO_OUT);
+    rx_frame_packet = false;
+
     // connect the device
     USBDevice::connect();
 }
@@ -125,15 +129,167 @@ uint32_t USBAudio::readSync(uint8_t *buf)
     return size;
 }
 
+void USBAudio::ringStart(PacketRing *ring, uint8_t *buf, uint32_t nb_packets, uint32_t packet_size) {
+    ring->active = false;
+    ring->buf = buf;
+    ring->nb_packets = nb_packets;
+    ring->packet_size = packet_size;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->packets = 0;
+    ring->overruns = 0;
+    ring->underruns = 0;
+    // start from the half full target, so drift only reflects the stream
+    ring->level_avg = nb_packets ? (int32_t)(nb_packets - 1) << 7 : 0;
+}
+
+uint32_t USBAudio::ringLevel(PacketRing *ring) {
+    uint32_t head = ring->head;
+    uint32_t tail = ring->tail;
+    return (head + ring->nb_packets - tail) % ring->nb_packets;
+}
+
+void USBAudio::ringStats(PacketRing *ring, StreamStats *stats) {
+    core_util_critical_section_enter();
+    stats->packets = ring->packets;
+    stats->overruns = ring->overruns;
+    stats->underruns = ring->underruns;
+    if (ring->nb_packets) {
+        stats->level = ringLevel(ring);
+        stats->drift = ring->level_avg - ((int32_t)(ring->nb_packets - 1) << 7);
+    } else {
+        stats->level = 0;
+        stats->drift = 0;
+    }
+    core_util_critical_section_exit();
+}
+
+bool USBAudio::readStreamStart(uint8_t *ring, uint32_t nb_packets) {
+    if (ring == NULL || nb_packets < 2 || nb_packets > USBAUDIO_STREAM_MAX_PACKETS) {
+        return false;
+    }
+
+    core_util_critical_section_enter();
+    ringStart(&rx_ring, ring, nb_packets, PACKET_SIZE_ISO_IN);
+    buf_stream_in = NULL;
+    rx_frame_packet = false;
+    rx_ring.active = true;
+    core_util_critical_section_exit();
+    return true;
+}
+
+void USBAudio::readStreamStop() {
+    rx_ring.active = false;
+}
+
+uint8_t *USBAudio::readStreamGet(uint32_t *size) {
+    uint32_t tail = rx_ring.tail;
+
+    if (!rx_ring.active || tail == rx_ring.head) {
+        return NULL;
+    }
+    if (size != NULL) {
+        *size = rx_ring.size[tail];
+    }
+    return rx_ring.buf + tail * rx_ring.packet_size;
+}
+
+void USBAudio::readStreamRelease() {
+    uint32_t tail = rx_ring.tail;
+
+    if (tail != rx_ring.head) {
+        rx_ring.tail = (tail + 1) % rx_ring.nb_packets;
+    }
+}
+
+bool USBAudio::writeStreamStart(uint8_t *ring, uint32_t nb_packets) {
+    if (ring == NULL || nb_packets < 2 || nb_packets > USBAUDIO_STREAM_MAX_PACKETS) {
+        return false;
+    }
+
+    core_util_critical_section_enter();
+    ringStart(&tx_ring, ring, nb_packets, PACKET_SIZE_ISO_OUT);
+    buf_stream_out = NULL;
+    tx_ring.active = true;
+    core_util_critical_section_exit();
+    return true;
+}
+
+void USBAudio::writeStreamStop() {
+    tx_ring.active = false;
+}
+
+uint8_t *USBAudio::writeStreamGet() {
+    uint32_t head = tx_ring.head;
+
+    if (!tx_ring.active || (head + 1) % tx_ring.nb_packets == tx_ring.tail) {
+        return NULL;
+    }
+    return tx_ring.buf + head * tx_ring.packet_size;
+}
+
+void USBAudio::writeStreamCommit(uint32_t size) {
+    uint32_t head = tx_ring.head;
+    uint32_t next;
+
+    if (!tx_ring.active) {
+        return;
+    }
+    next = (head + 1) % tx_ring.nb_packets;
+    if (next == tx_ring.tail) {
+        return;
+    }
+    if (size == 0 || size > tx_ring.packet_size) {
+        size = tx_ring.packet_size;
+    }
+    tx_ring.size[head] = size;
+    tx_ring.head = next;
+}
+
+void USBAudio::readStreamStats(StreamStats *stats) {
+    ringStats(&rx_ring, stats);
+}
+
+void USBAudio::writeStreamStats(StreamStats *stats) {
+    ringStats(&tx_ring, stats);
+}
+
 float USBAudio::getVolume() {
     return (mute) ? 0.0 : volume;
 }
 
 
+// Called in ISR context
+void USBAudio::rxStreamPacket(uint32_t size) {
+    uint32_t head = rx_ring.head;
+    uint32_t next = (head + 1) % rx_ring.nb_packets;
+
+    if (size == 0) {
+        return;
+    }
+    rx_frame_packet = true;
+    rx_ring.packets++;
+    if (next == rx_ring.tail) {
+        // ring full: the slot is reused by the next packet
+        rx_ring.overruns++;
+        return;
+    }
+    rx_ring.size[head] = size;
+    rx_ring.head = next;
+    if (rxDone)
+        rxDone.call();
+}
+
+
 bool USBAudio::EPISO_OUT_callback() {
     uint32_t size = 0;
     interruptOUT = true;
-    if (buf_stream_in != NULL) {
+    if (rx_ring.active) {
+        // receive directly in the free slot of the ring
+        readEP(EPISO_OUT, rx_ring.buf + rx_ring.head * rx_ring.packet_size, &size, PACKET_SIZE_ISO_IN);
+        rxStreamPacket(size);
+    }
+    else if (buf_stream_in != NULL) {
         readEP(EPISO_OUT, (uint8_t *)buf_stream_in, &size, PACKET_SIZE_ISO_IN);
         available = true;
         buf_stream_in = NULL;
@@ -150,7 +306,8 @@ bool USBAudio::EPISO_OUT_callback() {
 bool USBAudio::EPISO_IN_callback() {
     interruptIN = true;
     writeIN = true;
-    if (txDone) 
+    // when streaming, txDone is called once the ring slot has been freed
+    if (txDone && !tx_ring.active)
         txDone.call();
     return true;
 }
@@ -161,7 +318,24 @@ bool USBAudio::EPISO_IN_callback() {
 void USBAudio::SOF(int frameNumber) {
     uint32_t size = 0;
 
-    if (!interruptOUT) {
+    if (rx_ring.active) {
+        if (!interruptOUT) {
+            // read the isochronous endpoint in the free slot of the ring
+            if (USBDevice::readEP_NB(EPISO_OUT, rx_ring.buf + rx_ring.head * rx_ring.packet_size, &size, PACKET_SIZE_ISO_IN)) {
+                if (size) {
+                    rxStreamPacket(size);
+                    readStart(EPISO_OUT, PACKET_SIZE_ISO_IN);
+                }
+            }
+        }
+
+        // the host sends one packet per frame once the stream has started
+        if (!rx_frame_packet && rx_ring.packets) {
+            rx_ring.underruns++;
+        }
+        rx_frame_packet = false;
+        rx_ring.level_avg += (((int32_t)ringLevel(&rx_ring) << 8) - rx_ring.level_avg) >> 4;
+    } else if (!interruptOUT) {
         // read the isochronous endpoint
         if (buf_stream_in != NULL) {
             if (USBDevice::readEP_NB(EPISO_OUT, (uint8_t *)buf_stream_in, &size, PACKET_SIZE_ISO_IN)) {
@@ -174,7 +348,20 @@ void USBAudio::SOF(int frameNumber) {
         }
     }
 
-    if (!interruptIN) {
+    if (tx_ring.active) {
+        // send the oldest queued packet, one per frame
+        uint32_t tail = tx_ring.tail;
+        if (tail != tx_ring.head) {
+            USBDevice::writeNB(EPISO_IN, tx_ring.buf + tail * tx_ring.packet_size, tx_ring.size[tail], PACKET_SIZE_ISO_OUT);
+            tx_ring.tail = (tail + 1) % tx_ring.nb_packets;
+            tx_ring.packets++;
+            if (txDone)
+                txDone.call();
+        } else {
+            tx_ring.underruns++;
+        }
+        tx_ring.level_avg += (((int32_t)ringLevel(&tx_ring) << 8) - tx_ring.level_avg) >> 4;
+    } else if (!interruptIN) {
         // write if needed
         if (buf_stream_out != NULL) {
             USBDevice::writeNB(EPISO_IN, (uint8_t *)buf_stream_out, PACKET_SIZE_ISO_OUT, PACKET_SIZE_ISO_OUT);
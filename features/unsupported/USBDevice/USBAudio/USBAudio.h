@@ -27,6 +27,11 @@
 #include "USBDevice.h"
 #include "Callback.h"
 
+// Maximum number of packets in a streaming ring
+#ifndef USBAUDIO_STREAM_MAX_PACKETS
+#define USBAUDIO_STREAM_MAX_PACKETS 16
+#endif
+
 /**
 * USBAudio example
 *
@@ -65,10 +70,59 @@
 *    }
 * }
 * @endcode
+*
+* Streaming example: the ISR moves packets between the USB endpoint and a ring
+* of buffers, the application only wakes up when a packet is ready.
+*
+* @code
+* #include "mbed.h"
+* #include "USBAudio.h"
+*
+* #define AUDIO_LENGTH_PACKET 48 * 2 * 1
+* #define NB_PACKETS 8
+*
+* USBAudio audio(48000, 1);
+* Semaphore rx_sem(0);
+* uint8_t ring[NB_PACKETS * AUDIO_LENGTH_PACKET];
+*
+* void rx_done() {
+*     rx_sem.release();
+* }
+*
+* int main() {
+*     audio.attachRx(rx_done);
+*     audio.readStreamStart(ring, NB_PACKETS);
+*
+*     while (1) {
+*         rx_sem.wait();
+*         uint32_t size;
+*         uint8_t *packet;
+*         while ((packet = audio.readStreamGet(&size)) != NULL) {
+*             // play the packet
+*             audio.readStreamRelease();
+*         }
+*     }
+* }
+* @endcode
 */
 class USBAudio: public USBDevice {
 public:
 
+    /** Streaming statistics */
+    struct StreamStats {
+        // packets moved by the ISR
+        uint32_t packets;
+        // received packets dropped because the ring was full
+        uint32_t overruns;
+        // frames without a packet: none received, or none ready to send
+        uint32_t underruns;
+        // packets queued in the ring
+        uint32_t level;
+        // smoothed fill level minus half the ring capacity, in 1/256 packet.
+        // Growing values mean the producer runs faster than the consumer.
+        int32_t drift;
+    };
+
     /**
     * Constructor
     *
@@ -138,6 +192,80 @@ public:
     */
     bool readWrite(uint8_t * buf_read, uint8_t * buf_write);
 
+    /**
+    * Stream received audio into a ring of packets. Each packet received from the host is
+    * stored by the ISR in the next free slot and the Rx handler is called. When the ring
+    * is full the packet is dropped and counted as an overrun.
+    * read, readNB and readWrite must not be used while streaming.
+    *
+    * @param ring buffer of nb_packets slots of the input packet size (2 * frequency_in / 1000 * channel_nb_in bytes)
+    * @param nb_packets number of slots, between 2 and USBAUDIO_STREAM_MAX_PACKETS. One slot is kept by the ISR.
+    * @returns true if successful
+    */
+    bool readStreamStart(uint8_t *ring, uint32_t nb_packets);
+
+    /**
+    * Stop streaming received audio
+    */
+    void readStreamStop();
+
+    /**
+    * Get the oldest packet received while streaming. The packet stays valid until readStreamRelease is called.
+    *
+    * @param size if not NULL, filled with the packet length
+    * @returns pointer on the packet, or NULL if no packet is available
+    */
+    uint8_t *readStreamGet(uint32_t *size = NULL);
+
+    /**
+    * Give back the packet returned by readStreamGet to the ISR
+    */
+    void readStreamRelease();
+
+    /**
+    * Stream audio to send from a ring of packets. On each start of frame the ISR sends the
+    * oldest queued packet and calls the Tx handler. A frame without a queued packet is
+    * counted as an underrun. write, writeSync and readWrite must not be used while streaming.
+    *
+    * @param ring buffer of nb_packets slots of the output packet size (2 * frequency_out / 1000 * channel_nb_out bytes)
+    * @param nb_packets number of slots, between 2 and USBAUDIO_STREAM_MAX_PACKETS. One slot is kept free.
+    * @returns true if successful
+    */
+    bool writeStreamStart(uint8_t *ring, uint32_t nb_packets);
+
+    /**
+    * Stop streaming audio to send. Queued packets are discarded.
+    */
+    void writeStreamStop();
+
+    /**
+    * Get a free slot to fill with the next packet to send
+    *
+    * @returns pointer on the slot, or NULL if the ring is full
+    */
+    uint8_t *writeStreamGet();
+
+    /**
+    * Queue the slot returned by writeStreamGet for sending
+    *
+    * @param size packet length, at most the output packet size (default: output packet size)
+    */
+    void writeStreamCommit(uint32_t size = 0);
+
+    /**
+    * Get the statistics of the receive stream
+    *
+    * @param stats filled with the statistics
+    */
+    void readStreamStats(StreamStats *stats);
+
+    /**
+    * Get the statistics of the send stream
+    *
+    * @param stats filled with the statistics
+    */
+    void writeStreamStats(StreamStats *stats);
+
 
     /** attach a handler to update the volume
      *
@@ -263,6 +391,39 @@ protected:
 
 private:
 
+    // ring of packets shared between the application and the ISR.
+    // The producer only moves head, the consumer only moves tail.
+    struct PacketRing {
+        uint8_t *buf;
+        uint32_t nb_packets;
+        uint32_t packet_size;
+        volatile uint32_t head;
+        volatile uint32_t tail;
+        uint16_t size[USBAUDIO_STREAM_MAX_PACKETS];
+        volatile bool active;
+        volatile uint32_t packets;
+        volatile uint32_t overruns;
+        volatile uint32_t underruns;
+        // fill level average, in 1/256 packet
+        volatile int32_t level_avg;
+    };
+
+    void ringStart(PacketRing *ring, uint8_t *buf, uint32_t nb_packets, uint32_t packet_size);
+    uint32_t ringLevel(PacketRing *ring);
+    void ringStats(PacketRing *ring, StreamStats *stats);
+
+    // Called in ISR context: queue the packet received in the head slot
+    void rxStreamPacket(uint32_t size);
+
+    // received packets
+    PacketRing rx_ring;
+
+    // packets to send
+    PacketRing tx_ring;
+
+    // a packet has been received during the current frame
+    volatile bool rx_frame_packet;
+
     // stream available ?
     volatile bool available;
 
@@ -320,6 +320,10 @@ bool USBDevice::requestSetConfiguration(void)
 {
 
     device.configuration = transfer.setup.wValue;
+
+    /* Endpoints are reconfigured, running transfers are lost */
+    transferAbortAll();
+
     /* Set the device configuration */
     if (device.configuration == 0)
     {
@@ -678,6 +682,8 @@ void USBDevice::busReset(void)
     device.configuration = 0;
     device.suspended = false;
 
+    transferAbortAll();
+
     /* Call class / vendor specific busReset function */
     USBCallback_busReset();
 }
@@ -826,6 +832,8 @@ USBDevice::USBDevice(uint16_t vendor_id, uint16_t product_id, uint16_t product_r
     device.state = POWERED;
     device.configuration = 0;
     device.suspended = false;
+
+    transferAbortAll();
 };
 
 
@@ -894,6 +902,150 @@ bool USBDevice::writeNB(uint8_t endpoint, uint8_t * buffer, uint32_t size, uint3
 
 
 
+USBDevice::EP_TRANSFER * USBDevice::findEPTransfer(uint8_t endpoint)
+{
+    switch (endpoint) {
+        case EPINT_OUT:
+            return &epTransfer[0];
+        case EPINT_IN:
+            return &epTransfer[1];
+        case EPBULK_OUT:
+            return &epTransfer[2];
+        case EPBULK_IN:
+            return &epTransfer[3];
+        default:
+            return NULL;
+    }
+}
+
+
+bool USBDevice::transferStart(uint8_t endpoint, uint8_t * buffer, uint32_t size, uint32_t maxPacket,
+                              Callback<void(uint32_t)> done, bool zlp)
+{
+    EP_TRANSFER *t = findEPTransfer(endpoint);
+    bool in = (endpoint & 1) != 0;
+
+    if (t == NULL || maxPacket == 0 || (buffer == NULL && size > 0)) {
+        return false;
+    }
+
+    /* OUT packets are read in place, a full packet must always fit */
+    if (!in && (size == 0 || (size % maxPacket) != 0)) {
+        return false;
+    }
+
+    if (!configured()) {
+        return false;
+    }
+
+    core_util_critical_section_enter();
+
+    if (t->active) {
+        core_util_critical_section_exit();
+        return false;
+    }
+
+    t->buffer = buffer;
+    t->size = size;
+    t->count = 0;
+    t->packet = 0;
+    t->maxPacket = maxPacket;
+    t->zlp = in && zlp;
+    t->done = done;
+    t->active = true;
+
+    if (!transferNext(endpoint, t)) {
+        t->active = false;
+        core_util_critical_section_exit();
+        return false;
+    }
+
+    core_util_critical_section_exit();
+    return true;
+}
+
+
+uint32_t USBDevice::transferAbort(uint8_t endpoint)
+{
+    EP_TRANSFER *t = findEPTransfer(endpoint);
+
+    if (t == NULL) {
+        return 0;
+    }
+
+    core_util_critical_section_enter();
+    t->active = false;
+    uint32_t count = t->count;
+    core_util_critical_section_exit();
+
+    return count;
+}
+
+
+bool USBDevice::transferBusy(uint8_t endpoint)
+{
+    EP_TRANSFER *t = findEPTransfer(endpoint);
+
+    return (t != NULL) && t->active;
+}
+
+
+void USBDevice::transferAbortAll(void)
+{
+    for (uint32_t i = 0; i < sizeof(epTransfer) / sizeof(epTransfer[0]); i++) {
+        epTransfer[i].active = false;
+    }
+}
+
+
+/* Queue the next packet of a transfer, return false if the endpoint refused it */
+bool USBDevice::transferNext(uint8_t endpoint, EP_TRANSFER * t)
+{
+    if (endpoint & 1) {
+        uint32_t remaining = t->size - t->count;
+        t->packet = (remaining < t->maxPacket) ? remaining : t->maxPacket;
+        return endpointWrite(endpoint, t->buffer + t->count, t->packet) == EP_PENDING;
+    }
+
+    return endpointRead(endpoint, t->maxPacket) == EP_PENDING;
+}
+
+
+// Called in ISR context when a packet of the endpoint has been sent or received
+bool USBDevice::transferCallback(uint8_t endpoint)
+{
+    EP_TRANSFER *t = findEPTransfer(endpoint);
+    bool last;
+
+    if (t == NULL || !t->active) {
+        return false;
+    }
+
+    if (endpoint & 1) {
+        /* The previous packet has been sent */
+        t->count += t->packet;
+        last = (t->count == t->size) && !(t->zlp && t->packet == t->maxPacket);
+    } else {
+        uint32_t size = 0;
+        if (endpointReadResult(endpoint, t->buffer + t->count, &size) != EP_COMPLETED) {
+            return false;
+        }
+        t->count += size;
+        last = (size < t->maxPacket) || (t->count == t->size);
+    }
+
+    if (!last && transferNext(endpoint, t)) {
+        return true;
+    }
+
+    t->active = false;
+    if (t->done) {
+        t->done.call(t->count);
+    }
+    return true;
+}
+
+
 bool USBDevice::readEP(uint8_t endpoint, uint8_t * buffer, uint32_t * size, uint32_t maxSize)
 {
     EP_STATUS result;
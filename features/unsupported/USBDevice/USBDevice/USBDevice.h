@@ -19,7 +19,11 @@
 #ifndef USBDEVICE_H
 #define USBDEVICE_H
 
+#if !defined(USBHAL_LOOPBACK) || defined(__MBED__)
 #include "mbed.h"
+#else
+#include <stdint.h>
+#endif
 #include "USBDevice_Types.h"
 #include "USBHAL.h"
 
@@ -118,6 +122,47 @@ public:
     */
     bool writeNB(uint8_t endpoint, uint8_t * buffer, uint32_t size, uint32_t maxSize);
 
+    /*
+    * Start a transfer of any length on a bulk or interrupt endpoint.
+    * The packets are chained from the endpoint interrupt: the endpoint
+    * callback of the class is not called for each packet. A class using
+    * transfers on an endpoint must not override its callback, or must call
+    * transferCallback from it.
+    *
+    * Warning: non blocking
+    *
+    * @param endpoint EPBULK_IN, EPBULK_OUT, EPINT_IN or EPINT_OUT
+    * @param buffer data to send, or buffer filled with the data received.
+    *        Must stay valid until the end of the transfer
+    * @param size number of bytes to send, or size of the buffer for OUT
+    *        endpoints (multiple of maxPacket). An OUT transfer also ends on
+    *        a short packet
+    * @param maxPacket the maximum packet size of the endpoint
+    * @param done called in ISR context at the end of the transfer with the
+    *        number of bytes transferred
+    * @param zlp IN endpoints only: terminate with a zero length packet when
+    *        size is a multiple of maxPacket
+    * @returns true if the transfer has been started
+    */
+    bool transferStart(uint8_t endpoint, uint8_t * buffer, uint32_t size, uint32_t maxPacket,
+                       Callback<void(uint32_t)> done = Callback<void(uint32_t)>(), bool zlp = false);
+
+    /*
+    * Abort the transfer of an endpoint. The done callback is not called.
+    *
+    * @param endpoint endpoint of the transfer
+    * @returns the number of bytes transferred before the abort
+    */
+    uint32_t transferAbort(uint8_t endpoint);
+
+    /*
+    * Check if a transfer is running on an endpoint
+    *
+    * @param endpoint endpoint to check
+    * @returns true if a transfer has been started and has not ended yet
+    */
+    bool transferBusy(uint8_t endpoint);
+
 
     /*
     * Called by USBDevice layer on bus reset. Warning: Called in ISR context
@@ -239,6 +284,21 @@ protected:
     uint8_t * findDescriptor(uint8_t descriptorType);
     CONTROL_TRANSFER * getTransferPtr(void);
 
+    /*
+    * Move the transfer of an endpoint to its next packet.
+    * Warning: Called in ISR context
+    *
+    * @param endpoint endpoint whose packet has been sent or received
+    * @returns true if the event belonged to a transfer
+    */
+    bool transferCallback(uint8_t endpoint);
+
+    // Called in ISR context: run the transfers of these endpoints
+    virtual bool EPINT_OUT_callback() { return transferCallback(EPINT_OUT); };
+    virtual bool EPINT_IN_callback() { return transferCallback(EPINT_IN); };
+    virtual bool EPBULK_OUT_callback() { return transferCallback(EPBULK_OUT); };
+    virtual bool EPBULK_IN_callback() { return transferCallback(EPBULK_IN); };
+
     uint16_t VENDOR_ID;
     uint16_t PRODUCT_ID;
     uint16_t PRODUCT_RELEASE;
@@ -260,6 +320,25 @@ private:
     bool requestGetInterface(void);
     bool requestSetInterface(void);
 
+    // transfer running on an interrupt or bulk endpoint
+    struct EP_TRANSFER {
+        uint8_t * buffer;
+        uint32_t size;
+        uint32_t count;
+        uint32_t packet;
+        uint32_t maxPacket;
+        volatile bool active;
+        bool zlp;
+        Callback<void(uint32_t)> done;
+    };
+
+    EP_TRANSFER * findEPTransfer(uint8_t endpoint);
+    bool transferNext(uint8_t endpoint, EP_TRANSFER * t);
+    void transferAbortAll(void);
+
+    // indexed by EPINT_OUT, EPINT_IN, EPBULK_OUT, EPBULK_IN
+    EP_TRANSFER epTransfer[4];
+
     CONTROL_TRANSFER transfer;
     USB_DEVICE device;
 
@@ -19,7 +19,16 @@
 #ifndef USBBUSINTERFACE_H
 #define USBBUSINTERFACE_H
 
+#if defined(USBHAL_LOOPBACK) && !defined(__MBED__)
+// host build of the loopback HAL, without the target headers
+#include <stdint.h>
+#include <string.h>
+#include "platform/Callback.h"
+#include "platform/mbed_critical.h"
+using mbed::Callback;
+#else
 #include "mbed.h"
+#endif
 #include "USBEndpoints.h"
 #include "mbed_toolchain.h"
 
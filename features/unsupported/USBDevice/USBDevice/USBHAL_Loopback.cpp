@@ -0,0 +1,287 @@
+/* Copyright (c) 2010-2011 mbed.org, MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Reference HAL without hardware, for builds that have no USB target.
+// A packet written to an IN endpoint is looped back to the OUT endpoint of
+// the same number once that endpoint has been armed, and connect()
+// configures the device as a host would. Endpoint events are dispatched
+// synchronously, from the call that produced them, so class drivers and
+// transfers can be exercised on the host.
+
+#if defined(USBHAL_LOOPBACK)
+
+#include "USBHAL.h"
+
+USBHAL * USBHAL::instance;
+
+// Convert physical endpoint number to register bit
+#define EP(endpoint) (1UL<<(endpoint))
+
+// Get endpoint direction
+#define IN_EP(endpoint)     ((endpoint) & 1U ? true : false)
+
+typedef struct {
+    uint8_t data[64];
+    uint32_t size;
+    uint32_t maxPacket;
+    bool full;          // IN: packet waiting to be looped back, OUT: packet to read
+    bool armed;         // OUT: a read has been started
+    bool stalled;
+} LOOPBACK_EP;
+
+static LOOPBACK_EP ep_state[NUMBER_OF_PHYSICAL_ENDPOINTS];
+
+// endpoints whose transfer has completed, until read by the driver
+static volatile uint32_t epComplete = 0;
+// endpoint events not dispatched yet
+static volatile uint32_t epPending = 0;
+static volatile bool resetPending = false;
+static volatile bool setupPending = false;
+static bool dispatching = false;
+
+// SET_CONFIGURATION 1, sent on connect
+static const uint8_t setConfiguration[SETUP_PACKET_SIZE] = {0x00, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+// Move the packet of an IN endpoint to its OUT endpoint if possible
+static void loopback(uint8_t endpoint) {
+    LOOPBACK_EP *in = &ep_state[endpoint | 1];
+    LOOPBACK_EP *out = &ep_state[endpoint & ~1];
+
+    if (in->full && out->armed && !out->full) {
+        memcpy(out->data, in->data, in->size);
+        out->size = in->size;
+        out->full = true;
+        out->armed = false;
+        in->full = false;
+        epComplete |= EP(endpoint | 1) | EP(endpoint & ~1);
+        epPending |= EP(endpoint | 1) | EP(endpoint & ~1);
+    }
+}
+
+USBHAL::USBHAL(void) {
+    instance = this;
+    memset(ep_state, 0, sizeof(ep_state));
+
+    // fill the callbacks array
+    epCallback[0] = &USBHAL::EP1_OUT_callback;
+    epCallback[1] = &USBHAL::EP1_IN_callback;
+    epCallback[2] = &USBHAL::EP2_OUT_callback;
+    epCallback[3] = &USBHAL::EP2_IN_callback;
+    epCallback[4] = &USBHAL::EP3_OUT_callback;
+    epCallback[5] = &USBHAL::EP3_IN_callback;
+    epCallback[6] = &USBHAL::EP4_OUT_callback;
+    epCallback[7] = &USBHAL::EP4_IN_callback;
+    epCallback[8] = &USBHAL::EP5_OUT_callback;
+    epCallback[9] = &USBHAL::EP5_IN_callback;
+    epCallback[10] = &USBHAL::EP6_OUT_callback;
+    epCallback[11] = &USBHAL::EP6_IN_callback;
+    epCallback[12] = &USBHAL::EP7_OUT_callback;
+    epCallback[13] = &USBHAL::EP7_IN_callback;
+    epCallback[14] = &USBHAL::EP8_OUT_callback;
+    epCallback[15] = &USBHAL::EP8_IN_callback;
+    epCallback[16] = &USBHAL::EP9_OUT_callback;
+    epCallback[17] = &USBHAL::EP9_IN_callback;
+    epCallback[18] = &USBHAL::EP10_OUT_callback;
+    epCallback[19] = &USBHAL::EP10_IN_callback;
+    epCallback[20] = &USBHAL::EP11_OUT_callback;
+    epCallback[21] = &USBHAL::EP11_IN_callback;
+    epCallback[22] = &USBHAL::EP12_OUT_callback;
+    epCallback[23] = &USBHAL::EP12_IN_callback;
+    epCallback[24] = &USBHAL::EP13_OUT_callback;
+    epCallback[25] = &USBHAL::EP13_IN_callback;
+    epCallback[26] = &USBHAL::EP14_OUT_callback;
+    epCallback[27] = &USBHAL::EP14_IN_callback;
+    epCallback[28] = &USBHAL::EP15_OUT_callback;
+    epCallback[29] = &USBHAL::EP15_IN_callback;
+}
+
+USBHAL::~USBHAL(void) {
+    instance = NULL;
+}
+
+void USBHAL::connect(void) {
+    resetPending = true;
+    setupPending = true;
+    _usbisr();
+}
+
+void USBHAL::disconnect(void) {
+    resetPending = false;
+    setupPending = false;
+    epPending = 0;
+    epComplete = 0;
+}
+
+void USBHAL::configureDevice(void) {
+}
+
+void USBHAL::unconfigureDevice(void) {
+}
+
+void USBHAL::setAddress(uint8_t address) {
+}
+
+void USBHAL::remoteWakeup(void) {
+}
+
+bool USBHAL::realiseEndpoint(uint8_t endpoint, uint32_t maxPacket, uint32_t flags) {
+    if (endpoint >= NUMBER_OF_PHYSICAL_ENDPOINTS || maxPacket > sizeof(ep_state[0].data)) {
+        return false;
+    }
+    ep_state[endpoint].maxPacket = maxPacket;
+    ep_state[endpoint].full = false;
+    ep_state[endpoint].armed = false;
+    ep_state[endpoint].stalled = false;
+    epComplete &= ~EP(endpoint);
+    epPending &= ~EP(endpoint);
+    return true;
+}
+
+void USBHAL::EP0setup(uint8_t *buffer) {
+    memcpy(buffer, setConfiguration, SETUP_PACKET_SIZE);
+}
+
+void USBHAL::EP0read(void) {
+}
+
+void USBHAL::EP0readStage(void) {
+}
+
+uint32_t USBHAL::EP0getReadResult(uint8_t *buffer) {
+    return 0;
+}
+
+void USBHAL::EP0write(uint8_t *buffer, uint32_t size) {
+}
+
+void USBHAL::EP0getWriteResult(void) {
+}
+
+void USBHAL::EP0stall(void) {
+}
+
+EP_STATUS USBHAL::endpointRead(uint8_t endpoint, uint32_t maximumSize) {
+    if (endpoint >= NUMBER_OF_PHYSICAL_ENDPOINTS || IN_EP(endpoint)) {
+        return EP_INVALID;
+    }
+    ep_state[endpoint].armed = true;
+    loopback(endpoint);
+    _usbisr();
+    return EP_PENDING;
+}
+
+EP_STATUS USBHAL::endpointReadResult(uint8_t endpoint, uint8_t *buffer, uint32_t *bytesRead) {
+    if (endpoint >= NUMBER_OF_PHYSICAL_ENDPOINTS || IN_EP(endpoint)) {
+        return EP_INVALID;
+    }
+
+    LOOPBACK_EP *ep = &ep_state[endpoint];
+    if (!ep->full) {
+        return EP_PENDING;
+    }
+    memcpy(buffer, ep->data, ep->size);
+    *bytesRead = ep->size;
+    ep->full = false;
+    epComplete &= ~EP(endpoint);
+    return EP_COMPLETED;
+}
+
+EP_STATUS USBHAL::endpointWrite(uint8_t endpoint, uint8_t *data, uint32_t size) {
+    if (endpoint >= NUMBER_OF_PHYSICAL_ENDPOINTS || !IN_EP(endpoint)) {
+        return EP_INVALID;
+    }
+
+    LOOPBACK_EP *ep = &ep_state[endpoint];
+
+    if (size > ep->maxPacket) {
+        return EP_INVALID;
+    }
+    if (ep->stalled) {
+        return EP_STALLED;
+    }
+    memcpy(ep->data, data, size);
+    ep->size = size;
+    ep->full = true;
+    epComplete &= ~EP(endpoint);
+    loopback(endpoint);
+    _usbisr();
+    return EP_PENDING;
+}
+
+EP_STATUS USBHAL::endpointWriteResult(uint8_t endpoint) {
+    if (epComplete & EP(endpoint)) {
+        epComplete &= ~EP(endpoint);
+        return EP_COMPLETED;
+    }
+    return EP_PENDING;
+}
+
+void USBHAL::stallEndpoint(uint8_t endpoint) {
+    ep_state[endpoint].stalled = true;
+}
+
+void USBHAL::unstallEndpoint(uint8_t endpoint) {
+    ep_state[endpoint].stalled = false;
+}
+
+bool USBHAL::getEndpointStallState(uint8_t endpoint) {
+    return ep_state[endpoint].stalled;
+}
+
+void USBHAL::_usbisr(void) {
+    if (instance != NULL) {
+        instance->usbisr();
+    }
+}
+
+// Dispatch the pending events. Events raised by the callbacks are
+// dispatched by the outermost call, so callbacks never nest.
+void USBHAL::usbisr(void) {
+    if (dispatching) {
+        return;
+    }
+    dispatching = true;
+
+    while (resetPending || setupPending || epPending) {
+        if (resetPending) {
+            resetPending = false;
+            busReset();
+            continue;
+        }
+
+        if (setupPending) {
+            setupPending = false;
+            EP0setupCallback();
+            continue;
+        }
+
+        for (uint8_t endpoint = 2; endpoint < NUMBER_OF_PHYSICAL_ENDPOINTS; endpoint++) {
+            if (epPending & EP(endpoint)) {
+                epPending &= ~EP(endpoint);
+                if ((instance->*(epCallback[endpoint - 2]))()) {
+                    epComplete &= ~EP(endpoint);
+                }
+                break;
+            }
+        }
+    }
+
+    dispatching = false;
+}
+
+#endif
@@ -17,13 +17,12 @@
 */
 
 #include "stdint.h"
+#include "string.h"
 #include "USBSerial.h"
 
 int USBSerial::_putc(int c) {
-    if (!terminal_connected)
-        return 0;
-    send((uint8_t *)&c, 1);
-    return 1;
+    uint8_t byte = c;
+    return (write(&byte, 1) == 1) ? 1 : 0;
 }
 
 int USBSerial::_getc() {
@@ -34,16 +33,160 @@ int USBSerial::_getc() {
 }
 
 
+ssize_t USBSerial::write(const void *buffer, size_t length) {
+    const uint8_t *ptr = (const uint8_t *)buffer;
+    size_t done = 0;
+
+    while (done < length) {
+        if (!terminal_connected || !configured())
+            break;
+
+        // only the endpoint side frees space, so it can only grow meanwhile
+        uint32_t n = USBSERIAL_TX_BUFFER_SIZE - tx_count;
+        if (n == 0)
+            continue;
+        if (n > length - done)
+            n = length - done;
+
+        // copy at tx_head, in two chunks if the ring wraps
+        uint32_t first = USBSERIAL_TX_BUFFER_SIZE - tx_head;
+        if (first > n)
+            first = n;
+        memcpy(&tx_ring[tx_head], ptr + done, first);
+        memcpy(&tx_ring[0], ptr + done + first, n - first);
+        tx_head = (tx_head + n) % USBSERIAL_TX_BUFFER_SIZE;
+
+        core_util_critical_section_enter();
+        tx_count += n;
+        core_util_critical_section_exit();
+
+        startTx();
+        done += n;
+    }
+    return done;
+}
+
+
+bool USBSerial::flush() {
+    core_util_critical_section_enter();
+    if (tx_count > 0 || tx_zlp)
+        tx_flush_partial = true;
+    core_util_critical_section_exit();
+
+    // the timeout restarts whenever the host takes a packet
+    Timer timer;
+    timer.start();
+    uint32_t pending = tx_count;
+
+    while ((tx_count > 0 || tx_busy || tx_zlp) && terminal_connected && configured()) {
+        if (tx_count != pending) {
+            pending = tx_count;
+            timer.reset();
+        } else if (timer.read_ms() >= USBSERIAL_TX_FLUSH_TIMEOUT_MS) {
+            return false;
+        }
+        startTx();
+    }
+    return tx_count == 0 && !tx_busy && !tx_zlp;
+}
+
+
+int USBSerial::sync() {
+    return flush() ? 0 : -1;
+}
+
+
 bool USBSerial::writeBlock(uint8_t * buf, uint16_t size) {
-    if(size > MAX_PACKET_SIZE_EPBULK) {
-        return false;
+    return write(buf, size) == size;
+}
+
+
+// Send the next packet if the endpoint is idle. A partial packet is only
+// sent once flushing was requested, otherwise the flush timer is armed.
+// Data ending on a full packet is ended the same way with a zero length
+// packet, as the host only sees the transfer complete on a short packet.
+// Called from both thread and ISR context.
+void USBSerial::startTx() {
+    core_util_critical_section_enter();
+
+    if (!tx_busy && tx_count == 0 && tx_zlp && tx_flush_partial && configured()) {
+        if (endpointWrite(EPBULK_IN, tx_packet, 0) == EP_PENDING) {
+            tx_busy = true;
+            tx_zlp = false;
+            tx_flush_partial = false;
+        } else if (!tx_timer_armed) {
+            tx_timer_armed = true;
+            tx_timer.attach_us(callback(this, &USBSerial::txRetry), USBSERIAL_TX_FLUSH_DELAY_US);
+        }
     }
-    if(!send(buf, size)) {
-        return false;
+
+    if (!tx_busy && tx_count > 0 && configured()) {
+        uint32_t n = (tx_count < MAX_PACKET_SIZE_EPBULK) ? tx_count : MAX_PACKET_SIZE_EPBULK;
+
+        if (n == MAX_PACKET_SIZE_EPBULK || tx_flush_partial) {
+            for (uint32_t i = 0; i < n; i++) {
+                tx_packet[i] = tx_ring[(tx_tail + i) % USBSERIAL_TX_BUFFER_SIZE];
+            }
+
+            if (endpointWrite(EPBULK_IN, tx_packet, n) == EP_PENDING) {
+                tx_tail = (tx_tail + n) % USBSERIAL_TX_BUFFER_SIZE;
+                tx_count -= n;
+                tx_busy = true;
+                tx_zlp = (tx_count == 0 && n == MAX_PACKET_SIZE_EPBULK);
+                if (tx_count == 0 && !tx_zlp)
+                    tx_flush_partial = false;
+            } else if (!tx_timer_armed) {
+                // nothing will complete to call us again, so try later
+                tx_timer_armed = true;
+                tx_timer.attach_us(callback(this, &USBSerial::txRetry), USBSERIAL_TX_FLUSH_DELAY_US);
+            }
+        }
+    }
+
+    if (((tx_count > 0 && tx_count < MAX_PACKET_SIZE_EPBULK) || (tx_count == 0 && tx_zlp)) &&
+        !tx_flush_partial && !tx_timer_armed) {
+        tx_timer_armed = true;
+        tx_timer.attach_us(callback(this, &USBSerial::txTimeout), USBSERIAL_TX_FLUSH_DELAY_US);
     }
+
+    core_util_critical_section_exit();
+}
+
+// Called in ISR context when no more data arrived for a partial packet
+// or after a full one
+void USBSerial::txTimeout() {
+    tx_timer_armed = false;
+    tx_flush_partial = true;
+    startTx();
+}
+
+// Called in ISR context after the endpoint refused a packet
+void USBSerial::txRetry() {
+    tx_timer_armed = false;
+    startTx();
+}
+
+// Called in ISR context when a packet has been sent
+bool USBSerial::EPBULK_IN_callback() {
+    tx_busy = false;
+    startTx();
     return true;
 }
 
+// Called in ISR context
+// A new configuration drops whatever was waiting to be sent
+bool USBSerial::USBCallback_setConfiguration(uint8_t configuration) {
+    tx_timer.detach();
+    tx_head = 0;
+    tx_tail = 0;
+    tx_count = 0;
+    tx_busy = false;
+    tx_flush_partial = false;
+    tx_zlp = false;
+    tx_timer_armed = false;
+
+    return USBCDC::USBCallback_setConfiguration(configuration);
+}
 
 
 bool USBSerial::EPBULK_OUT_callback() {
@@ -63,6 +206,6 @@ bool USBSerial::EPBULK_OUT_callback() {
     return true;
 }
 
-uint8_t USBSerial::available() {
+uint16_t USBSerial::available() {
     return buf.available();
 }
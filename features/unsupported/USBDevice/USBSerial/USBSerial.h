@@ -24,6 +24,26 @@
 #include "CircBuffer.h"
 #include "Callback.h"
 
+/** Size of the receive buffer, in bytes */
+#ifndef USBSERIAL_RX_BUFFER_SIZE
+#define USBSERIAL_RX_BUFFER_SIZE    128
+#endif
+
+/** Size of the transmit buffer, in bytes */
+#ifndef USBSERIAL_TX_BUFFER_SIZE
+#define USBSERIAL_TX_BUFFER_SIZE    (4 * MAX_PACKET_SIZE_EPBULK)
+#endif
+
+/** Time a partial packet may wait for more data before it is sent, in us */
+#ifndef USBSERIAL_TX_FLUSH_DELAY_US
+#define USBSERIAL_TX_FLUSH_DELAY_US 1000
+#endif
+
+/** Time flush() waits for the host to take more data before giving up, in ms */
+#ifndef USBSERIAL_TX_FLUSH_TIMEOUT_MS
+#define USBSERIAL_TX_FLUSH_TIMEOUT_MS 500
+#endif
+
 /**
 * USBSerial example
 *
@@ -43,6 +63,12 @@
 *    }
 * }
 * @endcode
+*
+* Output is buffered and sent in full packets of MAX_PACKET_SIZE_EPBULK
+* bytes. A partial packet is sent once no more data arrived for
+* USBSERIAL_TX_FLUSH_DELAY_US, or right away with flush(). Buffer sizes can
+* be changed by defining USBSERIAL_RX_BUFFER_SIZE and
+* USBSERIAL_TX_BUFFER_SIZE.
 */
 class USBSerial: public USBCDC, public Stream {
 public:
@@ -58,6 +84,13 @@ public:
     */
     USBSerial(uint16_t vendor_id = 0x1f00, uint16_t product_id = 0x2012, uint16_t product_release = 0x0001, bool connect_blocking = true): USBCDC(vendor_id, product_id, product_release, connect_blocking){
         settingsChangedCallback = 0;
+        tx_head = 0;
+        tx_tail = 0;
+        tx_count = 0;
+        tx_busy = false;
+        tx_flush_partial = false;
+        tx_zlp = false;
+        tx_timer_armed = false;
     };
 
 
@@ -76,12 +109,33 @@ public:
     */
     virtual int _getc();
 
+    /**
+    * Write a buffer. Blocks only while the transmit buffer is full.
+    *
+    * @param buffer data to send
+    * @param length number of bytes to send
+    * @returns the number of bytes buffered, less than length if the terminal
+    *          disconnected
+    */
+    virtual ssize_t write(const void *buffer, size_t length);
+
+    /**
+    * Send buffered data now, including a partial packet, and wait until
+    * it has been transferred.
+    *
+    * Gives up if the host takes no data for USBSERIAL_TX_FLUSH_TIMEOUT_MS,
+    * leaving the rest buffered.
+    *
+    * @returns true if all data was transferred
+    */
+    bool flush();
+
     /**
     * Check the number of bytes available.
     *
     * @returns the number of bytes available
     */
-    uint8_t available();
+    uint16_t available();
 
     /** Determine if there is a character available to read
      *
@@ -97,15 +151,15 @@ public:
      *    1 if there is space to write a character,
      *    0 otherwise
      */
-    int writeable() { return 1; } // always return 1, for write operation is blocking
+    int writeable() { return (tx_count < USBSERIAL_TX_BUFFER_SIZE) ? 1 : 0; }
 
     /**
     * Write a block of data.
     *
-    * For more efficiency, a block of size 64 (maximum size of a bulk endpoint) has to be written.
+    * The data goes through the transmit buffer like any other output.
     *
     * @param buf pointer on data which will be written
-    * @param size size of the buffer. The maximum size of a block is limited by the size of the endpoint (64 bytes)
+    * @param size size of the buffer
     *
     * @returns true if successfull
     */
@@ -146,6 +200,9 @@ public:
 
 protected:
     virtual bool EPBULK_OUT_callback();
+    virtual bool EPBULK_IN_callback();
+    virtual bool USBCallback_setConfiguration(uint8_t configuration);
+    virtual int sync();
     virtual void lineCodingChanged(int baud, int bits, int parity, int stop){
         if (settingsChangedCallback) {
             settingsChangedCallback(baud, bits, parity, stop);
@@ -153,9 +210,25 @@ protected:
     }
 
 private:
+    void startTx();
+    void txTimeout();
+    void txRetry();
+
     Callback<void()> rx;
-    CircBuffer<uint8_t,128> buf;
+    CircBuffer<uint8_t,USBSERIAL_RX_BUFFER_SIZE> buf;
     void (*settingsChangedCallback)(int baud, int bits, int parity, int stop);
+
+    /* Transmit ring, filled by write() and drained one packet at a time */
+    uint8_t tx_ring[USBSERIAL_TX_BUFFER_SIZE];
+    uint32_t tx_head;
+    volatile uint32_t tx_tail;
+    volatile uint32_t tx_count;
+    uint8_t tx_packet[MAX_PACKET_SIZE_EPBULK];
+    volatile bool tx_busy;
+    volatile bool tx_flush_partial;
+    volatile bool tx_zlp;
+    volatile bool tx_timer_armed;
+    Timeout tx_timer;
 };
 
 #endif
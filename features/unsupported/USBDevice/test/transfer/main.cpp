@@ -0,0 +1,204 @@
+/* Copyright (c) 2010-2011 mbed.org, MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Host test of USBDevice::transferStart() on the loopback USBHAL. What is
+// sent on EPBULK_IN is received on EPBULK_OUT, and since the loopback HAL
+// dispatches its events synchronously, transfers that can complete have
+// done so when transferStart() returns.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "USBDevice.h"
+
+// The events run from the calling thread, there is nothing to mask
+extern "C" void core_util_critical_section_enter(void) {}
+extern "C" void core_util_critical_section_exit(void) {}
+extern "C" void mbed_assert_internal(const char *expr, const char *file, int line)
+{
+    printf("%s:%d: assertion '%s' failed\n", file, line, expr);
+}
+
+static int failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+class LoopbackDevice: public USBDevice {
+public:
+    LoopbackDevice(): USBDevice(0x1f00, 0x2012, 0x0001) {
+        connect();
+    }
+
+protected:
+    virtual bool USBCallback_setConfiguration(uint8_t configuration) {
+        return configuration == 1 &&
+               addEndpoint(EPBULK_IN, MAX_PACKET_SIZE_EPBULK) &&
+               addEndpoint(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    }
+};
+
+// Records the done callbacks of a transfer
+struct Done {
+    int calls;
+    uint32_t count;
+
+    Done(): calls(0), count(0) {}
+
+    void call(uint32_t n) {
+        calls++;
+        count = n;
+    }
+
+    Callback<void(uint32_t)> callback() {
+        return Callback<void(uint32_t)>(this, &Done::call);
+    }
+};
+
+static uint8_t sent[4 * MAX_PACKET_SIZE_EPBULK];
+static uint8_t received[4 * MAX_PACKET_SIZE_EPBULK];
+
+static void fill(uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        sent[i] = (uint8_t)(i * 7 + 3);
+    }
+    memset(received, 0, sizeof(received));
+}
+
+// Several full packets then a short one, which ends the OUT transfer
+static void test_multi_packet()
+{
+    LoopbackDevice device;
+    Done in, out;
+    const uint32_t size = 2 * MAX_PACKET_SIZE_EPBULK + 22;
+
+    fill(size);
+    CHECK(device.configured());
+    CHECK(device.transferStart(EPBULK_OUT, received, sizeof(received), MAX_PACKET_SIZE_EPBULK, out.callback()));
+    CHECK(device.transferBusy(EPBULK_OUT));
+    CHECK(device.transferStart(EPBULK_IN, sent, size, MAX_PACKET_SIZE_EPBULK, in.callback()));
+
+    CHECK(in.calls == 1 && in.count == size);
+    CHECK(out.calls == 1 && out.count == size);
+    CHECK(memcmp(sent, received, size) == 0);
+    CHECK(!device.transferBusy(EPBULK_IN));
+    CHECK(!device.transferBusy(EPBULK_OUT));
+}
+
+// A size that is a multiple of maxPacket is terminated by a zero length packet
+static void test_zlp()
+{
+    LoopbackDevice device;
+    Done in, out;
+    const uint32_t size = 2 * MAX_PACKET_SIZE_EPBULK;
+
+    // the IN side first: its packets wait for the OUT endpoint
+    fill(size);
+    CHECK(device.transferStart(EPBULK_IN, sent, size, MAX_PACKET_SIZE_EPBULK, in.callback(), true));
+    CHECK(device.transferBusy(EPBULK_IN));
+    CHECK(device.transferStart(EPBULK_OUT, received, sizeof(received), MAX_PACKET_SIZE_EPBULK, out.callback()));
+
+    CHECK(in.calls == 1 && in.count == size);
+    CHECK(out.calls == 1 && out.count == size);
+    CHECK(memcmp(sent, received, size) == 0);
+}
+
+// Without the zero length packet the OUT transfer waits for more data
+static void test_abort()
+{
+    LoopbackDevice device;
+    Done in, out;
+    const uint32_t size = 2 * MAX_PACKET_SIZE_EPBULK;
+
+    fill(size);
+    CHECK(device.transferStart(EPBULK_OUT, received, sizeof(received), MAX_PACKET_SIZE_EPBULK, out.callback()));
+    CHECK(device.transferStart(EPBULK_IN, sent, size, MAX_PACKET_SIZE_EPBULK, in.callback()));
+
+    CHECK(in.calls == 1 && in.count == size);
+    CHECK(out.calls == 0);
+    CHECK(device.transferBusy(EPBULK_OUT));
+
+    // only one transfer per endpoint
+    CHECK(!device.transferStart(EPBULK_OUT, received, sizeof(received), MAX_PACKET_SIZE_EPBULK, out.callback()));
+
+    CHECK(device.transferAbort(EPBULK_OUT) == size);
+    CHECK(!device.transferBusy(EPBULK_OUT));
+    CHECK(out.calls == 0);
+    CHECK(memcmp(sent, received, size) == 0);
+}
+
+static void test_invalid()
+{
+    LoopbackDevice device;
+
+    CHECK(!device.transferStart(EPBULK_OUT, received, MAX_PACKET_SIZE_EPBULK + 1, MAX_PACKET_SIZE_EPBULK));
+    CHECK(!device.transferStart(EPBULK_OUT, received, 0, MAX_PACKET_SIZE_EPBULK));
+    CHECK(!device.transferStart(EPBULK_IN, NULL, 10, MAX_PACKET_SIZE_EPBULK));
+    CHECK(!device.transferStart(EP0IN, sent, 10, MAX_PACKET_SIZE_EP0));
+    CHECK(!device.transferBusy(EPBULK_OUT));
+    CHECK(!device.transferBusy(EPBULK_IN));
+    CHECK(device.transferAbort(EP0IN) == 0);
+
+    device.disconnect();
+    CHECK(!device.transferStart(EPBULK_IN, sent, 10, MAX_PACKET_SIZE_EPBULK));
+}
+
+// A bus reset drops the running transfers without calling done
+static void test_bus_reset()
+{
+    LoopbackDevice device;
+    Done out;
+
+    CHECK(device.transferStart(EPBULK_OUT, received, sizeof(received), MAX_PACKET_SIZE_EPBULK, out.callback()));
+    CHECK(device.transferBusy(EPBULK_OUT));
+
+    device.connect();
+    CHECK(device.configured());
+    CHECK(!device.transferBusy(EPBULK_OUT));
+    CHECK(out.calls == 0);
+
+    // the endpoint can be used again after the reset
+    Done in;
+    fill(10);
+    CHECK(device.transferStart(EPBULK_OUT, received, sizeof(received), MAX_PACKET_SIZE_EPBULK, out.callback()));
+    CHECK(device.transferStart(EPBULK_IN, sent, 10, MAX_PACKET_SIZE_EPBULK, in.callback()));
+    CHECK(out.calls == 1 && out.count == 10);
+    CHECK(in.calls == 1 && in.count == 10);
+}
+
+int main()
+{
+    test_multi_packet();
+    test_zlp();
+    test_abort();
+    test_invalid();
+    test_bus_reset();
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("PASS\n");
+    return 0;
+}
@@ -29,13 +29,21 @@
 #define GET_MAX_LUN             (0xFE)
 #define BO_MASS_STORAGE_RESET   (0xFF)
 
-USBHostMSD::USBHostMSD(const char * rootdir) : FATFileSystem(rootdir)
+USBHostMSD::USBHostMSD()
 {
     host = USBHost::getHostInst();
-    init();
+    cache_buf = NULL;
+    cache_block_size = 0;
+    cache_clock = 0;
+    init_usb();
 }
 
-void USBHostMSD::init() {
+USBHostMSD::~USBHostMSD()
+{
+    delete[] cache_buf;
+}
+
+void USBHostMSD::init_usb() {
     dev_connected = false;
     dev = NULL;
     bulk_in = NULL;
@@ -48,6 +56,7 @@ void USBHostMSD::init() {
     disk_init = false;
     dev_connected = false;
     nb_ep = 0;
+    cacheInvalidate();
 }
 
 
@@ -80,14 +89,14 @@ bool USBHostMSD::connect()
 
                 USB_INFO("New MSD device: VID:%04x PID:%04x [dev: %p - intf: %d]", dev->getVid(), dev->getPid(), dev, msd_intf);
                 dev->setName("MSD", msd_intf);
-                host->registerDriver(dev, msd_intf, this, &USBHostMSD::init);
+                host->registerDriver(dev, msd_intf, this, &USBHostMSD::init_usb);
 
                 dev_connected = true;
                 return true;
             }
         } //if()
     } //for()
-    init();
+    init_usb();
     return false;
 }
 
@@ -277,7 +286,7 @@ int USBHostMSD::SCSITransfer(uint8_t * cmd, uint8_t cmd_len, int flags, uint8_t
 }
 
 
-int USBHostMSD::dataTransfer(uint8_t * buf, uint32_t block, uint8_t nbBlock, int direction) {
+int USBHostMSD::dataTransfer(uint8_t * buf, uint32_t block, uint16_t nbBlock, int direction) {
     uint8_t cmd[10];
     memset(cmd,0,10);
     cmd[0] = (direction == DEVICE_TO_HOST) ? 0x28 : 0x2A;
@@ -301,10 +310,84 @@ int USBHostMSD::getMaxLun() {
     return res;
 }
 
-int USBHostMSD::disk_initialize() {
+int USBHostMSD::blockTransfer(uint8_t * buf, uint32_t block, uint32_t count, int direction) {
+    // merge the whole range into as few commands as the host allows
+    uint32_t max = USBHOST_MSD_MAX_TRANSFER_SIZE / blockSize;
+    if (max == 0)
+        max = 1;
+    if (max > 0xffff)
+        max = 0xffff;
+
+    while (count > 0) {
+        uint32_t n = (count < max) ? count : max;
+        if (dataTransfer(buf, block, n, direction))
+            return -1;
+        buf += n * blockSize;
+        block += n;
+        count -= n;
+    }
+    return 0;
+}
+
+USBHostMSD::CacheLine * USBHostMSD::cacheFind(uint32_t block) {
+    for (int i = 0; i < USBHOST_MSD_CACHE_LINES; i++) {
+        if (cache[i].count && block >= cache[i].block && block - cache[i].block < cache[i].count)
+            return &cache[i];
+    }
+    return NULL;
+}
+
+// Read the aligned line holding block into the least recently used line
+USBHostMSD::CacheLine * USBHostMSD::cacheFill(uint32_t block) {
+    CacheLine * line = &cache[0];
+    for (int i = 1; i < USBHOST_MSD_CACHE_LINES && line->count; i++) {
+        if (!cache[i].count || cache[i].used < line->used)
+            line = &cache[i];
+    }
+
+    uint32_t start = block - block % USBHOST_MSD_READ_AHEAD;
+    uint32_t count = blockCount - start;
+    if (count > USBHOST_MSD_READ_AHEAD)
+        count = USBHOST_MSD_READ_AHEAD;
+
+    line->count = 0;
+    if (dataTransfer(line->data, start, count, DEVICE_TO_HOST))
+        return NULL;
+
+    line->block = start;
+    line->count = count;
+    return line;
+}
+
+// Keep cached copies in sync with sectors that were just written
+void USBHostMSD::cacheUpdate(const uint8_t * buf, uint32_t block, uint32_t count) {
+    for (int i = 0; i < USBHOST_MSD_CACHE_LINES; i++) {
+        CacheLine * line = &cache[i];
+        uint32_t first = (block > line->block) ? block : line->block;
+        uint32_t last = (block + count < line->block + line->count) ? block + count : line->block + line->count;
+
+        if (line->count && first < last) {
+            memcpy(line->data + (first - line->block) * blockSize,
+                   buf + (first - block) * blockSize, (last - first) * blockSize);
+        }
+    }
+}
+
+void USBHostMSD::cacheInvalidate() {
+    for (int i = 0; i < USBHOST_MSD_CACHE_LINES; i++) {
+        cache[i].count = 0;
+    }
+}
+
+int USBHostMSD::init() {
     USB_DBG("FILESYSTEM: init");
     uint16_t i, timeout = 10;
 
+    disk_init = false;
+    cacheInvalidate();
+    if (!dev_connected)
+        return BD_ERROR_DEVICE_ERROR;
+
     getMaxLun();
 
     for (i = 0; i < timeout; i++) {
@@ -313,54 +396,135 @@ int USBHostMSD::disk_initialize() {
             break;
     }
 
-    if (i == timeout) {
-        disk_init = false;
-        return -1;
-    }
+    if (i == timeout)
+        return BD_ERROR_DEVICE_ERROR;
 
     inquiry(0, 0);
-    disk_init = 1;
-    return readCapacity();
+    if (readCapacity() || blockSize <= 0)
+        return BD_ERROR_DEVICE_ERROR;
+
+#if USBHOST_MSD_CACHE_LINES
+    if (cache_block_size != blockSize) {
+        delete[] cache_buf;
+        cache_buf = new uint8_t[USBHOST_MSD_CACHE_LINES * USBHOST_MSD_READ_AHEAD * blockSize];
+        cache_block_size = blockSize;
+        for (int l = 0; l < USBHOST_MSD_CACHE_LINES; l++) {
+            cache[l].data = cache_buf + l * USBHOST_MSD_READ_AHEAD * blockSize;
+        }
+    }
+#endif
+
+    disk_init = true;
+    return BD_ERROR_OK;
+}
+
+int USBHostMSD::deinit() {
+    cacheInvalidate();
+    disk_init = false;
+    return BD_ERROR_OK;
 }
 
-int USBHostMSD::disk_write(const uint8_t* buffer, uint32_t block_number, uint32_t count) {
-    USB_DBG("FILESYSTEM: write block: %lld, count: %d", block_number, count);
+int USBHostMSD::program(const void * buffer, bd_addr_t addr, bd_size_t size) {
+    USB_DBG("FILESYSTEM: write addr: %llu, size: %llu", addr, size);
     if (!disk_init) {
-        disk_initialize();
+        init();
     }
     if (!disk_init)
-        return -1;
-    for (uint32_t b = block_number; b < block_number + count; b++) {
-        if (dataTransfer((uint8_t*)buffer, b, 1, HOST_TO_DEVICE))
-            return -1;
-        buffer += 512;
+        return BD_ERROR_DEVICE_ERROR;
+    MBED_ASSERT(is_valid_program(addr, size));
+
+    const uint8_t * buf = (const uint8_t *)buffer;
+    uint32_t block = addr / blockSize;
+    uint32_t count = size / blockSize;
+
+    if (blockTransfer((uint8_t *)buf, block, count, HOST_TO_DEVICE)) {
+        // whatever reached the disk is unknown now
+        cacheInvalidate();
+        return BD_ERROR_DEVICE_ERROR;
     }
-    return 0;
+    cacheUpdate(buf, block, count);
+    return BD_ERROR_OK;
 }
 
-int USBHostMSD::disk_read(uint8_t* buffer, uint32_t block_number, uint32_t count) {
-    USB_DBG("FILESYSTEM: read block: %lld, count: %d", block_number, count);
+int USBHostMSD::read(void * buffer, bd_addr_t addr, bd_size_t size) {
+    USB_DBG("FILESYSTEM: read addr: %llu, size: %llu", addr, size);
     if (!disk_init) {
-        disk_initialize();
+        init();
     }
     if (!disk_init)
-        return -1;
-    for (uint32_t b = block_number; b < block_number + count; b++) {
-        if (dataTransfer((uint8_t*)buffer, b, 1, DEVICE_TO_HOST))
-            return -1;
-        buffer += 512;
+        return BD_ERROR_DEVICE_ERROR;
+    MBED_ASSERT(is_valid_read(addr, size));
+
+    uint8_t * buf = (uint8_t *)buffer;
+    uint32_t block = addr / blockSize;
+    uint32_t count = size / blockSize;
+
+    while (count > 0) {
+        uint32_t n = count;
+
+#if USBHOST_MSD_CACHE_LINES
+        CacheLine * line = cacheFind(block);
+
+        if (!line) {
+            // length of the run missing from the cache
+            n = 1;
+            while (n < count && !cacheFind(block + n))
+                n++;
+
+            // short runs pull in the whole line, long ones go straight to the buffer
+            if (n < USBHOST_MSD_READ_AHEAD) {
+                line = cacheFill(block);
+                if (!line)
+                    return BD_ERROR_DEVICE_ERROR;
+            }
+        }
+
+        if (line) {
+            uint32_t offset = block - line->block;
+            n = line->count - offset;
+            if (n > count)
+                n = count;
+
+            line->used = ++cache_clock;
+            memcpy(buf, line->data + offset * blockSize, n * blockSize);
+        } else
+#endif
+        if (blockTransfer(buf, block, n, DEVICE_TO_HOST)) {
+            return BD_ERROR_DEVICE_ERROR;
+        }
+
+        buf += n * blockSize;
+        block += n;
+        count -= n;
     }
-    return 0;
+    return BD_ERROR_OK;
+}
+
+int USBHostMSD::erase(bd_addr_t addr, bd_size_t size) {
+    // sectors are rewritten in place, nothing to erase
+    return BD_ERROR_OK;
+}
+
+bd_size_t USBHostMSD::get_read_size() const {
+    return blockSize;
+}
+
+bd_size_t USBHostMSD::get_program_size() const {
+    return blockSize;
+}
+
+bd_size_t USBHostMSD::get_erase_size() const {
+    return blockSize;
 }
 
-uint32_t USBHostMSD::disk_sectors() {
-    USB_DBG("FILESYSTEM: sectors");
+bd_size_t USBHostMSD::size() {
+    USB_DBG("FILESYSTEM: size");
     if (!disk_init) {
-        disk_initialize();
+        init();
     }
     if (!disk_init)
         return 0;
-    return blockCount;
+    return (bd_size_t)blockCount * blockSize;
 }
 
 #endif
@@ -22,19 +22,50 @@
 #if USBHOST_MSD
 
 #include "USBHost.h"
-#include "FATFileSystem.h"
+#include "BlockDevice.h"
+
+// Number of cache lines kept for recently read sectors, 0 disables the cache
+#ifndef USBHOST_MSD_CACHE_LINES
+#define USBHOST_MSD_CACHE_LINES         4
+#endif
+
+// Sectors per cache line: a miss reads the whole aligned line, so
+// sequential small reads are served from the cache
+#ifndef USBHOST_MSD_READ_AHEAD
+#define USBHOST_MSD_READ_AHEAD          2
+#endif
+
+// Largest data stage of a single READ(10)/WRITE(10) command, in bytes
+#ifndef USBHOST_MSD_MAX_TRANSFER_SIZE
+#define USBHOST_MSD_MAX_TRANSFER_SIZE   4096
+#endif
 
 /**
  * A class to communicate a USB flash disk
+ *
+ * The disk is exposed as a BlockDevice, mount it with a FATFileSystem:
+ *
+ * @code
+ * USBHostMSD msd;
+ * FATFileSystem fs("usb");
+ *
+ * while (!msd.connect()) {
+ *     Thread::wait(500);
+ * }
+ * fs.mount(&msd);
+ * @endcode
  */
-class USBHostMSD : public IUSBEnumerator, public FATFileSystem {
+class USBHostMSD : public IUSBEnumerator, public BlockDevice {
 public:
     /**
     * Constructor
-    *
-    * @param rootdir mount name
     */
-    USBHostMSD(const char * rootdir);
+    USBHostMSD();
+
+    /**
+    * Destructor
+    */
+    virtual ~USBHostMSD();
 
     /**
     * Check if a MSD device is connected
@@ -50,20 +81,81 @@ public:
      */
     bool connect();
 
+    /** Initialize the connected disk
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int init();
+
+    /** Deinitialize the disk, dropping the sector cache
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int deinit();
+
+    /** Read blocks from the disk
+     *
+     *  Contiguous sectors are read with as few commands as possible,
+     *  small reads go through the sector cache
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int read(void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Program blocks to the disk
+     *
+     *  Writes go straight to the disk, cached copies are updated
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int program(const void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Erase blocks on the disk
+     *
+     *  Sectors are overwritten in place, so this does nothing
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int erase(bd_addr_t addr, bd_size_t size);
+
+    /** Get the size of a readable block
+     *
+     *  @return         Size of a readable block in bytes
+     */
+    virtual bd_size_t get_read_size() const;
+
+    /** Get the size of a programable block
+     *
+     *  @return         Size of a programable block in bytes
+     */
+    virtual bd_size_t get_program_size() const;
+
+    /** Get the size of a eraseable block
+     *
+     *  @return         Size of a eraseable block in bytes
+     */
+    virtual bd_size_t get_erase_size() const;
+
+    /** Get the total size of the disk
+     *
+     *  @return         Size of the disk in bytes
+     */
+    virtual bd_size_t size();
+
 protected:
     //From IUSBEnumerator
     virtual void setVidPid(uint16_t vid, uint16_t pid);
     virtual bool parseInterface(uint8_t intf_nb, uint8_t intf_class, uint8_t intf_subclass, uint8_t intf_protocol); //Must return true if the interface should be parsed
     virtual bool useEndpoint(uint8_t intf_nb, ENDPOINT_TYPE type, ENDPOINT_DIRECTION dir); //Must return true if the endpoint will be used
 
-    // From FATFileSystem
-    virtual int disk_initialize();
-    virtual int disk_status() {return 0;};
-    virtual int disk_read(uint8_t* buffer, uint32_t sector, uint32_t count);
-    virtual int disk_write(const uint8_t* buffer, uint32_t sector, uint32_t count);
-    virtual int disk_sync() {return 0;};
-    virtual uint32_t disk_sectors();
-
 private:
     USBHost * host;
     USBDeviceConnected * dev;
@@ -99,7 +191,8 @@ private:
     int readCapacity();
     int inquiry(uint8_t lun, uint8_t page_code);
     int SCSIRequestSense();
-    int dataTransfer(uint8_t * buf, uint32_t block, uint8_t nbBlock, int direction);
+    int dataTransfer(uint8_t * buf, uint32_t block, uint16_t nbBlock, int direction);
+    int blockTransfer(uint8_t * buf, uint32_t block, uint32_t count, int direction);
     int checkResult(uint8_t res, USBEndpoint * ep);
     int getMaxLun();
 
@@ -110,7 +203,26 @@ private:
     bool msd_device_found;
     bool disk_init;
 
-    void init();
+    // A line holds up to USBHOST_MSD_READ_AHEAD sectors starting at an
+    // aligned block, count is 0 for an unused line
+    struct CacheLine {
+        uint32_t block;
+        uint32_t count;
+        uint32_t used;
+        uint8_t * data;
+    };
+
+    CacheLine cache[USBHOST_MSD_CACHE_LINES ? USBHOST_MSD_CACHE_LINES : 1];
+    uint8_t * cache_buf;
+    int cache_block_size;
+    uint32_t cache_clock;
+
+    CacheLine * cacheFind(uint32_t block);
+    CacheLine * cacheFill(uint32_t block);
+    void cacheUpdate(const uint8_t * buf, uint32_t block, uint32_t count);
+    void cacheInvalidate();
+
+    void init_usb();
 
 };
 
@@ -21,10 +21,18 @@ using namespace std;
 
 namespace mbed {
 
+static uint32_t get_le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
 Arguments::Arguments(const char* rqs) {
     obj_name = NULL;
     method_name = NULL;
     argc = 0;
+    binary = false;
+    valid = true;
+    obj_hash = 0;
+    method_hash = 0;
 
     // This copy can be removed if we can assume the request string is
     // persistent and writable for the duration of the call
@@ -54,6 +62,61 @@ Arguments::Arguments(const char* rqs) {
     index = -1;
 }
 
+Arguments::Arguments(const uint8_t* frame, uint32_t len) {
+    obj_name = NULL;
+    method_name = NULL;
+    argc = 0;
+    index = -1;
+    binary = true;
+    valid = false;
+    obj_hash = 0;
+    method_hash = 0;
+
+    if (len < RPC_BINARY_HEADER_SIZE) return;
+    obj_hash = get_le32(frame);
+    method_hash = get_le32(frame + 4);
+    int n = frame[8];
+    if (n > RPC_MAX_ARGS) return;
+
+    const uint8_t* p = frame + RPC_BINARY_HEADER_SIZE;
+    const uint8_t* end = frame + len;
+    while (argc < n) {
+        uint32_t size;
+        if (p >= end) return;
+        switch (*p) {
+            case RPC_ARG_INT:
+            case RPC_ARG_FLOAT:
+                size = 5;
+                break;
+            case RPC_ARG_STRING:
+                // the length includes the terminating null byte
+                if (end - p < 2 || p[1] == 0) return;
+                size = 2 + p[1];
+                break;
+            default:
+                return;
+        }
+        if ((uint32_t)(end - p) < size) return;
+
+        if (*p == RPC_ARG_STRING) {
+            if (p[size - 1] != '\0') return;
+            argv[argc] = (char*)(p + 2);
+        } else {
+            argv[argc] = NULL;
+        }
+        argb[argc] = p;
+        argc++;
+        p += size;
+    }
+
+    valid = (p == end);
+}
+
+const uint8_t* Arguments::next_binary(void) {
+    index++;
+    return (index < argc) ? argb[index] : NULL;
+}
+
 char* Arguments::search_arg(char **arg, char *p, char next_sep) {
     char *s = p;
     while (true) {
@@ -68,41 +131,146 @@ char* Arguments::search_arg(char **arg, char *p, char next_sep) {
     return (separator == next_sep) ? (p) : (NULL);
 }
 
+// Numeric value of a binary argument, strings are converted as in text requests
+static int binary_int(const uint8_t *arg) {
+    if (arg == NULL) return 0;
+    switch (*arg) {
+        case RPC_ARG_INT:
+            return (int32_t)get_le32(arg + 1);
+        case RPC_ARG_FLOAT: {
+            uint32_t u = get_le32(arg + 1);
+            float f;
+            memcpy(&f, &u, sizeof(f));
+            return (int)f;
+        }
+        default: {
+            char *pEnd;
+            return strtol((const char*)(arg + 2), &pEnd, 10);
+        }
+    }
+}
+
+static double binary_double(const uint8_t *arg) {
+    if (arg == NULL) return 0;
+    switch (*arg) {
+        case RPC_ARG_INT:
+            return (int32_t)get_le32(arg + 1);
+        case RPC_ARG_FLOAT: {
+            uint32_t u = get_le32(arg + 1);
+            float f;
+            memcpy(&f, &u, sizeof(f));
+            return f;
+        }
+        default:
+            return atof((const char*)(arg + 2));
+    }
+}
+
 template<> PinName Arguments::getArg<PinName>(void) {
+    if (binary) {
+        const uint8_t *arg = next_binary();
+        if (arg != NULL && *arg == RPC_ARG_STRING) {
+            return parse_pins((const char*)(arg + 2));
+        }
+        return arg ? (PinName)binary_int(arg) : NC;
+    }
     index++;
     return parse_pins(argv[index]);
 }
 
 template<> int Arguments::getArg<int>(void) {
+    if (binary) {
+        return binary_int(next_binary());
+    }
     index++;
     char *pEnd;
     return strtol(argv[index], &pEnd, 10);
 }
 
 template<> const char* Arguments::getArg<const char*>(void) {
+    if (binary) {
+        const uint8_t *arg = next_binary();
+        return (arg != NULL && *arg == RPC_ARG_STRING) ? (const char*)(arg + 2) : NULL;
+    }
     index++;
     return argv[index];
 }
 
 template<> char Arguments::getArg<char>(void) {
+    if (binary) {
+        const uint8_t *arg = next_binary();
+        if (arg != NULL && *arg == RPC_ARG_STRING) {
+            return arg[2];
+        }
+        return (char)binary_int(arg);
+    }
     index++;
     return *argv[index];
 }
 
 template<> double Arguments::getArg<double>(void) {
+    if (binary) {
+        return binary_double(next_binary());
+    }
     index++;
     return atof(argv[index]);
 }
 
 template<> float Arguments::getArg<float>(void) {
+    if (binary) {
+        return binary_double(next_binary());
+    }
     index++;
     return atof(argv[index]);
 }
 
 Reply::Reply(char* r) {
     first = true;
+    binary = false;
+    overflow = false;
     *r = '\0';
     reply = r;
+    begin = r;
+    end = NULL;
+}
+
+Reply::Reply(uint8_t* r, uint32_t size) {
+    first = true;
+    binary = true;
+    overflow = false;
+    reply = (char*)r;
+    begin = reply;
+    end = reply + size;
+}
+
+bool Reply::reserve(uint32_t len) {
+    if (overflow || (uint32_t)(end - reply) < len) {
+        overflow = true;
+        return false;
+    }
+    return true;
+}
+
+void Reply::putBinary(char type, uint32_t value) {
+    if (!reserve(5)) return;
+    reply[0] = type;
+    reply[1] = value;
+    reply[2] = value >> 8;
+    reply[3] = value >> 16;
+    reply[4] = value >> 24;
+    reply += 5;
+}
+
+void Reply::putBinary(const char* s) {
+    size_t len = strlen(s) + 1;
+    if (len > 255 || !reserve(2 + len)) {
+        overflow = true;
+        return;
+    }
+    reply[0] = RPC_ARG_STRING;
+    reply[1] = len;
+    memcpy(reply + 2, s, len);
+    reply += 2 + len;
 }
 
 void Reply::separator(void) {
@@ -114,26 +282,49 @@ void Reply::separator(void) {
 }
 
 template<> void Reply::putData<const char*>(const char* s) {
+    if (binary) {
+        putBinary(s);
+        return;
+    }
     separator();
     reply += sprintf(reply, "%s", s);
 }
 
 template<> void Reply::putData<char*>(char* s) {
+    if (binary) {
+        putBinary(s);
+        return;
+    }
     separator();
     reply += sprintf(reply, "%s", s);
 }
 
 template<> void Reply::putData<char>(char c) {
+    if (binary) {
+        char s[2] = { c, '\0' };
+        putBinary(s);
+        return;
+    }
     separator();
     reply += sprintf(reply, "%c", c);
 }
 
 template<> void Reply::putData<int>(int v) {
+    if (binary) {
+        putBinary(RPC_ARG_INT, (uint32_t)v);
+        return;
+    }
     separator();
     reply += sprintf(reply, "%d", v);
 }
 
 template<> void Reply::putData<float>(float f) {
+    if (binary) {
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        putBinary(RPC_ARG_FLOAT, u);
+        return;
+    }
     separator();
     reply += sprintf(reply, "%.17g", f);
 }
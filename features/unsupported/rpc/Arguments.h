@@ -24,10 +24,21 @@ namespace mbed {
 #define RPC_MAX_STRING  128
 #define RPC_MAX_ARGS     16
 
+// Binary request header: object hash, method hash, argument count
+#define RPC_BINARY_HEADER_SIZE  9
+
+// Binary argument types
+#define RPC_ARG_INT     'i'
+#define RPC_ARG_FLOAT   'f'
+#define RPC_ARG_STRING  's'
+
 class Arguments {
 public:
     Arguments(const char* rqs);
 
+    // Decode a binary request in place, the frame must stay valid during the call
+    Arguments(const uint8_t* frame, uint32_t len);
+
     template<typename Arg>
     Arg   getArg(void);
 
@@ -35,27 +46,52 @@ public:
     char *method_name;
 
     int   argc;
+    // In binary requests, string arguments point into the frame and
+    // numeric arguments are NULL
     char* argv[RPC_MAX_ARGS];
 
+    // Binary request: hashes of the object and method names
+    bool binary;
+    bool valid;
+    uint32_t obj_hash;
+    uint32_t method_hash;
+
 private:
     // This copy can be removed if we can assume the request string is
     // persistent and writable for the duration of the call
     char  request[RPC_MAX_STRING];
     int index;
     char* search_arg(char **arg, char *p, char next_sep);
+
+    // Binary request: arguments, starting with their type
+    const uint8_t* argb[RPC_MAX_ARGS];
+    const uint8_t* next_binary(void);
 };
 
 class Reply {
 public:
     Reply(char* r);
 
+    // Encode the reply in the binary format, in at most size bytes
+    Reply(uint8_t* r, uint32_t size);
+
     template<typename Data>
     void putData(Data d);
 
+    // Binary reply: length written, and whether some data did not fit
+    uint32_t length(void) const { return reply - begin; }
+    bool overflow;
+
 private:
     void separator(void);
+    bool reserve(uint32_t len);
+    void putBinary(char type, uint32_t value);
+    void putBinary(const char* s);
     bool first;
+    bool binary;
     char* reply;
+    char* begin;
+    char* end;
 };
 
 
@@ -19,6 +19,15 @@ using namespace std;
 
 namespace mbed {
 
+/* Methods recently resolved, indexed by method table and method hash */
+struct rpc_method_cache_entry {
+    const rpc_method *table;
+    uint32_t hash;
+    const rpc_method *method;
+};
+
+static rpc_method_cache_entry method_cache[RPC_METHOD_CACHE_SIZE];
+
 RPC::RPC(const char *name) {
     _from_construct = false;
     if (name != NULL) {
@@ -31,9 +40,22 @@ RPC::RPC(const char *name) {
     // put this object at head of the list
     _next = _head;
     _head = this;
+
+    // and in the index
+    _hash = hash(_name);
+    RPC **bucket = &_buckets[_hash & (RPC_HASH_BUCKETS - 1)];
+    _hash_next = *bucket;
+    *bucket = this;
 }
 
 RPC::~RPC() {
+    // remove this object from the index
+    RPC **bucket = &_buckets[_hash & (RPC_HASH_BUCKETS - 1)];
+    while (*bucket != this) {
+        bucket = &(*bucket)->_hash_next;
+    }
+    *bucket = _hash_next;
+
     // remove this object from the list
     if (_head == this) { // first in the list, so just drop me
         _head = _next;
@@ -54,17 +76,86 @@ const rpc_method *RPC::get_rpc_methods() {
     return methods;
 }
 
+uint32_t RPC::hash(const char *name) {
+    uint32_t h = 2166136261UL;
+    while (*name != '\0') {
+        h ^= (uint8_t)*name++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
 RPC *RPC::lookup(const char *name) {
-    size_t len = strlen(name);
-    for (RPC *p = _head; p != NULL; p = p->_next) {
-        /* Check that p->_name matches name and is the correct length */
-        if (strncmp(p->_name, name, len) == 0 && (strlen(p->_name) == len)) {
+    uint32_t h = hash(name);
+    for (RPC *p = _buckets[h & (RPC_HASH_BUCKETS - 1)]; p != NULL; p = p->_hash_next) {
+        if (p->_hash == h && strcmp(p->_name, name) == 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+RPC *RPC::lookup_hash(uint32_t h) {
+    for (RPC *p = _buckets[h & (RPC_HASH_BUCKETS - 1)]; p != NULL; p = p->_hash_next) {
+        if (p->_hash == h) {
             return p;
         }
     }
     return NULL;
 }
 
+/* Find a method of this object by name, or by hash alone if name is NULL.
+ * The super class chain is only walked on a cache miss.
+ */
+const rpc_method *RPC::find_method(uint32_t h, const char *name) {
+    const rpc_method *table = get_rpc_methods();
+    rpc_method_cache_entry *e = &method_cache[(((uint32_t)(uintptr_t)table >> 2) ^ h) & (RPC_METHOD_CACHE_SIZE - 1)];
+
+    if (e->table == table && e->hash == h && (name == NULL || strcmp(e->method->name, name) == 0)) {
+        return e->method;
+    }
+
+    const rpc_method *cur_method = table;
+    while (true) {
+        for (; cur_method->name != NULL; cur_method++) {
+            if ((name != NULL) ? (strcmp(cur_method->name, name) == 0) : (hash(cur_method->name) == h)) {
+                e->table = table;
+                e->hash = h;
+                e->method = cur_method;
+                return cur_method;
+            }
+        }
+
+        if (cur_method->super != 0) {
+            cur_method = cur_method->super(this);
+        } else {
+            return NULL;
+        }
+    }
+}
+
+rpc_class *RPC::find_class(uint32_t h, const char *name) {
+    for (rpc_class *c = _classes; c != NULL; c = c->next) {
+        if (c->hash == 0) {
+            c->hash = hash(c->name);
+        }
+        if (c->hash == h && (name == NULL || strcmp(c->name, name) == 0)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+/* Find a static function of a class by name, or by hash alone if name is NULL */
+static const rpc_function *find_function(const rpc_class *c, uint32_t h, const char *name) {
+    for (const rpc_function *f = c->static_functions; f->name != NULL; f++) {
+        if ((name != NULL) ? (strcmp(f->name, name) == 0) : (RPC::hash(f->name) == h)) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
 void RPC::delete_self() {
     delete[] _name;
     if (_from_construct) {
@@ -102,6 +193,8 @@ rpc_class RPC::_RPC_class = { "RPC", _RPC_funcs, NULL };
 
 RPC *RPC::_head = NULL;
 
+RPC *RPC::_buckets[RPC_HASH_BUCKETS];
+
 rpc_class *RPC::_classes = &_RPC_class;
 
 bool RPC::call(const char *request, char *reply) {
@@ -144,48 +237,68 @@ bool RPC::call(const char *request, char *reply) {
         }
 
         /* Look through the methods for the one whose name matches */
-        while (true) {
-            for (; cur_method->name != NULL; cur_method++) {
-                if (strcmp(cur_method->name, args.method_name) == 0) {
-                    (cur_method->method_caller)(p, &args, &r);
-                    return true;
-                }
-            }
-
-            if (cur_method->super != 0) {
-                cur_method = cur_method->super(p);
-            } else {
-                /* end of methods and no match */
-                return false;
-            }
-
+        const rpc_method *m = p->find_method(hash(args.method_name), args.method_name);
+        if (m == NULL) {
+            return false;
         }
+        (m->method_caller)(p, &args, &r);
+        return true;
     }
 
     /* Then try a class */
-    for (const rpc_class *q = _classes; q != NULL; q = q->next) {
-        if (strcmp(q->name, args.obj_name) == 0) {
-            /* Matched the class name, so get its functions */
-            const rpc_function *cur_func = q->static_functions;
-            if (args.method_name == NULL) {
-                for (; cur_func->name != NULL; cur_func++) {
-                    r.putData<const char*>(cur_func->name);
-                }
-                return true;
-            } else {
-                /* Otherwise call the appropriate function */
-                for (; cur_func->name != NULL; cur_func++) {
-                    if (strcmp(cur_func->name, args.method_name) == 0) {
-                        (cur_func->function_caller)(&args, &r);
-                        return true;
-                    }
-                }
-                return false;
+    rpc_class *q = find_class(hash(args.obj_name), args.obj_name);
+    if (q != NULL) {
+        /* Matched the class name, so get its functions */
+        if (args.method_name == NULL) {
+            for (const rpc_function *cur_func = q->static_functions; cur_func->name != NULL; cur_func++) {
+                r.putData<const char*>(cur_func->name);
             }
+            return true;
         }
+
+        /* Otherwise call the appropriate function */
+        const rpc_function *f = find_function(q, 0, args.method_name);
+        if (f == NULL) {
+            return false;
+        }
+        (f->function_caller)(&args, &r);
+        return true;
     }
 
     return false;
 }
 
+int RPC::call_binary(const uint8_t *request, uint32_t request_len, uint8_t *reply, uint32_t reply_size) {
+    if (request == NULL || reply == NULL) return -1;
+
+    Arguments args(request, request_len);
+    Reply r(reply, reply_size);
+
+    if (!args.valid) {
+        return -1;
+    }
+
+    /* First try matching an instance, then a class */
+    RPC *p = lookup_hash(args.obj_hash);
+    if (p != NULL) {
+        const rpc_method *m = p->find_method(args.method_hash, NULL);
+        if (m == NULL) {
+            return -1;
+        }
+        (m->method_caller)(p, &args, &r);
+    } else {
+        rpc_class *q = find_class(args.obj_hash, NULL);
+        if (q == NULL) {
+            return -1;
+        }
+        const rpc_function *f = find_function(q, args.method_hash, NULL);
+        if (f == NULL) {
+            return -1;
+        }
+        (f->function_caller)(&args, &r);
+    }
+
+    return r.overflow ? -1 : (int)r.length();
+}
+
 } // namespace mbed
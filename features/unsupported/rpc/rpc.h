@@ -23,6 +23,20 @@ namespace mbed {
 
 #define RPC_MAX_STRING      128
 
+/* Macro RPC_HASH_BUCKETS
+ *  Number of buckets of the object index, must be a power of 2
+ */
+#ifndef RPC_HASH_BUCKETS
+#define RPC_HASH_BUCKETS    16
+#endif
+
+/* Macro RPC_METHOD_CACHE_SIZE
+ *  Number of entries of the cache of resolved methods, must be a power of 2
+ */
+#ifndef RPC_METHOD_CACHE_SIZE
+#define RPC_METHOD_CACHE_SIZE 16
+#endif
+
 struct rpc_function {
     const char *name;
     void (*function_caller)(Arguments*, Reply*);
@@ -32,6 +46,8 @@ struct rpc_class {
     const char *name;
     const rpc_function *static_functions;
     struct rpc_class *next;
+    /* hash of name, computed on first lookup when left to 0 */
+    uint32_t hash;
 };
 
 /* Class RPC
@@ -66,6 +82,30 @@ public:
 
     static bool call(const char *buf, char *result);
 
+    /* Function call_binary
+     *  Execute a request in the binary format and write the reply in
+     *  the same format. Objects, classes and methods are identified by
+     *  the hash of their name, see RPC::hash.
+     *
+     *  Request: object hash (4) | method hash (4) | argc (1) | arguments
+     *  Argument: 'i' int32 (4)
+     *            'f' float (4)
+     *            's' length (1) characters, terminating null byte included
+     *  Reply:    the returned values, encoded as arguments
+     *
+     *  Multi-byte values are little endian. String arguments are passed
+     *  to the method in place, without copy.
+     *
+     * Variables
+     *  request - the request frame
+     *  request_len - length of the request frame
+     *  reply - buffer receiving the reply
+     *  reply_size - size of the reply buffer
+     *  returns - the length of the reply, or -1 if the request is malformed,
+     *            does not match an object and method, or the reply does not fit
+     */
+    static int call_binary(const uint8_t *request, uint32_t request_len, uint8_t *reply, uint32_t reply_size);
+
     /* Function lookup
      *  Lookup and return the object that has the given name.
      *
@@ -74,15 +114,39 @@ public:
      */
     static RPC *lookup(const char *name);
 
+    /* Function lookup_hash
+     *  Lookup and return the object whose name has the given hash.
+     *
+     * Variables
+     *  hash - the hash of the name to lookup.
+     */
+    static RPC *lookup_hash(uint32_t hash);
+
+    /* Function hash
+     *  Hash of a name, used to index objects and methods (32-bit FNV-1a)
+     *
+     * Variables
+     *  name - the name to hash.
+     */
+    static uint32_t hash(const char *name);
+
 protected:
     static RPC *_head;
     RPC *_next;
     char *_name;
     bool _from_construct;
 
+    /* objects indexed by the hash of their name */
+    static RPC *_buckets[RPC_HASH_BUCKETS];
+    RPC *_hash_next;
+    uint32_t _hash;
+
 private:
     static rpc_class *_classes;
 
+    const rpc_method *find_method(uint32_t hash, const char *name);
+    static rpc_class *find_class(uint32_t hash, const char *name);
+
     static const rpc_function _RPC_funcs[];
     static rpc_class _RPC_class;
 
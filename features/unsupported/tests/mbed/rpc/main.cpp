@@ -22,6 +22,35 @@ bool rpc_test(const char *input, const char *expected) {
     return result;
 }
 
+// Binary request: object hash, method hash, then argc arguments
+static uint32_t put_le32(uint8_t *buf, uint32_t v) {
+    buf[0] = v; buf[1] = v >> 8; buf[2] = v >> 16; buf[3] = v >> 24;
+    return 4;
+}
+
+static uint32_t binary_request(uint8_t *buf, const char *obj, const char *method, uint8_t argc) {
+    put_le32(buf, RPC::hash(obj));
+    put_le32(buf + 4, RPC::hash(method));
+    buf[8] = argc;
+    return RPC_BINARY_HEADER_SIZE;
+}
+
+bool rpc_binary_test(const char *name, const uint8_t *input, uint32_t len, const uint8_t *expected, int expected_len) {
+    uint8_t outbuf[RPC_MAX_STRING];
+    int result = RPC::call_binary(input, len, outbuf, sizeof(outbuf));
+    printf("RPC binary: %s -> ", name);
+
+    if (result != expected_len) {
+        printf("%d != %d ... [FAIL]\r\n", result, expected_len);
+        return false;
+    } else if (result > 0 && memcmp(outbuf, expected, result) != 0) {
+        printf("reply mismatch ... [FAIL]\r\n");
+        return false;
+    }
+    printf("%d bytes ... [OK]\r\n", result);
+    return true;
+}
+
 #define RPC_TEST(INPUT,EXPECTED) result = result && rpc_test(INPUT,EXPECTED); if (result == false) { notify_completion(result); exit(1); }
 
 int main() {
@@ -58,6 +87,45 @@ int main() {
     RPC_TEST("/DigitalOut", "new");
     RPC_TEST("/led1", "write read delete");
 
+    // Binary requests
+    uint8_t req[32];
+    uint8_t rep[8];
+    uint32_t len;
+    float v = 2.5f;
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+
+    len = binary_request(req, "f", "write", 1);
+    req[len++] = RPC_ARG_FLOAT;
+    len += put_le32(req + len, u);
+    result = result && rpc_binary_test("/f/write 2.5", req, len, NULL, 0);
+
+    len = binary_request(req, "f", "read", 0);
+    rep[0] = RPC_ARG_FLOAT;
+    put_le32(rep + 1, u);
+    result = result && rpc_binary_test("/f/read", req, len, rep, 5);
+
+    len = binary_request(req, "led1", "read", 0);
+    rep[0] = RPC_ARG_INT;
+    put_le32(rep + 1, 1);
+    result = result && rpc_binary_test("/led1/read", req, len, rep, 5);
+
+    len = binary_request(req, "led1", "write", 1);
+    req[len++] = RPC_ARG_STRING;
+    req[len++] = 2;
+    req[len++] = '0';
+    req[len++] = '\0';
+    result = result && rpc_binary_test("/led1/write \"0\"", req, len, NULL, 0);
+    RPC_TEST("/led1/read", "0");
+
+    len = binary_request(req, "led1", "toggle", 0);
+    result = result && rpc_binary_test("/led1/toggle", req, len, NULL, -1);
+
+    len = binary_request(req, "led1", "write", 1);
+    req[len++] = RPC_ARG_INT;
+    result = result && rpc_binary_test("truncated", req, len, NULL, -1);
+    if (result == false) { notify_completion(result); exit(1); }
+
     // Delete instance
     RPC_TEST("/led2/delete", "");
     RPC_TEST("/", "led1 foo f DigitalOut RPC");
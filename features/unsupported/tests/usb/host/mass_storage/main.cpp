@@ -1,9 +1,11 @@
 #include "mbed.h"
 #include "USBHostMSD.h"
+#include "FATFileSystem.h"
 DigitalOut led(LED1);
 void msd_task(void const *) {
 	printf("init msd\n");
-	USBHostMSD msd("usb");
+	USBHostMSD msd;
+	FATFileSystem fs("usb");
 	int i = 0;
 	printf("wait for usb memory stick insertion\n");
 	while(1) {
@@ -12,6 +14,7 @@ void msd_task(void const *) {
 		while(!msd.connect()) {
 			Thread::wait(500);
 		}
+		fs.mount(&msd);
 
 		// in a loop, append a file
 		// if the device is disconnected, we try to connect it again
@@ -32,6 +35,7 @@ void msd_task(void const *) {
 		while (msd.connected()) {
 			Thread::wait(500);
 		}
+		fs.unmount();
 	}
 }
 
@@ -44,6 +44,20 @@ typedef struct port_s port_t;
  */
 PinName port_pin(PortName port, int pin_n);
 
+/** Get the port and the port's pin number of a pin
+ *
+ * This is the inverse of port_pin(). Targets that don't implement it
+ * use a default that reports every pin as not mappable to a port.
+ * Buses write the pins it maps with port_write(), so a target implementing
+ * it must write only the masked pins, without a read-modify-write of the
+ * whole port that could undo changes made meanwhile to its other pins.
+ *
+ * @param pin  The pin name
+ * @param port The port name of the pin
+ * @return The pin number within the port, or -1 if the pin can't be accessed through a port
+ */
+int port_pin_number(PinName pin, PortName *port);
+
 /** Initilize the port
  *
  * @param obj  The port object to initialize
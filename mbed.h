@@ -90,6 +90,7 @@
 // mbed Internal components
 #include "drivers/Timer.h"
 #include "drivers/Ticker.h"
+#include "drivers/TickerGroup.h"
 #include "drivers/Timeout.h"
 #include "drivers/LowPowerTimeout.h"
 #include "drivers/LowPowerTicker.h"
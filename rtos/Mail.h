@@ -95,7 +95,128 @@ public:
         return osMailFree(_mail_id, (void*)mptr);
     }
 
+    /** Allocate several memory blocks of type T
+      @param   data      array receiving the memory blocks.
+      @param   count     number of memory blocks to allocate.
+      @param   millisec  timeout value or 0 in case of no time-out, for each wait for a free block. (default: 0).
+      @return  number of memory blocks allocated, less than count if the pool stayed empty.
+    */
+    uint32_t alloc_n(T** data, uint32_t count, uint32_t millisec=0) {
+        uint32_t n = 0;
+        while (n < count) {
+            uint32_t done = alloc_batch(data + n, count - n);
+            n += done;
+            if (done != 0) {
+                continue;
+            }
+            // Pool is empty, wait for one block and batch the rest again
+            if (millisec == 0 || (data[n] = alloc(millisec)) == NULL) {
+                break;
+            }
+            n++;
+        }
+        return n;
+    }
+
+    /** Put several mails in the queue, in order.
+      @param   data   memory blocks previously allocated with Mail::alloc, Mail::calloc or Mail::alloc_n.
+      @param   count  number of memory blocks in data.
+      @return  number of mails put.
+
+      @note From an ISR no more mails are put than fit in the RTX post service FIFO
+            (OS_FIFOSZ, 16 by default) until it is next handled.
+    */
+    uint32_t put_n(T** data, uint32_t count) {
+        uint32_t n = 0;
+        while (n < count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+            uint32_t done = osMailPutN(_mail_id, (void* const*)(data + n), count - n);
+#else
+            uint32_t done = (put(data[n]) == osOK) ? 1 : 0;
+#endif
+            if (done == 0) {
+                break;
+            }
+            n += done;
+        }
+        return n;
+    }
+
+    /** Get several mails from a queue, in order, waiting for the first one.
+      @param   data      array receiving the memory blocks.
+      @param   count     maximum number of mails to get.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever).
+      @return  number of mails got, 0 if none arrived in time.
+    */
+    uint32_t get_n(T** data, uint32_t count, uint32_t millisec=osWaitForever) {
+        uint32_t n = get_batch(data, count);
+        if (n == 0 && count != 0 && millisec != 0) {
+            osEvent evt = get(millisec);
+            if (evt.status != osEventMail) {
+                return 0;
+            }
+            data[n++] = (T*)evt.value.p;
+        }
+        while (n < count) {
+            uint32_t done = get_batch(data + n, count - n);
+            if (done == 0) {
+                break;
+            }
+            n += done;
+        }
+        return n;
+    }
+
+    /** Free several memory blocks from a mail.
+      @param   data   memory blocks that were obtained with Mail::get or Mail::get_n.
+      @param   count  number of memory blocks in data.
+      @return  status code that indicates the execution status of the function.
+    */
+    osStatus free_n(T** data, uint32_t count) {
+        uint32_t n = 0;
+        while (n < count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+            uint32_t done = osMailFreeN(_mail_id, (void* const*)(data + n), count - n);
+#else
+            uint32_t done = (free(data[n]) == osOK) ? 1 : 0;
+#endif
+            if (done == 0) {
+                return osErrorValue;
+            }
+            n += done;
+        }
+        return osOK;
+    }
+
 private:
+    uint32_t alloc_batch(T** data, uint32_t count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+        return osMailAllocN(_mail_id, (void**)data, count);
+#else
+        uint32_t n = 0;
+        while (n < count && (data[n] = alloc()) != NULL) {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    uint32_t get_batch(T** data, uint32_t count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+        return osMailGetN(_mail_id, (void**)data, count);
+#else
+        uint32_t n = 0;
+        while (n < count) {
+            osEvent evt = get(0);
+            if (evt.status != osEventMail) {
+                break;
+            }
+            data[n++] = (T*)evt.value.p;
+        }
+        return n;
+#endif
+    }
+
     osMailQId    _mail_id;
     osMailQDef_t _mail_def;
 #ifdef CMSIS_OS_RTX
@@ -72,6 +72,42 @@ public:
         return osPoolFree(_pool_id, (void*)block);
     }
 
+    /** Allocate several memory blocks of type T from a memory pool.
+      @param   blocks  array receiving the addresses of the allocated memory blocks.
+      @param   count   number of memory blocks to allocate.
+      @return  number of memory blocks allocated, less than count if the memory pool ran out.
+    */
+    uint32_t alloc_n(T** blocks, uint32_t count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+        return osPoolAllocN(_pool_id, (void**)blocks, count);
+#else
+        uint32_t n = 0;
+        while (n < count && (blocks[n] = alloc()) != NULL) {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    /** Return several allocated memory blocks back to a specific memory pool.
+      @param   blocks  addresses of the allocated memory blocks that are returned to the memory pool.
+      @param   count   number of memory blocks in blocks.
+      @return  status code that indicates the execution status of the function.
+    */
+    osStatus free_n(T** blocks, uint32_t count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+        return (osPoolFreeN(_pool_id, (void* const*)blocks, count) == count) ? osOK : osErrorValue;
+#else
+        for (uint32_t n = 0; n < count; n++) {
+            osStatus status = free(blocks[n]);
+            if (status != osOK) {
+                return status;
+            }
+        }
+        return osOK;
+#endif
+    }
+
 private:
     osPoolId    _pool_id;
     osPoolDef_t _pool_def;
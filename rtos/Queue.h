@@ -71,7 +71,86 @@ public:
         return osMessageGet(_queue_id, millisec);
     }
 
+    /** Put several messages in a Queue, in order.
+      @param   data      array of message pointers.
+      @param   count     number of messages in data.
+      @param   millisec  timeout value or 0 in case of no time-out, for each wait for free space. (default: 0)
+      @return  number of messages put, less than count if the Queue stayed full.
+
+      @note From an ISR millisec must be 0, and no more messages are put than fit in
+            the RTX post service FIFO (OS_FIFOSZ, 16 by default) until it is next handled.
+    */
+    uint32_t put_n(T** data, uint32_t count, uint32_t millisec=0) {
+        uint32_t n = 0;
+        while (n < count) {
+            uint32_t done = put_batch(data + n, count - n);
+            n += done;
+            if (done != 0) {
+                continue;
+            }
+            // Queue is full, wait for space for one message and batch the rest again
+            if (millisec == 0 || put(data[n], millisec) != osOK) {
+                break;
+            }
+            n++;
+        }
+        return n;
+    }
+
+    /** Get several messages from a Queue, in order, waiting for the first one.
+      @param   data      array receiving the message pointers.
+      @param   count     maximum number of messages to get.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever).
+      @return  number of messages got, 0 if none arrived in time.
+    */
+    uint32_t get_n(T** data, uint32_t count, uint32_t millisec=osWaitForever) {
+        uint32_t n = get_batch(data, count);
+        if (n == 0 && count != 0 && millisec != 0) {
+            osEvent evt = get(millisec);
+            if (evt.status != osEventMessage) {
+                return 0;
+            }
+            data[n++] = (T*)evt.value.p;
+        }
+        while (n < count) {
+            uint32_t done = get_batch(data + n, count - n);
+            if (done == 0) {
+                break;
+            }
+            n += done;
+        }
+        return n;
+    }
+
 private:
+    uint32_t put_batch(T** data, uint32_t count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+        return osMessagePutN(_queue_id, (const uint32_t*)data, count);
+#else
+        uint32_t n = 0;
+        while (n < count && put(data[n]) == osOK) {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    uint32_t get_batch(T** data, uint32_t count) {
+#if defined(osFeature_Batch) && (osFeature_Batch != 0)
+        return osMessageGetN(_queue_id, (uint32_t*)data, count);
+#else
+        uint32_t n = 0;
+        while (n < count) {
+            osEvent evt = get(0);
+            if (evt.status != osEventMessage) {
+                break;
+            }
+            data[n++] = (T*)evt.value.p;
+        }
+        return n;
+#endif
+    }
+
     osMessageQId    _queue_id;
     osMessageQDef_t _queue_def;
 #ifdef CMSIS_OS_RTX
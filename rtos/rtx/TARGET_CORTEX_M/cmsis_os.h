@@ -107,6 +107,7 @@
 #define osFeature_Wait         0       ///< osWait not available
 #define osFeature_SysTick      1       ///< osKernelSysTick functions available
 #define osFeature_ThreadEnum   1       ///< Thread enumeration available
+#define osFeature_Batch        1       ///< Batch message, mail and memory pool functions available
 
 #if defined (__CC_ARM)
 #define os_InRegs __value_in_regs      // Compiler specific: force struct in registers
@@ -737,6 +738,72 @@ uint32_t os_suspend (void);
 /// \param[in]     sleep_time    specifies how long the system was in sleep or power-down mode.
 void os_resume (uint32_t sleep_time);
 
+#if (defined (osFeature_Batch)  &&  (osFeature_Batch != 0))     // Batch functions available
+
+// The batch functions never wait: each one processes as many elements as it can
+// without blocking and returns that number, handling them in a single service call.
+
+/// Put several Messages to a Queue, in order.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[in]     info          array of message information.
+/// \param[in]     count         number of elements in \a info.
+/// \return number of messages put, less than \a count when the queue became full.
+/// \note From an ISR at most \c OS_FIFOSZ messages, less those already waiting in
+///       the ISR post service FIFO, are put per call.
+uint32_t osMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count);
+
+/// Get several Messages from a Queue, in order.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[out]    info          array receiving the message information.
+/// \param[in]     count         number of elements in \a info.
+/// \return number of messages got, less than \a count when the queue became empty.
+uint32_t osMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count);
+
+/// Allocate several memory blocks from a memory pool.
+/// \param[in]     pool_id       memory pool ID obtain referenced with \ref osPoolCreate.
+/// \param[out]    blocks        array receiving the addresses of the allocated memory blocks.
+/// \param[in]     count         number of elements in \a blocks.
+/// \return number of blocks allocated, less than \a count when the pool ran out.
+uint32_t osPoolAllocN (osPoolId pool_id, void **blocks, uint32_t count);
+
+/// Return several allocated memory blocks back to a specific memory pool.
+/// \param[in]     pool_id       memory pool ID obtain referenced with \ref osPoolCreate.
+/// \param[in]     blocks        array of addresses of the memory blocks to return.
+/// \param[in]     count         number of elements in \a blocks.
+/// \return number of blocks returned, less than \a count when a block was not from this pool.
+uint32_t osPoolFreeN (osPoolId pool_id, void * const *blocks, uint32_t count);
+
+/// Allocate several memory blocks from a mail.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[out]    mail          array receiving the addresses of the allocated memory blocks.
+/// \param[in]     count         number of elements in \a mail.
+/// \return number of blocks allocated, less than \a count when the mail pool ran out.
+uint32_t osMailAllocN (osMailQId queue_id, void **mail, uint32_t count);
+
+/// Put several mails to a queue, in order.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[in]     mail          array of memory blocks previously allocated with \ref osMailAlloc.
+/// \param[in]     count         number of elements in \a mail.
+/// \return number of mails put, less than \a count when the queue became full.
+/// \note From an ISR the same limit as for \ref osMessagePutN applies.
+uint32_t osMailPutN (osMailQId queue_id, void * const *mail, uint32_t count);
+
+/// Get several mails from a queue, in order.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[out]    mail          array receiving the mail memory blocks.
+/// \param[in]     count         number of elements in \a mail.
+/// \return number of mails got, less than \a count when the queue became empty.
+uint32_t osMailGetN (osMailQId queue_id, void **mail, uint32_t count);
+
+/// Free several memory blocks from a mail.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[in]     mail          array of memory blocks that were obtained with \ref osMailGet.
+/// \param[in]     count         number of elements in \a mail.
+/// \return number of blocks freed, less than \a count when a block was not from this mail.
+uint32_t osMailFreeN (osMailQId queue_id, void * const *mail, uint32_t count);
+
+#endif  // Batch functions available
+
 
 #ifdef  __cplusplus
 }
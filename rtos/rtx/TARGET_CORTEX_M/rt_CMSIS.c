@@ -2342,3 +2342,258 @@ uint32_t os_suspend (void) {
 void os_resume (uint32_t sleep_time) {
   __rt_resume(sleep_time);
 }
+
+
+#if (defined (osFeature_Batch)  &&  (osFeature_Batch != 0))     // Batch functions available
+
+// Batch Service Calls declarations
+SVC_3_1(svcMessagePutN, uint32_t, osMessageQId, const uint32_t *,  uint32_t,           RET_uint32_t)
+SVC_3_1(svcMessageGetN, uint32_t, osMessageQId,       uint32_t *,  uint32_t,           RET_uint32_t)
+SVC_3_1(sysPoolAllocN,  uint32_t, osPoolId,           void **,     uint32_t,           RET_uint32_t)
+SVC_3_1(sysPoolFreeN,   uint32_t, osPoolId,           void * const *, uint32_t,        RET_uint32_t)
+SVC_4_1(sysMailFreeN,   uint32_t, osMailQId,          void * const *, uint32_t, uint32_t, RET_uint32_t)
+
+// Batch Service & ISR Calls
+//
+// rt_dispatch() may only hand the CPU over once per service call, otherwise
+// the running task would be put to the ready list twice. The thread batches
+// therefore stop before a second element that would wake up a waiting task;
+// the caller gets a short count and simply calls again.
+
+/// Put several Messages to a Queue
+uint32_t svcMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+  P_MCB    pmcb = (P_MCB)queue_id;
+  uint32_t n;
+
+  if ((pmcb == NULL) || (info == NULL) || (pmcb->cb_type != MCB)) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if ((n != 0U) && (pmcb->p_lnk != NULL) && (pmcb->state == 1U)) {
+      break;                                    // Another receiver to wake up
+    }
+    if (rt_mbx_send(pmcb, (void *)info[n], 0U) != OS_R_OK) {
+      break;                                    // Queue is full
+    }
+  }
+
+  return n;
+}
+
+/// Get several Messages from a Queue
+uint32_t svcMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+  P_MCB    pmcb = (P_MCB)queue_id;
+  void    *msg;
+  uint32_t n;
+
+  if ((pmcb == NULL) || (info == NULL) || (pmcb->cb_type != MCB)) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if ((n != 0U) && (pmcb->p_lnk != NULL) && (pmcb->state == 2U)) {
+      break;                                    // Another sender to wake up
+    }
+    if (rt_mbx_wait(pmcb, &msg, 0U) != OS_R_OK) {
+      break;                                    // Queue is empty
+    }
+    info[n] = (uint32_t)msg;
+  }
+
+  return n;
+}
+
+/// Put several Messages to a Queue from an ISR
+static uint32_t isrMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+  uint32_t primask;
+  uint32_t space;
+  uint32_t n;
+
+  if ((queue_id == NULL) || (info == NULL) || (((P_MCB)queue_id)->cb_type != MCB)) {
+    return 0U;
+  }
+
+  // Keep other ISRs from taking the free slots checked below
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  space = rt_mbx_check(queue_id);
+  if (count > space) {
+    count = space;
+  }
+  // Each message takes a post service FIFO slot until PendSV runs
+  space = (uint32_t)os_psq->size - os_psq->count;
+  if (count > space) {
+    count = space;
+  }
+
+  // Deferred to PendSV, which handles all of them in one go
+  for (n = 0U; n < count; n++) {
+    isr_mbx_send(queue_id, (void *)info[n]);
+  }
+
+  if (primask == 0U) {
+    __enable_irq();
+  }
+
+  return n;
+}
+
+/// Get several Messages from a Queue from an ISR
+static uint32_t isrMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+  void    *msg;
+  uint32_t n;
+
+  if ((queue_id == NULL) || (info == NULL) || (((P_MCB)queue_id)->cb_type != MCB)) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if (isr_mbx_receive(queue_id, &msg) != OS_R_MBX) {
+      break;
+    }
+    info[n] = (uint32_t)msg;
+  }
+
+  return n;
+}
+
+/// Allocate several memory blocks from a memory pool
+uint32_t sysPoolAllocN (osPoolId pool_id, void **blocks, uint32_t count) {
+  uint32_t n;
+
+  if ((pool_id == NULL) || (blocks == NULL)) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    blocks[n] = rt_alloc_box(pool_id);
+    if (blocks[n] == NULL) {
+      break;
+    }
+  }
+
+  return n;
+}
+
+/// Return several allocated memory blocks back to a specific memory pool
+uint32_t sysPoolFreeN (osPoolId pool_id, void * const *blocks, uint32_t count) {
+  uint32_t n;
+
+  if ((pool_id == NULL) || (blocks == NULL)) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if (rt_free_box(pool_id, blocks[n]) != 0U) {
+      break;
+    }
+  }
+
+  return n;
+}
+
+/// Free several memory blocks from a mail
+uint32_t sysMailFreeN (osMailQId queue_id, void * const *mail, uint32_t count, uint32_t isr) {
+  P_MCB    pmcb;
+  uint32_t n;
+
+  if ((queue_id == NULL) || (mail == NULL)) {
+    return 0U;
+  }
+
+  pmcb = *(((void **)queue_id) + 0);
+  if (pmcb == NULL) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if ((isr == 0U) && (n != 0U) && (pmcb->p_lnk != NULL) && (pmcb->state == 3U)) {
+      break;                                    // Another allocator to wake up
+    }
+    if (sysMailFree(queue_id, mail[n], isr) != osOK) {
+      break;
+    }
+  }
+
+  return n;
+}
+
+
+// Batch Public API
+
+/// Put several Messages to a Queue
+uint32_t osMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+  if (__get_PRIMASK() != 0U || __get_IPSR() != 0U) {                     // in ISR
+    return   isrMessagePutN(queue_id, info, count);
+  }
+  if ((queue_id == NULL) || (count == 0U) || (rt_mbx_check(queue_id) == 0U)) {
+    return 0U;                                  // Nothing to do, skip the service call
+  }
+  return __svcMessagePutN(queue_id, info, count);
+}
+
+/// Get several Messages from a Queue
+uint32_t osMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+  if (__get_PRIMASK() != 0U || __get_IPSR() != 0U) {                     // in ISR
+    return   isrMessageGetN(queue_id, info, count);
+  }
+  if ((queue_id == NULL) || (count == 0U) || (((P_MCB)queue_id)->count == 0U)) {
+    return 0U;                                  // Nothing to do, skip the service call
+  }
+  return __svcMessageGetN(queue_id, info, count);
+}
+
+/// Allocate several memory blocks from a memory pool
+uint32_t osPoolAllocN (osPoolId pool_id, void **blocks, uint32_t count) {
+  if ((__get_PRIMASK() != 0U || __get_IPSR() != 0U) || ((__get_CONTROL() & 1U) == 0U)) {     // in ISR or Privileged
+    return   sysPoolAllocN(pool_id, blocks, count);
+  } else {                                      // in Thread
+    return __sysPoolAllocN(pool_id, blocks, count);
+  }
+}
+
+/// Return several allocated memory blocks back to a specific memory pool
+uint32_t osPoolFreeN (osPoolId pool_id, void * const *blocks, uint32_t count) {
+  if ((__get_PRIMASK() != 0U || __get_IPSR() != 0U) || ((__get_CONTROL() & 1U) == 0U)) {     // in ISR or Privileged
+    return   sysPoolFreeN(pool_id, blocks, count);
+  } else {                                      // in Thread
+    return __sysPoolFreeN(pool_id, blocks, count);
+  }
+}
+
+/// Allocate several memory blocks from a mail
+uint32_t osMailAllocN (osMailQId queue_id, void **mail, uint32_t count) {
+  if (queue_id == NULL) {
+    return 0U;
+  }
+  return osPoolAllocN(*(((void **)queue_id) + 1), mail, count);
+}
+
+/// Put several mails to a queue
+uint32_t osMailPutN (osMailQId queue_id, void * const *mail, uint32_t count) {
+  if (queue_id == NULL) {
+    return 0U;
+  }
+  return osMessagePutN(*((void **)queue_id), (const uint32_t *)mail, count);
+}
+
+/// Get several mails from a queue
+uint32_t osMailGetN (osMailQId queue_id, void **mail, uint32_t count) {
+  if (queue_id == NULL) {
+    return 0U;
+  }
+  return osMessageGetN(*((void **)queue_id), (uint32_t *)mail, count);
+}
+
+/// Free several memory blocks from a mail
+uint32_t osMailFreeN (osMailQId queue_id, void * const *mail, uint32_t count) {
+  if (__get_PRIMASK() != 0U || __get_IPSR() != 0U) {                     // in ISR
+    return   sysMailFreeN(queue_id, mail, count, 1U);
+  } else {                                      // in Thread
+    return __sysMailFreeN(queue_id, mail, count, 0U);
+  }
+}
+
+#endif  // Batch functions available
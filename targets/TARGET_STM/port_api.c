@@ -31,6 +31,7 @@
 #include "pinmap.h"
 #include "gpio_api.h"
 #include "mbed_error.h"
+#include <stddef.h>
 
 #if DEVICE_PORTIN || DEVICE_PORTOUT
 
@@ -43,6 +44,16 @@ PinName port_pin(PortName port, int pin_n)
     return (PinName)(pin_n + (port << 4));
 }
 
+int port_pin_number(PinName pin, PortName *port)
+{
+    if (pin == NC) {
+        return -1;
+    }
+
+    *port = (PortName)STM_PORT(pin);
+    return STM_PIN(pin);
+}
+
 void port_init(port_t *obj, PortName port, int mask, PinDirection dir)
 {
     uint32_t port_index = (uint32_t)port;
@@ -87,7 +98,10 @@ void port_mode(port_t *obj, PinMode mode)
 
 void port_write(port_t *obj, int value)
 {
-    *obj->reg_out = (*obj->reg_out & ~obj->mask) | (value & obj->mask);
+    // Set and reset the masked pins with a single BSRR store, a read-modify-write
+    // of ODR could undo changes made meanwhile to the other pins of the port
+    GPIO_TypeDef *gpio = (GPIO_TypeDef *)((uint32_t)obj->reg_out - offsetof(GPIO_TypeDef, ODR));
+    gpio->BSRR = (value & obj->mask) | ((~value & obj->mask) << 16);
 }
 
 int port_read(port_t *obj)